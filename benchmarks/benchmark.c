@@ -0,0 +1,199 @@
+/*
+*	Name: benchmark.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Times every stage of the analysis programs on one trajectory and contact file,
+*		usually written by generateBenchmarkData.  Each stage is run --repeat times
+*		(default 3) and the fastest run is reported:
+*			countFrames - scanning the frame headers of the traj.xtc
+*			decode - decompressing every frame
+*			q - the Q value of every frame, from decoded coordinates
+*			probability - the probability of every contact, from decoded coordinates
+*			sort - sorting the contacts and their reverse by residue
+*			average - the average probability of every residue, from the sorted contacts
+*			residueGraph - the same averages, from a struct ResidueGraph
+*			qStream - decoding and the Q values together, on 1, 2, 4, ... up to
+*				  --threads threads
+*		One tab separated line is written per stage: stage, residues, frames, contacts,
+*		threads, seconds, items and items per second.  Items are frames for
+*		countFrames, decode and qStream, frames times contacts for q and probability,
+*		and contacts for sort, average and residueGraph.
+*
+*	Usage example:
+*		benchmark {residues} {cutoff} {xtcFile} {contactFile} --repeat 3 --threads 4
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <limits.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+#include "../software/headers/averageContactProbabilityInQValueRange/averageContactProbabilityInQValueRange.h"
+#include "../software/headers/residueGraph/residueGraph.h"
+#include "../software/headers/threadedAnalysis/threadedAnalysis.h"
+#include "../software/headers/programOptions/programOptions.h"
+
+struct Benchmark {
+	char *xtcFile;
+	int residues;
+	int frames;
+	int contacts;
+	int threads;
+	float cutoff;
+	struct Contact *residueContacts;
+	struct XtcTrajectory *trajectory;
+	struct ContactInformation *contactInformation;
+	struct ContactInformation *sortedContacts;
+};
+
+typedef void (*BenchmarkStage)(struct Benchmark *benchmark);
+
+static double now() {
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+static void countFrames(struct Benchmark *benchmark) {
+	freeXtcFrameIndex(scanXtcFrameIndex(benchmark->xtcFile));
+}
+
+static void decodeFrames(struct Benchmark *benchmark) {
+	struct XtcStream *stream = openXtcStream(benchmark->xtcFile, benchmark->residues);
+
+	while(readXtcStreamFrame(stream));
+
+	closeXtcStream(stream);
+}
+
+static void calculateQ(struct Benchmark *benchmark) {
+	free(calculateQValuesFromTrajectory(benchmark->trajectory, benchmark->contacts, benchmark->cutoff, benchmark->residueContacts));
+}
+
+static void calculateProbability(struct Benchmark *benchmark) {
+	struct QRange qRange = {0, INT_MAX};
+	struct TSRange timeRange = {1, INT_MAX};
+
+	free(calculateContactProbabilityFromTrajectory(benchmark->trajectory, benchmark->contacts, benchmark->residueContacts, qRange, timeRange, benchmark->cutoff));
+}
+
+static void sortContactInformation(struct Benchmark *benchmark) {
+	free(sortContacts(benchmark->contacts, createContactInfoForSort(benchmark->contacts, benchmark->contactInformation)));
+}
+
+static void averageSortedContacts(struct Benchmark *benchmark) {
+	free(calculateAverageContactProbability(benchmark->residues, benchmark->contacts, benchmark->sortedContacts));
+}
+
+static void averageResidueGraph(struct Benchmark *benchmark) {
+	struct ResidueGraph *residueGraph = createResidueGraph(benchmark->residues, benchmark->contacts, benchmark->residueContacts);
+
+	free(calculateResidueGraphAverages(residueGraph, benchmark->contactInformation));
+	freeResidueGraph(residueGraph);
+}
+
+static void calculateQStream(struct Benchmark *benchmark) {
+	struct XtcStream *stream = openXtcStream(benchmark->xtcFile, benchmark->residues);
+	int frames;
+
+	if(benchmark->threads > 1) {
+		free(calculateQValuesThreaded(stream, benchmark->contacts, benchmark->cutoff, benchmark->residueContacts, &frames, benchmark->threads));
+	} else {
+		free(calculateQValuesFromStream(stream, benchmark->contacts, benchmark->cutoff, benchmark->residueContacts, &frames));
+	}
+
+	closeXtcStream(stream);
+}
+
+/*
+*	Runs the stage repeat times and writes the line of the fastest run.
+*/
+
+static void timeStage(struct Benchmark *benchmark, char *name, BenchmarkStage stage, int repeat, double items) {
+	double best = -1;
+
+	for(int r = 0; r < repeat; r++) {
+		double start = now();
+
+		stage(benchmark);
+
+		double seconds = now() - start;
+		if(best < 0 || seconds < best) {
+			best = seconds;
+		}
+	}
+
+	printf("%s\t%d\t%d\t%d\t%d\t%.6f\t%.0f\t%.1f\n", name, benchmark->residues, benchmark->frames, benchmark->contacts,
+	       benchmark->threads, best, items, best > 0 ? items / best : 0.0);
+	fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+	int threads = takeThreadsOption(&argc, argv);
+	char *repeatOption = takeOption(&argc, argv, "--repeat");
+	int repeat = repeatOption ? atoi(repeatOption) : 3;
+
+	if (argc != 5 || repeat < 1) {
+		printf("Usage Example: benchmark 1000 1.0 bench.xtc benchContacts --repeat 3 --threads 4\n");
+		return 1;
+	}
+
+	struct Benchmark benchmark;
+	struct ContactSet *contactSet = readContactSet(argv[4]);
+
+	benchmark.residues = atoi(argv[1]);
+	benchmark.cutoff = atof(argv[2]);
+	benchmark.xtcFile = argv[3];
+	benchmark.threads = 1;
+
+	checkContactSetResidues(contactSet, benchmark.residues);
+	benchmark.contacts = contactSet->contacts;
+	benchmark.residueContacts = contactSet->residueContacts;
+
+	// The stages after decode start from coordinates and probabilities already in memory
+	benchmark.frames = getFrames(benchmark.xtcFile, benchmark.residues);
+	benchmark.trajectory = getXtcFileTrajectory(benchmark.xtcFile, benchmark.residues, benchmark.frames);
+
+	struct QRange qRange = {0, INT_MAX};
+	struct TSRange timeRange = {1, INT_MAX};
+	benchmark.contactInformation = calculateContactProbabilityFromTrajectory(benchmark.trajectory, benchmark.contacts, benchmark.residueContacts, qRange, timeRange, benchmark.cutoff);
+	benchmark.sortedContacts = sortContacts(benchmark.contacts, createContactInfoForSort(benchmark.contacts, benchmark.contactInformation));
+
+	double frames = benchmark.frames;
+	double evaluations = (double) benchmark.frames * benchmark.contacts;
+
+	printf("stage\tresidues\tframes\tcontacts\tthreads\tseconds\titems\titemsPerSecond\n");
+
+	timeStage(&benchmark, "countFrames", countFrames, repeat, frames);
+	timeStage(&benchmark, "decode", decodeFrames, repeat, frames);
+	timeStage(&benchmark, "q", calculateQ, repeat, evaluations);
+	timeStage(&benchmark, "probability", calculateProbability, repeat, evaluations);
+	timeStage(&benchmark, "sort", sortContactInformation, repeat, benchmark.contacts);
+	timeStage(&benchmark, "average", averageSortedContacts, repeat, benchmark.contacts);
+	timeStage(&benchmark, "residueGraph", averageResidueGraph, repeat, benchmark.contacts);
+
+	// Doubles the threads up to --threads, which is always included
+	for(benchmark.threads = 1; ; benchmark.threads = benchmark.threads * 2 < threads ? benchmark.threads * 2 : threads) {
+		timeStage(&benchmark, "qStream", calculateQStream, repeat, frames);
+
+		if(benchmark.threads == threads) {
+			break;
+		}
+	}
+
+	free(benchmark.sortedContacts);
+	free(benchmark.contactInformation);
+	freeXtcTrajectory(benchmark.trajectory);
+	freeContactSet(contactSet);
+
+	return 0;
+}
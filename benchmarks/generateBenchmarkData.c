@@ -0,0 +1,199 @@
+/*
+*	Name: generateBenchmarkData.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Writes a synthetic traj.xtc and a SMOG contact file of any size for the
+*		benchmarks.  The native structure is a random walk of residues 0.38 nm apart
+*		inside a box of protein density.  Every frame moves the residues away from the
+*		native structure by a random amount that grows with the frame, so the Q values
+*		fall from near the amount of contacts to near 0 over the trajectory.  Contacts
+*		are residue pairs at least 4 apart in sequence and closer than 0.8 nm in the
+*		native structure; if there are not enough of these, other pairs are added.
+*		The same arguments and --seed always write the same files.
+*
+*	Usage example:
+*		generateBenchmarkData {residues} {frames} {contacts} {xtcFile} {contactFile} --seed 1
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "../software/headers/xtcReader/xdrfile.h"
+#include "../software/headers/xtcReader/xdrfile_xtc.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/programOptions/programOptions.h"
+
+// Residues further apart in sequence than this are not checked for native contacts
+#define NATIVE_CONTACT_WINDOW 64
+#define NATIVE_CONTACT_DISTANCE 0.8
+#define BOND_LENGTH 0.38
+
+static double randomUniform() {
+	return (rand() + 0.5) / ((double) RAND_MAX + 1.0);
+}
+
+static double randomGaussian() {
+	return sqrt(-2.0 * log(randomUniform())) * cos(2.0 * M_PI * randomUniform());
+}
+
+static int isNativeContact(rvec *native, int i, int j) {
+	double distance = 0;
+
+	if(j - i < 4 || j - i > NATIVE_CONTACT_WINDOW) {
+		return 0;
+	}
+
+	for(int k = 0; k < 3; k++) {
+		distance += (native[i][k] - native[j][k]) * (native[i][k] - native[j][k]);
+	}
+
+	return distance < NATIVE_CONTACT_DISTANCE * NATIVE_CONTACT_DISTANCE;
+}
+
+static int compareContacts(const void *a, const void *b) {
+	const struct Contact *contact1 = (const struct Contact*) a;
+	const struct Contact *contact2 = (const struct Contact*) b;
+
+	if(contact1->focusResidue != contact2->focusResidue) {
+		return contact1->focusResidue - contact2->focusResidue;
+	}
+
+	return contact1->contactResidue - contact2->contactResidue;
+}
+
+int main(int argc, char *argv[]) {
+	char *seedOption = takeOption(&argc, argv, "--seed");
+
+	if (argc != 6) {
+		printf("Usage Example: generateBenchmarkData 1000 500 3000 bench.xtc benchContacts --seed 1\n");
+		return 1;
+	}
+
+	int residues = atoi(argv[1]);
+	int frames = atoi(argv[2]);
+	int contacts = atoi(argv[3]);
+	char *xtcFile = argv[4];
+	char *contactFile = argv[5];
+
+	if (residues < 5 || frames < 1 || contacts < 1 || contacts > (long) (residues - 4) * (residues - 3) / 2) {
+		printf("\nNeeds at least 5 residues, 1 frame and 1 contact, and no more contacts than pairs 4 or more residues apart\n");
+		return 1;
+	}
+
+	srand(seedOption ? atoi(seedOption) : 1);
+
+	rvec *native = (rvec*) malloc(sizeof(rvec) * residues);
+	rvec *x = (rvec*) malloc(sizeof(rvec) * residues);
+	struct Contact *residueContacts = (struct Contact*) malloc(sizeof(struct Contact) * contacts);
+	if(!native || !x || !residueContacts) {
+		perror("benchmark data memory not allocated");
+		abort();
+	}
+
+	// About 9 residues per cubic nm, as in a folded protein
+	double side = cbrt(residues / 9.0) + BOND_LENGTH;
+	matrix box = {{side, 0, 0}, {0, side, 0}, {0, 0, side}};
+
+	for(int k = 0; k < 3; k++) {
+		native[0][k] = side / 2;
+	}
+
+	// Steps leaving the box are tried again in another direction
+	for(int i = 1; i < residues; i++) {
+		int inside;
+
+		do {
+			double step[3], length = 0;
+
+			for(int k = 0; k < 3; k++) {
+				step[k] = randomGaussian();
+				length += step[k] * step[k];
+			}
+
+			inside = 1;
+			for(int k = 0; k < 3; k++) {
+				native[i][k] = native[i-1][k] + BOND_LENGTH * step[k] / sqrt(length);
+				inside &= native[i][k] >= 0 && native[i][k] <= side;
+			}
+		} while(!inside);
+	}
+
+	// Native pairs are counted first, then every one of them or an even share is kept
+	long nativePairs = 0, seen = 0;
+	int pairs = 0;
+
+	for(int i = 0; i < residues; i++) {
+		for(int j = i + 4; j < residues && j - i <= NATIVE_CONTACT_WINDOW; j++) {
+			nativePairs += isNativeContact(native, i, j);
+		}
+	}
+
+	for(int i = 0; i < residues && pairs < contacts; i++) {
+		for(int j = i + 4; j < residues && j - i <= NATIVE_CONTACT_WINDOW && pairs < contacts; j++) {
+			if(isNativeContact(native, i, j) && (nativePairs <= contacts || seen++ * contacts / nativePairs == pairs)) {
+				residueContacts[pairs].focusResidue = i + 1;
+				residueContacts[pairs].contactResidue = j + 1;
+				pairs++;
+			}
+		}
+	}
+
+	// The rest are pairs that are not native contacts, closest in sequence first
+	for(int separation = 4; pairs < contacts; separation++) {
+		for(int i = 0; i + separation < residues && pairs < contacts; i++) {
+			if(!isNativeContact(native, i, i + separation)) {
+				residueContacts[pairs].focusResidue = i + 1;
+				residueContacts[pairs].contactResidue = i + separation + 1;
+				pairs++;
+			}
+		}
+	}
+
+	qsort(residueContacts, contacts, sizeof(struct Contact), compareContacts);
+
+	FILE *fp;
+	if ((fp = fopen(contactFile, "w")) == NULL) {
+		perror("could not open contactFile for output.");
+		exit(1);
+	}
+
+	fprintf(fp, "%d\t0\n", contacts);
+	for(int c = 0; c < contacts; c++) {
+		fprintf(fp, "1 %d 1 %d\n", residueContacts[c].focusResidue, residueContacts[c].contactResidue);
+	}
+	fclose(fp);
+
+	XDRFILE *xd = xdrfile_open(xtcFile, "w");
+	if (!xd) {
+		perror("could not open xtcFile for output.");
+		exit(1);
+	}
+
+	for(int f = 0; f < frames; f++) {
+		// Displacement from 0.05 nm in the first frame to 0.5 nm in the last
+		double sigma = 0.05 + 0.45 * f / (frames > 1 ? frames - 1 : 1);
+
+		for(int i = 0; i < residues; i++) {
+			for(int k = 0; k < 3; k++) {
+				x[i][k] = native[i][k] + sigma * randomGaussian();
+			}
+		}
+
+		if (write_xtc(xd, residues, f * 1000, f * 2.0f, box, x, 1000.0f) != exdrOK) {
+			printf("\nwrite_xtc: could not write frame %d\n", f + 1);
+			exit(1);
+		}
+	}
+
+	xdrfile_close(xd);
+
+	free(native);
+	free(x);
+	free(residueContacts);
+
+	return 0;
+}
@@ -0,0 +1,75 @@
+/*
+*	Name: analysisProg.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Reads the contact file and the traj.xtc file once and writes the output of
+*		calcQFromContactsProg, probabilityContactInQValueRangeProg and
+*		averageContactProbabilityInQValueRangeProg together.  After the residues,
+*		cutoff, traj.xtc and contact file comes a list of jobs, each writing one file:
+*			q {qFile}
+*			probability {qLow} {qHigh} {tsLow} {tsHigh} {file}
+*			average {qLow} {qHigh} {tsLow} {tsHigh} {file}
+*		Every file is the same as the qFile or stdout of the program the job replaces;
+*		a file of "-" is written to stdout.  Jobs may be repeated with other ranges.
+*
+*	Usage example:
+*		analysisProg {residues} {cutoff} {xtcFile} {contactFile} q qFile probability 0 100 1 500 probabilities average 0 100 1 500 averages
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "headers/xtcReader/xtcReader.h"
+#include "headers/contactReader/contactReader.h"
+#include "headers/analysisJobs/analysisJobs.h"
+#include "headers/programOptions/programOptions.h"
+#include "headers/profile/profile.h"
+
+int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	int threads = takeThreadsOption(&argc, argv);
+	int stride = takeStrideOption(&argc, argv);
+
+	if (argc < 7) {
+		printf("Usage Example: analysisProg 163 1.0 traj.xtc contactFile q qFile probability 0 100 1 500 probabilities average 0 100 1 500 averages\n");
+		return 1;
+	}
+
+	int residues = atoi(argv[1]);
+	float cutOff = atof(argv[2]);
+	char *xtcfile = argv[3];
+	char *contactFile = argv[4];
+
+	// Every job is checked before the trajectory is read
+	struct AnalysisJobs *jobs = parseAnalysisJobs(argc - 5, &argv[5]);
+
+	struct XtcStream *xtcStream;
+
+	// Reads the contacts from the contact file once
+	profileStage("readContacts");
+	struct ContactSet *contactSet = readContactSet(contactFile);
+	checkContactSetResidues(contactSet, residues);
+
+	// Opens the traj.xtc file, frames are decoded one at a time
+	profileStage("openTrajectory");
+	xtcStream = openXtcStream(xtcfile, residues);
+	setXtcStreamStride(xtcStream, stride);
+
+	// Every frame is decoded and evaluated once for all of the jobs
+	profileStage("calculateJobs");
+	calculateAnalysisJobs(jobs, xtcStream, contactSet->contacts, contactSet->residueContacts, residues, cutOff, threads);
+
+	closeXtcStream(xtcStream);
+
+	profileStage("writeOutput");
+	writeAnalysisJobs(jobs, residues);
+
+	freeAnalysisJobs(jobs);
+	freeContactSet(contactSet);
+
+	return 0;
+}
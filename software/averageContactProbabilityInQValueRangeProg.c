@@ -9,6 +9,12 @@
 *		contact (a residue and the residue it is in contact with) being present.  These probabilities
 *		will then be averaged together to determine the probability that a residue is part of any
 *		contact.  A range of Q values will be given.  A range of time slice values will be given.
+*
+*		With --qseries file, the Q values are read from a binary Q series written by
+*		calcQFromContactsProg --qseries, and only the frames in both ranges are decoded.
+*
+*		With --cache directory, or PROTEIN_CACHE set, the contact probabilities are kept
+*		in the directory and read from there when the same ranges are asked for again.
 *		
 *
 *	Compile example:
@@ -22,10 +28,27 @@
 #include "headers/xtcReader/xtcReader.h"
 #include "headers/contactReader/contactReader.h"
 #include "headers/calcQFromContacts/calcQFromContacts.h"
+#include "headers/threadedAnalysis/threadedAnalysis.h"
+#include "headers/checkpoint/checkpoint.h"
+#include "headers/qSeries/qSeries.h"
+#include "headers/resultCache/resultCache.h"
+#include "headers/programOptions/programOptions.h"
+#include "headers/profile/profile.h"
 #include "headers/probabilityContactInQValueRange/probabilityContactInQValueRange.h"
 #include "headers/averageContactProbabilityInQValueRange/averageContactProbabilityInQValueRange.h"
+#include "headers/residueGraph/residueGraph.h"
 
 int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	int threads = takeThreadsOption(&argc, argv);
+	char *checkpointFile = takeOption(&argc, argv, "--checkpoint");
+	char *checkpointFrames = takeOption(&argc, argv, "--checkpoint-frames");
+	char *qSeriesFile = takeOption(&argc, argv, "--qseries");
+	struct ResultCache *cache = openResultCache(&argc, argv);
+	char *settings = joinArguments(argc, argv);
+	int stride = takeStrideOption(&argc, argv);
+
 	char *xtcfile = argv[5];
 	char *contactFile = argv[6];
 
@@ -38,38 +61,76 @@ int main(int argc, char *argv[]) {
 	int residues = atoi(argv[7]);
 	float cutOff = atof(argv[8]);
 
-	int *qValues, xtcFrames, contacts;
+	int contacts;
 
-	struct XtcCoordinates **xtcResidueCoordinates;
-	struct ContactInformation *residueContactsInformation, *sortedContacts;
+	struct XtcStream *xtcStream;
+	struct Checkpoint *checkpoint = NULL;
+	struct ContactInformation *residueContactsInformation;
+	struct ResidueGraph *residueGraph;
 	struct ContactAverages* contactAverages;
+	struct ContactSet *contactSet;
 	struct Contact *residueContacts;
 
-	// Counts amount of frames from the traj.xtc file
-	xtcFrames = getFrames(xtcfile, residues);
+	// Reads the contacts from the contact file once
+	profileStage("readContacts");
+	contactSet = readContactSet(contactFile);
+	checkContactSetResidues(contactSet, residues);
 
-	// Copies all the residue coordinates for each frame of the traj.xtc file into memory
-	xtcResidueCoordinates = getXtcFileCoordinates(xtcfile, residues, xtcFrames);
+	contacts = contactSet->contacts;
+	residueContacts = contactSet->residueContacts;
 
-	// Reads the amount of contacts from the contact file
-	contacts = getAmountOfContacts(contactFile);
+	// Opens the traj.xtc file, frames are decoded one at a time
+	profileStage("openTrajectory");
+	xtcStream = openXtcStream(xtcfile, residues);
+	setXtcStreamStride(xtcStream, stride);
 
-	// Copies all the residue contacts from the contact file
-	residueContacts = getContactFileContacts(contactFile);
+	// Both programs keep the same results for the same ranges, cutoff and stride
+	char cacheSettings[512];
+	int64_t cachedFrames, cachedBytes;
+	int cached = 0;
 
-	// Creates Q values for every frame in the traj.xtc file
-	qValues = calculateQValues(xtcFrames, contacts, cutOff, xtcResidueCoordinates, residueContacts);
+	if(cache) {
+		snprintf(cacheSettings, sizeof(cacheSettings), "%s %s %s %s %s %s stride %d", argv[1], argv[2], argv[3], argv[4], argv[7], argv[8], stride);
+		setResultCacheKey(cache, "contactProbability", xtcfile, contactFile, cacheSettings);
+	}
 
 	// Records total occurrences of each contact and calculates the probability of the contact occurring
-	residueContactsInformation = calculateContactProbability(xtcFrames, contacts, xtcResidueCoordinates, contactFile, qRange, timeRange, qValues, cutOff);
+	profileStage("calculateProbability");
+	if(cache && (residueContactsInformation = (struct ContactInformation*) readResultCache(cache, &cachedFrames, &cachedBytes)) != NULL) {
+		cached = 1;
+	} else if(qSeriesFile) {
+		// Frames with a Q value out of range are not decoded
+		struct QSeries *series = readQSeries(qSeriesFile);
+
+		checkQSeries(series, xtcStream, contactFile, cutOff);
+		residueContactsInformation = calculateContactProbabilityFromQSeries(xtcStream, series, contacts, residueContacts, qRange, timeRange, cutOff);
+		freeQSeries(series);
+	} else if(checkpointFile) {
+		// The counts of a table with one window are saved, and are the same as below
+		struct OccupancyWindow window = {qRange, timeRange};
+
+		checkpoint = openCheckpoint(checkpointFile, checkpointFrames ? atoi(checkpointFrames) : CHECKPOINT_FRAMES, xtcfile, contactFile, settings);
+		residueContactsInformation = calculateOccupancyTableCheckpointed(checkpoint, xtcStream, contacts, residueContacts, 1, &window, cutOff, threads)->contactInformation;
+	} else if(threads > 1) {
+		residueContactsInformation = calculateContactProbabilityThreaded(xtcStream, contacts, residueContacts, qRange, timeRange, cutOff, threads);
+	} else {
+		residueContactsInformation = calculateContactProbabilityFromStream(xtcStream, contacts, residueContacts, qRange, timeRange, cutOff);
+	}
 
-	// Copies, reverses, and appended the copy to the end of the contacts, then sorts the
-	// contacts by the first of two contacts in the pair
-	sortedContacts = sortContacts(contacts, createContactInfoForSort(contacts, residueContactsInformation));
+	if(cache && !cached) {
+		writeResultCache(cache, residueContactsInformation, contacts, sizeof(struct ContactInformation) * (int64_t) contacts);
+	}
+
+	closeXtcStream(xtcStream);
+
+	// Lists the contacts of every residue, as either residue of the pair
+	profileStage("calculateAverages");
+	residueGraph = createResidueGraph(residues, contacts, residueContacts);
 
 	// Calculates the average of all probabilities per residue
-	contactAverages = calculateAverageContactProbability(residues, contacts, sortedContacts);
+	contactAverages = calculateResidueGraphAverages(residueGraph, residueContactsInformation);
 
+	profileStage("writeOutput");
 	for(int i = 0; i < residues; i++) {
 		if(contactAverages[i].averageProbability != -1.0) {
 			//printf("Residue: %d Probability: %f\n", contactAverages[i].focusResidue+1, contactAverages[i].averageProbability);
@@ -80,5 +141,9 @@ int main(int argc, char *argv[]) {
 		}
 	}
 
+	if(checkpoint) {
+		finishCheckpoint(checkpoint);
+	}
+
 	return 0;
 }
@@ -0,0 +1,44 @@
+/*
+*	Name: buildContactMapProg.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Reads the traj.xtc file once and writes the contact states of every frame to a
+*		contact map file.  Each frame stores one bit per contact in the contact file; the
+*		bit is set when the residue pair is within the cutoff value.  The contact map is
+*		then queried with queryContactMapProg instead of reading the traj.xtc again.
+*
+*	Usage example:
+*		buildContactMapProg {residues} {cutoff} {xtcFile} {contactFile} {mapFile}
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "headers/contactMap/contactMap.h"
+#include "headers/profile/profile.h"
+
+int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	if (argc != 6) {
+		printf("Usage Example: buildContactMapProg 163 1.0 traj.xtc contactFile traj.cmap\n");
+		return 1;
+	}
+
+	int residues = atoi(argv[1]);
+	float cutoff = atof(argv[2]);
+	char *xtcfile = argv[3];
+	char *contactFile = argv[4];
+	char *mapFile = argv[5];
+
+	// Evaluates every contact of every frame and writes the contact states
+	profileStage("buildContactMap");
+	int xtcFrames = buildContactMap(xtcfile, contactFile, residues, cutoff, mapFile);
+
+	printf("%d frames written to %s\n", xtcFrames, mapFile);
+
+	return 0;
+}
@@ -14,6 +14,31 @@
 *		within a cutoff distance.  If the residue pair is within the cutoff value, it will
 *		be considered a contact, and increase the Q value of the frame by 1.  The Q value
 *		of a frame is the amount of contacts present in the frame.
+*
+*		With --native, the fractional Q of Best, Hummer and Eaton is written instead,
+*		using the contact distances of the native structure (.gro or traj.xtc) and
+*		--beta and --lambda for the switching function.  The cutoff is not used.
+*
+*		With --follow, the traj.xtc is kept open while mdrun writes it.  Each new
+*		frame is read once it is complete and its Q value appended to the qFile, which
+*		continues after its last line if it already exists.  The file is checked every
+*		--poll seconds (default 1), and the program stops once no frame has been added
+*		for --idle seconds, or keeps following until it is stopped when --idle is not
+*		given.
+*
+*		With --checkpoint file, the Q values calculated so far are saved to the file
+*		every --checkpoint-frames frames (default 10000).  Running the same command
+*		again after it was stopped continues from the last checkpoint, and the file is
+*		removed once the qFile is written.
+*
+*		With --qseries file, the Q values are also written to a binary Q series that
+*		probabilityContactInQValueRangeProg and
+*		averageContactProbabilityInQValueRangeProg can read in place of evaluating
+*		every frame again.
+*
+*		With --cache directory, or PROTEIN_CACHE set, the Q values are kept in the
+*		directory and running again with the same trajectory, contacts and settings
+*		reads them from there.
 *		
 *	Compile example:
 *		gcc -o calcQFromContacts calcQFromContacts.c xdrfile.c xdrfile_xtc.c -lm
@@ -26,36 +51,196 @@
 #include "headers/xtcReader/xtcReader.h"
 #include "headers/contactReader/contactReader.h"
 #include "headers/calcQFromContacts/calcQFromContacts.h"
+#include "headers/smoothQ/smoothQ.h"
+#include "headers/threadedAnalysis/threadedAnalysis.h"
+#include "headers/followQ/followQ.h"
+#include "headers/qSeries/qSeries.h"
+#include "headers/resultCache/resultCache.h"
+#include "headers/checkpoint/checkpoint.h"
+#include "headers/programOptions/programOptions.h"
+#include "headers/profile/profile.h"
 
 int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	int threads = takeThreadsOption(&argc, argv);
+	char *checkpointFile = takeOption(&argc, argv, "--checkpoint");
+	char *checkpointFrames = takeOption(&argc, argv, "--checkpoint-frames");
+	char *qSeriesFile = takeOption(&argc, argv, "--qseries");
+	struct ResultCache *cache = openResultCache(&argc, argv);
+
+	// Every other argument changes the Q values, so a checkpoint is kept for the same ones
+	char *settings = joinArguments(argc, argv);
+
+	int stride = takeStrideOption(&argc, argv);
+	struct TSRange timeRange;
+	int ranged = takeRangeOption(&argc, argv, "--range", &timeRange.low, &timeRange.high);
+	char *nativeFile = takeOption(&argc, argv, "--native");
+	float beta = takeFloatOption(&argc, argv, "--beta", SMOOTH_Q_BETA);
+	float lambda = takeFloatOption(&argc, argv, "--lambda", SMOOTH_Q_LAMBDA);
+	int follow = takeFlag(&argc, argv, "--follow");
+	float poll = takeFloatOption(&argc, argv, "--poll", FOLLOW_Q_POLL);
+	float idle = takeFloatOption(&argc, argv, "--idle", 0.0f);
+
 	char *xtcfile = argv[3];
 	char *contactFile = argv[4];
 	char *qFile = argv[5];
+	char cacheSettings[512];
+	int64_t cachedFrames, cachedBytes;
+	int cached = 0;
 
-	float cutoff = atof(argv[2]);
+	// The settings that change the Q values, the file names do not
+	if(nativeFile) {
+		snprintf(cacheSettings, sizeof(cacheSettings), "%s stride %d range %d:%d native %016llx beta %g lambda %g", argv[1], stride,
+			 ranged ? timeRange.low : 1, ranged ? timeRange.high : 0, (unsigned long long) hashFileSample(nativeFile, RESULT_CACHE_SAMPLE), beta, lambda);
+	} else {
+		snprintf(cacheSettings, sizeof(cacheSettings), "%s %s stride %d range %d:%d", argv[1], argv[2], stride, ranged ? timeRange.low : 1, ranged ? timeRange.high : 0);
+	}
+
+	// Several cutoffs, "6,7.5,9", write one Q column per cutoff
+	int cutoffs;
+	float *cutoff = parseCutoffList(argv[2], &cutoffs);
 	int residues = atoi(argv[1]);
 	int *qValues, xtcFrames, contacts;
 
-	struct XtcCoordinates **xtcResidueCoordinates;
+	struct XtcStream *xtcStream;
+	struct ContactSet *contactSet;
 	struct Contact *residueContacts;
+	struct Checkpoint *checkpoint = NULL;
+
+	// Reads the contacts from the contact file once
+	profileStage("readContacts");
+	contactSet = readContactSet(contactFile);
+	checkContactSetResidues(contactSet, residues);
+
+	contacts = contactSet->contacts;
+	residueContacts = contactSet->residueContacts;
+
+	// Opens the traj.xtc file, frames are decoded one at a time
+	profileStage("openTrajectory");
+	xtcStream = openXtcStream(xtcfile, residues);
+	setXtcStreamStride(xtcStream, stride);
+
+	// Frames outside of the time slice range are never decoded
+	if(ranged) {
+		setXtcStreamTimeRange(xtcStream, timeRange);
+	}
+
+	// Appends the Q value of every new frame while the traj.xtc is written
+	if(follow) {
+		if(qSeriesFile) {
+			printf("\n--qseries is not written with --follow, the qFile is the only output\n");
+			return 1;
+		}
+
+		if(checkpointFile) {
+			printf("\n--checkpoint is not used with --follow, following the same qFile again continues after its last line\n");
+			return 1;
+		}
+
+		struct SmoothQ *smoothQ = NULL;
 
-	// Counts amount of frames from the traj.xtc file
-	xtcFrames = getFrames(xtcfile, residues);
+		if(nativeFile) {
+			smoothQ = createSmoothQ(contacts, residueContacts, readNativeStructure(nativeFile, residues), beta, lambda);
+		}
 
-	// Copies all the residue coordinates for each frame of the traj.xtc file into memory
-	xtcResidueCoordinates = getXtcFileCoordinates(xtcfile, residues, xtcFrames);
+		profileStage("followQ");
+		followQValues(xtcStream, contacts, cutoffs, cutoff, residueContacts, smoothQ, qFile, poll, idle);
 
-	// Reads the amount of contacts from the contact file
-	contacts = getAmountOfContacts(contactFile);
+		closeXtcStream(xtcStream);
 
-	// Copies all the residue contacts from the contact file
-	residueContacts = getContactFileContacts(contactFile);
+		return 0;
+	}
+
+	if(checkpointFile) {
+		checkpoint = openCheckpoint(checkpointFile, checkpointFrames ? atoi(checkpointFrames) : CHECKPOINT_FRAMES, xtcfile, contactFile, settings);
+	}
+
+	// Creates a fractional Q for every frame from the native contact distances
+	if(nativeFile) {
+		profileStage("calculateSmoothQ");
+
+		struct XtcCoordinates *nativeFrame = readNativeStructure(nativeFile, residues);
+		struct SmoothQ *smoothQ = createSmoothQ(contacts, residueContacts, nativeFrame, beta, lambda);
+		float *smoothQValues;
+
+		if(cache) {
+			setResultCacheKey(cache, "smoothQValues", xtcfile, contactFile, cacheSettings);
+		}
+
+		if(cache && (smoothQValues = (float*) readResultCache(cache, &cachedFrames, &cachedBytes)) != NULL) {
+			xtcFrames = cachedFrames;
+			cached = 1;
+		} else if(checkpoint) {
+			smoothQValues = calculateSmoothQValuesCheckpointed(checkpoint, xtcStream, smoothQ, residueContacts, &xtcFrames, threads);
+		} else if(threads > 1) {
+			smoothQValues = calculateSmoothQValuesThreaded(xtcStream, smoothQ, residueContacts, &xtcFrames, threads);
+		} else {
+			smoothQValues = calculateSmoothQValuesFromStream(xtcStream, smoothQ, residueContacts, &xtcFrames);
+		}
+
+		if(cache && !cached) {
+			writeResultCache(cache, smoothQValues, xtcFrames, sizeof(float) * (int64_t) xtcFrames);
+		}
+
+		profileStage("writeQFile");
+		if(qSeriesFile) {
+			writeQSeries(createQSeries(Q_SERIES_FLOAT, 1, NULL, xtcFrames, smoothQValues, xtcStream, contactFile), qSeriesFile);
+		}
+
+		closeXtcStream(xtcStream);
+
+		writeSmoothQFile(smoothQValues, xtcFrames, qFile);
+
+		if(checkpoint) {
+			finishCheckpoint(checkpoint);
+		}
+
+		return 0;
+	}
 
 	// Creates Q values for every frame in the traj.xtc file
-	qValues = calculateQValues(xtcFrames, contacts, cutoff, xtcResidueCoordinates, residueContacts);
-	
-	// Creates qFile of the Q values
-	writeQFile(qValues, xtcFrames, qFile);
+	profileStage("calculateQ");
+	if(cache) {
+		setResultCacheKey(cache, "qValues", xtcfile, contactFile, cacheSettings);
+	}
+
+	if(cache && (qValues = (int*) readResultCache(cache, &cachedFrames, &cachedBytes)) != NULL) {
+		xtcFrames = cachedFrames;
+		cached = 1;
+	} else if(checkpoint) {
+		qValues = calculateQValuesCheckpointed(checkpoint, xtcStream, contacts, cutoffs, cutoff, residueContacts, &xtcFrames, threads);
+	} else if(cutoffs > 1 && threads > 1) {
+		qValues = calculateQValuesCutoffsThreaded(xtcStream, contacts, cutoffs, cutoff, residueContacts, &xtcFrames, threads);
+	} else if(cutoffs > 1) {
+		qValues = calculateQValuesCutoffsFromStream(xtcStream, contacts, cutoffs, cutoff, residueContacts, &xtcFrames);
+	} else if(threads > 1) {
+		qValues = calculateQValuesThreaded(xtcStream, contacts, cutoff[0], residueContacts, &xtcFrames, threads);
+	} else {
+		qValues = calculateQValuesFromStream(xtcStream, contacts, cutoff[0], residueContacts, &xtcFrames);
+	}
+
+	if(cache && !cached) {
+		writeResultCache(cache, qValues, xtcFrames, sizeof(int) * (int64_t) xtcFrames * cutoffs);
+	}
+
+	// Creates qFile of the Q values, and the Q series if asked for
+	profileStage("writeQFile");
+	if(qSeriesFile) {
+		writeQSeries(createQSeries(Q_SERIES_INT32, cutoffs, cutoff, xtcFrames, qValues, xtcStream, contactFile), qSeriesFile);
+	}
+
+	closeXtcStream(xtcStream);
+
+	if(cutoffs > 1) {
+		writeQFileCutoffs(qValues, xtcFrames, cutoffs, qFile);
+	} else {
+		writeQFile(qValues, xtcFrames, qFile);
+	}
+
+	if(checkpoint) {
+		finishCheckpoint(checkpoint);
+	}
 
 	return 0;
 }
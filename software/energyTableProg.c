@@ -0,0 +1,72 @@
+/*
+*	Name: energyTableProg.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Reads energies from the md.log of a run by their labels and writes them as one
+*		table.  Given the traj.xtc of the run, every frame is joined to the energies of
+*		its step; given a qFile or Q series too, the Q value of every frame is added, so
+*		Q and energies are lined up frame by frame.  Frames whose step md.log has no
+*		energies for are written with N/A.
+*
+*	Usage example:
+*		energyTableProg {md.log} [{xtcFile} [{qFile}]] --energy Potential,"LJ (SR)"
+*		energyTableProg md.log traj.xtc qFile --energy Potential > table
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "headers/xtcReader/xtcReader.h"
+#include "headers/mdLog/mdLog.h"
+#include "headers/qSeries/qSeries.h"
+#include "headers/programOptions/programOptions.h"
+#include "headers/profile/profile.h"
+
+int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	char *energyOption = takeOption(&argc, argv, "--energy");
+	struct XtcFrameIndex *index = NULL;
+	double *qValue = NULL;
+	int labels, frames = 0, firstFrame = 0, stride = 1, missing;
+
+	if (argc < 2 || argc > 4) {
+		printf("Usage Example: energyTableProg md.log traj.xtc qFile --energy Potential,\"LJ (SR)\"\n");
+		return 1;
+	}
+
+	char **label = parseEnergyLabels(energyOption ? energyOption : "Potential", &labels);
+
+	profileStage("readLog");
+	struct MdLogEnergies *energies = readMdLogEnergies(argv[1], labels, label);
+
+	if (argc >= 3) {
+		profileStage("openTrajectory");
+		index = getXtcFrameIndex(argv[2]);
+		frames = index->frames;
+	}
+
+	if (argc == 4) {
+		profileStage("readQValues");
+		qValue = readQValuesFile(argv[3], &frames, &firstFrame, &stride);
+	}
+
+	profileStage("writeOutput");
+	missing = writeEnergyTable(stdout, energies, index, frames, qValue, firstFrame, stride);
+
+	if (missing > 0) {
+		fprintf(stderr, "%d of %d frames have no energies in %s, nstlog is not a divisor of nstxout\n", missing, frames, argv[1]);
+	}
+
+	if (index) {
+		freeXtcFrameIndex(index);
+	}
+
+	free(qValue);
+	freeMdLogEnergies(energies);
+
+	return 0;
+}
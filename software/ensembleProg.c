@@ -0,0 +1,72 @@
+/*
+*	Name: ensembleProg.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Runs occupancyTableProg over every replica trajectory of a simulation set at once.
+*		Trajectories are given as a list or as quoted patterns, and are read concurrently.
+*		The occurrences and frames in range of all replicas are added together before
+*		the probabilities and per-residue averages are calculated, so the combined table
+*		is exact.  The table of every replica follows the combined table.
+*
+*	Usage example:
+*		ensembleProg {residues} {cutoff} {contactFile} {xtcFile...} --q 0:20,21:40 --ts 1:500 --threads 8
+*		ensembleProg 163 1.0 contactFile '4FAK_130K_*_A/4FAK*.xtc' --threads 8
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "headers/contactReader/contactReader.h"
+#include "headers/occupancyTable/occupancyTable.h"
+#include "headers/ensemble/ensemble.h"
+#include "headers/programOptions/programOptions.h"
+#include "headers/profile/profile.h"
+
+int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	int threads = takeThreadsOption(&argc, argv);
+	int stride = takeStrideOption(&argc, argv);
+	int qBins, timeWindows, windows, replicas;
+	int *qBin = takeRangeListOption(&argc, argv, "--q", &qBins);
+	int *timeWindow = takeRangeListOption(&argc, argv, "--ts", &timeWindows);
+
+	if (argc < 5) {
+		printf("Usage Example: ensembleProg 163 1.0 contactFile '4FAK_130K_*_A/4FAK*.xtc' --q 0:100,101:200 --threads 8\n");
+		return 1;
+	}
+
+	int residues = atoi(argv[1]);
+	float cutOff = atof(argv[2]);
+	char *contactFile = argv[3];
+	char **xtcFile = expandXtcFiles(argc - 4, &argv[4], &replicas);
+
+	struct OccupancyWindow *window;
+	struct Ensemble *ensemble;
+
+	// Reads the contacts from the contact file once
+	profileStage("readContacts");
+	struct ContactSet *contactSet = readContactSet(contactFile);
+	checkContactSetResidues(contactSet, residues);
+
+	int contacts = contactSet->contacts;
+	struct Contact *residueContacts = contactSet->residueContacts;
+
+	window = createOccupancyWindows(qBins, qBin, timeWindows, timeWindow, &windows);
+
+	// Every replica is counted on its own, then the counts are added together
+	profileStage("calculateEnsemble");
+	ensemble = calculateEnsembleOccupancy(replicas, xtcFile, residues, contacts, residueContacts, windows, window, cutOff, stride, threads);
+
+	profileStage("writeOutput");
+	writeEnsemble(stdout, ensemble, residues);
+
+	freeEnsemble(ensemble);
+	freeContactSet(contactSet);
+	free(window);
+
+	return 0;
+}
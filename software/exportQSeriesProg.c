@@ -0,0 +1,51 @@
+/*
+*	Name: exportQSeriesProg.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Writes a binary Q series from calcQFromContactsProg --qseries as the text qFile
+*		calcQFromContactsProg would have written with the same arguments.  The header
+*		of the series is printed to stdout.
+*
+*	Usage example:
+*		exportQSeriesProg {qSeriesFile} {qFile}
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "headers/qSeries/qSeries.h"
+#include "headers/profile/profile.h"
+
+int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	if (argc != 3) {
+		printf("Usage Example: exportQSeriesProg qSeries qFile\n");
+		return 1;
+	}
+
+	profileStage("readQSeries");
+	struct QSeries *series = readQSeries(argv[1]);
+
+	printf("frames %lld, first frame %lld, stride %d, steps %lld to %lld, times %g to %g\n",
+	       (long long) series->header.frames, (long long) series->header.firstFrame + 1, series->header.stride,
+	       (long long) series->header.firstStep, (long long) series->header.lastStep, series->header.firstTime, series->header.lastTime);
+
+	for(int k = 0; k < series->header.columns; k++) {
+		if(series->header.type == Q_SERIES_FLOAT) {
+			printf("column %d: fractional Q\n", k + 1);
+		} else {
+			printf("column %d: cutoff %g\n", k + 1, series->cutoff[k]);
+		}
+	}
+
+	profileStage("writeQFile");
+	writeQSeriesText(series, argv[2]);
+
+	freeQSeries(series);
+
+	return 0;
+}
@@ -0,0 +1,268 @@
+/*
+*	Name: analysisJobs.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Runs the work of calcQFromContactsProg, probabilityContactInQValueRangeProg and
+*		averageContactProbabilityInQValueRangeProg from one pass over the traj.xtc.  A
+*		job list names the files to write:
+*			q {qFile}
+*			probability {qLow} {qHigh} {tsLow} {tsHigh} {file}
+*			average {qLow} {qHigh} {tsLow} {tsHigh} {file}
+*		Every probability and average job is a window of an occupancy table, and jobs
+*		with the same ranges share one.  Each frame is decoded and its contacts
+*		evaluated once; the Q value of the frame goes to the qFile and its contact
+*		states to every window it falls in.  Every file is the same as the output of
+*		the program it replaces, and a file of "-" is written to stdout.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../calcQFromContacts/calcQFromContacts.h"
+#include "../threadedAnalysis/threadedAnalysis.h"
+#include "analysisJobs.h"
+
+static int findAnalysisWindow(struct AnalysisJobs *jobs, struct OccupancyWindow window);
+static FILE* openAnalysisJobFile(char *file);
+static void closeAnalysisJobFile(FILE *fp);
+
+/*
+*	Name: struct AnalysisJobs* parseAnalysisJobs()
+*	Description: Reads a job list from the arguments.  Exits with a message if a job is
+*		     not known or is missing arguments.
+*
+*	Args: -int argc - the amount of arguments in the job list
+*	      -char *argv[] - the job list, for example {"q", "qFile", "average", "0", "100",
+*			      "1", "500", "averages"}
+*
+*	Returns: -struct AnalysisJobs *jobs - the jobs and the windows they need
+*/
+
+struct AnalysisJobs* parseAnalysisJobs(int argc, char *argv[]) {
+	struct AnalysisJobs *jobs = (struct AnalysisJobs*) calloc(1, sizeof(struct AnalysisJobs));
+	if(!jobs) {
+		perror("analysis jobs memory not allocated");
+		abort();
+	}
+
+	// A job takes at least two arguments, so there are never more jobs or windows than this
+	jobs->job = (struct AnalysisJob*) malloc(sizeof(struct AnalysisJob) * (argc / 2 + 1));
+	jobs->window = (struct OccupancyWindow*) malloc(sizeof(struct OccupancyWindow) * (argc / 2 + 1));
+	if(!jobs->job || !jobs->window) {
+		perror("analysis jobs memory not allocated");
+		abort();
+	}
+
+	for(int i = 0; i < argc; ) {
+		struct AnalysisJob *job = &jobs->job[jobs->jobs];
+
+		if(strcmp(argv[i], "q") == 0 && i + 1 < argc) {
+			job->type = ANALYSIS_JOB_Q;
+			job->tableWindow = -1;
+			job->file = argv[i + 1];
+			i += 2;
+		} else if((strcmp(argv[i], "probability") == 0 || strcmp(argv[i], "average") == 0) && i + 5 < argc) {
+			struct OccupancyWindow window;
+
+			window.qRange.low = atoi(argv[i + 1]), window.qRange.high = atoi(argv[i + 2]);
+			window.timeRange.low = atoi(argv[i + 3]), window.timeRange.high = atoi(argv[i + 4]);
+
+			job->type = strcmp(argv[i], "probability") == 0 ? ANALYSIS_JOB_PROBABILITY : ANALYSIS_JOB_AVERAGE;
+			job->tableWindow = findAnalysisWindow(jobs, window);
+			job->file = argv[i + 5];
+			i += 6;
+		} else {
+			printf("\nAnalysis job %s is not known or is missing arguments, expected:\n", argv[i]);
+			printf("q {qFile}\nprobability {qLow} {qHigh} {tsLow} {tsHigh} {file}\naverage {qLow} {qHigh} {tsLow} {tsHigh} {file}\n");
+			exit(1);
+		}
+
+		jobs->jobs++;
+	}
+
+	return jobs;
+}
+
+/*
+*	Name: void calculateAnalysisJobs()
+*	Description: Reads the frames left in an open traj.xtc stream once for every job.
+*		     The Q values are kept for a q job; otherwise frames outside of every
+*		     window are not decoded.
+*
+*	Args: -struct AnalysisJobs *jobs - from parseAnalysisJobs()
+*	      -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -int residues - the amount of residues in the protein
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*	      -int threads - the amount of worker threads
+*/
+
+void calculateAnalysisJobs(struct AnalysisJobs *jobs, struct XtcStream *stream, int contacts, struct Contact *residueContacts, int residues, float cutOff, int threads) {
+	int qJob = 0, averageJob = 0;
+
+	for(int j = 0; j < jobs->jobs; j++) {
+		qJob |= jobs->job[j].type == ANALYSIS_JOB_Q;
+		averageJob |= jobs->job[j].type == ANALYSIS_JOB_AVERAGE;
+	}
+
+	// Only Q values are needed
+	if(jobs->windows == 0) {
+		if(threads > 1) {
+			jobs->qValues = calculateQValuesThreaded(stream, contacts, cutOff, residueContacts, &jobs->xtcFrames, threads);
+		} else {
+			jobs->qValues = calculateQValuesFromStream(stream, contacts, cutOff, residueContacts, &jobs->xtcFrames);
+		}
+
+		return;
+	}
+
+	jobs->table = allocateOccupancyTable(jobs->windows, jobs->window, contacts, residueContacts);
+
+	if(!qJob) {
+		setXtcStreamTimeRange(stream, getOccupancyTimeRange(jobs->windows, jobs->window));
+	}
+
+	if(threads > 1) {
+		jobs->qValues = countOccupancyTableQValuesThreaded(stream, jobs->table, cutOff, &jobs->xtcFrames, threads);
+	} else {
+		jobs->qValues = countOccupancyTableQValuesFromStream(stream, jobs->table, cutOff, &jobs->xtcFrames);
+	}
+
+	calculateOccupancyTableProbabilities(jobs->table);
+
+	if(averageJob) {
+		jobs->contactAverages = calculateOccupancyTableAverages(jobs->table, residues);
+	}
+}
+
+/*
+*	Name: void writeAnalysisJobs()
+*	Description: Writes the file of every job, in the order of the job list.
+*
+*	Args: -struct AnalysisJobs *jobs - calculated with calculateAnalysisJobs()
+*	      -int residues - the amount of residues in the protein
+*/
+
+void writeAnalysisJobs(struct AnalysisJobs *jobs, int residues) {
+	for(int j = 0; j < jobs->jobs; j++) {
+		struct AnalysisJob *job = &jobs->job[j];
+
+		if(job->type == ANALYSIS_JOB_Q) {
+			if(strcmp(job->file, "-") == 0) {
+				for(int i = 0; i < jobs->xtcFrames; i++) {
+					printf("%i\n", jobs->qValues[i]);
+				}
+			} else {
+				writeQFile(jobs->qValues, jobs->xtcFrames, job->file);
+			}
+
+			continue;
+		}
+
+		FILE *fp = openAnalysisJobFile(job->file);
+
+		if(job->type == ANALYSIS_JOB_PROBABILITY) {
+			writeContactProbabilities(fp, jobs->table->contacts, &jobs->table->contactInformation[(size_t)job->tableWindow * jobs->table->contacts]);
+		} else {
+			writeContactAverages(fp, residues, &jobs->contactAverages[(size_t)job->tableWindow * residues]);
+		}
+
+		closeAnalysisJobFile(fp);
+	}
+}
+
+/*
+*	Name: void writeContactProbabilities()
+*	Description: Writes the probability and occurrences of every contact, as
+*		     probabilityContactInQValueRangeProg does.
+*
+*	Args: -FILE *fp - destination, for example stdout
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct ContactInformation *residueContactsInformation - probabilities of the contacts
+*/
+
+void writeContactProbabilities(FILE *fp, int contacts, struct ContactInformation *residueContactsInformation) {
+	for(int i = 0; i < contacts; i++) {
+		fprintf(fp, "%d %d %d %f %d\n", i+1, residueContactsInformation[i].focusResidue, residueContactsInformation[i].contactResidue, residueContactsInformation[i].probability, residueContactsInformation[i].totalOccurrences);
+	}
+}
+
+/*
+*	Name: void writeContactAverages()
+*	Description: Writes the average contact probability of every residue, as
+*		     averageContactProbabilityInQValueRangeProg does.
+*
+*	Args: -FILE *fp - destination, for example stdout
+*	      -int residues - the amount of residues in the protein
+*	      -struct ContactAverages *contactAverages - the average of every residue
+*/
+
+void writeContactAverages(FILE *fp, int residues, struct ContactAverages *contactAverages) {
+	for(int i = 0; i < residues; i++) {
+		if(contactAverages[i].averageProbability != -1.0) {
+			fprintf(fp, "%d %f\n", contactAverages[i].focusResidue+1, contactAverages[i].averageProbability);
+		} else {
+			fprintf(fp, "%d N/A\n", contactAverages[i].focusResidue+1);
+		}
+	}
+}
+
+/*
+*	Name: void freeAnalysisJobs()
+*	Description:	Frees the jobs, the windows parsed for them and the results
+*			calculateAnalysisJobs filled in.
+*
+*	Args: -struct AnalysisJobs *jobs - jobs from parseAnalysisJobs.
+*/
+
+void freeAnalysisJobs(struct AnalysisJobs *jobs) {
+	if(jobs->table) {
+		freeOccupancyTable(jobs->table);
+	}
+
+	free(jobs->contactAverages);
+	free(jobs->qValues);
+	free(jobs->window);
+	free(jobs->job);
+	free(jobs);
+}
+
+static int findAnalysisWindow(struct AnalysisJobs *jobs, struct OccupancyWindow window) {
+	for(int w = 0; w < jobs->windows; w++) {
+		if(memcmp(&jobs->window[w], &window, sizeof(struct OccupancyWindow)) == 0) {
+			return w;
+		}
+	}
+
+	jobs->window[jobs->windows] = window;
+
+	return jobs->windows++;
+}
+
+static FILE* openAnalysisJobFile(char *file) {
+	FILE *fp;
+
+	if(strcmp(file, "-") == 0) {
+		return stdout;
+	}
+
+	if((fp = fopen(file, "w")) == NULL) {
+		printf("\nCould not open %s for output\n", file);
+		exit(1);
+	}
+
+	return fp;
+}
+
+static void closeAnalysisJobFile(FILE *fp) {
+	if(fp == stdout) {
+		fflush(fp);
+	} else {
+		fclose(fp);
+	}
+}
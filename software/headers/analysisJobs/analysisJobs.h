@@ -0,0 +1,48 @@
+/*
+*	Name: analysisJobs.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef ANALYSIS_JOBS
+#define ANALYSIS_JOBS
+
+#include <stdio.h>
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactReader/contactReader.h"
+#include "../occupancyTable/occupancyTable.h"
+
+#define ANALYSIS_JOB_Q 0
+#define ANALYSIS_JOB_PROBABILITY 1
+#define ANALYSIS_JOB_AVERAGE 2
+
+// A job writes one file; probability and average jobs read the table window of their ranges
+struct AnalysisJob {
+	int type;
+	int tableWindow;
+	char *file;
+};
+
+struct AnalysisJobs {
+	int jobs;
+	struct AnalysisJob *job;
+	int windows;
+	struct OccupancyWindow *window;
+
+	// Filled in by calculateAnalysisJobs()
+	int xtcFrames;
+	int *qValues;
+	struct OccupancyTable *table;
+	struct ContactAverages *contactAverages;
+};
+
+struct AnalysisJobs* parseAnalysisJobs(int argc, char *argv[]);
+void calculateAnalysisJobs(struct AnalysisJobs *jobs, struct XtcStream *stream, int contacts, struct Contact *residueContacts, int residues, float cutOff, int threads);
+void writeAnalysisJobs(struct AnalysisJobs *jobs, int residues);
+void writeContactProbabilities(FILE *fp, int contacts, struct ContactInformation *residueContactsInformation);
+void writeContactAverages(FILE *fp, int residues, struct ContactAverages *contactAverages);
+void freeAnalysisJobs(struct AnalysisJobs *jobs);
+
+#endif
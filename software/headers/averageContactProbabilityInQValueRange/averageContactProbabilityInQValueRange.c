@@ -2,6 +2,7 @@
 #include <stdlib.h>
 
 #include "../probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+#include "../residueGraph/residueGraph.h"
 #include "averageContactProbabilityInQValueRange.h"
 
 /*
@@ -44,6 +45,42 @@ struct ContactAverages* calculateAverageContactProbability(int residues, int con
 	return contactAverages;
 }
 
+/*
+*	Name: struct ContactAverages* calculateResidueGraphAverages()
+*	Description: Same as calculateAverageContactProbability(), reading the contacts of every
+*		     residue from a struct ResidueGraph instead of sorted contacts.  The
+*		     probabilities are added in the same order, so the averages are identical.
+*
+*	Args: -struct ResidueGraph *graph - the contacts of every residue, from createResidueGraph()
+*	      -struct ContactInformation* residueContactInformation - the contacts with their
+*				probabilities, in contactFile order
+*
+*	Returns: -struct ContactAverages* contactAverages - the probability that a specific residue is part of
+*				a contact
+*/
+
+struct ContactAverages* calculateResidueGraphAverages(struct ResidueGraph *graph, struct ContactInformation* residueContactInformation) {
+	struct ContactAverages* contactAverages = allocateContactAveragesMemory(graph->residues);
+
+	for(int r = 1; r <= graph->residues; r++) {
+		int residueContacts;
+		int *contact = getResidueGraphContacts(graph, r, &residueContacts);
+		float tempAvgTotal = 0.0;
+
+		if(residueContacts == 0) {
+			continue;
+		}
+
+		for(int j = 0; j < residueContacts; j++) {
+			tempAvgTotal += residueContactInformation[contact[j]].probability;
+		}
+
+		contactAverages[r-1].averageProbability = tempAvgTotal / (float)residueContacts;
+	}
+
+	return contactAverages;
+}
+
 /*
 *	Name: struct ContactInformation* sortContacts()
 *	Description: Sorts the contacts and their reverse, ascending, by focusResidue.  Uses the
@@ -8,12 +8,15 @@
 #ifndef AVERAGE_CONTACT_PROBABILITY_IN_Q_VALUE_RANGE
 #define AVERAGE_CONTACT_PROBABILITY_IN_Q_VALUE_RANGE
 
+#include "../residueGraph/residueGraph.h"
+
 struct ContactAverages {
 	int focusResidue;
 	float averageProbability;
 };
 
 struct ContactAverages* calculateAverageContactProbability(int residues, int contacts, struct ContactInformation* residueContactInformation);
+struct ContactAverages* calculateResidueGraphAverages(struct ResidueGraph *graph, struct ContactInformation* residueContactInformation);
 struct ContactInformation* sortContacts(int contacts, struct ContactInformation* contactsForSort);
 struct ContactInformation* createContactInfoForSort(int contacts, struct ContactInformation *contactInfo);
 struct ContactAverages* allocateContactAveragesMemory(int residues);
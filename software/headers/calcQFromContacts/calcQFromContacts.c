@@ -9,6 +9,7 @@
 #include <stdlib.h>
 #include <math.h>
 
+#include "../contactKernel/contactKernel.h"
 #include "calcQFromContacts.h"
 
 /*
@@ -21,23 +22,90 @@
 */
 
 void writeQFile(int *qValues, int xtcFrames, char *qFile) {
+	writeQFileCutoffs(qValues, xtcFrames, 1, qFile);
+}
+
+/*
+*	Name: void writeQFileCutoffs()
+*	Description: Creates a file with the Q values of every cutoff on every line.  The
+*		     lines are formatted into a buffer and written Q_FILE_BUFFER bytes at a
+*		     time rather than with a call per value.
+*
+*	Args: -int *qValues - cutoffs Q values for each frame of the traj.xtc.
+*	      -int xtcFrames - the amount of frames in the traj.xtc file.
+*	      -int cutoffs - the amount of cutoffs, one column each.
+*	      -char *qFile - the file name where Q values will be written.
+*/
+
+void writeQFileCutoffs(int *qValues, int xtcFrames, int cutoffs, char *qFile) {
+	char buffer[Q_FILE_BUFFER];
+	size_t used = 0;
 	FILE *fp;
 
-	// Creates the Q file
 	if ((fp = fopen(qFile, "w")) == NULL) {
 		perror("could not open qFile for output.");
 		exit(1);
 	}
 
-	// Writes the Q values to the file
 	for(int i = 0; i < xtcFrames; i++) {
-		fprintf(fp, "%i\n", qValues[i]);
+		for(int k = 0; k < cutoffs; k++) {
+			// Room for a separator and the longest int
+			if(used + 12 > sizeof(buffer)) {
+				fwrite(buffer, 1, used, fp);
+				used = 0;
+			}
+
+			if(k > 0) {
+				buffer[used++] = ' ';
+			}
+
+			used += formatQValue(&buffer[used], qValues[(size_t)i * cutoffs + k]);
+		}
+
+		buffer[used++] = '\n';
+	}
+
+	fwrite(buffer, 1, used, fp);
+
+	if(ferror(fp)) {
+		printf("\nCould not write %s\n", qFile);
+		exit(1);
 	}
 
-	// Closes the Q file
 	fclose(fp);
 }
 
+/*
+*	Name: int formatQValue()
+*	Description: Writes a Q value in decimal, the same as "%i", without a terminating null.
+*
+*	Args: -char *text - at least 11 characters to write to.
+*	      -int qValue - the Q value.
+*
+*	returns: -int length - the amount of characters written.
+*/
+
+int formatQValue(char *text, int qValue) {
+	char digits[10];
+	unsigned int value = qValue < 0 ? -(unsigned int) qValue : (unsigned int) qValue;
+	int length = 0, count = 0;
+
+	do {
+		digits[count++] = '0' + value % 10;
+		value /= 10;
+	} while(value > 0);
+
+	if(qValue < 0) {
+		text[length++] = '-';
+	}
+
+	while(count > 0) {
+		text[length++] = digits[--count];
+	}
+
+	return length;
+}
+
 /*
 *	Name: int* calculateQValues()
 *	Description: Calculates the Q values of every frames from the traj.xtc.  Uses the contacts
@@ -58,21 +126,227 @@ int* calculateQValues(int xtcFrames, int contacts, float cutoff, struct XtcCoord
 
 	// For every frame in the traj.xtc file
 	for(int i = 0; i < xtcFrames; i++) {
+		qValues[i] = calculateFrameQValue(contacts, cutoff, xtcResidueCoordinates[i], residueContacts);
+	}
 
-		// For every contact pair in the contact file
-		for(int j = 0; j < contacts; j++) {
+	return qValues;
+}
 
-			// If the distance between the residue pair is within the cutoff value
-			if(calculateDistance(xtcResidueCoordinates[i][residueContacts[j].focusResidue-1],
-			   xtcResidueCoordinates[i][residueContacts[j].contactResidue-1]) <= cutoff) {
-				qValues[i]++;
+/*
+*	Name: int* calculateQValuesCutoffs()
+*	Description: Same as calculateQValues(), for several cutoff values at once.  The
+*		     distance of every contact pair is calculated once per frame and compared
+*		     against all cutoffs.
+*
+*	Args: -int xtcFrames - the amount of frames in the traj.xtc file.
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -int cutoffs - the amount of cutoff values.
+*	      -float *cutoff - the cutoff values.
+*	      -struct XtcCoordinates **xtcResidueCoordinates - frame data and residue coordinates from
+*							       the traj.xtc file.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*
+*	returns: -int *qValues - cutoffs Q values for each frame; the Q value of frame i with
+*			cutoff k is qValues[i * cutoffs + k].
+*/
+
+int* calculateQValuesCutoffs(int xtcFrames, int contacts, int cutoffs, float *cutoff, struct XtcCoordinates **xtcResidueCoordinates, struct Contact *residueContacts) {
+	int *qValues = allocateQValuesMemory(xtcFrames * cutoffs);
+	double *threshold = calculateCutoffThresholds(cutoffs, cutoff);
+
+	// For every frame in the traj.xtc file
+	for(int i = 0; i < xtcFrames; i++) {
+		calculateFrameQValueCutoffs(contacts, cutoffs, threshold, xtcResidueCoordinates[i], residueContacts, &qValues[(size_t)i * cutoffs]);
+	}
+
+	free(threshold);
+
+	return qValues;
+}
+
+/*
+*	Name: int* calculateQValuesFromStream()
+*	Description: Calculates the Q values of every frame from an open traj.xtc stream.  Each
+*		     frame is evaluated as it is decoded, so the trajectory is read once and only
+*		     one frame of coordinates is held in memory.  If the stream has a time range
+*		     or stride, only the frames it returns are given a Q value.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -int *xtcFrames - set to the amount of frames read from the stream.
+*
+*	returns: -int *qValues - a Q value for each frame read from the traj.xtc.
+*/
+
+int* calculateQValuesFromStream(struct XtcStream *stream, int contacts, float cutoff, struct Contact *residueContacts, int *xtcFrames) {
+	int capacity = 1024, frames = 0;
+	int *qValues = allocateQValuesMemory(capacity);
+
+	// For every frame decoded from the traj.xtc file
+	while(readXtcStreamFrame(stream)) {
+
+		// Grows the Q values as frames are read, the frame count is not known up front
+		if(frames == capacity) {
+			capacity *= 2;
+			qValues = (int*) realloc(qValues, sizeof(int) * capacity);
+			if(!qValues) {
+				perror("qValues memory not allocated");
+				abort();
 			}
 		}
+
+		qValues[frames++] = calculateFrameQValue(contacts, cutoff, stream->frame, residueContacts);
 	}
 
+	*xtcFrames = frames;
+
 	return qValues;
 }
 
+/*
+*	Name: int* calculateQValuesCutoffsFromStream()
+*	Description: Same as calculateQValuesFromStream(), for several cutoff values at once.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -int cutoffs - the amount of cutoff values.
+*	      -float *cutoff - the cutoff values.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -int *xtcFrames - set to the amount of frames read from the stream.
+*
+*	returns: -int *qValues - cutoffs Q values for each frame read from the traj.xtc.
+*/
+
+int* calculateQValuesCutoffsFromStream(struct XtcStream *stream, int contacts, int cutoffs, float *cutoff, struct Contact *residueContacts, int *xtcFrames) {
+	int capacity = 1024, frames = 0;
+	int *qValues = allocateQValuesMemory(capacity * cutoffs);
+	double *threshold = calculateCutoffThresholds(cutoffs, cutoff);
+
+	// For every frame decoded from the traj.xtc file
+	while(readXtcStreamFrame(stream)) {
+
+		// Grows the Q values as frames are read, the frame count is not known up front
+		if(frames == capacity) {
+			capacity *= 2;
+			qValues = (int*) realloc(qValues, sizeof(int) * capacity * cutoffs);
+			if(!qValues) {
+				perror("qValues memory not allocated");
+				abort();
+			}
+		}
+
+		calculateFrameQValueCutoffs(contacts, cutoffs, threshold, stream->frame, residueContacts, &qValues[(size_t)frames * cutoffs]);
+		frames++;
+	}
+
+	free(threshold);
+
+	*xtcFrames = frames;
+
+	return qValues;
+}
+
+/*
+*	Name: int* calculateQValuesFromTrajectory()
+*	Description: Same as calculateQValues(), for coordinates stored in a struct XtcTrajectory.
+*
+*	Args: -struct XtcTrajectory *trajectory - residue coordinates of every frame.
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*
+*	returns: -int *qValues - a Q value for each frame of the trajectory.
+*/
+
+int* calculateQValuesFromTrajectory(struct XtcTrajectory *trajectory, int contacts, float cutoff, struct Contact *residueContacts) {
+	int *qValues = allocateQValuesMemory(trajectory->frames);
+
+	for(int i = 0; i < trajectory->frames; i++) {
+		qValues[i] = calculateTrajectoryFrameQValue(trajectory, i, contacts, cutoff, residueContacts);
+	}
+
+	return qValues;
+}
+
+/*
+*	Name: int calculateFrameQValue()
+*	Description: Calculates the Q value of a single frame.
+*
+*	Args: -int contacts - the amount of contacts in the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -struct XtcCoordinates *frame - residue coordinates of one frame.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*
+*	returns: -int qValue - the amount of contacts present in the frame.
+*/
+
+int calculateFrameQValue(int contacts, float cutoff, struct XtcCoordinates *frame, struct Contact *residueContacts) {
+	// Counts every contact pair within the cutoff value, see contactKernel.c
+	return calculateContactKernel(&frame[0].x, &frame[0].y, &frame[0].z, 3, contacts, residueContacts, cutoff, NULL);
+}
+
+/*
+*	Name: void calculateFrameQValueCutoffs()
+*	Description: Calculates the Q value of one frame for several cutoffs.
+*
+*	Args: -int contacts - the amount of contacts in the contacts file.
+*	      -int cutoffs - the amount of cutoff values.
+*	      -double *threshold - from calculateCutoffThresholds().
+*	      -struct XtcCoordinates *frame - residue coordinates of one frame.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -int *qValues - set to the Q value of every cutoff.
+*/
+
+void calculateFrameQValueCutoffs(int contacts, int cutoffs, double *threshold, struct XtcCoordinates *frame, struct Contact *residueContacts, int *qValues) {
+	calculateContactKernelThresholds(&frame[0].x, &frame[0].y, &frame[0].z, 3, contacts, residueContacts, cutoffs, threshold, qValues);
+}
+
+/*
+*	Name: double* calculateCutoffThresholds()
+*	Description: Converts cutoff values to the squared distance thresholds used by
+*		     calculateFrameQValueCutoffs(), see calculateCutoffThreshold().
+*
+*	Args: -int cutoffs - the amount of cutoff values.
+*	      -float *cutoff - the cutoff values.
+*
+*	returns: -double *threshold - a threshold for every cutoff.
+*/
+
+double* calculateCutoffThresholds(int cutoffs, float *cutoff) {
+	double *threshold = (double*) malloc(sizeof(double) * cutoffs);
+	if(!threshold) {
+		perror("threshold memory not allocated");
+		abort();
+	}
+
+	for(int k = 0; k < cutoffs; k++) {
+		threshold[k] = calculateCutoffThreshold(cutoff[k]);
+	}
+
+	return threshold;
+}
+
+/*
+*	Name: int calculateTrajectoryFrameQValue()
+*	Description: Same as calculateFrameQValue(), for one frame of a struct XtcTrajectory.
+*
+*	Args: -struct XtcTrajectory *trajectory - residue coordinates of every frame.
+*	      -int frame - index of the frame, starting at 0.
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*
+*	returns: -int qValue - the amount of contacts present in the frame.
+*/
+
+int calculateTrajectoryFrameQValue(struct XtcTrajectory *trajectory, int frame, int contacts, float cutoff, struct Contact *residueContacts) {
+	size_t offset = (size_t) frame * trajectory->stride;
+
+	return calculateContactKernel(&trajectory->x[offset], &trajectory->y[offset], &trajectory->z[offset], 1, contacts, residueContacts, cutoff, NULL);
+}
+
 /*
 *	Name: float calculateDistance()
 *	Description: Calculates the distance between the residue pair.
@@ -11,8 +11,21 @@
 #include "../xtcReader/xtcReader.h"
 #include "../contactReader/contactReader.h"
 
+// Bytes of text formatted before each write of a qFile
+#define Q_FILE_BUFFER 65536
+
 void writeQFile(int *qValues, int xtcFrames, char *qFile);
+void writeQFileCutoffs(int *qValues, int xtcFrames, int cutoffs, char *qFile);
+int formatQValue(char *text, int qValue);
 int* calculateQValues(int xtcFrames, int contacts, float cutoff, struct XtcCoordinates **xtcResidueCoordinates, struct Contact *residueContacts);
+int* calculateQValuesCutoffs(int xtcFrames, int contacts, int cutoffs, float *cutoff, struct XtcCoordinates **xtcResidueCoordinates, struct Contact *residueContacts);
+int* calculateQValuesFromStream(struct XtcStream *stream, int contacts, float cutoff, struct Contact *residueContacts, int *xtcFrames);
+int* calculateQValuesCutoffsFromStream(struct XtcStream *stream, int contacts, int cutoffs, float *cutoff, struct Contact *residueContacts, int *xtcFrames);
+int* calculateQValuesFromTrajectory(struct XtcTrajectory *trajectory, int contacts, float cutoff, struct Contact *residueContacts);
+int calculateFrameQValue(int contacts, float cutoff, struct XtcCoordinates *frame, struct Contact *residueContacts);
+void calculateFrameQValueCutoffs(int contacts, int cutoffs, double *threshold, struct XtcCoordinates *frame, struct Contact *residueContacts, int *qValues);
+double* calculateCutoffThresholds(int cutoffs, float *cutoff);
+int calculateTrajectoryFrameQValue(struct XtcTrajectory *trajectory, int frame, int contacts, float cutoff, struct Contact *residueContacts);
 float calculateDistance(struct XtcCoordinates coords1, struct XtcCoordinates coords2);
 int* allocateQValuesMemory(int xtcFrames);
 
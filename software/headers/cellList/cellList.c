@@ -0,0 +1,622 @@
+/*
+*	Name: cellList.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Finds every residue pair of a frame within the cutoff, not only the pairs of the
+*		contacts file.  The residues are sorted into a grid of cells at least one cutoff
+*		wide, so a residue only has to be tested against the residues of its own and the
+*		26 surrounding cells; the work grows with the amount of residues instead of its
+*		square.  The grid is rebuilt for every frame.
+*
+*		Pairs found in the contacts file are native contacts, every other pair at least
+*		--separation residues apart in sequence is a non-native contact.  The pairs are
+*		tested the same way as calculateContactKernel(), so the native count of a frame
+*		is its Q value when the contacts file holds no duplicate pairs or a residue
+*		paired with itself.  Occurrences of every pair are added to a struct PairMap,
+*		which only stores the pairs seen at least once.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../contactKernel/contactKernel.h"
+#include "cellList.h"
+
+static void setCellListGrid(struct CellList *cellList, float *low, float *high);
+static int getCellIndex(float coordinate, float origin, float cellSize, int dimension);
+static int64_t findPairMapSlot(struct PairMap *map, uint64_t key);
+static void growPairMap(struct PairMap *map);
+static int comparePairCounts(const void *a, const void *b);
+static void growNonNativeContacts(struct NonNativeContacts *nonNative, int capacity);
+
+/*
+*	Name: struct CellList* createCellList()
+*	Description: Allocates a cell list for the residues of a frame.  The grid itself is
+*		     placed by buildCellList().
+*
+*	Args: -int residues - the amount of residues in each frame.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -int separation - non-native pairs closer than this in sequence are skipped.
+*
+*	Returns: -struct CellList *cellList - an empty cell list.
+*/
+
+struct CellList* createCellList(int residues, float cutoff, int separation) {
+	struct CellList *cellList = (struct CellList*) malloc(sizeof(struct CellList));
+	if(!cellList) {
+		perror("cellList memory not allocated");
+		abort();
+	}
+
+	cellList->residues = residues;
+	cellList->cutoff = cutoff;
+	cellList->threshold = calculateCutoffThreshold(cutoff);
+	cellList->separation = separation;
+
+	// A little wider than the cutoff, so rounding never puts a contact two cells apart
+	cellList->cellSize = cutoff > 0.0f ? cutoff * 1.0001f : 1.0f;
+	cellList->capacity = CELL_LIST_CELLS_PER_RESIDUE * (residues > 0 ? residues : 1);
+	cellList->cells = 0;
+
+	cellList->cellStart = (int*) malloc(sizeof(int) * (cellList->capacity + 1));
+	cellList->cellResidue = (int*) malloc(sizeof(int) * (residues > 0 ? residues : 1));
+	cellList->residueCell = (int*) malloc(sizeof(int) * (residues > 0 ? residues : 1));
+	if(!cellList->cellStart || !cellList->cellResidue || !cellList->residueCell) {
+		perror("cellList memory not allocated");
+		abort();
+	}
+
+	return cellList;
+}
+
+/*
+*	Name: void buildCellList()
+*	Description: Places a grid over the bounding box of the frame and sorts the residues
+*		     into its cells.  The residues of cell c are cellResidue[cellStart[c]] to
+*		     cellResidue[cellStart[c+1]-1], in ascending order.
+*
+*	Args: -struct CellList *cellList - from createCellList().
+*	      -struct XtcCoordinates *frame - the residue coordinates of one frame.
+*/
+
+void buildCellList(struct CellList *cellList, struct XtcCoordinates *frame) {
+	float low[3] = {0.0f, 0.0f, 0.0f}, high[3] = {0.0f, 0.0f, 0.0f};
+	int residues = cellList->residues;
+
+	// The bounding box of the finite coordinates
+	for(int i = 0, first = 1; i < residues; i++) {
+		float coordinate[3] = {frame[i].x, frame[i].y, frame[i].z};
+
+		if(!isfinite(coordinate[0]) || !isfinite(coordinate[1]) || !isfinite(coordinate[2])) {
+			continue;
+		}
+
+		for(int d = 0; d < 3; d++) {
+			if(first || coordinate[d] < low[d]) {
+				low[d] = coordinate[d];
+			}
+			if(first || coordinate[d] > high[d]) {
+				high[d] = coordinate[d];
+			}
+		}
+		first = 0;
+	}
+
+	setCellListGrid(cellList, low, high);
+
+	memset(cellList->cellStart, 0, sizeof(int) * (cellList->cells + 1));
+
+	// Counts the residues of every cell, then gives each cell its place in cellResidue
+	for(int i = 0; i < residues; i++) {
+		int cx = getCellIndex(frame[i].x, cellList->origin[0], cellList->cellSize, cellList->dimension[0]);
+		int cy = getCellIndex(frame[i].y, cellList->origin[1], cellList->cellSize, cellList->dimension[1]);
+		int cz = getCellIndex(frame[i].z, cellList->origin[2], cellList->cellSize, cellList->dimension[2]);
+
+		cellList->residueCell[i] = (cz * cellList->dimension[1] + cy) * cellList->dimension[0] + cx;
+		cellList->cellStart[cellList->residueCell[i] + 1]++;
+	}
+
+	for(int c = 0; c < cellList->cells; c++) {
+		cellList->cellStart[c + 1] += cellList->cellStart[c];
+	}
+
+	for(int i = 0; i < residues; i++) {
+		cellList->cellResidue[cellList->cellStart[cellList->residueCell[i]]++] = i;
+	}
+
+	// Placing the residues moved every start to the start of the next cell
+	for(int c = cellList->cells; c > 0; c--) {
+		cellList->cellStart[c] = cellList->cellStart[c - 1];
+	}
+	cellList->cellStart[0] = 0;
+}
+
+/*
+*	Name: int countCellListContacts()
+*	Description: Finds every residue pair of the frame within the cutoff.  Each pair is
+*		     tested once, with the lower residue first.
+*
+*	Args: -struct CellList *cellList - built for this frame by buildCellList().
+*	      -struct XtcCoordinates *frame - the residue coordinates of the frame.
+*	      -struct PairMap *nativePairs - the contacts file, from createNativePairMap(); may
+*				be NULL, then every pair is non-native.
+*	      -struct PairMap *frequency - if not NULL, every pair found is added to it.
+*	      -int *nonNativeContacts - set to the amount of non-native pairs found.
+*
+*	Returns: -int nativeContacts - the amount of native pairs found.
+*/
+
+int countCellListContacts(struct CellList *cellList, struct XtcCoordinates *frame, struct PairMap *nativePairs, struct PairMap *frequency, int *nonNativeContacts) {
+	int nativeContacts = 0, nonNative = 0;
+	int *dimension = cellList->dimension;
+
+	for(int i = 0; i < cellList->residues; i++) {
+		int cell = cellList->residueCell[i];
+		int cx = cell % dimension[0];
+		int cy = cell / dimension[0] % dimension[1];
+		int cz = cell / dimension[0] / dimension[1];
+
+		// The cell of residue i and its neighbours
+		for(int z = cz > 0 ? cz - 1 : 0; z <= cz + 1 && z < dimension[2]; z++) {
+			for(int y = cy > 0 ? cy - 1 : 0; y <= cy + 1 && y < dimension[1]; y++) {
+				for(int x = cx > 0 ? cx - 1 : 0; x <= cx + 1 && x < dimension[0]; x++) {
+					int neighbour = (z * dimension[1] + y) * dimension[0] + x;
+
+					for(int k = cellList->cellStart[neighbour]; k < cellList->cellStart[neighbour + 1]; k++) {
+						int j = cellList->cellResidue[k];
+
+						if(j <= i) {
+							continue;
+						}
+
+						// Differences are taken in float, as in calculateContactKernel()
+						double dx = frame[j].x - frame[i].x;
+						double dy = frame[j].y - frame[i].y;
+						double dz = frame[j].z - frame[i].z;
+
+						// Pairs with coordinates that are not finite are never in contact
+						if(!(dx * dx + dy * dy + dz * dz <= cellList->threshold)) {
+							continue;
+						}
+
+						if(nativePairs != NULL && getPairMap(nativePairs, i + 1, j + 1)) {
+							nativeContacts++;
+						} else if(j - i >= cellList->separation) {
+							nonNative++;
+						} else {
+							continue;
+						}
+
+						if(frequency != NULL) {
+							addPairMap(frequency, i + 1, j + 1, 1);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	*nonNativeContacts = nonNative;
+
+	return nativeContacts;
+}
+
+/*
+*	Name: void freeCellList()
+*	Description:	Frees the cells of a cell list, the cell of every residue and the
+*			cell list.
+*
+*	Args: -struct CellList *cellList - cell list from createCellList.
+*/
+
+void freeCellList(struct CellList *cellList) {
+	free(cellList->cellStart);
+	free(cellList->cellResidue);
+	free(cellList->residueCell);
+	free(cellList);
+}
+
+/*
+*	Name: static void setCellListGrid()
+*	Description: Sets the origin and dimensions of the grid over the bounding box.  Cells
+*		     are widened when a spread out frame would need more cells than allocated.
+*/
+
+static void setCellListGrid(struct CellList *cellList, float *low, float *high) {
+	float cellSize = cellList->cutoff > 0.0f ? cellList->cutoff * 1.0001f : 1.0f;
+	double cells;
+
+	do {
+		cells = 1.0;
+		for(int d = 0; d < 3; d++) {
+			double extent = (double) high[d] - low[d];
+
+			cellList->dimension[d] = (int) fmin(extent / cellSize, cellList->capacity) + 1;
+			cells *= cellList->dimension[d];
+		}
+
+		if(cells > cellList->capacity) {
+			cellSize *= 1.25f;
+		}
+	} while(cells > cellList->capacity);
+
+	for(int d = 0; d < 3; d++) {
+		cellList->origin[d] = low[d];
+	}
+
+	cellList->cellSize = cellSize;
+	cellList->cells = (int) cells;
+}
+
+static int getCellIndex(float coordinate, float origin, float cellSize, int dimension) {
+	float cell = (coordinate - origin) / cellSize;
+
+	// Coordinates that are not finite go to the first cell and are never within the cutoff
+	if(!(cell >= 0.0f)) {
+		return 0;
+	}
+
+	return cell < dimension ? (int) cell : dimension - 1;
+}
+
+/*
+*	Name: struct PairMap* createPairMap()
+*	Description: Allocates an empty map of residue pairs.  The map grows as pairs are added.
+*
+*	Args: -int64_t capacity - the amount of pairs expected.
+*
+*	Returns: -struct PairMap *map - an empty map.
+*/
+
+struct PairMap* createPairMap(int64_t capacity) {
+	struct PairMap *map = (struct PairMap*) malloc(sizeof(struct PairMap));
+	if(!map) {
+		perror("pairMap memory not allocated");
+		abort();
+	}
+
+	// A power of two at least twice the amount of pairs expected
+	map->capacity = 64;
+	while(map->capacity < capacity * 2) {
+		map->capacity *= 2;
+	}
+	map->pairs = 0;
+
+	map->key = (uint64_t*) calloc(map->capacity, sizeof(uint64_t));
+	map->value = (int*) calloc(map->capacity, sizeof(int));
+	if(!map->key || !map->value) {
+		perror("pairMap memory not allocated");
+		abort();
+	}
+
+	return map;
+}
+
+/*
+*	Name: struct PairMap* createNativePairMap()
+*	Description: A map from every pair of the contacts file to its contact number, starting
+*		     at 1.  A pair listed more than once keeps its first number.
+*
+*	Args: -int contacts - the amount of contacts in the contacts file.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*
+*	Returns: -struct PairMap *nativePairs - the native pairs.
+*/
+
+struct PairMap* createNativePairMap(int contacts, struct Contact *residueContacts) {
+	struct PairMap *nativePairs = createPairMap(contacts);
+
+	for(int j = 0; j < contacts; j++) {
+		if(!getPairMap(nativePairs, residueContacts[j].focusResidue, residueContacts[j].contactResidue)) {
+			addPairMap(nativePairs, residueContacts[j].focusResidue, residueContacts[j].contactResidue, j + 1);
+		}
+	}
+
+	return nativePairs;
+}
+
+/*
+*	Name: void addPairMap()
+*	Description: Adds count to the pair.  The order of the residues does not matter.
+*
+*	Args: -struct PairMap *map - from createPairMap().
+*	      -int focusResidue, contactResidue - the residues of the pair, starting at 1.
+*	      -int count - added to the value of the pair.
+*/
+
+void addPairMap(struct PairMap *map, int focusResidue, int contactResidue, int count) {
+	uint64_t key = focusResidue < contactResidue ?
+			((uint64_t) focusResidue << 32) | (uint32_t) contactResidue :
+			((uint64_t) contactResidue << 32) | (uint32_t) focusResidue;
+
+	// Kept at most half full
+	if((map->pairs + 1) * 2 > map->capacity) {
+		growPairMap(map);
+	}
+
+	int64_t slot = findPairMapSlot(map, key);
+
+	if(map->key[slot] == 0) {
+		map->key[slot] = key;
+		map->pairs++;
+	}
+
+	map->value[slot] += count;
+}
+
+/*
+*	Name: int getPairMap()
+*	Description: The value of a pair, 0 when it was never added.
+*/
+
+int getPairMap(struct PairMap *map, int focusResidue, int contactResidue) {
+	uint64_t key = focusResidue < contactResidue ?
+			((uint64_t) focusResidue << 32) | (uint32_t) contactResidue :
+			((uint64_t) contactResidue << 32) | (uint32_t) focusResidue;
+
+	return map->value[findPairMapSlot(map, key)];
+}
+
+/*
+*	Name: void addPairMaps()
+*	Description: Adds the value of every pair of other to map.
+*/
+
+void addPairMaps(struct PairMap *map, struct PairMap *other) {
+	for(int64_t s = 0; s < other->capacity; s++) {
+		if(other->key[s] != 0) {
+			addPairMap(map, (int) (other->key[s] >> 32), (int) (other->key[s] & 0xffffffff), other->value[s]);
+		}
+	}
+}
+
+/*
+*	Name: struct PairCount* getSortedPairCounts()
+*	Description: The pairs of the map sorted by focusResidue, then contactResidue.
+*
+*	Args: -struct PairMap *map - from createPairMap().
+*
+*	Returns: -struct PairCount *pairCounts - map->pairs pairs with their values.
+*/
+
+struct PairCount* getSortedPairCounts(struct PairMap *map) {
+	struct PairCount *pairCounts = (struct PairCount*) malloc(sizeof(struct PairCount) * (map->pairs > 0 ? map->pairs : 1));
+	if(!pairCounts) {
+		perror("pairCounts memory not allocated");
+		abort();
+	}
+
+	int64_t n = 0;
+	for(int64_t s = 0; s < map->capacity; s++) {
+		if(map->key[s] != 0) {
+			pairCounts[n].focusResidue = (int) (map->key[s] >> 32);
+			pairCounts[n].contactResidue = (int) (map->key[s] & 0xffffffff);
+			pairCounts[n].count = map->value[s];
+			n++;
+		}
+	}
+
+	qsort(pairCounts, n, sizeof(struct PairCount), comparePairCounts);
+
+	return pairCounts;
+}
+
+/*
+*	Name: void freePairMap()
+*	Description:	Frees the keys and values of a pair map and the map.
+*
+*	Args: -struct PairMap *map - pair map from createPairMap.
+*/
+
+void freePairMap(struct PairMap *map) {
+	free(map->key);
+	free(map->value);
+	free(map);
+}
+
+/*
+*	Name: static int64_t findPairMapSlot()
+*	Description: The slot holding key, or the empty slot where it would be added.
+*/
+
+static int64_t findPairMapSlot(struct PairMap *map, uint64_t key) {
+	uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+	int64_t slot = (int64_t) ((hash ^ (hash >> 32)) & (uint64_t) (map->capacity - 1));
+
+	while(map->key[slot] != 0 && map->key[slot] != key) {
+		slot = (slot + 1) & (map->capacity - 1);
+	}
+
+	return slot;
+}
+
+static void growPairMap(struct PairMap *map) {
+	int64_t capacity = map->capacity;
+	uint64_t *key = map->key;
+	int *value = map->value;
+
+	map->capacity *= 2;
+	map->key = (uint64_t*) calloc(map->capacity, sizeof(uint64_t));
+	map->value = (int*) calloc(map->capacity, sizeof(int));
+	if(!map->key || !map->value) {
+		perror("pairMap memory not allocated");
+		abort();
+	}
+
+	for(int64_t s = 0; s < capacity; s++) {
+		if(key[s] != 0) {
+			int64_t slot = findPairMapSlot(map, key[s]);
+
+			map->key[slot] = key[s];
+			map->value[slot] = value[s];
+		}
+	}
+
+	free(key);
+	free(value);
+}
+
+static int comparePairCounts(const void *a, const void *b) {
+	const struct PairCount *first = (const struct PairCount*) a;
+	const struct PairCount *second = (const struct PairCount*) b;
+
+	if(first->focusResidue != second->focusResidue) {
+		return first->focusResidue < second->focusResidue ? -1 : 1;
+	}
+
+	return (first->contactResidue > second->contactResidue) - (first->contactResidue < second->contactResidue);
+}
+
+/*
+*	Name: struct NonNativeContacts* calculateNonNativeContactsFromStream()
+*	Description: Counts the native and non-native contacts of every frame left in an open
+*		     traj.xtc stream, and how often every pair is in contact.  The time range and
+*		     stride of the stream are followed.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -int separation - non-native pairs closer than this in sequence are skipped.
+*
+*	Returns: -struct NonNativeContacts *nonNative - the counts of every frame and the
+*				occurrences of every pair.
+*/
+
+struct NonNativeContacts* calculateNonNativeContactsFromStream(struct XtcStream *stream, int contacts, struct Contact *residueContacts, float cutoff, int separation) {
+	struct PairMap *nativePairs = createNativePairMap(contacts, residueContacts);
+	struct CellList *cellList = createCellList(stream->residues, cutoff, separation);
+	int capacity = 1024;
+	struct NonNativeContacts *nonNative = allocateNonNativeContacts(capacity);
+
+	// For every frame decoded from the traj.xtc file
+	while(readXtcStreamFrame(stream)) {
+		if(nonNative->frames == capacity) {
+			capacity *= 2;
+			growNonNativeContacts(nonNative, capacity);
+		}
+
+		buildCellList(cellList, stream->frame);
+		nonNative->nativeContacts[nonNative->frames] = countCellListContacts(cellList, stream->frame, nativePairs,
+				nonNative->frequency, &nonNative->nonNativeContacts[nonNative->frames]);
+		nonNative->frames++;
+	}
+
+	freeCellList(cellList);
+	freePairMap(nativePairs);
+
+	return nonNative;
+}
+
+/*
+*	Name: struct NonNativeContacts* allocateNonNativeContacts()
+*	Description:	Allocates the contact counts of a trajectory, with room for frames
+*			frames.  The arrays grow when more frames are read.
+*
+*	Args: -int frames - the amount of frames expected, 0 when unknown.
+*
+*	Returns: -struct NonNativeContacts *nonNative - counts with no frames recorded
+*			and an empty frequency map.
+*/
+
+struct NonNativeContacts* allocateNonNativeContacts(int frames) {
+	struct NonNativeContacts *nonNative = (struct NonNativeContacts*) malloc(sizeof(struct NonNativeContacts));
+	if(!nonNative) {
+		perror("nonNativeContacts memory not allocated");
+		abort();
+	}
+
+	nonNative->frames = 0;
+	nonNative->nativeContacts = NULL;
+	nonNative->nonNativeContacts = NULL;
+	growNonNativeContacts(nonNative, frames);
+	nonNative->frequency = createPairMap(1024);
+
+	return nonNative;
+}
+
+static void growNonNativeContacts(struct NonNativeContacts *nonNative, int capacity) {
+	capacity = capacity > 0 ? capacity : 1;
+
+	nonNative->nativeContacts = (int*) realloc(nonNative->nativeContacts, sizeof(int) * capacity);
+	nonNative->nonNativeContacts = (int*) realloc(nonNative->nonNativeContacts, sizeof(int) * capacity);
+	if(!nonNative->nativeContacts || !nonNative->nonNativeContacts) {
+		perror("nonNativeContacts memory not allocated");
+		abort();
+	}
+}
+
+/*
+*	Name: void writeNonNativeCountsFile()
+*	Description: Creates a file with the native and non-native contacts of a frame on
+*		     every line.
+*
+*	Args: -struct NonNativeContacts *nonNative - from calculateNonNativeContactsFromStream().
+*	      -char *countsFile - the file name where the counts will be written.
+*/
+
+void writeNonNativeCountsFile(struct NonNativeContacts *nonNative, char *countsFile) {
+	FILE *fp;
+
+	if ((fp = fopen(countsFile, "w")) == NULL) {
+		perror("could not open countsFile for output.");
+		exit(1);
+	}
+
+	for(int i = 0; i < nonNative->frames; i++) {
+		fprintf(fp, "%d %d\n", nonNative->nativeContacts[i], nonNative->nonNativeContacts[i]);
+	}
+
+	fclose(fp);
+}
+
+/*
+*	Name: void writePairFrequencyFile()
+*	Description: Creates a file with every pair found in contact, its probability over the
+*		     frames, its occurrences and its contact number in the contacts file (0 for
+*		     a non-native pair).  Pairs are sorted by residue.
+*
+*	Args: -struct NonNativeContacts *nonNative - from calculateNonNativeContactsFromStream().
+*	      -struct PairMap *nativePairs - from createNativePairMap().
+*	      -char *frequencyFile - the file name where the pairs will be written.
+*/
+
+void writePairFrequencyFile(struct NonNativeContacts *nonNative, struct PairMap *nativePairs, char *frequencyFile) {
+	struct PairCount *pairCounts = getSortedPairCounts(nonNative->frequency);
+	FILE *fp;
+
+	if ((fp = fopen(frequencyFile, "w")) == NULL) {
+		perror("could not open frequencyFile for output.");
+		exit(1);
+	}
+
+	fprintf(fp, "# focusResidue contactResidue probability occurrences contact\n");
+	for(int64_t p = 0; p < nonNative->frequency->pairs; p++) {
+		fprintf(fp, "%d %d %f %d %d\n", pairCounts[p].focusResidue, pairCounts[p].contactResidue,
+				(float) pairCounts[p].count / nonNative->frames, pairCounts[p].count,
+				getPairMap(nativePairs, pairCounts[p].focusResidue, pairCounts[p].contactResidue));
+	}
+
+	fclose(fp);
+	free(pairCounts);
+}
+
+/*
+*	Name: void freeNonNativeContacts()
+*	Description:	Frees the contact counts and the frequency map of every pair.
+*
+*	Args: -struct NonNativeContacts *nonNative - counts from
+*			calculateNonNativeContactsFromStream or allocateNonNativeContacts.
+*/
+
+void freeNonNativeContacts(struct NonNativeContacts *nonNative) {
+	free(nonNative->nativeContacts);
+	free(nonNative->nonNativeContacts);
+	freePairMap(nonNative->frequency);
+	free(nonNative);
+}
@@ -0,0 +1,77 @@
+/*
+*	Name: cellList.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef CELL_LIST
+#define CELL_LIST
+
+#include <stdint.h>
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactReader/contactReader.h"
+
+// Non-native pairs closer than this in sequence are not counted
+#define CELL_LIST_SEPARATION 4
+
+// The grid never has more cells than this times the amount of residues
+#define CELL_LIST_CELLS_PER_RESIDUE 2
+
+struct CellList {
+	int residues;
+	float cutoff;
+	double threshold;
+	int separation;
+	float cellSize;
+	float origin[3];
+	int dimension[3];
+	int cells;
+	int capacity;
+	int *cellStart;
+	int *cellResidue;
+	int *residueCell;
+};
+
+// Open addressing hash table from a residue pair, focus < contact, to a count
+struct PairMap {
+	int64_t capacity;
+	int64_t pairs;
+	uint64_t *key;
+	int *value;
+};
+
+struct PairCount {
+	int focusResidue;
+	int contactResidue;
+	int count;
+};
+
+struct NonNativeContacts {
+	int frames;
+	int *nativeContacts;
+	int *nonNativeContacts;
+	struct PairMap *frequency;
+};
+
+struct CellList* createCellList(int residues, float cutoff, int separation);
+void buildCellList(struct CellList *cellList, struct XtcCoordinates *frame);
+int countCellListContacts(struct CellList *cellList, struct XtcCoordinates *frame, struct PairMap *nativePairs, struct PairMap *frequency, int *nonNativeContacts);
+void freeCellList(struct CellList *cellList);
+
+struct PairMap* createPairMap(int64_t capacity);
+struct PairMap* createNativePairMap(int contacts, struct Contact *residueContacts);
+void addPairMap(struct PairMap *map, int focusResidue, int contactResidue, int count);
+int getPairMap(struct PairMap *map, int focusResidue, int contactResidue);
+void addPairMaps(struct PairMap *map, struct PairMap *other);
+struct PairCount* getSortedPairCounts(struct PairMap *map);
+void freePairMap(struct PairMap *map);
+
+struct NonNativeContacts* calculateNonNativeContactsFromStream(struct XtcStream *stream, int contacts, struct Contact *residueContacts, float cutoff, int separation);
+struct NonNativeContacts* allocateNonNativeContacts(int frames);
+void writeNonNativeCountsFile(struct NonNativeContacts *nonNative, char *countsFile);
+void writePairFrequencyFile(struct NonNativeContacts *nonNative, struct PairMap *nativePairs, char *frequencyFile);
+void freeNonNativeContacts(struct NonNativeContacts *nonNative);
+
+#endif
@@ -0,0 +1,509 @@
+/*
+*	Name: checkpoint.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Lets a long analysis be stopped and started again without losing its progress.
+*		The frames of the traj.xtc are evaluated in blocks of checkpoint->interval
+*		frames, by the same serial or threaded functions used without a checkpoint.
+*		After every block the next frame, its byte offset and the results so far (the
+*		Q values, or the counts of an occupancy table) are saved in the checkpoint
+*		file.  Q values are only ever added to, so the Q values of the block are
+*		appended and the header is rewritten; the file is not written again as a
+*		whole.  A run started with the same checkpoint file, trajectory, contacts file
+*		and settings continues from the next frame.  Blocks keep the stride of the
+*		stream and integer counts are added, so the final output is identical to a
+*		run that was never stopped.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "../calcQFromContacts/calcQFromContacts.h"
+#include "../threadedAnalysis/threadedAnalysis.h"
+#include "checkpoint.h"
+
+// Evaluates the frames in the stream's range and adds them to the checkpoint's results
+typedef void (*CheckpointBlock)(struct Checkpoint *checkpoint, struct XtcStream *stream, void *arg);
+
+struct QValuesBlock {
+	int contacts;
+	int cutoffs;
+	float *cutoff;
+	struct Contact *residueContacts;
+	struct SmoothQ *smoothQ;
+	int threads;
+};
+
+struct OccupancyBlock {
+	struct OccupancyTable *table;
+	float cutOff;
+	int threads;
+};
+
+static int readCheckpointFile(struct Checkpoint *checkpoint);
+static void runCheckpointBlocks(struct Checkpoint *checkpoint, struct XtcStream *stream, CheckpointBlock block, void *arg);
+static void moveCheckpointStream(struct XtcStream *stream, struct XtcFrameIndex *index, int frame);
+static void evaluateQValuesBlock(struct Checkpoint *checkpoint, struct XtcStream *stream, void *arg);
+static void evaluateOccupancyBlock(struct Checkpoint *checkpoint, struct XtcStream *stream, void *arg);
+static void appendCheckpointData(struct Checkpoint *checkpoint, void *data, int64_t frames, int64_t bytes);
+static void* copyCheckpointData(struct Checkpoint *checkpoint);
+static void replaceCheckpointFile(struct Checkpoint *checkpoint);
+static int appendCheckpointFile(struct Checkpoint *checkpoint);
+
+/*
+*	Name: struct Checkpoint* openCheckpoint()
+*	Description: Loads the checkpoint file if it was written for the same trajectory,
+*		     contacts file and settings.  Otherwise the analysis starts from the first
+*		     frame and the file is replaced after the first block.
+*
+*	Args: -char *checkpointFile - where the checkpoint is kept.
+*	      -int interval - frames evaluated between checkpoints.
+*	      -char *xtcFile - the traj.xtc file being analysed.
+*	      -char *contactFile - the contacts file of the analysis.
+*	      -char *settings - every other setting that changes the results, as text.
+*
+*	Returns: -struct Checkpoint *checkpoint - the loaded or empty checkpoint.
+*/
+
+struct Checkpoint* openCheckpoint(char *checkpointFile, int interval, char *xtcFile, char *contactFile, char *settings) {
+	struct Checkpoint *checkpoint = (struct Checkpoint*) malloc(sizeof(struct Checkpoint));
+	if(!checkpoint) {
+		perror("checkpoint memory not allocated");
+		abort();
+	}
+
+	if(interval < 1) {
+		printf("\nopenCheckpoint: at least 1 frame is needed between checkpoints\n");
+		exit(1);
+	}
+
+	checkpoint->checkpointFile = strdup(checkpointFile);
+	checkpoint->interval = interval;
+	checkpoint->data = NULL;
+	checkpoint->savedBytes = 0;
+
+	memset(&checkpoint->header, 0, sizeof(checkpoint->header));
+	memcpy(checkpoint->header.magic, CHECKPOINT_MAGIC, sizeof(checkpoint->header.magic));
+	checkpoint->header.version = CHECKPOINT_VERSION;
+	checkpoint->header.settings = hashBytes(FILE_IDENTITY_HASH_SEED, settings, strlen(settings));
+	checkpoint->header.xtcIdentity = getFileIdentity(xtcFile, 0);
+	checkpoint->header.contactIdentity = getFileIdentity(contactFile, 1);
+
+	if(readCheckpointFile(checkpoint)) {
+		fprintf(stderr, "Resuming from frame %d of %s\n", checkpoint->header.nextFrame + 1, xtcFile);
+	}
+
+	return checkpoint;
+}
+
+/*
+*	Name: int* calculateQValuesCheckpointed()
+*	Description: Same as calculateQValuesFromStream(), or calculateQValuesCutoffsFromStream()
+*		     when there are several cutoffs, saving a checkpoint after every block.
+*
+*	Args: -struct Checkpoint *checkpoint - from openCheckpoint().
+*	      -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -int cutoffs - the amount of cutoff values.
+*	      -float *cutoff - the cutoff values.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -int *xtcFrames - set to the amount of frames evaluated, counting earlier runs.
+*	      -int threads - the amount of worker threads.
+*
+*	returns: -int *qValues - cutoffs Q values for each frame.
+*/
+
+int* calculateQValuesCheckpointed(struct Checkpoint *checkpoint, struct XtcStream *stream, int contacts, int cutoffs, float *cutoff, struct Contact *residueContacts, int *xtcFrames, int threads) {
+	struct QValuesBlock block = {contacts, cutoffs, cutoff, residueContacts, NULL, threads};
+
+	runCheckpointBlocks(checkpoint, stream, evaluateQValuesBlock, &block);
+
+	*xtcFrames = checkpoint->header.frames;
+
+	return (int*) copyCheckpointData(checkpoint);
+}
+
+/*
+*	Name: float* calculateSmoothQValuesCheckpointed()
+*	Description: Same as calculateSmoothQValuesFromStream(), saving a checkpoint after
+*		     every block.
+*
+*	Args: -struct Checkpoint *checkpoint - from openCheckpoint().
+*	      -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -struct SmoothQ *smoothQ - from createSmoothQ().
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -int *xtcFrames - set to the amount of frames evaluated, counting earlier runs.
+*	      -int threads - the amount of worker threads.
+*
+*	returns: -float *qValues - a fractional Q for each frame.
+*/
+
+float* calculateSmoothQValuesCheckpointed(struct Checkpoint *checkpoint, struct XtcStream *stream, struct SmoothQ *smoothQ, struct Contact *residueContacts, int *xtcFrames, int threads) {
+	struct QValuesBlock block = {smoothQ->contacts, 0, NULL, residueContacts, smoothQ, threads};
+
+	runCheckpointBlocks(checkpoint, stream, evaluateQValuesBlock, &block);
+
+	*xtcFrames = checkpoint->header.frames;
+
+	return (float*) copyCheckpointData(checkpoint);
+}
+
+/*
+*	Name: struct OccupancyTable* calculateOccupancyTableCheckpointed()
+*	Description: Same as calculateOccupancyTableFromStream(), saving the counts of the
+*		     table after every block.
+*
+*	Args: -struct Checkpoint *checkpoint - from openCheckpoint().
+*	      -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -int windows - the amount of windows
+*	      -struct OccupancyWindow *window - Q value and time slice range of each window
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*	      -int threads - the amount of worker threads
+*
+*	Returns: -struct OccupancyTable *table - occurrences and probabilities of every contact
+*				in every window
+*/
+
+struct OccupancyTable* calculateOccupancyTableCheckpointed(struct Checkpoint *checkpoint, struct XtcStream *stream, int contacts, struct Contact *residueContacts, int windows, struct OccupancyWindow *window, float cutOff, int threads) {
+	struct OccupancyTable *table = allocateOccupancyTable(windows, window, contacts, residueContacts);
+	struct OccupancyBlock block = {table, cutOff, threads};
+	int64_t counts = (int64_t) windows + (int64_t) windows * contacts;
+
+	// Counts saved by an earlier run: frames in range of every window, then occurrences
+	if(checkpoint->header.bytes == counts * (int64_t) sizeof(int)) {
+		int *count = (int*) checkpoint->data;
+
+		for(int w = 0; w < windows; w++) {
+			table->qValuesInRange[w] = count[w];
+		}
+
+		for(int64_t i = 0; i < (int64_t) windows * contacts; i++) {
+			table->contactInformation[i].totalOccurrences = count[windows + i];
+		}
+	} else if(checkpoint->header.bytes != 0) {
+		printf("\n%s does not hold an occupancy table of this size\n", checkpoint->checkpointFile);
+		exit(1);
+	}
+
+	// Frames outside of every time window are never decoded
+	setXtcStreamTimeRange(stream, getOccupancyTimeRange(windows, window));
+
+	runCheckpointBlocks(checkpoint, stream, evaluateOccupancyBlock, &block);
+
+	calculateOccupancyTableProbabilities(table);
+
+	return table;
+}
+
+/*
+*	Name: void writeCheckpoint()
+*	Description: Saves the checkpoint.  When the file already holds the start of the
+*		     results, only the bytes added since are appended after them and the
+*		     header is rewritten last, so a run stopped while writing leaves a header
+*		     that describes the previous checkpoint.  Otherwise the checkpoint is
+*		     written to a temporary file which is then renamed.
+*
+*	Args: -struct Checkpoint *checkpoint - the checkpoint to save.
+*/
+
+void writeCheckpoint(struct Checkpoint *checkpoint) {
+	if (checkpoint->savedBytes == 0 || !appendCheckpointFile(checkpoint)) {
+		replaceCheckpointFile(checkpoint);
+	}
+
+	checkpoint->savedBytes = checkpoint->header.bytes;
+}
+
+/*
+*	Name: void finishCheckpoint()
+*	Description: Removes the checkpoint file once the output of the analysis is written.
+*/
+
+void finishCheckpoint(struct Checkpoint *checkpoint) {
+	remove(checkpoint->checkpointFile);
+
+	free(checkpoint->checkpointFile);
+	free(checkpoint->data);
+	free(checkpoint);
+}
+
+/*
+*	Returns 1 and loads the results if the checkpoint file belongs to this analysis.
+*/
+
+static int readCheckpointFile(struct Checkpoint *checkpoint) {
+	struct CheckpointHeader header;
+	FILE *fp;
+
+	if ((fp = fopen(checkpoint->checkpointFile, "rb")) == NULL) {
+		return 0;
+	}
+
+	if (fread(&header, sizeof(header), 1, fp) != 1 ||
+	    memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+	    header.version != CHECKPOINT_VERSION || header.bytes < 0 || header.nextFrame < 0 ||
+	    header.settings != checkpoint->header.settings ||
+	    !compareFileIdentity(header.xtcIdentity, checkpoint->header.xtcIdentity) ||
+	    !compareFileIdentity(header.contactIdentity, checkpoint->header.contactIdentity)) {
+		fprintf(stderr, "%s was written for another analysis and is not used\n", checkpoint->checkpointFile);
+		fclose(fp);
+		return 0;
+	}
+
+	char *data = (char*) malloc(header.bytes > 0 ? header.bytes : 1);
+	if(!data) {
+		perror("checkpoint data memory not allocated");
+		abort();
+	}
+
+	if (header.bytes > 0 && fread(data, header.bytes, 1, fp) != 1) {
+		fprintf(stderr, "%s is incomplete and is not used\n", checkpoint->checkpointFile);
+		free(data);
+		fclose(fp);
+		return 0;
+	}
+
+	fclose(fp);
+
+	checkpoint->header = header;
+	checkpoint->data = data;
+	checkpoint->savedBytes = header.bytes;
+
+	return 1;
+}
+
+/*
+*	Name: static void runCheckpointBlocks()
+*	Description: Evaluates the frames left in the stream, interval frames at a time,
+*		     writing the checkpoint after each block.  A loaded checkpoint moves the
+*		     stream to its next frame first.
+*/
+
+static void runCheckpointBlocks(struct Checkpoint *checkpoint, struct XtcStream *stream, CheckpointBlock block, void *arg) {
+	struct XtcFrameIndex *index;
+	int lastFrame = stream->lastFrame;
+	int frame;
+
+	if (!stream->index) {
+		stream->index = getXtcFrameIndex(stream->xtcFile);
+	}
+	index = stream->index;
+
+	if(checkpoint->header.nextFrame > 0) {
+		int nextFrame = checkpoint->header.nextFrame;
+
+		if(nextFrame < index->frames && index->offsets[nextFrame] != checkpoint->header.offset) {
+			printf("\n%s does not match the frames of %s\n", checkpoint->checkpointFile, stream->xtcFile);
+			exit(1);
+		}
+
+		moveCheckpointStream(stream, index, nextFrame);
+	}
+
+	while((frame = nextXtcStreamFrame(stream)) <= lastFrame && frame < index->frames) {
+		// Ends before the first frame of the next block, which is where a resumed run starts
+		int64_t blockEnd = frame + (int64_t) checkpoint->interval * stream->stride - 1;
+
+		if(blockEnd > lastFrame) {
+			blockEnd = lastFrame;
+		}
+		if(blockEnd > index->frames - 1) {
+			blockEnd = index->frames - 1;
+		}
+
+		// The stream stops after the block; the stride still counts from its first frame
+		stream->lastFrame = (int) blockEnd;
+		block(checkpoint, stream, arg);
+		stream->lastFrame = lastFrame;
+
+		moveCheckpointStream(stream, index, (int) blockEnd + 1);
+
+		checkpoint->header.nextFrame = (int) blockEnd + 1;
+		checkpoint->header.offset = blockEnd + 1 < index->frames ? index->offsets[blockEnd + 1] : checkpoint->header.xtcIdentity.size;
+		writeCheckpoint(checkpoint);
+	}
+}
+
+/*
+*	Threaded functions leave the stream at the end of the file, so the stream is always
+*	moved to the frame after a block.
+*/
+
+static void moveCheckpointStream(struct XtcStream *stream, struct XtcFrameIndex *index, int frame) {
+	if(frame < index->frames) {
+		seekXtcStream(stream, index, frame);
+	} else {
+		stream->currentFrame = frame;
+	}
+}
+
+static void evaluateQValuesBlock(struct Checkpoint *checkpoint, struct XtcStream *stream, void *arg) {
+	struct QValuesBlock *block = (struct QValuesBlock*) arg;
+	int frames;
+	void *qValues;
+	size_t size;
+
+	if(block->smoothQ) {
+		size = sizeof(float);
+		if(block->threads > 1) {
+			qValues = calculateSmoothQValuesThreaded(stream, block->smoothQ, block->residueContacts, &frames, block->threads);
+		} else {
+			qValues = calculateSmoothQValuesFromStream(stream, block->smoothQ, block->residueContacts, &frames);
+		}
+	} else if(block->cutoffs > 1) {
+		size = sizeof(int) * block->cutoffs;
+		if(block->threads > 1) {
+			qValues = calculateQValuesCutoffsThreaded(stream, block->contacts, block->cutoffs, block->cutoff, block->residueContacts, &frames, block->threads);
+		} else {
+			qValues = calculateQValuesCutoffsFromStream(stream, block->contacts, block->cutoffs, block->cutoff, block->residueContacts, &frames);
+		}
+	} else {
+		size = sizeof(int);
+		if(block->threads > 1) {
+			qValues = calculateQValuesThreaded(stream, block->contacts, block->cutoff[0], block->residueContacts, &frames, block->threads);
+		} else {
+			qValues = calculateQValuesFromStream(stream, block->contacts, block->cutoff[0], block->residueContacts, &frames);
+		}
+	}
+
+	appendCheckpointData(checkpoint, qValues, frames, (int64_t) frames * size);
+	free(qValues);
+}
+
+static void evaluateOccupancyBlock(struct Checkpoint *checkpoint, struct XtcStream *stream, void *arg) {
+	struct OccupancyBlock *block = (struct OccupancyBlock*) arg;
+	struct OccupancyTable *table = block->table;
+	int64_t occurrences = (int64_t) table->windows * table->contacts;
+
+	if(block->threads > 1) {
+		countOccupancyTableThreaded(stream, table, block->cutOff, block->threads);
+	} else {
+		countOccupancyTableFromStream(stream, table, block->cutOff);
+	}
+
+	// The counts replace the ones saved after the last block
+	int *count = (int*) malloc(sizeof(int) * (table->windows + occurrences));
+	if(!count) {
+		perror("checkpoint data memory not allocated");
+		abort();
+	}
+
+	memcpy(count, table->qValuesInRange, sizeof(int) * table->windows);
+	for(int64_t i = 0; i < occurrences; i++) {
+		count[table->windows + i] = table->contactInformation[i].totalOccurrences;
+	}
+
+	free(checkpoint->data);
+	checkpoint->data = (char*) count;
+	checkpoint->header.bytes = sizeof(int) * (table->windows + occurrences);
+	checkpoint->savedBytes = 0;
+}
+
+static void appendCheckpointData(struct Checkpoint *checkpoint, void *data, int64_t frames, int64_t bytes) {
+	checkpoint->data = (char*) realloc(checkpoint->data, checkpoint->header.bytes + bytes > 0 ? checkpoint->header.bytes + bytes : 1);
+	if(!checkpoint->data) {
+		perror("checkpoint data memory not allocated");
+		abort();
+	}
+
+	memcpy(checkpoint->data + checkpoint->header.bytes, data, bytes);
+	checkpoint->header.bytes += bytes;
+	checkpoint->header.frames += frames;
+}
+
+static void* copyCheckpointData(struct Checkpoint *checkpoint) {
+	void *data = malloc(checkpoint->header.bytes > 0 ? checkpoint->header.bytes : 1);
+	if(!data) {
+		perror("checkpoint data memory not allocated");
+		abort();
+	}
+
+	memcpy(data, checkpoint->data ? checkpoint->data : "", checkpoint->header.bytes);
+
+	return data;
+}
+
+/*
+*	Writes the header and every byte of the results to a temporary file which is then
+*	renamed, so a run stopped while writing leaves the previous checkpoint in place.  The
+*	temporary file has a unique name, so runs sharing a checkpoint never write into
+*	each other's.
+*/
+
+static void replaceCheckpointFile(struct Checkpoint *checkpoint) {
+	char *tmpFile;
+	FILE *fp = NULL;
+	int fd, written;
+
+	tmpFile = (char*) malloc(strlen(checkpoint->checkpointFile) + sizeof(".XXXXXX"));
+	if(!tmpFile) {
+		perror("tmpFile memory not allocated");
+		abort();
+	}
+
+	strcpy(tmpFile, checkpoint->checkpointFile);
+	strcat(tmpFile, ".XXXXXX");
+
+	if ((fd = mkstemp(tmpFile)) != -1) {
+		fchmod(fd, 0644);
+		if ((fp = fdopen(fd, "wb")) == NULL) {
+			close(fd);
+			remove(tmpFile);
+		}
+	}
+
+	if (fp == NULL) {
+		perror("could not open checkpointFile for output.");
+		exit(1);
+	}
+
+	written = fwrite(&checkpoint->header, sizeof(checkpoint->header), 1, fp) == 1 &&
+		  (checkpoint->header.bytes == 0 || fwrite(checkpoint->data, checkpoint->header.bytes, 1, fp) == 1);
+
+	if (fclose(fp) != 0 || !written || rename(tmpFile, checkpoint->checkpointFile) != 0) {
+		perror("could not write checkpointFile.");
+		remove(tmpFile);
+		exit(1);
+	}
+
+	free(tmpFile);
+}
+
+/*
+*	Writes the results added since the last checkpoint after the ones in the file, over
+*	anything left by a run stopped while appending, then the header.  The results reach
+*	the disk before the header, so the header never counts bytes that were not written.
+*	Returns 0 if the file could not be opened, and it is then replaced.
+*/
+
+static int appendCheckpointFile(struct Checkpoint *checkpoint) {
+	int64_t bytes = checkpoint->header.bytes - checkpoint->savedBytes;
+	FILE *fp;
+	int written;
+
+	if ((fp = fopen(checkpoint->checkpointFile, "r+b")) == NULL) {
+		return 0;
+	}
+
+	written = fseeko(fp, (off_t) sizeof(checkpoint->header) + checkpoint->savedBytes, SEEK_SET) == 0 &&
+		  (bytes == 0 || fwrite(checkpoint->data + checkpoint->savedBytes, bytes, 1, fp) == 1) &&
+		  fflush(fp) == 0 && fsync(fileno(fp)) == 0 &&
+		  fseeko(fp, 0, SEEK_SET) == 0 &&
+		  fwrite(&checkpoint->header, sizeof(checkpoint->header), 1, fp) == 1 &&
+		  fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+
+	if (fclose(fp) != 0 || !written) {
+		perror("could not write checkpointFile.");
+		exit(1);
+	}
+
+	return 1;
+}
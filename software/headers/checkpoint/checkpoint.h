@@ -0,0 +1,54 @@
+/*
+*	Name: checkpoint.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef CHECKPOINT
+#define CHECKPOINT
+
+#include <stdint.h>
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactReader/contactReader.h"
+#include "../fileIdentity/fileIdentity.h"
+#include "../occupancyTable/occupancyTable.h"
+#include "../smoothQ/smoothQ.h"
+
+#define CHECKPOINT_MAGIC "QCKPT\0\0\0"
+#define CHECKPOINT_VERSION 2
+
+// Frames evaluated between checkpoints, unless --checkpoint-frames is given
+#define CHECKPOINT_FRAMES 10000
+
+// Followed by bytes of results: the Q values so far, or the counts of an occupancy table
+struct CheckpointHeader {
+	char magic[8];
+	int32_t version;
+	int32_t nextFrame;
+	int64_t offset;
+	int64_t frames;
+	int64_t bytes;
+	uint64_t settings;
+	struct FileIdentity xtcIdentity;
+	struct FileIdentity contactIdentity;
+};
+
+struct Checkpoint {
+	char *checkpointFile;
+	int interval;
+	struct CheckpointHeader header;
+	char *data;
+	// Bytes at the start of data already in the checkpoint file, 0 if it must be replaced
+	int64_t savedBytes;
+};
+
+struct Checkpoint* openCheckpoint(char *checkpointFile, int interval, char *xtcFile, char *contactFile, char *settings);
+int* calculateQValuesCheckpointed(struct Checkpoint *checkpoint, struct XtcStream *stream, int contacts, int cutoffs, float *cutoff, struct Contact *residueContacts, int *xtcFrames, int threads);
+float* calculateSmoothQValuesCheckpointed(struct Checkpoint *checkpoint, struct XtcStream *stream, struct SmoothQ *smoothQ, struct Contact *residueContacts, int *xtcFrames, int threads);
+struct OccupancyTable* calculateOccupancyTableCheckpointed(struct Checkpoint *checkpoint, struct XtcStream *stream, int contacts, struct Contact *residueContacts, int windows, struct OccupancyWindow *window, float cutOff, int threads);
+void writeCheckpoint(struct Checkpoint *checkpoint);
+void finishCheckpoint(struct Checkpoint *checkpoint);
+
+#endif
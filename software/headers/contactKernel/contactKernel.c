@@ -0,0 +1,659 @@
+/*
+*	Name: contactKernel.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Tests many residue pairs against the cutoff at once using the squared distance,
+*		without calling pow() or sqrt().  An AVX-512, AVX2, SSE2 or scalar version is
+*		chosen when the program starts, based on what the processor supports.  The
+*		environment variable PROTEIN_CONTACT_KERNEL (avx512, avx2, sse2 or scalar)
+*		selects a version by hand.
+*
+*		Every version makes the same decision as calculateDistance() <= cutoff.  The
+*		squared distance is added in double precision, where the square of a float is
+*		exact, and compared to the largest double whose square root, rounded to a float,
+*		is still within the cutoff (see calculateCutoffThreshold()).
+*
+*		The smooth kernel adds 1/(1+exp(beta(r-lambda*r0))) over the contacts for the
+*		fractional Q.  exp() is replaced by calculateApproximateExp(), which the scalar
+*		and AVX2 versions evaluate with the same float operations.  The terms are added
+*		in double precision to 8 partial sums, one per vector lane, which are then
+*		added in order, so every version returns the same sum.
+*
+*	Notes:
+*		Coordinates are read as x[i * stride], y[i * stride] and z[i * stride] for
+*		residue i + 1.  For an array of struct XtcCoordinates pass &frame[0].x,
+*		&frame[0].y, &frame[0].z and a stride of 3.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CONTACT_KERNEL_X86
+#endif
+
+#include "contactKernel.h"
+
+typedef int (*ContactKernel)(const float*, const float*, const float*, int, int, struct Contact*, double, uint64_t*);
+typedef void (*ThresholdsKernel)(const float*, const float*, const float*, int, int, struct Contact*, int, const double*, int*);
+typedef double (*SmoothKernel)(const float*, const float*, const float*, int, int, struct Contact*, const float*, float);
+
+static int scalarContactKernel(const float *x, const float *y, const float *z, int stride, int start, int contacts, struct Contact *residueContacts, double threshold, uint64_t *contactStates);
+static int runScalarContactKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, double threshold, uint64_t *contactStates);
+static void scalarThresholdsKernel(const float *x, const float *y, const float *z, int stride, int start, int contacts, struct Contact *residueContacts, int thresholds, const double *threshold, int *qValues);
+static void runScalarThresholdsKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, int thresholds, const double *threshold, int *qValues);
+static double scalarSmoothKernel(const float *x, const float *y, const float *z, int stride, int start, int contacts, struct Contact *residueContacts, const float *switchDistance, float beta);
+static double runScalarSmoothKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, const float *switchDistance, float beta);
+
+#ifdef CONTACT_KERNEL_X86
+static int sse2ContactKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, double threshold, uint64_t *contactStates);
+static int avx2ContactKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, double threshold, uint64_t *contactStates);
+static int avx512ContactKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, double threshold, uint64_t *contactStates);
+static void avx2ThresholdsKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, int thresholds, const double *threshold, int *qValues);
+static double avx2SmoothKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, const float *switchDistance, float beta);
+#endif
+
+static ContactKernel contactKernel = runScalarContactKernel;
+static ThresholdsKernel thresholdsKernel = runScalarThresholdsKernel;
+static SmoothKernel smoothKernel = runScalarSmoothKernel;
+static char *contactKernelName = "scalar";
+
+// Contact pairs evaluated by every thread so far, see getContactEvaluations()
+static int64_t contactEvaluations = 0;
+
+/*
+*	Name: int calculateContactKernel()
+*	Description: Tests every contact pair of one frame against the cutoff.
+*
+*	Args: -const float *x, *y, *z - coordinates of the first residue.
+*	      -int stride - floats between the coordinates of neighbouring residues.
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -uint64_t *contactStates - if not NULL, bit j is set when contact j is present.
+*				The words must be zeroed by the caller.
+*
+*	Returns: -int qValue - the amount of contacts present in the frame.
+*/
+
+int calculateContactKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, float cutoff, uint64_t *contactStates) {
+	static __thread float lastCutoff = -1.0f;
+	static __thread double lastThreshold = -1.0;
+
+	// The threshold only changes with the cutoff
+	if(cutoff != lastCutoff) {
+		lastThreshold = calculateCutoffThreshold(cutoff);
+		lastCutoff = cutoff;
+	}
+
+	__atomic_fetch_add(&contactEvaluations, contacts, __ATOMIC_RELAXED);
+
+	return contactKernel(x, y, z, stride, contacts, residueContacts, lastThreshold, contactStates);
+}
+
+/*
+*	Name: void calculateContactKernelThresholds()
+*	Description: Calculates the Q value of one frame for several cutoffs.  The squared
+*		     distance of every contact pair is calculated once and compared against
+*		     every threshold.
+*
+*	Args: -const float *x, *y, *z - coordinates of the first residue.
+*	      -int stride - floats between the coordinates of neighbouring residues.
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -int thresholds - the amount of cutoffs.
+*	      -const double *threshold - calculateCutoffThreshold() of every cutoff.
+*	      -int *qValues - set to the Q value for every cutoff.
+*/
+
+void calculateContactKernelThresholds(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, int thresholds, const double *threshold, int *qValues) {
+	__atomic_fetch_add(&contactEvaluations, contacts, __ATOMIC_RELAXED);
+
+	thresholdsKernel(x, y, z, stride, contacts, residueContacts, thresholds, threshold, qValues);
+}
+
+/*
+*	Name: double calculateContactKernelSmooth()
+*	Description: Adds the switching function 1/(1+exp(beta(r-switchDistance))) of every
+*		     contact pair of one frame, where r is the distance between the pair.
+*
+*	Args: -const float *x, *y, *z - coordinates of the first residue.
+*	      -int stride - floats between the coordinates of neighbouring residues.
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -const float *switchDistance - lambda times the native distance of every contact.
+*	      -float beta - steepness of the switching function, per unit of distance.
+*
+*	Returns: -double sum - between 0 and contacts.
+*/
+
+double calculateContactKernelSmooth(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, const float *switchDistance, float beta) {
+	__atomic_fetch_add(&contactEvaluations, contacts, __ATOMIC_RELAXED);
+
+	return smoothKernel(x, y, z, stride, contacts, residueContacts, switchDistance, beta);
+}
+
+/*
+*	Name: float calculateApproximateExp()
+*	Description: exp(x) from a degree 5 polynomial after removing multiples of ln(2), as in
+*		     the Cephes library, with a relative error below 2e-7.  x is limited to
+*		     [-87, 88] so the result stays a normal float.
+*
+*	Args: -float x - the exponent.
+*
+*	Returns: -float e - approximately exp(x).
+*/
+
+float calculateApproximateExp(float x) {
+	x = x > 88.0f ? 88.0f : x;
+	x = x < -87.0f ? -87.0f : x;
+
+	// x = n ln(2) + remainder, ln(2) split in two so the remainder is exact
+	float n = floorf(x * 1.44269504088896341f + 0.5f);
+	x = x - n * 0.693359375f;
+	x = x - n * -2.12194440e-4f;
+
+	float polynomial = 1.9875691500e-4f;
+	polynomial = polynomial * x + 1.3981999507e-3f;
+	polynomial = polynomial * x + 8.3334519073e-3f;
+	polynomial = polynomial * x + 4.1665795894e-2f;
+	polynomial = polynomial * x + 1.6666665459e-1f;
+	polynomial = polynomial * x + 5.0000001201e-1f;
+	polynomial = polynomial * (x * x) + x + 1.0f;
+
+	// Multiplies by 2^n through the exponent bits
+	uint32_t bits = (uint32_t)((int) n + 127) << 23;
+	float scale;
+	memcpy(&scale, &bits, sizeof(float));
+
+	return polynomial * scale;
+}
+
+/*
+*	Name: double calculateCutoffThreshold()
+*	Description: Finds the largest squared distance d2 for which (float) sqrt(d2) <= cutoff,
+*		     the test made with calculateDistance().  Comparing d2 <= threshold then
+*		     makes the same decision without a square root.
+*
+*	Args: -float cutoff - the user specified contact cutoff value for a residue pair.
+*
+*	Returns: -double threshold - the largest squared distance within the cutoff, or -1.0
+*			if no distance is within the cutoff.
+*/
+
+double calculateCutoffThreshold(float cutoff) {
+	if(!(cutoff >= 0.0f)) {
+		return -1.0;
+	}
+
+	double low = 0.0, high = ((double) cutoff + 1.0) * ((double) cutoff + 1.0);
+	uint64_t lowBits, highBits;
+
+	memcpy(&lowBits, &low, sizeof(double));
+	memcpy(&highBits, &high, sizeof(double));
+
+	// Positive doubles are ordered the same as their bit patterns
+	while(highBits - lowBits > 1) {
+		uint64_t middleBits = lowBits + (highBits - lowBits) / 2;
+		double middle;
+
+		memcpy(&middle, &middleBits, sizeof(double));
+
+		if((float) sqrt(middle) <= cutoff) {
+			lowBits = middleBits;
+		} else {
+			highBits = middleBits;
+		}
+	}
+
+	memcpy(&low, &lowBits, sizeof(double));
+
+	return low;
+}
+
+/*
+*	Name: int setContactKernel()
+*	Description: Selects a version of the kernel by name.
+*
+*	Args: -char *name - "avx512", "avx2", "sse2" or "scalar".
+*
+*	Returns: -int - 1 if the version is supported by the processor, otherwise 0 and the
+*			selected version is unchanged.
+*/
+
+int setContactKernel(char *name) {
+	if(strcmp(name, "scalar") == 0) {
+		contactKernel = runScalarContactKernel;
+		thresholdsKernel = runScalarThresholdsKernel;
+		smoothKernel = runScalarSmoothKernel;
+		contactKernelName = "scalar";
+		return 1;
+	}
+
+#ifdef CONTACT_KERNEL_X86
+	__builtin_cpu_init();
+
+	if(strcmp(name, "sse2") == 0 && __builtin_cpu_supports("sse2")) {
+		contactKernel = sse2ContactKernel;
+		thresholdsKernel = runScalarThresholdsKernel;
+		smoothKernel = runScalarSmoothKernel;
+		contactKernelName = "sse2";
+		return 1;
+	}
+
+	if(strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+		contactKernel = avx2ContactKernel;
+		thresholdsKernel = avx2ThresholdsKernel;
+		smoothKernel = avx2SmoothKernel;
+		contactKernelName = "avx2";
+		return 1;
+	}
+
+	// Several thresholds are compared per block and the smooth kernel is bound by the
+	// gathers, so the AVX2 versions are used for them
+	if(strcmp(name, "avx512") == 0 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2")) {
+		contactKernel = avx512ContactKernel;
+		thresholdsKernel = avx2ThresholdsKernel;
+		smoothKernel = avx2SmoothKernel;
+		contactKernelName = "avx512";
+		return 1;
+	}
+#endif
+
+	return 0;
+}
+
+/*
+*	Name: char* getContactKernelName()
+*	Description:	The name of the kernel chosen by selectContactKernel or
+*			setContactKernel, for example "avx2", as written in profiles.
+*
+*	Returns: -char *contactKernelName - name of the kernel, not to be freed.
+*/
+
+char* getContactKernelName() {
+	return contactKernelName;
+}
+
+/*
+*	Name: int64_t getContactEvaluations()
+*	Description: The amount of contact pairs tested by every kernel, on every thread,
+*		     since the program started.  A pair tested against several cutoffs
+*		     counts once.
+*/
+
+int64_t getContactEvaluations() {
+	return __atomic_load_n(&contactEvaluations, __ATOMIC_RELAXED);
+}
+
+/*
+*	Name: static void selectContactKernel()
+*	Description: Runs before main() and selects the widest version the processor supports,
+*		     unless PROTEIN_CONTACT_KERNEL names one.
+*/
+
+__attribute__((constructor))
+static void selectContactKernel() {
+	char *name = getenv("PROTEIN_CONTACT_KERNEL");
+
+	if(name != NULL) {
+		if(!setContactKernel(name)) {
+			printf("\nPROTEIN_CONTACT_KERNEL=%s is not supported, using the default\n", name);
+		} else {
+			return;
+		}
+	}
+
+	if(!setContactKernel("avx512") && !setContactKernel("avx2") && !setContactKernel("sse2")) {
+		setContactKernel("scalar");
+	}
+}
+
+static int runScalarContactKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, double threshold, uint64_t *contactStates) {
+	return scalarContactKernel(x, y, z, stride, 0, contacts, residueContacts, threshold, contactStates);
+}
+
+/*
+*	Name: static int scalarContactKernel()
+*	Description: Tests contacts start to contacts-1 one at a time.  Also finishes the
+*		     contacts left over by the vector versions.
+*/
+
+static int scalarContactKernel(const float *x, const float *y, const float *z, int stride, int start, int contacts, struct Contact *residueContacts, double threshold, uint64_t *contactStates) {
+	int qValue = 0;
+
+	for(int j = start; j < contacts; j++) {
+		int focus = (residueContacts[j].focusResidue-1) * stride;
+		int contact = (residueContacts[j].contactResidue-1) * stride;
+
+		// Differences are taken in float, as in calculateDistance()
+		double dx = x[contact] - x[focus];
+		double dy = y[contact] - y[focus];
+		double dz = z[contact] - z[focus];
+
+		if(dx * dx + dy * dy + dz * dz <= threshold) {
+			if(contactStates != NULL) {
+				contactStates[j / 64] |= (uint64_t)1 << (j % 64);
+			}
+			qValue++;
+		}
+	}
+
+	return qValue;
+}
+
+static void runScalarThresholdsKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, int thresholds, const double *threshold, int *qValues) {
+	for(int k = 0; k < thresholds; k++) {
+		qValues[k] = 0;
+	}
+
+	scalarThresholdsKernel(x, y, z, stride, 0, contacts, residueContacts, thresholds, threshold, qValues);
+}
+
+/*
+*	Name: static void scalarThresholdsKernel()
+*	Description: Adds the contacts start to contacts-1 within each threshold to qValues.
+*/
+
+static void scalarThresholdsKernel(const float *x, const float *y, const float *z, int stride, int start, int contacts, struct Contact *residueContacts, int thresholds, const double *threshold, int *qValues) {
+	for(int j = start; j < contacts; j++) {
+		int focus = (residueContacts[j].focusResidue-1) * stride;
+		int contact = (residueContacts[j].contactResidue-1) * stride;
+
+		double dx = x[contact] - x[focus];
+		double dy = y[contact] - y[focus];
+		double dz = z[contact] - z[focus];
+		double squared = dx * dx + dy * dy + dz * dz;
+
+		for(int k = 0; k < thresholds; k++) {
+			qValues[k] += squared <= threshold[k];
+		}
+	}
+}
+
+/*
+*	Name: static float smoothTerm()
+*	Description: The switching function of contact j.  The float operations match
+*		     avx2SmoothKernel() one for one.
+*/
+
+static inline float smoothTerm(const float *x, const float *y, const float *z, int stride, int j, struct Contact *residueContacts, const float *switchDistance, float beta) {
+	int focus = (residueContacts[j].focusResidue-1) * stride;
+	int contact = (residueContacts[j].contactResidue-1) * stride;
+
+	float dx = x[contact] - x[focus];
+	float dy = y[contact] - y[focus];
+	float dz = z[contact] - z[focus];
+	float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+
+	return 1.0f / (1.0f + calculateApproximateExp(beta * (distance - switchDistance[j])));
+}
+
+static double runScalarSmoothKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, const float *switchDistance, float beta) {
+	int blocks = contacts / 8 * 8;
+	double lane[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+	double sum = 0.0;
+
+	// Contact j is added to lane j % 8, as in the vector versions
+	for(int j = 0; j < blocks; j++) {
+		lane[j % 8] += smoothTerm(x, y, z, stride, j, residueContacts, switchDistance, beta);
+	}
+
+	for(int k = 0; k < 8; k++) {
+		sum += lane[k];
+	}
+
+	return sum + scalarSmoothKernel(x, y, z, stride, blocks, contacts, residueContacts, switchDistance, beta);
+}
+
+/*
+*	Name: static double scalarSmoothKernel()
+*	Description: Adds the switching function of contacts start to contacts-1 in order.
+*		     Finishes the contacts left over by the blocks of 8.
+*/
+
+static double scalarSmoothKernel(const float *x, const float *y, const float *z, int stride, int start, int contacts, struct Contact *residueContacts, const float *switchDistance, float beta) {
+	double sum = 0.0;
+
+	for(int j = start; j < contacts; j++) {
+		sum += smoothTerm(x, y, z, stride, j, residueContacts, switchDistance, beta);
+	}
+
+	return sum;
+}
+
+#ifdef CONTACT_KERNEL_X86
+
+static int sse2ContactKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, double threshold, uint64_t *contactStates) {
+	__m128d limit = _mm_set1_pd(threshold);
+	int blocks = contacts / 4 * 4;
+	int qValue = 0;
+
+	for(int j = 0; j < blocks; j += 4) {
+		int f0 = (residueContacts[j].focusResidue-1) * stride, c0 = (residueContacts[j].contactResidue-1) * stride;
+		int f1 = (residueContacts[j+1].focusResidue-1) * stride, c1 = (residueContacts[j+1].contactResidue-1) * stride;
+		int f2 = (residueContacts[j+2].focusResidue-1) * stride, c2 = (residueContacts[j+2].contactResidue-1) * stride;
+		int f3 = (residueContacts[j+3].focusResidue-1) * stride, c3 = (residueContacts[j+3].contactResidue-1) * stride;
+
+		__m128 dx = _mm_sub_ps(_mm_setr_ps(x[c0], x[c1], x[c2], x[c3]), _mm_setr_ps(x[f0], x[f1], x[f2], x[f3]));
+		__m128 dy = _mm_sub_ps(_mm_setr_ps(y[c0], y[c1], y[c2], y[c3]), _mm_setr_ps(y[f0], y[f1], y[f2], y[f3]));
+		__m128 dz = _mm_sub_ps(_mm_setr_ps(z[c0], z[c1], z[c2], z[c3]), _mm_setr_ps(z[f0], z[f1], z[f2], z[f3]));
+
+		__m128d dxd = _mm_cvtps_pd(dx), dyd = _mm_cvtps_pd(dy), dzd = _mm_cvtps_pd(dz);
+		__m128d squared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dxd, dxd), _mm_mul_pd(dyd, dyd)), _mm_mul_pd(dzd, dzd));
+		int mask = _mm_movemask_pd(_mm_cmple_pd(squared, limit));
+
+		dxd = _mm_cvtps_pd(_mm_movehl_ps(dx, dx)), dyd = _mm_cvtps_pd(_mm_movehl_ps(dy, dy)), dzd = _mm_cvtps_pd(_mm_movehl_ps(dz, dz));
+		squared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dxd, dxd), _mm_mul_pd(dyd, dyd)), _mm_mul_pd(dzd, dzd));
+		mask |= _mm_movemask_pd(_mm_cmple_pd(squared, limit)) << 2;
+
+		if(contactStates != NULL) {
+			contactStates[j / 64] |= (uint64_t)mask << (j % 64);
+		}
+		qValue += __builtin_popcount(mask);
+	}
+
+	return qValue + scalarContactKernel(x, y, z, stride, blocks, contacts, residueContacts, threshold, contactStates);
+}
+
+/*
+*	Name: static void avx2Differences()
+*	Description: Gathers the coordinates of 8 contacts and takes their differences in float.
+*/
+
+__attribute__((target("avx2")))
+static inline void avx2Differences(const float *x, const float *y, const float *z, int stride, struct Contact *residueContacts, __m256 *dx, __m256 *dy, __m256 *dz) {
+	__m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	__m256i one = _mm256_set1_epi32(1);
+	__m256i strides = _mm256_set1_epi32(stride);
+
+	// Splits 8 (focusResidue, contactResidue) pairs into focus and contact indices
+	__m256i pairs0 = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i*) &residueContacts[0]), deinterleave);
+	__m256i pairs1 = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i*) &residueContacts[4]), deinterleave);
+	__m256i focus = _mm256_mullo_epi32(_mm256_sub_epi32(_mm256_permute2x128_si256(pairs0, pairs1, 0x20), one), strides);
+	__m256i contact = _mm256_mullo_epi32(_mm256_sub_epi32(_mm256_permute2x128_si256(pairs0, pairs1, 0x31), one), strides);
+
+	*dx = _mm256_sub_ps(_mm256_i32gather_ps(x, contact, 4), _mm256_i32gather_ps(x, focus, 4));
+	*dy = _mm256_sub_ps(_mm256_i32gather_ps(y, contact, 4), _mm256_i32gather_ps(y, focus, 4));
+	*dz = _mm256_sub_ps(_mm256_i32gather_ps(z, contact, 4), _mm256_i32gather_ps(z, focus, 4));
+}
+
+/*
+*	Name: static void avx2SquaredDistances()
+*	Description: Calculates the squared distances of 8 contacts, 4 in each result.
+*/
+
+__attribute__((target("avx2")))
+static inline void avx2SquaredDistances(const float *x, const float *y, const float *z, int stride, struct Contact *residueContacts, __m256d *squaredLow, __m256d *squaredHigh) {
+	__m256 dx, dy, dz;
+
+	avx2Differences(x, y, z, stride, residueContacts, &dx, &dy, &dz);
+
+	__m256d dxd = _mm256_cvtps_pd(_mm256_castps256_ps128(dx));
+	__m256d dyd = _mm256_cvtps_pd(_mm256_castps256_ps128(dy));
+	__m256d dzd = _mm256_cvtps_pd(_mm256_castps256_ps128(dz));
+	*squaredLow = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dxd, dxd), _mm256_mul_pd(dyd, dyd)), _mm256_mul_pd(dzd, dzd));
+
+	dxd = _mm256_cvtps_pd(_mm256_extractf128_ps(dx, 1));
+	dyd = _mm256_cvtps_pd(_mm256_extractf128_ps(dy, 1));
+	dzd = _mm256_cvtps_pd(_mm256_extractf128_ps(dz, 1));
+	*squaredHigh = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dxd, dxd), _mm256_mul_pd(dyd, dyd)), _mm256_mul_pd(dzd, dzd));
+}
+
+__attribute__((target("avx2")))
+static int avx2ContactKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, double threshold, uint64_t *contactStates) {
+	__m256d limit = _mm256_set1_pd(threshold);
+	int blocks = contacts / 8 * 8;
+	int qValue = 0;
+
+	for(int j = 0; j < blocks; j += 8) {
+		__m256d squaredLow, squaredHigh;
+
+		avx2SquaredDistances(x, y, z, stride, &residueContacts[j], &squaredLow, &squaredHigh);
+
+		int mask = _mm256_movemask_pd(_mm256_cmp_pd(squaredLow, limit, _CMP_LE_OQ));
+		mask |= _mm256_movemask_pd(_mm256_cmp_pd(squaredHigh, limit, _CMP_LE_OQ)) << 4;
+
+		if(contactStates != NULL) {
+			contactStates[j / 64] |= (uint64_t)mask << (j % 64);
+		}
+		qValue += __builtin_popcount(mask);
+	}
+
+	return qValue + scalarContactKernel(x, y, z, stride, blocks, contacts, residueContacts, threshold, contactStates);
+}
+
+__attribute__((target("avx2")))
+static void avx2ThresholdsKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, int thresholds, const double *threshold, int *qValues) {
+	int blocks = contacts / 8 * 8;
+
+	for(int k = 0; k < thresholds; k++) {
+		qValues[k] = 0;
+	}
+
+	for(int j = 0; j < blocks; j += 8) {
+		__m256d squaredLow, squaredHigh;
+
+		avx2SquaredDistances(x, y, z, stride, &residueContacts[j], &squaredLow, &squaredHigh);
+
+		// The distances are compared against every threshold without being recalculated
+		for(int k = 0; k < thresholds; k++) {
+			__m256d limit = _mm256_set1_pd(threshold[k]);
+			int mask = _mm256_movemask_pd(_mm256_cmp_pd(squaredLow, limit, _CMP_LE_OQ));
+			mask |= _mm256_movemask_pd(_mm256_cmp_pd(squaredHigh, limit, _CMP_LE_OQ)) << 4;
+
+			qValues[k] += __builtin_popcount(mask);
+		}
+	}
+
+	scalarThresholdsKernel(x, y, z, stride, blocks, contacts, residueContacts, thresholds, threshold, qValues);
+}
+
+/*
+*	Name: static __m256 avx2ApproximateExp()
+*	Description: calculateApproximateExp() of 8 floats.
+*/
+
+__attribute__((target("avx2")))
+static inline __m256 avx2ApproximateExp(__m256 x) {
+	x = _mm256_min_ps(x, _mm256_set1_ps(88.0f));
+	x = _mm256_max_ps(x, _mm256_set1_ps(-87.0f));
+
+	__m256 n = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)), _mm256_set1_ps(0.5f)));
+	x = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(0.693359375f)));
+	x = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(-2.12194440e-4f)));
+
+	__m256 polynomial = _mm256_set1_ps(1.9875691500e-4f);
+	polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, x), _mm256_set1_ps(1.3981999507e-3f));
+	polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, x), _mm256_set1_ps(8.3334519073e-3f));
+	polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, x), _mm256_set1_ps(4.1665795894e-2f));
+	polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, x), _mm256_set1_ps(1.6666665459e-1f));
+	polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, x), _mm256_set1_ps(5.0000001201e-1f));
+	polynomial = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(polynomial, _mm256_mul_ps(x, x)), x), _mm256_set1_ps(1.0f));
+
+	__m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n), _mm256_set1_epi32(127)), 23);
+
+	return _mm256_mul_ps(polynomial, _mm256_castsi256_ps(bits));
+}
+
+__attribute__((target("avx2")))
+static double avx2SmoothKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, const float *switchDistance, float beta) {
+	__m256 steepness = _mm256_set1_ps(beta);
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256d laneLow = _mm256_setzero_pd(), laneHigh = _mm256_setzero_pd();
+	int blocks = contacts / 8 * 8;
+	double lane[8], sum = 0.0;
+
+	for(int j = 0; j < blocks; j += 8) {
+		__m256 dx, dy, dz;
+
+		avx2Differences(x, y, z, stride, &residueContacts[j], &dx, &dy, &dz);
+
+		__m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)));
+		__m256 exponent = _mm256_mul_ps(steepness, _mm256_sub_ps(distance, _mm256_loadu_ps(&switchDistance[j])));
+		__m256 term = _mm256_div_ps(one, _mm256_add_ps(one, avx2ApproximateExp(exponent)));
+
+		laneLow = _mm256_add_pd(laneLow, _mm256_cvtps_pd(_mm256_castps256_ps128(term)));
+		laneHigh = _mm256_add_pd(laneHigh, _mm256_cvtps_pd(_mm256_extractf128_ps(term, 1)));
+	}
+
+	// The partial sums are added in lane order, the same as the scalar version
+	_mm256_storeu_pd(&lane[0], laneLow);
+	_mm256_storeu_pd(&lane[4], laneHigh);
+	for(int k = 0; k < 8; k++) {
+		sum += lane[k];
+	}
+
+	return sum + scalarSmoothKernel(x, y, z, stride, blocks, contacts, residueContacts, switchDistance, beta);
+}
+
+__attribute__((target("avx512f")))
+static int avx512ContactKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, double threshold, uint64_t *contactStates) {
+	__m512i evens = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+	__m512i odds = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+	__m512i one = _mm512_set1_epi32(1);
+	__m512i strides = _mm512_set1_epi32(stride);
+	__m512d limit = _mm512_set1_pd(threshold);
+	int blocks = contacts / 16 * 16;
+	int qValue = 0;
+
+	for(int j = 0; j < blocks; j += 16) {
+
+		// Splits 16 (focusResidue, contactResidue) pairs into focus and contact indices
+		__m512i pairs0 = _mm512_loadu_si512((void*) &residueContacts[j]);
+		__m512i pairs1 = _mm512_loadu_si512((void*) &residueContacts[j+8]);
+		__m512i focus = _mm512_mullo_epi32(_mm512_sub_epi32(_mm512_permutex2var_epi32(pairs0, evens, pairs1), one), strides);
+		__m512i contact = _mm512_mullo_epi32(_mm512_sub_epi32(_mm512_permutex2var_epi32(pairs0, odds, pairs1), one), strides);
+
+		__m512 dx = _mm512_sub_ps(_mm512_i32gather_ps(contact, x, 4), _mm512_i32gather_ps(focus, x, 4));
+		__m512 dy = _mm512_sub_ps(_mm512_i32gather_ps(contact, y, 4), _mm512_i32gather_ps(focus, y, 4));
+		__m512 dz = _mm512_sub_ps(_mm512_i32gather_ps(contact, z, 4), _mm512_i32gather_ps(focus, z, 4));
+
+		__m512d dxd = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_castpd512_pd256(_mm512_castps_pd(dx))));
+		__m512d dyd = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_castpd512_pd256(_mm512_castps_pd(dy))));
+		__m512d dzd = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_castpd512_pd256(_mm512_castps_pd(dz))));
+		__m512d squared = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dxd, dxd), _mm512_mul_pd(dyd, dyd)), _mm512_mul_pd(dzd, dzd));
+		int mask = (int) _mm512_cmp_pd_mask(squared, limit, _CMP_LE_OQ);
+
+		dxd = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(dx), 1)));
+		dyd = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(dy), 1)));
+		dzd = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(dz), 1)));
+		squared = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dxd, dxd), _mm512_mul_pd(dyd, dyd)), _mm512_mul_pd(dzd, dzd));
+		mask |= (int) _mm512_cmp_pd_mask(squared, limit, _CMP_LE_OQ) << 8;
+
+		if(contactStates != NULL) {
+			contactStates[j / 64] |= (uint64_t)mask << (j % 64);
+		}
+		qValue += __builtin_popcount(mask);
+	}
+
+	return qValue + scalarContactKernel(x, y, z, stride, blocks, contacts, residueContacts, threshold, contactStates);
+}
+
+#endif
@@ -0,0 +1,24 @@
+/*
+*	Name: contactKernel.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef CONTACT_KERNEL
+#define CONTACT_KERNEL
+
+#include <stdint.h>
+
+#include "../contactReader/contactReader.h"
+
+int calculateContactKernel(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, float cutoff, uint64_t *contactStates);
+void calculateContactKernelThresholds(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, int thresholds, const double *threshold, int *qValues);
+double calculateContactKernelSmooth(const float *x, const float *y, const float *z, int stride, int contacts, struct Contact *residueContacts, const float *switchDistance, float beta);
+float calculateApproximateExp(float x);
+double calculateCutoffThreshold(float cutoff);
+int setContactKernel(char *name);
+char* getContactKernelName();
+int64_t getContactEvaluations();
+
+#endif
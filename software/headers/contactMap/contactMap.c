@@ -0,0 +1,208 @@
+/*
+*	Name: contactMap.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Stores the contact states of every frame of a trajectory in a file, so Q range,
+*		time range and per-residue queries can be answered without reading the traj.xtc
+*		again.  The file holds a struct ContactMapHeader, the contact pairs from the
+*		contact file, then one bit per contact for every frame, packed into 64-bit
+*		words.  The header records the identity of the traj.xtc and contact file and
+*		the cutoff used, so an out of date map can be detected.  Maps are read with mmap.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactState/contactState.h"
+#include "contactMap.h"
+
+/*
+*	Name: int buildContactMap()
+*	Description: Reads the traj.xtc once and writes the contact states of every frame
+*		     to a contact map file.
+*
+*	Args: -char *xtcFile - location of the trajectory file to be read.
+*	      -char *contactFile - location of the contacts file.
+*	      -int residues - total number of residues in the protein.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -char *mapFile - location of the contact map file to be written.
+*
+*	Returns: -int xtcFrames - the amount of frames written to the contact map.
+*/
+
+int buildContactMap(char *xtcFile, char *contactFile, int residues, float cutoff, char *mapFile) {
+	struct ContactMapHeader header;
+	struct XtcStream *xtcStream;
+	struct ContactSet *contactSet;
+	struct Contact *residueContacts;
+	uint64_t *contactStates;
+	FILE *fp;
+
+	// The contacts are read once and checked before the traj.xtc is opened
+	contactSet = readContactSet(contactFile);
+	checkContactSetResidues(contactSet, residues);
+
+	int contacts = contactSet->contacts;
+	residueContacts = contactSet->residueContacts;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CONTACT_MAP_MAGIC, sizeof(header.magic));
+	header.version = CONTACT_MAP_VERSION;
+	header.contacts = contacts;
+	header.words = getContactStateWords(contacts);
+	header.residues = residues;
+	header.cutoff = cutoff;
+	header.xtcIdentity = getFileIdentity(xtcFile, 0);
+	header.contactIdentity = getFileIdentity(contactFile, 1);
+
+	if ((fp = fopen(mapFile, "wb")) == NULL) {
+		perror("could not open mapFile for output.");
+		exit(1);
+	}
+
+	// The frame count is written once the traj.xtc has been read
+	fwrite(&header, sizeof(header), 1, fp);
+	fwrite(residueContacts, sizeof(struct Contact), contacts, fp);
+
+	contactStates = allocateContactStatesMemory(1, contacts);
+	xtcStream = openXtcStream(xtcFile, residues);
+
+	// Writes the contact states of every frame as it is decoded
+	while(readXtcStreamFrame(xtcStream)) {
+		calculateContactStates(contacts, cutoff, xtcStream->frame, residueContacts, contactStates);
+		fwrite(contactStates, sizeof(uint64_t), header.words, fp);
+	}
+
+	header.frames = xtcStream->currentFrame;
+	closeXtcStream(xtcStream);
+
+	rewind(fp);
+	fwrite(&header, sizeof(header), 1, fp);
+
+	if (ferror(fp) || fclose(fp) != 0) {
+		perror("could not write mapFile.");
+		exit(1);
+	}
+
+	free(contactStates);
+	freeContactSet(contactSet);
+
+	return header.frames;
+}
+
+/*
+*	Name: struct ContactMap* openContactMap()
+*	Description: Maps a contact map file into memory.
+*
+*	Args: -char *mapFile - location of the contact map file.
+*
+*	Returns: -struct ContactMap *contactMap - header, contact pairs and contact states of
+*			every frame, pointing into the mapped file.
+*/
+
+struct ContactMap* openContactMap(char *mapFile) {
+	struct ContactMap *contactMap;
+	struct stat fileStat;
+	int fd;
+
+	if ((fd = open(mapFile, O_RDONLY)) < 0 || fstat(fd, &fileStat) != 0) {
+		perror("could not open mapFile for openContactMap().");
+		exit(1);
+	}
+
+	if ((size_t) fileStat.st_size < sizeof(struct ContactMapHeader)) {
+		printf("\n%s is not a contact map\n", mapFile);
+		exit(1);
+	}
+
+	contactMap = (struct ContactMap*) malloc(sizeof(struct ContactMap));
+	if(!contactMap) {
+		perror("contactMap memory not allocated");
+		abort();
+	}
+
+	contactMap->size = (size_t) fileStat.st_size;
+	contactMap->data = mmap(NULL, contactMap->size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (contactMap->data == MAP_FAILED) {
+		perror("could not mmap mapFile.");
+		exit(1);
+	}
+
+	contactMap->header = (struct ContactMapHeader*) contactMap->data;
+
+	if (memcmp(contactMap->header->magic, CONTACT_MAP_MAGIC, sizeof(contactMap->header->magic)) != 0 ||
+	    contactMap->header->version != CONTACT_MAP_VERSION) {
+		printf("\n%s is not a contact map\n", mapFile);
+		exit(1);
+	}
+
+	size_t expectedSize = sizeof(struct ContactMapHeader) +
+			sizeof(struct Contact) * (size_t) contactMap->header->contacts +
+			sizeof(uint64_t) * (size_t) contactMap->header->words * contactMap->header->frames;
+
+	if (contactMap->size != expectedSize) {
+		printf("\n%s is truncated or incomplete\n", mapFile);
+		exit(1);
+	}
+
+	contactMap->residueContacts = (struct Contact*) ((char*) contactMap->data + sizeof(struct ContactMapHeader));
+	contactMap->contactStates = (uint64_t*) (contactMap->residueContacts + contactMap->header->contacts);
+
+	// Access is mostly a linear scan over the frames
+	madvise(contactMap->data, contactMap->size, MADV_SEQUENTIAL);
+
+	return contactMap;
+}
+
+/*
+*	Name: int checkContactMap()
+*	Description: Checks that a contact map was built from the given traj.xtc, contact file
+*		     and cutoff.  The traj.xtc is compared by size and modification time only,
+*		     it is never decoded.
+*
+*	Args: -struct ContactMap *contactMap - the opened contact map.
+*	      -char *xtcFile - location of the trajectory file, or NULL to skip the check.
+*	      -char *contactFile - location of the contacts file, or NULL to skip the check.
+*	      -float cutoff - the expected cutoff, or a negative value to skip the check.
+*
+*	Returns: -int - 1 if the contact map matches, otherwise 0.
+*/
+
+int checkContactMap(struct ContactMap *contactMap, char *xtcFile, char *contactFile, float cutoff) {
+	if (xtcFile != NULL && !compareFileIdentity(contactMap->header->xtcIdentity, getFileIdentity(xtcFile, 0))) {
+		return 0;
+	}
+
+	if (contactFile != NULL && !compareFileIdentity(contactMap->header->contactIdentity, getFileIdentity(contactFile, 1))) {
+		return 0;
+	}
+
+	if (cutoff >= 0 && contactMap->header->cutoff != cutoff) {
+		return 0;
+	}
+
+	return 1;
+}
+
+/*
+*	Name: void closeContactMap()
+*	Description:	Unmaps the contact map file and frees the map.
+*
+*	Args: -struct ContactMap *contactMap - map from openContactMap.
+*/
+
+void closeContactMap(struct ContactMap *contactMap) {
+	munmap(contactMap->data, contactMap->size);
+	free(contactMap);
+}
@@ -0,0 +1,45 @@
+/*
+*	Name: contactMap.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef CONTACT_MAP
+#define CONTACT_MAP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../contactReader/contactReader.h"
+#include "../fileIdentity/fileIdentity.h"
+
+#define CONTACT_MAP_MAGIC "QCMAP\0\0\0"
+#define CONTACT_MAP_VERSION 2
+
+struct ContactMapHeader {
+	char magic[8];
+	int32_t version;
+	int32_t frames;
+	int32_t contacts;
+	int32_t words;
+	int32_t residues;
+	float cutoff;
+	struct FileIdentity xtcIdentity;
+	struct FileIdentity contactIdentity;
+};
+
+struct ContactMap {
+	void *data;
+	size_t size;
+	struct ContactMapHeader *header;
+	struct Contact *residueContacts;
+	uint64_t *contactStates;
+};
+
+int buildContactMap(char *xtcFile, char *contactFile, int residues, float cutoff, char *mapFile);
+struct ContactMap* openContactMap(char *mapFile);
+int checkContactMap(struct ContactMap *contactMap, char *xtcFile, char *contactFile, float cutoff);
+void closeContactMap(struct ContactMap *contactMap);
+
+#endif
@@ -2,7 +2,7 @@
 *	Name: contactReader.c
 *	Author: Thomas Dahlstrom
 *	Date: Mar. 25, 2020
-*	Updated: Mar. 26, 2020
+*	Updated: Oct. 17, 2026
 *
 *	Summary of expected functionality:
 *		Provides functions to read a contact file created from http://smog-server.org/.
@@ -13,9 +13,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "contactReader.h"
 
+static int scanContactInt(const char **c, const char *end, int *value);
 
 /*
 *	Name: int getAmountOfContacts()
@@ -27,21 +32,10 @@
 */
 
 int getAmountOfContacts(char *contactfile) {
-	int contacts, iTemp;
-	FILE *fp;
+	struct ContactSet *contactSet = readContactSet(contactfile);
+	int contacts = contactSet->contacts;
 
-	// Opens file
-	if ((fp = fopen(contactfile, "r")) == NULL) {
-		perror("could not open contactFile for getAmountOfContacts().");
-		exit(1);
-	}
-
-	// Reads number of contacts and omits other value
-	fscanf(fp, "%i", &contacts);
-	fscanf(fp, "%i", &iTemp);
-
-	// Closes file
-	fclose(fp);
+	freeContactSet(contactSet);
 
 	return contacts;
 }
@@ -56,37 +50,160 @@ int getAmountOfContacts(char *contactfile) {
 */
 
 struct Contact* getContactFileContacts(char *contactfile) {
-	struct Contact *residueContacts;
-	int contacts, iTemp;
-	FILE *fp;
+	struct ContactSet *contactSet = readContactSet(contactfile);
+	struct Contact *residueContacts = contactSet->residueContacts;
+
+	free(contactSet);
+
+	return residueContacts;
+}
+
+/*
+*	Name: struct ContactSet* readContactSet()
+*	Description:	Reads the amount of contacts and every contact pair from the contact
+*			file in one pass.  The file is mapped into memory and the integers are
+*			scanned by hand, so a run reads the contact file once.
+*
+*	Args: -char *contactFile - location of the contacts file.
+*
+*	Returns: -struct ContactSet *contactSet - the amount of contacts and the contact pairs.
+*/
+
+struct ContactSet* readContactSet(char *contactFile) {
+	struct ContactSet *contactSet;
+	struct stat status;
+	const char *c, *end;
+	char *map;
+	int fd, iTemp;
 
 	// Opens file
-	if ((fp = fopen(contactfile, "r")) == NULL) {
-		perror("could not open contactFile for getContactFileContacts().");
+	if ((fd = open(contactFile, O_RDONLY)) < 0 || fstat(fd, &status) != 0) {
+		perror("could not open contactFile for readContactSet().");
 		exit(1);
 	}
 
+	if (status.st_size == 0) {
+		printf("\n%s is empty\n", contactFile);
+		exit(1);
+	}
+
+	map = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		perror("could not map contactFile for readContactSet().");
+		exit(1);
+	}
+
+	close(fd);
+
+	contactSet = (struct ContactSet*) malloc(sizeof(struct ContactSet));
+	if(!contactSet) {
+		perror("contactSet memory not allocated");
+		abort();
+	}
+
+	c = map;
+	end = map + status.st_size;
+
 	// Reads number of contacts and omits other value
-	fscanf(fp, "%i", &contacts);
-	fscanf(fp, "%i", &iTemp);
+	if (!scanContactInt(&c, end, &contactSet->contacts) || !scanContactInt(&c, end, &iTemp) ||
+	    contactSet->contacts < 0) {
+		printf("\n%s does not start with the amount of contacts\n", contactFile);
+		exit(1);
+	}
 
 	// Allocate memory for the coordinates from the contactfile
-	residueContacts = (struct Contact*) malloc(sizeof(struct Contact) * contacts);
-	if(!residueContacts) {
+	contactSet->residueContacts = (struct Contact*) malloc(sizeof(struct Contact) * (contactSet->contacts > 0 ? contactSet->contacts : 1));
+	if(!contactSet->residueContacts) {
 		perror("contactFile memory not allocated");
 		abort();
 	}
 
 	// Reads the focused residue and contact residue while omitting other values
-	for(int i = 0; i < contacts; i++) {
-		fscanf(fp, "%i", &iTemp);
-		fscanf(fp, "%i", &residueContacts[i].focusResidue);
-		fscanf(fp, "%i", &iTemp);
-		fscanf(fp, "%i", &residueContacts[i].contactResidue);
+	for(int i = 0; i < contactSet->contacts; i++) {
+		if (!scanContactInt(&c, end, &iTemp) || !scanContactInt(&c, end, &contactSet->residueContacts[i].focusResidue) ||
+		    !scanContactInt(&c, end, &iTemp) || !scanContactInt(&c, end, &contactSet->residueContacts[i].contactResidue)) {
+			printf("\n%s ends at contact %d of %d\n", contactFile, i + 1, contactSet->contacts);
+			exit(1);
+		}
 	}
 
-	// Closes file
-	fclose(fp);
+	munmap(map, status.st_size);
 
-	return residueContacts;
+	return contactSet;
+}
+
+/*
+*	Name: void checkContactSetResidues()
+*	Description:	Stops the program when a contact names a residue outside of the
+*			protein, before any frame is read.  residues has already been checked
+*			against the atoms of the trajectory by openXtcStream().
+*
+*	Args: -struct ContactSet *contactSet - from readContactSet().
+*	      -int residues - total number of residues in the protein.
+*/
+
+void checkContactSetResidues(struct ContactSet *contactSet, int residues) {
+	for(int i = 0; i < contactSet->contacts; i++) {
+		struct Contact *contact = &contactSet->residueContacts[i];
+
+		if (contact->focusResidue < 1 || contact->focusResidue > residues ||
+		    contact->contactResidue < 1 || contact->contactResidue > residues) {
+			printf("\nContact %d (%d %d) is outside of the %d residues\n", i + 1, contact->focusResidue, contact->contactResidue, residues);
+			exit(1);
+		}
+	}
+}
+
+/*
+*	Name: void freeContactSet()
+*	Description:	Frees a contact set and its contacts.
+*
+*	Args: -struct ContactSet *contactSet - set from readContactSet.
+*/
+
+void freeContactSet(struct ContactSet *contactSet) {
+	free(contactSet->residueContacts);
+	free(contactSet);
+}
+
+/*
+*	Name: static int scanContactInt()
+*	Description:	Reads the next decimal integer, skipping white space before it.
+*
+*	Returns: -int found - 1 if an integer was read, 0 at the end of the file or at text
+*			that is not an integer.
+*/
+
+static int scanContactInt(const char **c, const char *end, int *value) {
+	const char *p = *c;
+	int negative = 0;
+	long number = 0;
+
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+		p++;
+	}
+
+	if (p < end && (*p == '-' || *p == '+')) {
+		negative = *p++ == '-';
+	}
+
+	if (p == end || *p < '0' || *p > '9') {
+		return 0;
+	}
+
+	while (p < end && *p >= '0' && *p <= '9') {
+		if (number <= 2147483647L) {
+			number = number * 10 + (*p - '0');
+		}
+		p++;
+	}
+
+	if (number > 2147483647L) {
+		return 0;
+	}
+
+	*value = (int)(negative ? -number : number);
+	*c = p;
+
+	return 1;
 }
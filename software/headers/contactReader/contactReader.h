@@ -13,8 +13,16 @@ struct Contact {
 	int contactResidue;
 };
 
+// The contact file parsed once and shared by every analysis of a run
+struct ContactSet {
+	int contacts;
+	struct Contact *residueContacts;
+};
 
 int getAmountOfContacts(char *contactfile);
 struct Contact* getContactFileContacts(char *contactfile);
+struct ContactSet* readContactSet(char *contactFile);
+void checkContactSetResidues(struct ContactSet *contactSet, int residues);
+void freeContactSet(struct ContactSet *contactSet);
 
 #endif
@@ -0,0 +1,205 @@
+/*
+*	Name: contactState.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Evaluates every contact of a frame once and records the result as a bit vector;
+*		bit j of a frame is set when contact j of the contact file is within the cutoff.
+*		The Q value of a frame is the amount of set bits, and the occurrences of each
+*		contact are read from the same bits, so no distance is calculated twice.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../calcQFromContacts/calcQFromContacts.h"
+#include "../contactKernel/contactKernel.h"
+#include "contactState.h"
+
+/*
+*	Name: int calculateContactStates()
+*	Description: Sets the bit of every contact present in a single frame.
+*
+*	Args: -int contacts - the amount of contacts in the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -struct XtcCoordinates *frame - residue coordinates of one frame.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -uint64_t *contactStates - getContactStateWords(contacts) words, overwritten.
+*
+*	Returns: -int qValue - the amount of contacts present in the frame.
+*/
+
+int calculateContactStates(int contacts, float cutoff, struct XtcCoordinates *frame, struct Contact *residueContacts, uint64_t *contactStates) {
+	int words = getContactStateWords(contacts);
+
+	for(int i = 0; i < words; i++) {
+		contactStates[i] = 0;
+	}
+
+	// Sets the bit of every contact pair within the cutoff value, see contactKernel.c
+	return calculateContactKernel(&frame[0].x, &frame[0].y, &frame[0].z, 3, contacts, residueContacts, cutoff, contactStates);
+}
+
+/*
+*	Name: uint64_t* calculateTrajectoryContactStates()
+*	Description: Calculates the contact states of every frame from the traj.xtc.
+*
+*	Args: -int xtcFrames - the amount of frames in the traj.xtc file.
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -struct XtcCoordinates **xtcResidueCoordinates - frame data and residue coordinates from
+*							       the traj.xtc file.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*
+*	Returns: -uint64_t *contactStates - getContactStateWords(contacts) words for each frame.
+*/
+
+uint64_t* calculateTrajectoryContactStates(int xtcFrames, int contacts, float cutoff, struct XtcCoordinates **xtcResidueCoordinates, struct Contact *residueContacts) {
+	uint64_t *contactStates = allocateContactStatesMemory(xtcFrames, contacts);
+	int words = getContactStateWords(contacts);
+
+	for(int i = 0; i < xtcFrames; i++) {
+		calculateContactStates(contacts, cutoff, xtcResidueCoordinates[i], residueContacts, &contactStates[(size_t)i * words]);
+	}
+
+	return contactStates;
+}
+
+/*
+*	Name: int calculateTrajectoryFrameContactStates()
+*	Description: Same as calculateContactStates(), for one frame of a struct XtcTrajectory.
+*
+*	Args: -struct XtcTrajectory *trajectory - residue coordinates of every frame.
+*	      -int frame - index of the frame, starting at 0.
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -uint64_t *contactStates - getContactStateWords(contacts) words, overwritten.
+*
+*	Returns: -int qValue - the amount of contacts present in the frame.
+*/
+
+int calculateTrajectoryFrameContactStates(struct XtcTrajectory *trajectory, int frame, int contacts, float cutoff, struct Contact *residueContacts, uint64_t *contactStates) {
+	size_t offset = (size_t) frame * trajectory->stride;
+	int words = getContactStateWords(contacts);
+
+	for(int i = 0; i < words; i++) {
+		contactStates[i] = 0;
+	}
+
+	return calculateContactKernel(&trajectory->x[offset], &trajectory->y[offset], &trajectory->z[offset], 1, contacts, residueContacts, cutoff, contactStates);
+}
+
+/*
+*	Name: uint64_t* calculateContactStatesFromTrajectory()
+*	Description: Same as calculateTrajectoryContactStates(), for coordinates stored in a
+*		     struct XtcTrajectory.
+*
+*	Returns: -uint64_t *contactStates - getContactStateWords(contacts) words for each frame.
+*/
+
+uint64_t* calculateContactStatesFromTrajectory(struct XtcTrajectory *trajectory, int contacts, float cutoff, struct Contact *residueContacts) {
+	uint64_t *contactStates = allocateContactStatesMemory(trajectory->frames, contacts);
+	int words = getContactStateWords(contacts);
+
+	for(int i = 0; i < trajectory->frames; i++) {
+		calculateTrajectoryFrameContactStates(trajectory, i, contacts, cutoff, residueContacts, &contactStates[(size_t)i * words]);
+	}
+
+	return contactStates;
+}
+
+/*
+*	Name: int* calculateQValuesFromContactStates()
+*	Description: Derives the Q value of every frame from its contact states.
+*
+*	Args: -int xtcFrames - the amount of frames in the traj.xtc file.
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -uint64_t *contactStates - contact states of every frame.
+*
+*	Returns: -int *qValues - a Q value for each frame of the traj.xtc.
+*/
+
+int* calculateQValuesFromContactStates(int xtcFrames, int contacts, uint64_t *contactStates) {
+	int *qValues = allocateQValuesMemory(xtcFrames);
+	int words = getContactStateWords(contacts);
+
+	for(int i = 0; i < xtcFrames; i++) {
+		qValues[i] = countContactStates(contacts, &contactStates[(size_t)i * words]);
+	}
+
+	return qValues;
+}
+
+/*
+*	Name: int countContactStates()
+*	Description: Counts the contacts present in one frame's contact states.
+*
+*	Args: -int contacts - the amount of contacts in the contacts file.
+*	      -uint64_t *contactStates - contact states of one frame.
+*
+*	Returns: -int qValue - the amount of set bits.
+*/
+
+int countContactStates(int contacts, uint64_t *contactStates) {
+	int words = getContactStateWords(contacts);
+	int qValue = 0;
+
+	for(int i = 0; i < words; i++) {
+		qValue += __builtin_popcountll(contactStates[i]);
+	}
+
+	return qValue;
+}
+
+/*
+*	Name: int getContactState()
+*	Description:	Whether a contact is formed in the states of one frame.
+*
+*	Args: -uint64_t *contactStates - the state words of the frame.
+*	      -int contact - index of the contact, starting at 0.
+*
+*	Returns: -int state - 1 if the contact is formed, else 0.
+*/
+
+int getContactState(uint64_t *contactStates, int contact) {
+	return (contactStates[contact / CONTACT_STATE_BITS] >> (contact % CONTACT_STATE_BITS)) & 1;
+}
+
+/*
+*	Name: int getContactStateWords()
+*	Description:	The amount of 64 bit words holding the states of one frame.
+*
+*	Args: -int contacts - the amount of contacts.
+*
+*	Returns: -int words - words per frame.
+*/
+
+int getContactStateWords(int contacts) {
+	return (contacts + CONTACT_STATE_BITS - 1) / CONTACT_STATE_BITS;
+}
+
+/*
+*	Name: uint64_t* allocateContactStatesMemory()
+*	Description:	Allocates the contact states of every frame, every contact not
+*			formed.
+*
+*	Args: -int xtcFrames - the amount of frames.
+*	      -int contacts - the amount of contacts.
+*
+*	Returns: -uint64_t *contactStates - getContactStateWords(contacts) words per frame.
+*/
+
+uint64_t* allocateContactStatesMemory(int xtcFrames, int contacts) {
+	uint64_t *contactStates;
+
+	contactStates = (uint64_t*) calloc((size_t)xtcFrames * getContactStateWords(contacts), sizeof(uint64_t));
+	if(!contactStates) {
+		perror("contactStates memory not allocated");
+		abort();
+	}
+
+	return contactStates;
+}
@@ -0,0 +1,28 @@
+/*
+*	Name: contactState.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef CONTACT_STATE
+#define CONTACT_STATE
+
+#include <stdint.h>
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactReader/contactReader.h"
+
+#define CONTACT_STATE_BITS 64
+
+int calculateContactStates(int contacts, float cutoff, struct XtcCoordinates *frame, struct Contact *residueContacts, uint64_t *contactStates);
+uint64_t* calculateTrajectoryContactStates(int xtcFrames, int contacts, float cutoff, struct XtcCoordinates **xtcResidueCoordinates, struct Contact *residueContacts);
+int calculateTrajectoryFrameContactStates(struct XtcTrajectory *trajectory, int frame, int contacts, float cutoff, struct Contact *residueContacts, uint64_t *contactStates);
+uint64_t* calculateContactStatesFromTrajectory(struct XtcTrajectory *trajectory, int contacts, float cutoff, struct Contact *residueContacts);
+int* calculateQValuesFromContactStates(int xtcFrames, int contacts, uint64_t *contactStates);
+int countContactStates(int contacts, uint64_t *contactStates);
+int getContactState(uint64_t *contactStates, int contact);
+int getContactStateWords(int contacts);
+uint64_t* allocateContactStatesMemory(int xtcFrames, int contacts);
+
+#endif
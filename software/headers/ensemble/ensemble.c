@@ -0,0 +1,237 @@
+/*
+*	Name: ensemble.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Dependencies: pthreads
+*
+*	Summary of expected functionality:
+*		Runs the occupancy table of calculateOccupancyTableFromStream() over every
+*		replica trajectory of a simulation set, for example all of the
+*		4FAK_<T>K_<NN>_{A,B,C} folders made by run_simulation_set.csh.  Replicas are
+*		claimed by threads from a shared counter; with more threads than replicas each
+*		replica is also split over several threads.  The occurrences and frames in range
+*		of every replica are then added together, so the combined probabilities are
+*		those of one trajectory holding every replica's frames.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <glob.h>
+
+#include "../xtcReader/xtcReader.h"
+#include "../threadedAnalysis/threadedAnalysis.h"
+#include "ensemble.h"
+
+struct EnsembleAnalysis {
+	struct Ensemble *ensemble;
+	int residues;
+	int contacts;
+	struct Contact *residueContacts;
+	int windows;
+	struct OccupancyWindow *window;
+	float cutOff;
+	int stride;
+	int replicaThreads;
+	atomic_int nextReplica;
+};
+
+static void* analyseReplicas(void *arg);
+
+/*
+*	Name: struct Ensemble* calculateEnsembleOccupancy()
+*	Description: Counts the occurrences of every contact in every window for each replica
+*		     trajectory, then adds the replicas together and calculates the
+*		     probabilities of the combined and of every single replica.
+*
+*	Args: -int replicas - the amount of replica trajectories
+*	      -char **xtcFile - location of every replica traj.xtc, from expandXtcFiles();
+*				not copied, freed by freeEnsemble()
+*	      -int residues - the amount of residues in the protein
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -int windows - the amount of windows
+*	      -struct OccupancyWindow *window - Q value and time slice range of each window
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*	      -int stride - use every stride-th frame of each replica
+*	      -int threads - the amount of threads
+*
+*	Returns: -struct Ensemble *ensemble - the table of every replica and the combined table
+*/
+
+struct Ensemble* calculateEnsembleOccupancy(int replicas, char **xtcFile, int residues, int contacts, struct Contact *residueContacts, int windows, struct OccupancyWindow *window, float cutOff, int stride, int threads) {
+	struct Ensemble *ensemble = (struct Ensemble*) malloc(sizeof(struct Ensemble));
+	struct EnsembleAnalysis analysis;
+	int workers = threads < replicas ? threads : replicas;
+
+	if(!ensemble) {
+		perror("ensemble memory not allocated");
+		abort();
+	}
+
+	ensemble->replicas = replicas;
+	ensemble->xtcFile = xtcFile;
+	ensemble->replicaTable = (struct OccupancyTable**) calloc(replicas, sizeof(struct OccupancyTable*));
+	if(!ensemble->replicaTable) {
+		perror("replicaTable memory not allocated");
+		abort();
+	}
+
+	analysis.ensemble = ensemble;
+	analysis.residues = residues;
+	analysis.contacts = contacts;
+	analysis.residueContacts = residueContacts;
+	analysis.windows = windows;
+	analysis.window = window;
+	analysis.cutOff = cutOff;
+	analysis.stride = stride;
+	analysis.replicaThreads = workers > 0 ? threads / workers : 1;
+	atomic_init(&analysis.nextReplica, 0);
+
+	pthread_t *worker = (pthread_t*) malloc(sizeof(pthread_t) * (workers > 0 ? workers : 1));
+	if(!worker) {
+		perror("worker memory not allocated");
+		abort();
+	}
+
+	for(int t = 0; t < workers; t++) {
+		if(pthread_create(&worker[t], NULL, analyseReplicas, &analysis) != 0) {
+			perror("could not create ensemble thread");
+			exit(1);
+		}
+	}
+
+	for(int t = 0; t < workers; t++) {
+		pthread_join(worker[t], NULL);
+	}
+
+	free(worker);
+
+	// Sums of counts are exact, so the order the replicas finished in does not matter
+	ensemble->table = allocateOccupancyTable(windows, window, contacts, residueContacts);
+	for(int r = 0; r < replicas; r++) {
+		addOccupancyTable(ensemble->table, ensemble->replicaTable[r]);
+	}
+
+	calculateOccupancyTableProbabilities(ensemble->table);
+
+	return ensemble;
+}
+
+static void* analyseReplicas(void *arg) {
+	struct EnsembleAnalysis *analysis = (struct EnsembleAnalysis*) arg;
+	struct Ensemble *ensemble = analysis->ensemble;
+	int r;
+
+	while((r = atomic_fetch_add(&analysis->nextReplica, 1)) < ensemble->replicas) {
+		struct XtcStream *stream = openXtcStream(ensemble->xtcFile[r], analysis->residues);
+		setXtcStreamStride(stream, analysis->stride);
+
+		if(analysis->replicaThreads > 1) {
+			ensemble->replicaTable[r] = calculateOccupancyTableThreaded(stream, analysis->contacts, analysis->residueContacts,
+					analysis->windows, analysis->window, analysis->cutOff, analysis->replicaThreads);
+		} else {
+			ensemble->replicaTable[r] = calculateOccupancyTableFromStream(stream, analysis->contacts, analysis->residueContacts,
+					analysis->windows, analysis->window, analysis->cutOff);
+		}
+
+		closeXtcStream(stream);
+	}
+
+	return NULL;
+}
+
+/*
+*	Name: void writeEnsemble()
+*	Description: Writes the combined occupancy table, then the table of every replica.
+*		     Each table starts with a "## replica" line naming its trajectory; the
+*		     combined table is replica 0.
+*
+*	Args: -FILE *fp - destination, for example stdout
+*	      -struct Ensemble *ensemble - from calculateEnsembleOccupancy()
+*	      -int residues - the amount of residues in the protein
+*/
+
+void writeEnsemble(FILE *fp, struct Ensemble *ensemble, int residues) {
+	for(int r = 0; r <= ensemble->replicas; r++) {
+		struct OccupancyTable *table = r == 0 ? ensemble->table : ensemble->replicaTable[r-1];
+		struct ContactAverages *contactAverages = calculateOccupancyTableAverages(table, residues);
+
+		if(r == 0) {
+			fprintf(fp, "## replica 0 all %d replicas\n", ensemble->replicas);
+		} else {
+			fprintf(fp, "## replica %d %s\n", r, ensemble->xtcFile[r-1]);
+		}
+
+		writeOccupancyTable(fp, table, contactAverages, residues);
+
+		free(contactAverages);
+	}
+}
+
+/*
+*	Name: char** expandXtcFiles()
+*	Description: Expands shell style patterns, for example "4FAK_*K_*_A/4FAK*.xtc", to
+*		     the trajectories they match, sorted by name.  A pattern matching nothing
+*		     is kept as it is, so a missing file is reported when it is opened.
+*
+*	Args: -int patterns - the amount of patterns
+*	      -char **pattern - trajectory locations or patterns
+*	      -int *xtcFiles - set to the amount of trajectories
+*
+*	Returns: -char **xtcFile - location of every trajectory
+*/
+
+char** expandXtcFiles(int patterns, char **pattern, int *xtcFiles) {
+	glob_t matches;
+	char **xtcFile;
+
+	for(int p = 0; p < patterns; p++) {
+		if(glob(pattern[p], GLOB_NOCHECK | (p > 0 ? GLOB_APPEND : 0), NULL, &matches) != 0) {
+			printf("\nCould not expand %s\n", pattern[p]);
+			exit(1);
+		}
+	}
+
+	*xtcFiles = patterns > 0 ? (int) matches.gl_pathc : 0;
+
+	xtcFile = (char**) malloc(sizeof(char*) * (*xtcFiles > 0 ? *xtcFiles : 1));
+	if(!xtcFile) {
+		perror("xtcFile memory not allocated");
+		abort();
+	}
+
+	for(int i = 0; i < *xtcFiles; i++) {
+		xtcFile[i] = strdup(matches.gl_pathv[i]);
+	}
+
+	if(patterns > 0) {
+		globfree(&matches);
+	}
+
+	return xtcFile;
+}
+
+/*
+*	Name: void freeEnsemble()
+*	Description:	Frees the table of every replica, the combined table, the names of
+*			the trajectories and the ensemble.
+*
+*	Args: -struct Ensemble *ensemble - ensemble from calculateEnsembleOccupancy.
+*/
+
+void freeEnsemble(struct Ensemble *ensemble) {
+	for(int r = 0; r < ensemble->replicas; r++) {
+		freeOccupancyTable(ensemble->replicaTable[r]);
+		free(ensemble->xtcFile[r]);
+	}
+
+	free(ensemble->replicaTable);
+	free(ensemble->xtcFile);
+	freeOccupancyTable(ensemble->table);
+	free(ensemble);
+}
@@ -0,0 +1,29 @@
+/*
+*	Name: ensemble.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef ENSEMBLE
+#define ENSEMBLE
+
+#include <stdio.h>
+
+#include "../contactReader/contactReader.h"
+#include "../occupancyTable/occupancyTable.h"
+
+// The counts of every replica trajectory and their sum
+struct Ensemble {
+	int replicas;
+	char **xtcFile;
+	struct OccupancyTable **replicaTable;
+	struct OccupancyTable *table;
+};
+
+struct Ensemble* calculateEnsembleOccupancy(int replicas, char **xtcFile, int residues, int contacts, struct Contact *residueContacts, int windows, struct OccupancyWindow *window, float cutOff, int stride, int threads);
+void writeEnsemble(FILE *fp, struct Ensemble *ensemble, int residues);
+char** expandXtcFiles(int patterns, char **pattern, int *xtcFiles);
+void freeEnsemble(struct Ensemble *ensemble);
+
+#endif
@@ -0,0 +1,160 @@
+/*
+*	Name: fileIdentity.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Identifies an input file by its size, modification time and, optionally, a
+*		64-bit FNV-1a hash of its contents.  Files derived from a trajectory or a
+*		contact file record the identity so they can tell when they are out of date.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "fileIdentity.h"
+
+/*
+*	Name: struct FileIdentity getFileIdentity()
+*	Description: Reads the size and modification time of a file, in seconds and
+*		     nanoseconds.
+*
+*	Args: -char *file - location of the file.
+*	      -int hashContents - if non-zero, the contents of the file are also hashed;
+*				  otherwise identity.hash is 0.
+*
+*	Returns: -struct FileIdentity identity - size, modification time and hash of the file.
+*/
+
+struct FileIdentity getFileIdentity(char *file, int hashContents) {
+	struct FileIdentity identity;
+	struct stat fileStat;
+
+	if(stat(file, &fileStat) != 0) {
+		perror("could not stat file for getFileIdentity().");
+		exit(1);
+	}
+
+	identity.size = (int64_t) fileStat.st_size;
+	identity.modified = (int64_t) fileStat.st_mtim.tv_sec;
+	identity.modifiedNanoseconds = (int64_t) fileStat.st_mtim.tv_nsec;
+	identity.hash = hashContents ? hashFileContents(file) : 0;
+
+	return identity;
+}
+
+/*
+*	Name: int compareFileIdentity()
+*	Description: Compares two file identities.
+*
+*	Returns: -int - 1 if size, modification time and hash are equal, otherwise 0.
+*/
+
+int compareFileIdentity(struct FileIdentity identity1, struct FileIdentity identity2) {
+	return identity1.size == identity2.size && identity1.modified == identity2.modified &&
+	       identity1.modifiedNanoseconds == identity2.modifiedNanoseconds && identity1.hash == identity2.hash;
+}
+
+/*
+*	Name: uint64_t hashFileContents()
+*	Description: Hashes the contents of a file with 64-bit FNV-1a.
+*
+*	Args: -char *file - location of the file.
+*
+*	Returns: -uint64_t hash - hash of every byte of the file.
+*/
+
+uint64_t hashFileContents(char *file) {
+	unsigned char buffer[65536];
+	uint64_t hash = FILE_IDENTITY_HASH_SEED;
+	size_t length;
+	FILE *fp;
+
+	if ((fp = fopen(file, "rb")) == NULL) {
+		perror("could not open file for hashFileContents().");
+		exit(1);
+	}
+
+	while((length = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+		hash = hashBytes(hash, buffer, length);
+	}
+
+	fclose(fp);
+
+	return hash;
+}
+
+/*
+*	Name: uint64_t hashFileSample()
+*	Description: Hashes the first and last sample bytes of a file with 64-bit FNV-1a, or
+*		     every byte if the file is shorter than twice that.  Used for files too
+*		     large to hash on every run, such as a traj.xtc.
+*
+*	Args: -char *file - location of the file.
+*	      -int64_t sample - bytes hashed at each end of the file.
+*
+*	Returns: -uint64_t hash - hash of the sampled bytes.
+*/
+
+uint64_t hashFileSample(char *file, int64_t sample) {
+	unsigned char buffer[65536];
+	uint64_t hash = FILE_IDENTITY_HASH_SEED;
+	int64_t size, remaining;
+	size_t length;
+	FILE *fp;
+
+	if ((fp = fopen(file, "rb")) == NULL) {
+		perror("could not open file for hashFileSample().");
+		exit(1);
+	}
+
+	fseeko(fp, 0, SEEK_END);
+	size = (int64_t) ftello(fp);
+	rewind(fp);
+
+	if (size <= 2 * sample) {
+		fclose(fp);
+		return hashFileContents(file);
+	}
+
+	for(int end = 0; end < 2; end++) {
+		if (end == 1) {
+			fseeko(fp, (off_t) (size - sample), SEEK_SET);
+		}
+
+		remaining = sample;
+		while(remaining > 0 && (length = fread(buffer, 1, remaining < (int64_t) sizeof(buffer) ? (size_t) remaining : sizeof(buffer), fp)) > 0) {
+			hash = hashBytes(hash, buffer, length);
+			remaining -= length;
+		}
+	}
+
+	fclose(fp);
+
+	return hash;
+}
+
+/*
+*	Name: uint64_t hashBytes()
+*	Description: Continues a 64-bit FNV-1a hash over a block of memory.
+*
+*	Args: -uint64_t hash - FILE_IDENTITY_HASH_SEED, or the result of a previous call.
+*	      -const void *bytes - memory to hash.
+*	      -size_t length - amount of bytes to hash.
+*
+*	Returns: -uint64_t hash - the updated hash.
+*/
+
+uint64_t hashBytes(uint64_t hash, const void *bytes, size_t length) {
+	const unsigned char *data = (const unsigned char*) bytes;
+
+	for(size_t i = 0; i < length; i++) {
+		hash ^= data[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
@@ -0,0 +1,30 @@
+/*
+*	Name: fileIdentity.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef FILE_IDENTITY
+#define FILE_IDENTITY
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FILE_IDENTITY_HASH_SEED 14695981039346656037ULL
+
+struct FileIdentity {
+	int64_t size;
+	int64_t modified;
+	// A file rewritten within the same second still has another modification time
+	int64_t modifiedNanoseconds;
+	uint64_t hash;
+};
+
+struct FileIdentity getFileIdentity(char *file, int hashContents);
+int compareFileIdentity(struct FileIdentity identity1, struct FileIdentity identity2);
+uint64_t hashFileContents(char *file);
+uint64_t hashFileSample(char *file, int64_t sample);
+uint64_t hashBytes(uint64_t hash, const void *bytes, size_t length);
+
+#endif
@@ -0,0 +1,119 @@
+/*
+*	Name: followQ.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Calculates the Q values of a traj.xtc while mdrun is still writing it.  Every
+*		new frame is read with followXtcStreamFrame() once all of it is on disk, and
+*		its Q value is appended to the qFile and flushed right away, so the qFile can
+*		be watched while the simulation runs.  Frames already in the qFile are not
+*		calculated again; following the same trajectory and qFile later continues
+*		after the last complete line.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../calcQFromContacts/calcQFromContacts.h"
+#include "followQ.h"
+
+/*
+*	Name: int followQValues()
+*	Description: Appends the Q values of new frames to the qFile until the time range of
+*		     the stream is finished or the trajectory stops growing for idle seconds.
+*		     The lines match writeQFile(), writeQFileCutoffs() or writeSmoothQFile().
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -int cutoffs - the amount of cutoff values.
+*	      -float *cutoff - the cutoff values; one column is written per cutoff.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -struct SmoothQ *smoothQ - if not NULL, the fractional Q is written instead and the
+*				cutoffs are not used.
+*	      -char *qFile - the file name where Q values will be appended.
+*	      -float poll - seconds between checks of the trajectory.
+*	      -float idle - stop after this many seconds without a new frame; 0 never stops.
+*
+*	Returns: -int frames - the amount of frames in the qFile.
+*/
+
+int followQValues(struct XtcStream *stream, int contacts, int cutoffs, float *cutoff, struct Contact *residueContacts, struct SmoothQ *smoothQ, char *qFile, float poll, float idle) {
+	int frames = countQFileFrames(qFile);
+	double *threshold = calculateCutoffThresholds(cutoffs, cutoff);
+	int *qValues = allocateQValuesMemory(cutoffs);
+	FILE *fp;
+
+	// The frames already in the qFile are passed over without being decompressed
+	stream->firstFrame = nextXtcStreamFrame(stream) + frames * stream->stride;
+
+	if ((fp = fopen(qFile, "a")) == NULL) {
+		perror("could not open qFile for output.");
+		exit(1);
+	}
+
+	while(followXtcStreamFrame(stream, poll, idle)) {
+		if(smoothQ) {
+			fprintf(fp, "%.6f\n", calculateFrameSmoothQValue(smoothQ, stream->frame, residueContacts));
+		} else if(cutoffs > 1) {
+			calculateFrameQValueCutoffs(contacts, cutoffs, threshold, stream->frame, residueContacts, qValues);
+
+			for(int k = 0; k < cutoffs; k++) {
+				fprintf(fp, k == 0 ? "%i" : " %i", qValues[k]);
+			}
+			fprintf(fp, "\n");
+		} else {
+			fprintf(fp, "%i\n", calculateFrameQValue(contacts, cutoff[0], stream->frame, residueContacts));
+		}
+
+		// Every line is complete on disk before the next frame is waited for
+		fflush(fp);
+		frames++;
+	}
+
+	fclose(fp);
+	free(threshold);
+	free(qValues);
+
+	return frames;
+}
+
+/*
+*	Name: int countQFileFrames()
+*	Description: Counts the complete lines of a qFile.  A last line without a newline,
+*		     left by a run that was stopped while writing, is removed.
+*
+*	Args: -char *qFile - a qFile written by followQValues(); it may not exist yet.
+*
+*	Returns: -int frames - the amount of Q values in the qFile.
+*/
+
+int countQFileFrames(char *qFile) {
+	long length = 0, complete = 0;
+	int frames = 0, c;
+	FILE *fp;
+
+	if ((fp = fopen(qFile, "r")) == NULL) {
+		return 0;
+	}
+
+	while((c = fgetc(fp)) != EOF) {
+		length++;
+
+		if(c == '\n') {
+			complete = length;
+			frames++;
+		}
+	}
+
+	fclose(fp);
+
+	if(complete != length && truncate(qFile, complete) != 0) {
+		perror("could not remove the partial line of qFile.");
+		exit(1);
+	}
+
+	return frames;
+}
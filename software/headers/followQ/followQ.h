@@ -0,0 +1,21 @@
+/*
+*	Name: followQ.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef FOLLOW_Q
+#define FOLLOW_Q
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactReader/contactReader.h"
+#include "../smoothQ/smoothQ.h"
+
+// Seconds between checks of a trajectory that has no new frame yet
+#define FOLLOW_Q_POLL 1.0f
+
+int followQValues(struct XtcStream *stream, int contacts, int cutoffs, float *cutoff, struct Contact *residueContacts, struct SmoothQ *smoothQ, char *qFile, float poll, float idle);
+int countQFileFrames(char *qFile);
+
+#endif
@@ -0,0 +1,609 @@
+/*
+*	Name: mdLog.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Reads energies from the md.log of a Gromacs run by their labels, in place of
+*		the awk and grep of mdtoen.csh.  Every energy block of the log follows a line of
+*		"Step Time" values, and is pairs of lines: labels in fields of MD_LOG_FIELD
+*		characters, then their values.  The log is mapped into memory and only the step
+*		and energy lines are copied out.  The labels are matched once and again only
+*		when they change, and only the values of the labels asked for are parsed, so
+*		logs of many gigabytes are read at the speed of the disk.  Reading stops at
+*		the averages at the end of the log.
+*		The step of every energy is kept, so the energies can be joined to the frames
+*		of a traj.xtc by step, whatever nstlog and nstxout were.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mdLog.h"
+
+// A line of labels of an energy block, kept until a block has other labels
+struct MdLogLabels {
+	char text[MD_LOG_LINE];
+	int fields;
+	int term[MD_LOG_LINE / MD_LOG_FIELD + 1];
+};
+
+struct MdLogStep {
+	int64_t step;
+	int frame;
+};
+
+static const char* copyMdLogLine(const char *c, const char *end, char *line);
+static int isBlankMdLogLine(char *line);
+static void setMdLogLabels(struct MdLogLabels *labelLine, char *labels, int terms, char **label);
+static void printMdLogLabels(struct MdLogLabels *labelLine, int lines);
+static char* trimMdLogField(char *field);
+static void addMdLogEnergies(struct MdLogEnergies *energies, int *capacity, int64_t step, double time, double *value);
+static void sortMdLogEnergies(struct MdLogEnergies *energies, char *logFile);
+static int compareMdLogSteps(const void *a, const void *b);
+
+/*
+*	Name: char** parseEnergyLabels()
+*	Description: Reads a list of energy labels separated by commas, "Potential,LJ (SR)".
+*
+*	Args: -char *value - the argument holding the labels
+*	      -int *labels - set to the amount of labels
+*
+*	Returns: -char **label - every label, in the order given
+*/
+
+char** parseEnergyLabels(char *value, int *labels) {
+	char *copy = strdup(value), *next = copy;
+	char **label;
+	int capacity = 1;
+
+	for(char *c = value; *c; c++) {
+		capacity += *c == ',';
+	}
+
+	label = (char**) malloc(sizeof(char*) * capacity);
+	if(!copy || !label) {
+		perror("label memory not allocated");
+		abort();
+	}
+
+	*labels = 0;
+	for(char *field = strsep(&next, ","); field != NULL; field = strsep(&next, ",")) {
+		field = trimMdLogField(field);
+
+		if (*field == '\0') {
+			printf("\nEnergy labels must be separated by commas, for example Potential,LJ (SR)\n");
+			exit(1);
+		}
+
+		label[(*labels)++] = strdup(field);
+	}
+
+	free(copy);
+
+	return label;
+}
+
+/*
+*	Name: struct MdLogEnergies* readMdLogEnergies()
+*	Description: Reads the step, time and energies of every energy block of an md.log.
+*		     A log appended to by a restarted run repeats the steps since the
+*		     checkpoint; the energies written last are kept.
+*
+*	Args: -char *logFile - the md.log of a run
+*	      -int terms - the amount of energies to read
+*	      -char **label - the label of every energy as md.log writes it, "LJ (SR)"
+*
+*	Returns: -struct MdLogEnergies *energies - the energies in increasing step order
+*/
+
+struct MdLogEnergies* readMdLogEnergies(char *logFile, int terms, char **label) {
+	struct MdLogEnergies *energies = (struct MdLogEnergies*) malloc(sizeof(struct MdLogEnergies));
+	char line[MD_LOG_LINE], labels[MD_LOG_LINE], values[MD_LOG_LINE];
+	double *value = (double*) malloc(sizeof(double) * terms);
+	struct MdLogLabels *labelLine = (struct MdLogLabels*) calloc(MD_LOG_LABEL_LINES, sizeof(struct MdLogLabels));
+	const char *c, *end;
+	struct stat status;
+	int fd, capacity = 0, stepFound = 0;
+	long long step = 0;
+	double time = 0.0;
+	char *map;
+
+	if(!energies || !value || !labelLine) {
+		perror("energies memory not allocated");
+		abort();
+	}
+
+	if ((fd = open(logFile, O_RDONLY)) < 0 || fstat(fd, &status) != 0) {
+		printf("\nCould not open %s\n", logFile);
+		exit(1);
+	}
+
+	if (status.st_size == 0) {
+		printf("\n%s is empty\n", logFile);
+		exit(1);
+	}
+
+	map = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		perror("could not map logFile for readMdLogEnergies().");
+		exit(1);
+	}
+
+	close(fd);
+	madvise(map, status.st_size, MADV_SEQUENTIAL);
+
+	energies->terms = terms;
+	energies->label = label;
+	energies->frames = 0;
+	energies->step = NULL;
+	energies->time = NULL;
+	energies->energy = NULL;
+
+	c = map;
+	end = map + status.st_size;
+
+	while(c < end) {
+		const char *eol = memchr(c, '\n', end - c);
+		const char *s = c;
+
+		eol = eol ? eol : end;
+		while(s < eol && (*s == ' ' || *s == '\t')) {
+			s++;
+		}
+
+		// Most lines of the log are neither steps nor energies, and are not copied
+		if (eol - s >= 4 && memcmp(s, "Step", 4) == 0) {
+			c = copyMdLogLine(c, end, line);
+
+			if (strstr(line, "Time") != NULL) {
+				char *stepEnd, *timeEnd;
+
+				c = copyMdLogLine(c, end, line);
+				step = strtoll(line, &stepEnd, 10);
+				time = strtod(stepEnd, &timeEnd);
+				stepFound = stepEnd != line && timeEnd != stepEnd;
+			}
+		} else if (eol - s >= 17 && memcmp(s, "Energies (kJ/mol)", 17) == 0) {
+			int lines = 0;
+
+			c = copyMdLogLine(c, end, line);
+
+			for(int t = 0; t < terms; t++) {
+				value[t] = NAN;
+			}
+
+			// Pairs of a line of labels and a line of values, up to an empty line
+			for(c = copyMdLogLine(c, end, labels); !isBlankMdLogLine(labels); c = copyMdLogLine(c, end, labels)) {
+				c = copyMdLogLine(c, end, values);
+
+				if (lines == MD_LOG_LABEL_LINES) {
+					continue;
+				}
+
+				struct MdLogLabels *current = &labelLine[lines++];
+				int fields = current->fields;
+				char *v = values, *number;
+
+				if (strcmp(current->text, labels) != 0) {
+					setMdLogLabels(current, labels, terms, label);
+					fields = current->fields;
+				}
+
+				// Values are in fields as wide as their labels; otherwise read them in turn
+				int fixed = strlen(values) >= (size_t) fields * MD_LOG_FIELD - 1;
+
+				for(int f = 0; f < fields; f++) {
+					if (fixed && current->term[f] < 0) {
+						continue;
+					}
+
+					double energy = strtod(fixed ? &values[f * MD_LOG_FIELD] : v, &number);
+
+					if (number == (fixed ? &values[f * MD_LOG_FIELD] : v)) {
+						printf("\nThe energies of step %lld of %s are missing values\n", step, logFile);
+						exit(1);
+					}
+
+					v = number;
+
+					if (current->term[f] >= 0) {
+						value[current->term[f]] = energy;
+					}
+				}
+			}
+
+			for(int t = 0; t < terms; t++) {
+				if (isnan(value[t])) {
+					printf("\n%s has no energy called \"%s\" at step %lld, it has:", logFile, label[t], step);
+					printMdLogLabels(labelLine, lines);
+					exit(1);
+				}
+			}
+
+			if (stepFound) {
+				addMdLogEnergies(energies, &capacity, step, time, value);
+				stepFound = 0;
+			}
+		} else if (eol > s && *s == '<' && copyMdLogLine(c, end, line) && strstr(line, "A V E R A G E S") != NULL) {
+			break;
+		} else {
+			c = eol < end ? eol + 1 : end;
+		}
+	}
+
+	munmap(map, status.st_size);
+	free(value);
+	free(labelLine);
+
+	if (energies->frames == 0) {
+		printf("\n%s holds no energies\n", logFile);
+		exit(1);
+	}
+
+	sortMdLogEnergies(energies, logFile);
+
+	return energies;
+}
+
+/*
+*	Name: int findMdLogStep()
+*	Description: Finds the energies of a step.
+*
+*	Args: -struct MdLogEnergies *energies - from readMdLogEnergies()
+*	      -int64_t step - the step, for example of a traj.xtc frame
+*
+*	Returns: -int frame - the energies of the step are energy[frame * terms], -1 if the
+*			      step has no energies
+*/
+
+int findMdLogStep(struct MdLogEnergies *energies, int64_t step) {
+	int low = 0, high = energies->frames - 1;
+
+	while(low <= high) {
+		int middle = low + (high - low) / 2;
+
+		if (energies->step[middle] == step) {
+			return middle;
+		} else if (energies->step[middle] < step) {
+			low = middle + 1;
+		} else {
+			high = middle - 1;
+		}
+	}
+
+	return -1;
+}
+
+/*
+*	Name: int isMdLogFile()
+*	Description: Tells an md.log from a file of energies by its first line.  An md.log
+*		     starts with text, while the energy files of mdtoen.csh, gmx energy and
+*		     energyTableProg start with a number or a '#' or '@' comment.
+*
+*	Args: -char *file - an md.log or a file of energies
+*
+*	Returns: -int - 1 if the file starts like an md.log, otherwise 0
+*/
+
+int isMdLogFile(char *file) {
+	char line[MD_LOG_LINE];
+	int found = 0;
+	FILE *fp;
+
+	if ((fp = fopen(file, "r")) == NULL) {
+		printf("\nCould not open %s\n", file);
+		exit(1);
+	}
+
+	while(fgets(line, sizeof(line), fp) != NULL) {
+		char *c = line + strspn(line, " \t\r\n"), *end;
+
+		if (*c == '\0') {
+			continue;
+		}
+
+		strtod(c, &end);
+		found = end == c && *c != '#' && *c != '@';
+		break;
+	}
+
+	fclose(fp);
+
+	return found;
+}
+
+/*
+*	Name: int writeEnergyTable()
+*	Description: Writes a row for every frame of a traj.xtc with its step, time, Q value
+*		     and the energies of its step, N/A if md.log has none.  Without a frame
+*		     index a row is written for every step of md.log instead.
+*
+*	Args: -FILE *fp - destination, for example stdout
+*	      -struct MdLogEnergies *energies - from readMdLogEnergies()
+*	      -struct XtcFrameIndex *index - steps and times of the frames, or NULL
+*	      -int frames - the amount of rows; every frame when no Q values are given
+*	      -double *qValue - the Q value of every row, or NULL
+*	      -int firstFrame - the frame of the first row, starting at 0
+*	      -int stride - the frames between rows
+*
+*	Returns: -int missing - the amount of rows without energies
+*/
+
+int writeEnergyTable(FILE *fp, struct MdLogEnergies *energies, struct XtcFrameIndex *index, int frames, double *qValue, int firstFrame, int stride) {
+	int terms = energies->terms, missing = 0;
+
+	if (!index) {
+		fprintf(fp, "# step time");
+		for(int t = 0; t < terms; t++) {
+			fprintf(fp, " \"%s\"", energies->label[t]);
+		}
+
+		fprintf(fp, "\n");
+
+		for(int i = 0; i < energies->frames; i++) {
+			fprintf(fp, "%lld %g", (long long) energies->step[i], energies->time[i]);
+
+			for(int t = 0; t < terms; t++) {
+				fprintf(fp, " %.5e", energies->energy[(size_t)i * terms + t]);
+			}
+
+			fprintf(fp, "\n");
+		}
+
+		return 0;
+	}
+
+	fprintf(fp, "# frame step time%s", qValue ? " Q" : "");
+	for(int t = 0; t < terms; t++) {
+		fprintf(fp, " \"%s\"", energies->label[t]);
+	}
+
+	fprintf(fp, "\n");
+
+	for(int i = 0; i < frames; i++) {
+		int frame = firstFrame + i * stride;
+
+		if (frame >= index->frames) {
+			printf("\nThe Q values go on after the last frame, %d, of the trajectory\n", index->frames);
+			exit(1);
+		}
+
+		int row = findMdLogStep(energies, index->steps[frame]);
+
+		fprintf(fp, "%d %d %g", frame + 1, index->steps[frame], index->times[frame]);
+
+		if (qValue) {
+			fprintf(fp, " %g", qValue[i]);
+		}
+
+		for(int t = 0; t < terms; t++) {
+			if (row >= 0) {
+				fprintf(fp, " %.5e", energies->energy[(size_t)row * terms + t]);
+			} else {
+				fprintf(fp, " N/A");
+			}
+		}
+
+		fprintf(fp, "\n");
+		missing += row < 0;
+	}
+
+	return missing;
+}
+
+/*
+*	Name: void freeMdLogEnergies()
+*	Description:	Frees the energies and labels read from a log.
+*
+*	Args: -struct MdLogEnergies *energies - energies from readMdLogEnergies.
+*/
+
+void freeMdLogEnergies(struct MdLogEnergies *energies) {
+	for(int t = 0; t < energies->terms; t++) {
+		free(energies->label[t]);
+	}
+
+	free(energies->label);
+	free(energies->step);
+	free(energies->time);
+	free(energies->energy);
+	free(energies);
+}
+
+/*
+*	Name: static const char* copyMdLogLine()
+*	Description: Copies the line at c without its end of line, cut to MD_LOG_LINE - 1
+*		     characters.  At the end of the log the line is empty.
+*
+*	Args: -const char *c - the start of the line in the mapped log
+*	      -const char *end - the end of the mapped log
+*	      -char *line - MD_LOG_LINE characters
+*
+*	Returns: -const char *next - the start of the next line
+*/
+
+static const char* copyMdLogLine(const char *c, const char *end, char *line) {
+	const char *eol = c < end ? memchr(c, '\n', end - c) : NULL;
+	size_t length;
+
+	eol = eol ? eol : end;
+	length = eol - c < MD_LOG_LINE - 1 ? eol - c : MD_LOG_LINE - 1;
+
+	memcpy(line, c, length);
+	line[length] = '\0';
+
+	if (length > 0 && line[length-1] == '\r') {
+		line[length-1] = '\0';
+	}
+
+	return eol < end ? eol + 1 : end;
+}
+
+static int isBlankMdLogLine(char *line) {
+	return line[strspn(line, " \t")] == '\0';
+}
+
+/*
+*	Name: static void setMdLogLabels()
+*	Description: Splits a line of labels into its fields, and finds the energy asked for
+*		     in each field.
+*
+*	Args: -struct MdLogLabels *labelLine - set to the labels
+*	      -char *labels - a line of labels of an energy block
+*	      -int terms - the amount of energies asked for
+*	      -char **label - the label of every energy asked for
+*/
+
+static void setMdLogLabels(struct MdLogLabels *labelLine, char *labels, int terms, char **label) {
+	int length;
+
+	strcpy(labelLine->text, labels);
+
+	for(length = strlen(labels); length > 0 && labels[length-1] == ' '; length--);
+	labelLine->fields = (length + MD_LOG_FIELD - 1) / MD_LOG_FIELD;
+
+	for(int f = 0; f < labelLine->fields; f++) {
+		char fieldLabel[MD_LOG_FIELD + 1];
+		char *field;
+
+		strncpy(fieldLabel, &labels[f * MD_LOG_FIELD], MD_LOG_FIELD);
+		fieldLabel[MD_LOG_FIELD] = '\0';
+		field = trimMdLogField(fieldLabel);
+
+		labelLine->term[f] = -1;
+		for(int t = 0; t < terms; t++) {
+			if (strcmp(field, label[t]) == 0) {
+				labelLine->term[f] = t;
+			}
+		}
+	}
+}
+
+// Lists the labels of an energy block after a message
+static void printMdLogLabels(struct MdLogLabels *labelLine, int lines) {
+	for(int l = 0; l < lines; l++) {
+		for(int f = 0; f < labelLine[l].fields; f++) {
+			char fieldLabel[MD_LOG_FIELD + 1];
+
+			strncpy(fieldLabel, &labelLine[l].text[f * MD_LOG_FIELD], MD_LOG_FIELD);
+			fieldLabel[MD_LOG_FIELD] = '\0';
+			printf("%s %s", l + f > 0 ? "," : "", trimMdLogField(fieldLabel));
+		}
+	}
+
+	printf("\n");
+}
+
+// Removes the spaces around a label
+static char* trimMdLogField(char *field) {
+	char *last;
+
+	field += strspn(field, " \t");
+	for(last = field + strlen(field); last > field && (last[-1] == ' ' || last[-1] == '\t'); last--);
+	*last = '\0';
+
+	return field;
+}
+
+static void addMdLogEnergies(struct MdLogEnergies *energies, int *capacity, int64_t step, double time, double *value) {
+	int terms = energies->terms;
+
+	if (energies->frames == *capacity) {
+		*capacity = *capacity ? *capacity * 2 : 4096;
+		energies->step = (int64_t*) realloc(energies->step, sizeof(int64_t) * *capacity);
+		energies->time = (double*) realloc(energies->time, sizeof(double) * *capacity);
+		energies->energy = (double*) realloc(energies->energy, sizeof(double) * *capacity * terms);
+		if(!energies->step || !energies->time || !energies->energy) {
+			perror("energies memory not allocated");
+			abort();
+		}
+	}
+
+	energies->step[energies->frames] = step;
+	energies->time[energies->frames] = time;
+	memcpy(&energies->energy[(size_t)energies->frames * terms], value, sizeof(double) * terms);
+	energies->frames++;
+}
+
+/*
+*	Name: static void sortMdLogEnergies()
+*	Description: Puts the energies in increasing step order, keeping the energies written
+*		     last of a step written more than once.  Does nothing to a log whose
+*		     steps only increase.
+*
+*	Args: -struct MdLogEnergies *energies - from readMdLogEnergies()
+*	      -char *logFile - the md.log, named in the message about repeated steps
+*/
+
+static void sortMdLogEnergies(struct MdLogEnergies *energies, char *logFile) {
+	int terms = energies->terms, frames = 0, sorted = 1;
+
+	for(int i = 1; i < energies->frames && sorted; i++) {
+		sorted = energies->step[i] > energies->step[i-1];
+	}
+
+	if (sorted) {
+		return;
+	}
+
+	struct MdLogStep *order = (struct MdLogStep*) malloc(sizeof(struct MdLogStep) * energies->frames);
+	int64_t *step = (int64_t*) malloc(sizeof(int64_t) * energies->frames);
+	double *time = (double*) malloc(sizeof(double) * energies->frames);
+	double *energy = (double*) malloc(sizeof(double) * energies->frames * terms);
+	if(!order || !step || !time || !energy) {
+		perror("energies memory not allocated");
+		abort();
+	}
+
+	for(int i = 0; i < energies->frames; i++) {
+		order[i].step = energies->step[i];
+		order[i].frame = i;
+	}
+
+	// Equal steps stay in the order they were written, the last one is kept
+	qsort(order, energies->frames, sizeof(struct MdLogStep), compareMdLogSteps);
+
+	for(int i = 0; i < energies->frames; i++) {
+		if (i + 1 < energies->frames && order[i+1].step == order[i].step) {
+			continue;
+		}
+
+		step[frames] = order[i].step;
+		time[frames] = energies->time[order[i].frame];
+		memcpy(&energy[(size_t)frames * terms], &energies->energy[(size_t)order[i].frame * terms], sizeof(double) * terms);
+		frames++;
+	}
+
+	if (frames < energies->frames) {
+		fprintf(stderr, "%s writes the energies of %d steps again, those written last are used\n", logFile, energies->frames - frames);
+	}
+
+	free(order);
+	free(energies->step);
+	free(energies->time);
+	free(energies->energy);
+
+	energies->frames = frames;
+	energies->step = step;
+	energies->time = time;
+	energies->energy = energy;
+}
+
+static int compareMdLogSteps(const void *a, const void *b) {
+	const struct MdLogStep *step1 = (const struct MdLogStep*) a;
+	const struct MdLogStep *step2 = (const struct MdLogStep*) b;
+
+	if (step1->step != step2->step) {
+		return (step1->step > step2->step) - (step1->step < step2->step);
+	}
+
+	return step1->frame - step2->frame;
+}
@@ -0,0 +1,41 @@
+/*
+*	Name: mdLog.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef MD_LOG
+#define MD_LOG
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "../xtcReader/xtcReader.h"
+
+// Gromacs writes every energy label and value of md.log in a field this wide
+#define MD_LOG_FIELD 15
+
+#define MD_LOG_LINE 4096
+
+// Lines of labels of an energy block that are read
+#define MD_LOG_LABEL_LINES 16
+
+// The energies of every step written to md.log, in increasing step order
+struct MdLogEnergies {
+	int terms;
+	char **label;
+	int frames;
+	int64_t *step;
+	double *time;
+	double *energy;
+};
+
+char** parseEnergyLabels(char *value, int *labels);
+struct MdLogEnergies* readMdLogEnergies(char *logFile, int terms, char **label);
+int findMdLogStep(struct MdLogEnergies *energies, int64_t step);
+int isMdLogFile(char *file);
+int writeEnergyTable(FILE *fp, struct MdLogEnergies *energies, struct XtcFrameIndex *index, int frames, double *qValue, int firstFrame, int stride);
+void freeMdLogEnergies(struct MdLogEnergies *energies);
+
+#endif
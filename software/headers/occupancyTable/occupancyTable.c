@@ -0,0 +1,383 @@
+/*
+*	Name: occupancyTable.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Counts contact occurrences for many windows of Q values and time slices in one
+*		pass over the traj.xtc.  Every frame is evaluated once; its Q value and contact
+*		states are then added to every window the frame falls in.  A window gives the
+*		same probabilities as a run of probabilityContactInQValueRangeProg with its Q
+*		range and time slice range, and the same per-residue averages as
+*		averageContactProbabilityInQValueRangeProg.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "../calcQFromContacts/calcQFromContacts.h"
+#include "../contactState/contactState.h"
+#include "../residueGraph/residueGraph.h"
+#include "occupancyTable.h"
+
+/*
+*	Name: struct OccupancyTable* calculateOccupancyTableFromStream()
+*	Description: Counts the occurrences of every contact in every window from an open
+*		     traj.xtc stream, then calculates the probabilities.  Frames outside of all
+*		     time windows are never decoded.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -int windows - the amount of windows
+*	      -struct OccupancyWindow *window - Q value and time slice range of each window
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*
+*	Returns: -struct OccupancyTable *table - occurrences and probabilities of every contact
+*				in every window
+*/
+
+struct OccupancyTable* calculateOccupancyTableFromStream(struct XtcStream *stream, int contacts, struct Contact *residueContacts, int windows, struct OccupancyWindow *window, float cutOff) {
+	struct OccupancyTable *table = allocateOccupancyTable(windows, window, contacts, residueContacts);
+
+	// Frames outside of every time window are skipped by the reader
+	setXtcStreamTimeRange(stream, getOccupancyTimeRange(windows, window));
+
+	countOccupancyTableFromStream(stream, table, cutOff);
+
+	calculateOccupancyTableProbabilities(table);
+
+	return table;
+}
+
+/*
+*	Name: void countOccupancyTableFromStream()
+*	Description: Adds the frames left in an open traj.xtc stream to the occurrences of a
+*		     table.  The time range and stride of the stream are followed; the
+*		     probabilities are not calculated.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -struct OccupancyTable *table - the table being counted
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*/
+
+void countOccupancyTableFromStream(struct XtcStream *stream, struct OccupancyTable *table, float cutOff) {
+	int xtcFrames;
+
+	free(countOccupancyTableQValuesFromStream(stream, table, cutOff, &xtcFrames));
+}
+
+/*
+*	Name: int* countOccupancyTableQValuesFromStream()
+*	Description: Same as countOccupancyTableFromStream(), also keeping the Q value of every
+*		     frame read.  The Q values are the same as calculateQValuesFromStream() with
+*		     the same stream, so the qFile and the table come from one pass.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -struct OccupancyTable *table - the table being counted
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*	      -int *xtcFrames - set to the amount of frames read from the stream
+*
+*	Returns: -int *qValues - a Q value for each frame read from the traj.xtc
+*/
+
+int* countOccupancyTableQValuesFromStream(struct XtcStream *stream, struct OccupancyTable *table, float cutOff, int *xtcFrames) {
+	uint64_t *contactStates = allocateContactStatesMemory(1, table->contacts);
+	int capacity = 1024, frames = 0;
+	int *qValues = allocateQValuesMemory(capacity);
+
+	// For every frame decoded from the traj.xtc file
+	while(readXtcStreamFrame(stream)) {
+		if(frames == capacity) {
+			capacity *= 2;
+			qValues = (int*) realloc(qValues, sizeof(int) * capacity);
+			if(!qValues) {
+				perror("qValues memory not allocated");
+				abort();
+			}
+		}
+
+		qValues[frames] = calculateContactStates(table->contacts, cutOff, stream->frame, table->residueContacts, contactStates);
+
+		addOccupancyTableFrame(table, stream->currentFrame-1, qValues[frames++], contactStates);
+	}
+
+	free(contactStates);
+
+	*xtcFrames = frames;
+
+	return qValues;
+}
+
+/*
+*	Name: void addOccupancyTableFrame()
+*	Description: Adds one evaluated frame to every window it falls in.
+*
+*	Args: -struct OccupancyTable *table - the table being counted
+*	      -int frame - the frame, starting at 0
+*	      -int qValue - the Q value of the frame
+*	      -uint64_t *contactStates - contact states of the frame
+*/
+
+void addOccupancyTableFrame(struct OccupancyTable *table, int frame, int qValue, uint64_t *contactStates) {
+	for(int w = 0; w < table->windows; w++) {
+		struct OccupancyWindow *window = &table->window[w];
+
+		// If the time step and the Q value are within the window
+		if((frame >= (window->timeRange.low-1)) && (frame <= (window->timeRange.high-1)) &&
+		   qValue >= window->qRange.low && qValue <= window->qRange.high) {
+			addContactStateOccurrences(table->contacts, contactStates, &table->contactInformation[(size_t)w * table->contacts]);
+			table->qValuesInRange[w]++;
+		}
+	}
+}
+
+/*
+*	Name: void addOccupancyTable()
+*	Description: Adds the occurrences and frames in range of one table to another with
+*		     the same windows and contacts.  The probabilities are not recalculated.
+*
+*	Args: -struct OccupancyTable *table - the table being added to
+*	      -struct OccupancyTable *other - the counted table being added
+*/
+
+void addOccupancyTable(struct OccupancyTable *table, struct OccupancyTable *other) {
+	for(int w = 0; w < table->windows; w++) {
+		for(int j = 0; j < table->contacts; j++) {
+			size_t i = (size_t)w * table->contacts + j;
+			table->contactInformation[i].totalOccurrences += other->contactInformation[i].totalOccurrences;
+		}
+
+		table->qValuesInRange[w] += other->qValuesInRange[w];
+	}
+}
+
+/*
+*	Name: void calculateOccupancyTableProbabilities()
+*	Description:	Turns the occurrences counted in every window into probabilities.
+*
+*	Args: -struct OccupancyTable *table - a table with every frame counted.
+*/
+
+void calculateOccupancyTableProbabilities(struct OccupancyTable *table) {
+	for(int w = 0; w < table->windows; w++) {
+		calculateProbabilities(table->contacts, &table->contactInformation[(size_t)w * table->contacts], table->qValuesInRange[w]);
+	}
+}
+
+/*
+*	Name: struct ContactAverages* calculateOccupancyTableAverages()
+*	Description: Calculates the average contact probability of every residue in every
+*		     window, the same way as averageContactProbabilityInQValueRangeProg.
+*
+*	Args: -struct OccupancyTable *table - a table with probabilities calculated
+*	      -int residues - the amount of residues in the protein
+*
+*	Returns: -struct ContactAverages *contactAverages - one row of residues per window
+*/
+
+struct ContactAverages* calculateOccupancyTableAverages(struct OccupancyTable *table, int residues) {
+	struct ContactAverages *contactAverages = (struct ContactAverages*) malloc(sizeof(struct ContactAverages) * residues * table->windows);
+	if(!contactAverages) {
+		perror("contactAverages memory not allocated");
+		abort();
+	}
+
+	// Every window has the same contacts, so the graph is built once
+	struct ResidueGraph *residueGraph = createResidueGraph(residues, table->contacts, table->residueContacts);
+
+	for(int w = 0; w < table->windows; w++) {
+		struct ContactAverages *windowAverages = calculateResidueGraphAverages(residueGraph, &table->contactInformation[(size_t)w * table->contacts]);
+
+		for(int i = 0; i < residues; i++) {
+			contactAverages[(size_t)w * residues + i] = windowAverages[i];
+		}
+
+		free(windowAverages);
+	}
+
+	freeResidueGraph(residueGraph);
+
+	return contactAverages;
+}
+
+/*
+*	Name: void writeOccupancyTable()
+*	Description: Writes the windows, then a row for every contact and a row for every
+*		     residue.  Each row has one column group per window.  Lines starting with
+*		     '#' describe the columns.
+*
+*	Args: -FILE *fp - destination, for example stdout
+*	      -struct OccupancyTable *table - a table with probabilities calculated
+*	      -struct ContactAverages *contactAverages - from calculateOccupancyTableAverages()
+*	      -int residues - the amount of residues in the protein
+*/
+
+void writeOccupancyTable(FILE *fp, struct OccupancyTable *table, struct ContactAverages *contactAverages, int residues) {
+	fprintf(fp, "# window qLow qHigh tsLow tsHigh framesInRange\n");
+	for(int w = 0; w < table->windows; w++) {
+		fprintf(fp, "# %d %d %d %d %d %d\n", w+1, table->window[w].qRange.low, table->window[w].qRange.high,
+			table->window[w].timeRange.low, table->window[w].timeRange.high, table->qValuesInRange[w]);
+	}
+
+	fprintf(fp, "# contact focusResidue contactResidue {probability occurrences} per window\n");
+	for(int i = 0; i < table->contacts; i++) {
+		fprintf(fp, "%d %d %d", i+1, table->contactInformation[i].focusResidue, table->contactInformation[i].contactResidue);
+
+		for(int w = 0; w < table->windows; w++) {
+			struct ContactInformation *information = &table->contactInformation[(size_t)w * table->contacts + i];
+			fprintf(fp, " %f %d", information->probability, information->totalOccurrences);
+		}
+
+		fprintf(fp, "\n");
+	}
+
+	fprintf(fp, "# residue {averageProbability} per window\n");
+	for(int i = 0; i < residues; i++) {
+		fprintf(fp, "%d", i+1);
+
+		for(int w = 0; w < table->windows; w++) {
+			if(contactAverages[(size_t)w * residues + i].averageProbability != -1.0) {
+				fprintf(fp, " %f", contactAverages[(size_t)w * residues + i].averageProbability);
+			} else {
+				fprintf(fp, " N/A");
+			}
+		}
+
+		fprintf(fp, "\n");
+	}
+}
+
+/*
+*	Name: struct OccupancyWindow* createOccupancyWindows()
+*	Description: Creates a window for every pair of a Q bin and a time window.  With no
+*		     Q bins every Q value is used, with no time windows every time slice is used.
+*
+*	Args: -int qBins - the amount of Q bins
+*	      -int *qBin - low and high of every Q bin
+*	      -int timeWindows - the amount of time windows
+*	      -int *timeWindow - low and high time slice of every time window
+*	      -int *windows - set to the amount of windows created
+*
+*	Returns: -struct OccupancyWindow *window - the windows, ordered by time window first
+*/
+
+struct OccupancyWindow* createOccupancyWindows(int qBins, int *qBin, int timeWindows, int *timeWindow, int *windows) {
+	int allQValues[2] = {0, INT_MAX};
+	int allTimeSlices[2] = {1, INT_MAX};
+
+	if(qBins == 0) {
+		qBins = 1, qBin = allQValues;
+	}
+
+	if(timeWindows == 0) {
+		timeWindows = 1, timeWindow = allTimeSlices;
+	}
+
+	struct OccupancyWindow *window = (struct OccupancyWindow*) malloc(sizeof(struct OccupancyWindow) * qBins * timeWindows);
+	if(!window) {
+		perror("window memory not allocated");
+		abort();
+	}
+
+	*windows = 0;
+	for(int t = 0; t < timeWindows; t++) {
+		for(int q = 0; q < qBins; q++) {
+			window[*windows].qRange.low = qBin[q*2];
+			window[*windows].qRange.high = qBin[q*2 + 1];
+			window[*windows].timeRange.low = timeWindow[t*2];
+			window[*windows].timeRange.high = timeWindow[t*2 + 1];
+			(*windows)++;
+		}
+	}
+
+	return window;
+}
+
+/*
+*	Name: struct TSRange getOccupancyTimeRange()
+*	Description: Finds the one range of time slices from the start of the earliest window
+*		     to the end of the latest.  Time slices in a gap between windows are
+*		     within it, so they are still decoded, and are then counted by no window.
+*
+*	Args: -int windows - the amount of windows.
+*	      -struct OccupancyWindow *window - the Q and time range of every window.
+*
+*	Returns: -struct TSRange timeRange - lowest and highest time slice of the windows
+*/
+
+struct TSRange getOccupancyTimeRange(int windows, struct OccupancyWindow *window) {
+	struct TSRange timeRange = window[0].timeRange;
+
+	for(int w = 1; w < windows; w++) {
+		if(window[w].timeRange.low < timeRange.low) {
+			timeRange.low = window[w].timeRange.low;
+		}
+
+		if(window[w].timeRange.high > timeRange.high) {
+			timeRange.high = window[w].timeRange.high;
+		}
+	}
+
+	return timeRange;
+}
+
+/*
+*	Name: struct OccupancyTable* allocateOccupancyTable()
+*	Description:	Allocates a table of every contact in every window, nothing counted.
+*
+*	Args: -int windows - the amount of windows.
+*	      -struct OccupancyWindow *window - the Q and time range of every window.
+*	      -int contacts - the amount of contacts.
+*	      -struct Contact *residueContacts - the contacts of the contact file.
+*
+*	Returns: -struct OccupancyTable *table - contacts rows per window.
+*/
+
+struct OccupancyTable* allocateOccupancyTable(int windows, struct OccupancyWindow *window, int contacts, struct Contact *residueContacts) {
+	struct OccupancyTable *table = (struct OccupancyTable*) malloc(sizeof(struct OccupancyTable));
+	if(!table) {
+		perror("table memory not allocated");
+		abort();
+	}
+
+	table->windows = windows;
+	table->contacts = contacts;
+	table->window = window;
+	table->residueContacts = residueContacts;
+	table->qValuesInRange = (int*) calloc(windows, sizeof(int));
+	table->contactInformation = allocateContactInformationMemory(windows * contacts);
+
+	if(!table->qValuesInRange) {
+		perror("qValuesInRange memory not allocated");
+		abort();
+	}
+
+	for(int w = 0; w < windows; w++) {
+		for(int i = 0; i < contacts; i++) {
+			struct ContactInformation *information = &table->contactInformation[(size_t)w * contacts + i];
+
+			information->focusResidue = residueContacts[i].focusResidue;
+			information->contactResidue = residueContacts[i].contactResidue;
+			information->totalOccurrences = 0;
+			information->probability = 0.0;
+		}
+	}
+
+	return table;
+}
+
+/*
+*	Name: void freeOccupancyTable()
+*	Description:	Frees a table, not the windows or contacts it was given.
+*
+*	Args: -struct OccupancyTable *table - table from allocateOccupancyTable.
+*/
+
+void freeOccupancyTable(struct OccupancyTable *table) {
+	free(table->qValuesInRange);
+	free(table->contactInformation);
+	free(table);
+}
@@ -0,0 +1,47 @@
+/*
+*	Name: occupancyTable.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef OCCUPANCY_TABLE
+#define OCCUPANCY_TABLE
+
+#include <stdio.h>
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactReader/contactReader.h"
+#include "../probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+#include "../averageContactProbabilityInQValueRange/averageContactProbabilityInQValueRange.h"
+
+// A frame is counted in a window when both its time slice and its Q value are in range
+struct OccupancyWindow {
+	struct QRange qRange;
+	struct TSRange timeRange;
+};
+
+// contactInformation and qValuesInRange hold one row of contacts per window
+struct OccupancyTable {
+	int windows;
+	int contacts;
+	struct OccupancyWindow *window;
+	struct Contact *residueContacts;
+	int *qValuesInRange;
+	struct ContactInformation *contactInformation;
+};
+
+struct OccupancyTable* calculateOccupancyTableFromStream(struct XtcStream *stream, int contacts, struct Contact *residueContacts, int windows, struct OccupancyWindow *window, float cutOff);
+void countOccupancyTableFromStream(struct XtcStream *stream, struct OccupancyTable *table, float cutOff);
+int* countOccupancyTableQValuesFromStream(struct XtcStream *stream, struct OccupancyTable *table, float cutOff, int *xtcFrames);
+void addOccupancyTableFrame(struct OccupancyTable *table, int frame, int qValue, uint64_t *contactStates);
+void addOccupancyTable(struct OccupancyTable *table, struct OccupancyTable *other);
+void calculateOccupancyTableProbabilities(struct OccupancyTable *table);
+struct ContactAverages* calculateOccupancyTableAverages(struct OccupancyTable *table, int residues);
+void writeOccupancyTable(FILE *fp, struct OccupancyTable *table, struct ContactAverages *contactAverages, int residues);
+struct OccupancyWindow* createOccupancyWindows(int qBins, int *qBin, int timeWindows, int *timeWindow, int *windows);
+struct TSRange getOccupancyTimeRange(int windows, struct OccupancyWindow *window);
+struct OccupancyTable* allocateOccupancyTable(int windows, struct OccupancyWindow *window, int contacts, struct Contact *residueContacts);
+void freeOccupancyTable(struct OccupancyTable *table);
+
+#endif
@@ -0,0 +1,156 @@
+/*
+*	Name: parallelXtcReader.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Dependencies: libxdrfile v2.1, pthreads
+*
+*	Summary of expected functionality:
+*		Reads a whole traj.xtc using multiple threads.  The frame boundaries are found
+*		first with getXtcFrameIndex(), then every thread opens its own handle to the
+*		file and claims PARALLEL_XTC_READER_CHUNK frames at a time from a shared
+*		counter.  A thread seeks to the first frame of its chunk and decompresses the
+*		frames straight into their slots, so the result is identical to the serial
+*		readers.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "parallelXtcReader.h"
+
+struct ParallelXtcReader {
+	char *xtcFile;
+	int residues;
+	int frames;
+	struct XtcFrameIndex *index;
+	atomic_int nextFrame;
+
+	// Only one of the two destinations is set
+	struct XtcCoordinates **frameArray;
+	struct XtcTrajectory *trajectory;
+};
+
+static void readFramesParallel(struct ParallelXtcReader *reader, int threads);
+static void* readFrameChunks(void *arg);
+
+/*
+*	Name: struct XtcCoordinates** getXtcFileCoordinatesParallel()
+*	Description:	Same as getXtcFileCoordinates(), decoding the frames on multiple threads.
+*
+*	Args: -char *xtcFile - location of the trajectory file to be read.
+*	      -int residues - total number of residues in the protein.
+*	      -int xtcFrames - total number of frames in the xtcFile.
+*	      -int threads - the amount of threads decoding frames.
+*
+*	Returns: -struct XtcCoordinates** frameArray - the coordinates of each residue at
+*			each frame of the trajectory file.
+*/
+
+struct XtcCoordinates** getXtcFileCoordinatesParallel(char *xtcFile, int residues, int xtcFrames, int threads) {
+	struct ParallelXtcReader reader;
+
+	reader.xtcFile = xtcFile;
+	reader.residues = residues;
+	reader.index = getXtcFrameIndex(xtcFile);
+	reader.frameArray = allocateFrameArrayMemory(residues, xtcFrames);
+	reader.trajectory = NULL;
+
+	if (xtcFrames > reader.index->frames) {
+		printf("\n%s has %d frames, not %d\n", xtcFile, reader.index->frames, xtcFrames);
+		exit(1);
+	}
+
+	reader.frames = xtcFrames;
+	readFramesParallel(&reader, threads);
+
+	freeXtcFrameIndex(reader.index);
+
+	return reader.frameArray;
+}
+
+/*
+*	Name: struct XtcTrajectory* getXtcFileTrajectoryParallel()
+*	Description:	Same as getXtcFileTrajectory(), decoding the frames on multiple threads.
+*			The amount of frames is found while scanning the file.
+*
+*	Args: -char *xtcFile - location of the trajectory file to be read.
+*	      -int residues - total number of residues in the protein.
+*	      -int threads - the amount of threads decoding frames.
+*
+*	Returns: -struct XtcTrajectory *trajectory - every frame of the trajectory file.
+*/
+
+struct XtcTrajectory* getXtcFileTrajectoryParallel(char *xtcFile, int residues, int threads) {
+	struct ParallelXtcReader reader;
+
+	reader.xtcFile = xtcFile;
+	reader.residues = residues;
+	reader.index = getXtcFrameIndex(xtcFile);
+	reader.frames = reader.index->frames;
+	reader.frameArray = NULL;
+	reader.trajectory = allocateXtcTrajectory(residues, reader.frames);
+
+	readFramesParallel(&reader, threads);
+
+	freeXtcFrameIndex(reader.index);
+
+	return reader.trajectory;
+}
+
+static void readFramesParallel(struct ParallelXtcReader *reader, int threads) {
+	pthread_t *workers = (pthread_t*) malloc(sizeof(pthread_t) * threads);
+	if(!workers) {
+		perror("workers memory not allocated");
+		abort();
+	}
+
+	atomic_init(&reader->nextFrame, 0);
+
+	for(int t = 0; t < threads; t++) {
+		if(pthread_create(&workers[t], NULL, readFrameChunks, reader) != 0) {
+			perror("could not create reader thread");
+			exit(1);
+		}
+	}
+
+	for(int t = 0; t < threads; t++) {
+		pthread_join(workers[t], NULL);
+	}
+
+	free(workers);
+}
+
+static void* readFrameChunks(void *arg) {
+	struct ParallelXtcReader *reader = (struct ParallelXtcReader*) arg;
+	struct XtcStream *stream = openXtcStream(reader->xtcFile, reader->residues);
+	int start;
+
+	while((start = atomic_fetch_add(&reader->nextFrame, PARALLEL_XTC_READER_CHUNK)) < reader->frames) {
+		int end = start + PARALLEL_XTC_READER_CHUNK < reader->frames ? start + PARALLEL_XTC_READER_CHUNK : reader->frames;
+
+		seekXtcStream(stream, reader->index, start);
+
+		for(int f = start; f < end; f++) {
+			if(!readXtcStreamFrame(stream)) {
+				printf("\n%s ended before frame %d\n", reader->xtcFile, f + 1);
+				exit(1);
+			}
+
+			if(reader->trajectory) {
+				copyXtcStreamFrame(stream, reader->trajectory, f);
+			} else {
+				for(int r = 0; r < reader->residues; r++) {
+					reader->frameArray[f][r] = stream->frame[r];
+				}
+			}
+		}
+	}
+
+	closeXtcStream(stream);
+
+	return NULL;
+}
@@ -0,0 +1,19 @@
+/*
+*	Name: parallelXtcReader.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef PARALLEL_XTC_READER
+#define PARALLEL_XTC_READER
+
+#include "../xtcReader/xtcReader.h"
+
+// Consecutive frames decoded by a thread after each seek
+#define PARALLEL_XTC_READER_CHUNK 16
+
+struct XtcCoordinates** getXtcFileCoordinatesParallel(char *xtcFile, int residues, int xtcFrames, int threads);
+struct XtcTrajectory* getXtcFileTrajectoryParallel(char *xtcFile, int residues, int threads);
+
+#endif
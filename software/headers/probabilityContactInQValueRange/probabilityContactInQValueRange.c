@@ -11,19 +11,21 @@
 #include "../xtcReader/xtcReader.h"
 #include "../contactReader/contactReader.h"
 #include "../calcQFromContacts/calcQFromContacts.h"
+#include "../contactState/contactState.h"
 #include "probabilityContactInQValueRange.h"
 
 /*
 *	Name: struct ContactInformation* calculateContactProbability()
 *	Description: Given an array of Q values, and a range of Q values, the function
 *		     will determine the probability of a contact occurring when the Q value
-*		     of a frame is within the specified range.
+*		     of a frame is within the specified range.  The contacts of a frame are
+*		     evaluated by calculateContactStates(), with the contact kernel of the Q
+*		     values.
 *
 *	Args: -int xtcFrames - the amount of frame in the traj.xtc file
-*	      -int contacts - the amount of contacts in the contactFile
 *	      -struct XtcCoordinates **xtcResidueCoordinates - the residue coordinates from the
 *				traj.xtc file
-*	      -char* contactFile - location of the contactFile
+*	      -struct ContactSet *contactSet - the contacts read with readContactSet()
 *	      -struct QRange qRange - low and high range of Q values
 *	      -struct TSRange timeRange - low and high range of time slices
 *	      -int* qValues - an array of Q values; every frame of the traj.xtc has one Q value
@@ -32,38 +34,195 @@
 *				containing values for every variable
 */
 
-struct ContactInformation* calculateContactProbability(int xtcFrames, int contacts, struct XtcCoordinates **xtcResidueCoordinates, char* contactFile, struct QRange qRange, struct TSRange timeRange, int* qValues, float cutOff) {
+struct ContactInformation* calculateContactProbability(int xtcFrames, struct XtcCoordinates **xtcResidueCoordinates, struct ContactSet *contactSet, struct QRange qRange, struct TSRange timeRange, int* qValues, float cutOff) {
+	int contacts = contactSet->contacts;
 
 	// Populates an array of struct ContactInformation; size being the amount of contacts
-	struct ContactInformation* residueContactsInformation = createResidueContactInformation(contacts, getContactFileContacts(contactFile));
+	struct ContactInformation* residueContactsInformation = createResidueContactInformation(contacts, contactSet->residueContacts);
+	uint64_t *contactStates = allocateContactStatesMemory(1, contacts);
 	int qValuesInRange = 0;
+	int first = timeRange.low > 1 ? timeRange.low - 1 : 0;
+	int last = timeRange.high < xtcFrames ? timeRange.high - 1 : xtcFrames - 1;
+
+	// For every frame within the time range
+	for(int i = first; i <= last; i++) {
+
+		// If the Q value is within the defined range
+		if(qValues[i] >= qRange.low && qValues[i] <= qRange.high) {
+			calculateContactStates(contacts, cutOff, xtcResidueCoordinates[i], contactSet->residueContacts, contactStates);
+			addContactStateOccurrences(contacts, contactStates, residueContactsInformation);
+			qValuesInRange++;
+		}
+	}
 
-	// For every frame in the traj.xtc file; also the total amount of Q values
-	for(int i = 0; i < xtcFrames; i++) {
+	free(contactStates);
 
-		// If the time step is within the defined range
-		if((i >= (timeRange.low-1)) && (i <= (timeRange.high-1))) {
+	calculateProbabilities(contacts, residueContactsInformation, qValuesInRange);
 
-			// If the Q value is within the defined range
-			if(qValues[i] >= qRange.low && qValues[i] <= qRange.high) {
+	return residueContactsInformation;
+}
+
+/*
+*	Name: struct ContactInformation* calculateContactProbabilityFromStream()
+*	Description: Same as calculateContactProbability(), but frames are taken from an open
+*		     traj.xtc stream as they are decoded.  The time range is handed to the
+*		     stream, so frames outside of it are never decompressed; a stride set on
+*		     the stream is kept.  The contacts of each frame are evaluated once; the Q
+*		     value and the occurrences are both taken from the resulting contact states.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -struct QRange qRange - low and high range of Q values
+*	      -struct TSRange timeRange - low and high range of time slices
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*
+*	Returns: -struct ContactInformation* residueContactsInformation - an array of structures
+*				containing values for every variable
+*/
 
-				// For every contact pair in the contact file
-				for(int j = 0; j < contacts; j++) {
+struct ContactInformation* calculateContactProbabilityFromStream(struct XtcStream *stream, int contacts, struct Contact *residueContacts, struct QRange qRange, struct TSRange timeRange, float cutOff) {
+	struct ContactInformation* residueContactsInformation = createResidueContactInformation(contacts, residueContacts);
+	uint64_t *contactStates = allocateContactStatesMemory(1, contacts);
+	int qValuesInRange = 0;
 
-					// If the distance between the residue pair is within the cutoff value
-					if(calculateDistance(xtcResidueCoordinates[i][residueContactsInformation[j].focusResidue-1],
-					   xtcResidueCoordinates[i][residueContactsInformation[j].contactResidue-1]) <= cutOff) {
+	// Frames outside of the time range are skipped by the reader
+	setXtcStreamTimeRange(stream, timeRange);
 
-						// Increase the total occurrences of the contact by 1
-						residueContactsInformation[j].totalOccurrences++;
-					}
-				}
+	// For every frame decoded from the traj.xtc file
+	while(readXtcStreamFrame(stream)) {
+		int qValue = calculateContactStates(contacts, cutOff, stream->frame, residueContacts, contactStates);
 
-				qValuesInRange++;
-			}
+		// If the Q value is within the defined range
+		if(qValue >= qRange.low && qValue <= qRange.high) {
+			addContactStateOccurrences(contacts, contactStates, residueContactsInformation);
+			qValuesInRange++;
 		}
 	}
 
+	free(contactStates);
+
+	calculateProbabilities(contacts, residueContactsInformation, qValuesInRange);
+
+	return residueContactsInformation;
+}
+
+/*
+*	Name: struct ContactInformation* calculateContactProbabilityFromTrajectory()
+*	Description: Same as calculateContactProbabilityFromStream(), for coordinates stored in
+*		     a struct XtcTrajectory.
+*
+*	Args: -struct XtcTrajectory *trajectory - residue coordinates of every frame
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -struct QRange qRange - low and high range of Q values
+*	      -struct TSRange timeRange - low and high range of time slices
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*
+*	Returns: -struct ContactInformation* residueContactsInformation - an array of structures
+*				containing values for every variable
+*/
+
+struct ContactInformation* calculateContactProbabilityFromTrajectory(struct XtcTrajectory *trajectory, int contacts, struct Contact *residueContacts, struct QRange qRange, struct TSRange timeRange, float cutOff) {
+	struct ContactInformation* residueContactsInformation = createResidueContactInformation(contacts, residueContacts);
+	uint64_t *contactStates = allocateContactStatesMemory(1, contacts);
+	int qValuesInRange = 0;
+	int first = timeRange.low > 1 ? timeRange.low - 1 : 0;
+	int last = timeRange.high < trajectory->frames ? timeRange.high - 1 : trajectory->frames - 1;
+
+	// For every frame within the time range
+	for(int i = first; i <= last; i++) {
+		int qValue = calculateTrajectoryFrameContactStates(trajectory, i, contacts, cutOff, residueContacts, contactStates);
+
+		// If the Q value is within the defined range
+		if(qValue >= qRange.low && qValue <= qRange.high) {
+			addContactStateOccurrences(contacts, contactStates, residueContactsInformation);
+			qValuesInRange++;
+		}
+	}
+
+	free(contactStates);
+
+	calculateProbabilities(contacts, residueContactsInformation, qValuesInRange);
+
+	return residueContactsInformation;
+}
+
+/*
+*	Name: struct ContactInformation* calculateContactProbabilityFromContactStates()
+*	Description: Same as calculateContactProbability(), but the Q values and occurrences
+*		     are read from previously calculated contact states instead of coordinates.
+*
+*	Args: -int xtcFrames - the amount of frame in the traj.xtc file
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -uint64_t *contactStates - contact states of every frame
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -struct QRange qRange - low and high range of Q values
+*	      -struct TSRange timeRange - low and high range of time slices
+*
+*	Returns: -struct ContactInformation* residueContactsInformation - an array of structures
+*				containing values for every variable
+*/
+
+struct ContactInformation* calculateContactProbabilityFromContactStates(int xtcFrames, int contacts, uint64_t *contactStates, struct Contact *residueContacts, struct QRange qRange, struct TSRange timeRange) {
+	struct ContactInformation* residueContactsInformation = createResidueContactInformation(contacts, residueContacts);
+	int words = getContactStateWords(contacts);
+	int qValuesInRange = 0;
+	int first = timeRange.low > 1 ? timeRange.low - 1 : 0;
+	int last = timeRange.high < xtcFrames ? timeRange.high - 1 : xtcFrames - 1;
+
+	// For every frame within the time range
+	for(int i = first; i <= last; i++) {
+		uint64_t *frameStates = &contactStates[(size_t)i * words];
+		int qValue = countContactStates(contacts, frameStates);
+
+		// If the Q value is within the defined range
+		if(qValue >= qRange.low && qValue <= qRange.high) {
+			addContactStateOccurrences(contacts, frameStates, residueContactsInformation);
+			qValuesInRange++;
+		}
+	}
+
+	calculateProbabilities(contacts, residueContactsInformation, qValuesInRange);
+
+	return residueContactsInformation;
+}
+
+/*
+*	Name: void addContactStateOccurrences()
+*	Description: Increases totalOccurrences of every contact whose bit is set in one
+*		     frame's contact states.  Only set bits are visited.
+*
+*	Args: -int contacts - the amount of contacts in the contactFile
+*	      -uint64_t *contactStates - contact states of one frame
+*	      -struct ContactInformation *residueContactsInformation - contacts being counted
+*/
+
+void addContactStateOccurrences(int contacts, uint64_t *contactStates, struct ContactInformation *residueContactsInformation) {
+	int words = getContactStateWords(contacts);
+
+	for(int i = 0; i < words; i++) {
+		uint64_t word = contactStates[i];
+
+		while(word) {
+			residueContactsInformation[i * CONTACT_STATE_BITS + __builtin_ctzll(word)].totalOccurrences++;
+			word &= word - 1;
+		}
+	}
+}
+
+/*
+*	Name: void calculateProbabilities()
+*	Description: Divides the total occurrences of every contact by the amount of frames
+*		     that had a Q value within the specified range.
+*
+*	Args: -int contacts - the amount of contacts in the contactFile
+*	      -struct ContactInformation *residueContactsInformation - counted contacts
+*	      -int qValuesInRange - the amount of frames within the Q and time ranges
+*/
+
+void calculateProbabilities(int contacts, struct ContactInformation *residueContactsInformation, int qValuesInRange) {
+
 	// For every contact pair
 	for(int i = 0; i < contacts; i++) {
 		if(qValuesInRange == 0) {
@@ -73,8 +232,6 @@ struct ContactInformation* calculateContactProbability(int xtcFrames, int contac
 			residueContactsInformation[i].probability = (float)residueContactsInformation[i].totalOccurrences / (float)qValuesInRange;
 		}
 	}
-
-	return residueContactsInformation;
 }
 
 /*
@@ -8,6 +8,8 @@
 #ifndef PROBABILITY_CONTACT_IN_Q_VALUE_RANGE
 #define PROBABILITY_CONTACT_IN_Q_VALUE_RANGE
 
+#include <stdint.h>
+
 #include "../xtcReader/xtcReader.h"
 #include "../contactReader/contactReader.h"
 
@@ -23,12 +25,12 @@ struct QRange {
 	int high;
 };
 
-struct TSRange {
-	int low;
-	int high;
-};
-
-struct ContactInformation* calculateContactProbability(int xtcFrames, int contacts, struct XtcCoordinates **xtcResidueCoordinates, char* contactFile, struct QRange qRange, struct TSRange timeRange, int* qValues, float cutOff);
+struct ContactInformation* calculateContactProbability(int xtcFrames, struct XtcCoordinates **xtcResidueCoordinates, struct ContactSet *contactSet, struct QRange qRange, struct TSRange timeRange, int* qValues, float cutOff);
+struct ContactInformation* calculateContactProbabilityFromStream(struct XtcStream *stream, int contacts, struct Contact *residueContacts, struct QRange qRange, struct TSRange timeRange, float cutOff);
+struct ContactInformation* calculateContactProbabilityFromTrajectory(struct XtcTrajectory *trajectory, int contacts, struct Contact *residueContacts, struct QRange qRange, struct TSRange timeRange, float cutOff);
+struct ContactInformation* calculateContactProbabilityFromContactStates(int xtcFrames, int contacts, uint64_t *contactStates, struct Contact *residueContacts, struct QRange qRange, struct TSRange timeRange);
+void addContactStateOccurrences(int contacts, uint64_t *contactStates, struct ContactInformation *residueContactsInformation);
+void calculateProbabilities(int contacts, struct ContactInformation *residueContactsInformation, int qValuesInRange);
 struct ContactInformation* createResidueContactInformation(int contacts, struct Contact *residueContacts);
 struct ContactInformation* allocateContactInformationMemory(int contacts);
 
@@ -0,0 +1,270 @@
+/*
+*	Name: profile.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Measures the stages of a program when it is run with --profile, or with the
+*		environment variable PROTEIN_PROFILE set to anything but 0.  A program names
+*		each stage with profileStage() as it starts; the stage before it ends there.
+*		For every stage the wall and CPU time, the frames decoded, the contact pairs
+*		evaluated, the bytes read and the peak resident memory are recorded.  When the
+*		program exits, one line of JSON with every stage and the total of the run is
+*		written to stderr, so the output files and stdout are unchanged.
+*
+*	Notes:
+*		CPU time includes every thread.  Bytes read are the rchar of /proc/self/io,
+*		which counts read() calls but not files mapped into memory such as the
+*		contact file; without /proc the blocks read from disk are used.  Peak memory
+*		is the largest resident size of the process so far, so it never decreases.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactKernel/contactKernel.h"
+#include "../programOptions/programOptions.h"
+#include "profile.h"
+
+static int profileEnabled = 0;
+static int profileFinished = 0;
+static char *profileProgram = "";
+static struct ProfileSample programStart;
+static struct ProfileSample stageStart;
+static struct ProfileStage profileStages[PROFILE_STAGES];
+static int stages = 0;
+static int stageRunning = 0;
+
+static void endProfileStage();
+static long getPeakRssKb();
+static void writeProfileString(FILE *fp, char *value);
+static void writeProfileSample(FILE *fp, struct ProfileSample sample, long peakRssKb);
+
+/*
+*	Name: void startProfile()
+*	Description: Removes --profile from argv and, if it was given or PROTEIN_PROFILE is
+*		     set, starts measuring.  The summary is written when the program exits.
+*
+*	Args: -int *argc - argument count, reduced by 1 if --profile is found.
+*	      -char *argv[] - arguments; argv[0] names the program in the summary.
+*/
+
+void startProfile(int *argc, char *argv[]) {
+	char *environment = getenv("PROTEIN_PROFILE");
+	int flag = takeFlag(argc, argv, "--profile");
+
+	if (!flag && (environment == NULL || environment[0] == '\0' || strcmp(environment, "0") == 0)) {
+		return;
+	}
+
+	char *program = strrchr(argv[0], '/');
+	profileProgram = program ? program + 1 : argv[0];
+
+	profileEnabled = 1;
+	programStart = takeProfileSample();
+
+	atexit(finishProfile);
+}
+
+/*
+*	Name: void profileStage()
+*	Description: Ends the running stage, if any, and starts the next one.  Does nothing
+*		     unless startProfile() enabled profiling.
+*
+*	Args: -char *name - the name of the stage in the summary; not copied.
+*/
+
+void profileStage(char *name) {
+	if (!profileEnabled) {
+		return;
+	}
+
+	endProfileStage();
+
+	if (stages < PROFILE_STAGES) {
+		memset(&profileStages[stages], 0, sizeof(struct ProfileStage));
+		profileStages[stages++].name = name;
+	}
+
+	stageStart = takeProfileSample();
+	stageRunning = 1;
+}
+
+/*
+*	Name: void finishProfile()
+*	Description: Ends the running stage and writes the summary to stderr.  Called when
+*		     the program exits; later calls do nothing.
+*/
+
+void finishProfile() {
+	if (!profileEnabled || profileFinished) {
+		return;
+	}
+
+	endProfileStage();
+	writeProfile(stderr);
+
+	profileFinished = 1;
+}
+
+/*
+*	Name: int isProfileEnabled()
+*	Description:	Whether --profile or PROTEIN_PROFILE turned profiling on.
+*
+*	Returns: -int enabled - 1 if stages are recorded, else 0.
+*/
+
+int isProfileEnabled() {
+	return profileEnabled;
+}
+
+/*
+*	Name: struct ProfileStage* getProfileStages()
+*	Description:	The stages recorded so far, in the order they started.
+*
+*	Args: -int *profileStageCount - set to the amount of stages.
+*
+*	Returns: -struct ProfileStage *profileStages - the stages, not to be freed.
+*/
+
+struct ProfileStage* getProfileStages(int *profileStageCount) {
+	*profileStageCount = stages;
+
+	return profileStages;
+}
+
+/*
+*	Name: void writeProfile()
+*	Description: Writes the stages so far and the total since startProfile() as one line
+*		     of JSON, for example
+*		     {"program": "calcQFromContactsProg", "contactKernel": "avx2", "stages":
+*		     [{"stage": "calculateQ", "wallSeconds": 1.5, ...}], "total": {...}}
+*
+*	Args: -FILE *fp - where the summary is written.
+*/
+
+void writeProfile(FILE *fp) {
+	struct ProfileSample total = takeProfileSample();
+
+	total.wallSeconds -= programStart.wallSeconds;
+	total.cpuSeconds -= programStart.cpuSeconds;
+	total.frames -= programStart.frames;
+	total.contactEvaluations -= programStart.contactEvaluations;
+	total.bytesRead -= programStart.bytesRead;
+
+	fprintf(fp, "{\"program\": ");
+	writeProfileString(fp, profileProgram);
+	fprintf(fp, ", \"contactKernel\": ");
+	writeProfileString(fp, getContactKernelName());
+	fprintf(fp, ", \"stages\": [");
+
+	for (int i = 0; i < stages; i++) {
+		fprintf(fp, i == 0 ? "{\"stage\": " : ", {\"stage\": ");
+		writeProfileString(fp, profileStages[i].name);
+		fprintf(fp, ", ");
+		writeProfileSample(fp, profileStages[i].sample, profileStages[i].peakRssKb);
+		fprintf(fp, "}");
+	}
+
+	fprintf(fp, "], \"total\": {");
+	writeProfileSample(fp, total, getPeakRssKb());
+	fprintf(fp, "}}\n");
+	fflush(fp);
+}
+
+/*
+*	Name: struct ProfileSample takeProfileSample()
+*	Description: Reads the clocks and counters of the process; the measurements of a
+*		     stage are the difference of two samples.
+*/
+
+struct ProfileSample takeProfileSample() {
+	struct ProfileSample sample;
+	struct timespec time;
+	struct rusage usage;
+	FILE *fp;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	sample.wallSeconds = time.tv_sec + time.tv_nsec * 1e-9;
+
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+	sample.cpuSeconds = time.tv_sec + time.tv_nsec * 1e-9;
+
+	sample.frames = getXtcFramesDecoded();
+	sample.contactEvaluations = getContactEvaluations();
+	sample.bytesRead = -1;
+
+	if ((fp = fopen("/proc/self/io", "r")) != NULL) {
+		long long rchar;
+
+		if (fscanf(fp, "rchar: %lld", &rchar) == 1) {
+			sample.bytesRead = rchar;
+		}
+
+		fclose(fp);
+	}
+
+	if (sample.bytesRead < 0) {
+		getrusage(RUSAGE_SELF, &usage);
+		sample.bytesRead = (int64_t) usage.ru_inblock * 512;
+	}
+
+	return sample;
+}
+
+static void endProfileStage() {
+	if (!stageRunning) {
+		return;
+	}
+
+	struct ProfileStage *stage = &profileStages[stages - 1];
+	struct ProfileSample sample = takeProfileSample();
+
+	// A stage past PROFILE_STAGES is added to the last one
+	stage->sample.wallSeconds += sample.wallSeconds - stageStart.wallSeconds;
+	stage->sample.cpuSeconds += sample.cpuSeconds - stageStart.cpuSeconds;
+	stage->sample.frames += sample.frames - stageStart.frames;
+	stage->sample.contactEvaluations += sample.contactEvaluations - stageStart.contactEvaluations;
+	stage->sample.bytesRead += sample.bytesRead - stageStart.bytesRead;
+	stage->peakRssKb = getPeakRssKb();
+
+	stageRunning = 0;
+}
+
+static long getPeakRssKb() {
+	struct rusage usage;
+
+	getrusage(RUSAGE_SELF, &usage);
+
+	return usage.ru_maxrss;
+}
+
+static void writeProfileString(FILE *fp, char *value) {
+	fputc('"', fp);
+
+	for (char *c = value; *c; c++) {
+		if (*c == '"' || *c == '\\') {
+			fputc('\\', fp);
+		}
+
+		if ((unsigned char) *c >= 0x20) {
+			fputc(*c, fp);
+		}
+	}
+
+	fputc('"', fp);
+}
+
+static void writeProfileSample(FILE *fp, struct ProfileSample sample, long peakRssKb) {
+	double seconds = sample.wallSeconds > 0 ? sample.wallSeconds : 1e-9;
+
+	fprintf(fp, "\"wallSeconds\": %.6f, \"cpuSeconds\": %.6f, ", sample.wallSeconds, sample.cpuSeconds);
+	fprintf(fp, "\"frames\": %lld, \"framesPerSecond\": %.1f, ", (long long) sample.frames, sample.frames / seconds);
+	fprintf(fp, "\"contactEvaluations\": %lld, \"contactEvaluationsPerSecond\": %.1f, ", (long long) sample.contactEvaluations, sample.contactEvaluations / seconds);
+	fprintf(fp, "\"bytesRead\": %lld, \"peakRssKb\": %ld", (long long) sample.bytesRead, peakRssKb);
+}
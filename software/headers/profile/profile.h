@@ -0,0 +1,40 @@
+/*
+*	Name: profile.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef PROFILE
+#define PROFILE
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Stages after this many are added to the last one
+#define PROFILE_STAGES 32
+
+struct ProfileSample {
+	double wallSeconds;
+	double cpuSeconds;
+	int64_t frames;
+	int64_t contactEvaluations;
+	int64_t bytesRead;
+};
+
+// The difference between the samples at the start and end of the stage
+struct ProfileStage {
+	char *name;
+	struct ProfileSample sample;
+	long peakRssKb;
+};
+
+void startProfile(int *argc, char *argv[]);
+void profileStage(char *name);
+void finishProfile();
+int isProfileEnabled();
+struct ProfileStage* getProfileStages(int *stages);
+void writeProfile(FILE *fp);
+struct ProfileSample takeProfileSample();
+
+#endif
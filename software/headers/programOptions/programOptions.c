@@ -0,0 +1,303 @@
+/*
+*	Name: programOptions.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Removes optional "--name value" and "--name" arguments from argv, so the programs
+*		can keep reading their positional arguments by index.  Options may appear
+*		anywhere on the command line.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "programOptions.h"
+
+/*
+*	Name: float* parseCutoffList()
+*	Description: Reads a list of cutoff values separated by commas, "6.0,7.5,9".
+*
+*	Args: -char *value - the argument holding the cutoff values.
+*	      -int *cutoffs - set to the amount of cutoff values.
+*
+*	Returns: -float *cutoff - every cutoff value, in the order given.
+*/
+
+float* parseCutoffList(char *value, int *cutoffs) {
+	float *cutoff;
+	int capacity = 1;
+
+	for(char *c = value; *c; c++) {
+		capacity += *c == ',';
+	}
+
+	cutoff = (float*) malloc(sizeof(float) * capacity);
+	if(!cutoff) {
+		perror("cutoff memory not allocated");
+		abort();
+	}
+
+	*cutoffs = 0;
+	for(char *c = value; ; c++) {
+		int length;
+
+		if(sscanf(c, "%f%n", &cutoff[*cutoffs], &length) != 1 || cutoff[*cutoffs] < 0 ||
+		   (c[length] != ',' && c[length] != '\0')) {
+			printf("\nCutoff values must be numbers separated by commas\n");
+			exit(1);
+		}
+
+		(*cutoffs)++;
+		c += length;
+
+		if(*c == '\0') {
+			break;
+		}
+	}
+
+	return cutoff;
+}
+
+/*
+*	Name: char* joinArguments()
+*	Description: Joins the arguments after the program name, separated by spaces.  Used
+*		     to record the settings of a run, for example in a checkpoint.
+*
+*	Args: -int argc - argument count.
+*	      -char *argv[] - arguments.
+*
+*	Returns: -char *arguments - the joined arguments.
+*/
+
+char* joinArguments(int argc, char *argv[]) {
+	size_t length = 1;
+
+	for(int i = 1; i < argc; i++) {
+		length += strlen(argv[i]) + 1;
+	}
+
+	char *arguments = (char*) malloc(length);
+	if(!arguments) {
+		perror("arguments memory not allocated");
+		abort();
+	}
+
+	arguments[0] = '\0';
+	for(int i = 1; i < argc; i++) {
+		if(i > 1) {
+			strcat(arguments, " ");
+		}
+		strcat(arguments, argv[i]);
+	}
+
+	return arguments;
+}
+
+static void removeArguments(int *argc, char *argv[], int index, int count);
+
+/*
+*	Name: char* takeOption()
+*	Description: Finds "name value" in argv, removes both arguments and returns the value.
+*
+*	Args: -int *argc - argument count, reduced by 2 if the option is found.
+*	      -char *argv[] - arguments.
+*	      -char *name - the option, for example "--threads".
+*
+*	Returns: -char *value - the argument following the option, or NULL if not given.
+*/
+
+char* takeOption(int *argc, char *argv[], char *name) {
+	for(int i = 1; i < *argc; i++) {
+		if(strcmp(argv[i], name) == 0) {
+			if(i + 1 >= *argc) {
+				printf("\nOption %s requires a value\n", name);
+				exit(1);
+			}
+
+			char *value = argv[i + 1];
+			removeArguments(argc, argv, i, 2);
+
+			return value;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+*	Name: int takeFlag()
+*	Description: Finds "name" in argv and removes it.
+*
+*	Returns: -int - 1 if the flag was given, otherwise 0.
+*/
+
+int takeFlag(int *argc, char *argv[], char *name) {
+	for(int i = 1; i < *argc; i++) {
+		if(strcmp(argv[i], name) == 0) {
+			removeArguments(argc, argv, i, 1);
+
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+*	Name: int takeThreadsOption()
+*	Description: Reads "--threads N" from argv.
+*
+*	Returns: -int threads - N, or 1 if the option is not given.
+*/
+
+int takeThreadsOption(int *argc, char *argv[]) {
+	char *value = takeOption(argc, argv, "--threads");
+	int threads = value ? atoi(value) : 1;
+
+	if(threads < 1) {
+		printf("\n--threads must be at least 1\n");
+		exit(1);
+	}
+
+	return threads;
+}
+
+/*
+*	Name: int takeStrideOption()
+*	Description: Reads "--stride N" from argv.
+*
+*	Returns: -int stride - N, or 1 if the option is not given.
+*/
+
+int takeStrideOption(int *argc, char *argv[]) {
+	char *value = takeOption(argc, argv, "--stride");
+	int stride = value ? atoi(value) : 1;
+
+	if(stride < 1) {
+		printf("\n--stride must be at least 1\n");
+		exit(1);
+	}
+
+	return stride;
+}
+
+/*
+*	Name: float takeFloatOption()
+*	Description: Reads "name value" from argv, where value is a number.
+*
+*	Args: -int *argc - argument count, reduced by 2 if the option is found.
+*	      -char *argv[] - arguments.
+*	      -char *name - the option, for example "--beta".
+*	      -float defaultValue - returned if the option is not given.
+*
+*	Returns: -float value - the number following the option.
+*/
+
+float takeFloatOption(int *argc, char *argv[], char *name, float defaultValue) {
+	char *value = takeOption(argc, argv, name);
+	float number;
+	int length;
+
+	if(!value) {
+		return defaultValue;
+	}
+
+	if(sscanf(value, "%f%n", &number, &length) != 1 || value[length] != '\0') {
+		printf("\nOption %s requires a number\n", name);
+		exit(1);
+	}
+
+	return number;
+}
+
+/*
+*	Name: int takeRangeOption()
+*	Description: Reads "name low:high" from argv.
+*
+*	Args: -int *argc - argument count, reduced by 2 if the option is found.
+*	      -char *argv[] - arguments.
+*	      -char *name - the option, for example "--range".
+*	      -int *low - set to low if the option is given.
+*	      -int *high - set to high if the option is given.
+*
+*	Returns: -int - 1 if the option was given, otherwise 0.
+*/
+
+int takeRangeOption(int *argc, char *argv[], char *name, int *low, int *high) {
+	char *value = takeOption(argc, argv, name);
+
+	if(!value) {
+		return 0;
+	}
+
+	if(sscanf(value, "%d:%d", low, high) != 2 || *low > *high) {
+		printf("\nOption %s requires a range low:high\n", name);
+		exit(1);
+	}
+
+	return 1;
+}
+
+/*
+*	Name: int* takeRangeListOption()
+*	Description: Reads "name low:high,low:high,..." from argv.
+*
+*	Args: -int *argc - argument count, reduced by 2 if the option is found.
+*	      -char *argv[] - arguments.
+*	      -char *name - the option, for example "--q".
+*	      -int *ranges - set to the amount of ranges, 0 if the option is not given.
+*
+*	Returns: -int *range - low and high of every range, or NULL if not given.
+*/
+
+int* takeRangeListOption(int *argc, char *argv[], char *name, int *ranges) {
+	char *value = takeOption(argc, argv, name);
+	int *range;
+
+	*ranges = 0;
+	if(!value) {
+		return NULL;
+	}
+
+	// Every range but the last is followed by a comma
+	int capacity = 1;
+	for(char *c = value; *c; c++) {
+		capacity += *c == ',';
+	}
+
+	range = (int*) malloc(sizeof(int) * 2 * capacity);
+	if(!range) {
+		perror("range memory not allocated");
+		abort();
+	}
+
+	for(char *c = value; ; c++) {
+		int length;
+
+		if(sscanf(c, "%d:%d%n", &range[*ranges * 2], &range[*ranges * 2 + 1], &length) != 2 ||
+		   range[*ranges * 2] > range[*ranges * 2 + 1] || (c[length] != ',' && c[length] != '\0')) {
+			printf("\nOption %s requires ranges low:high separated by commas\n", name);
+			exit(1);
+		}
+
+		(*ranges)++;
+		c += length;
+
+		if(*c == '\0') {
+			break;
+		}
+	}
+
+	return range;
+}
+
+static void removeArguments(int *argc, char *argv[], int index, int count) {
+	for(int i = index; i + count <= *argc; i++) {
+		argv[i] = argv[i + count];
+	}
+
+	*argc -= count;
+}
@@ -0,0 +1,21 @@
+/*
+*	Name: programOptions.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef PROGRAM_OPTIONS
+#define PROGRAM_OPTIONS
+
+char* takeOption(int *argc, char *argv[], char *name);
+int takeFlag(int *argc, char *argv[], char *name);
+int takeThreadsOption(int *argc, char *argv[]);
+int takeStrideOption(int *argc, char *argv[]);
+float takeFloatOption(int *argc, char *argv[], char *name, float defaultValue);
+int takeRangeOption(int *argc, char *argv[], char *name, int *low, int *high);
+int* takeRangeListOption(int *argc, char *argv[], char *name, int *ranges);
+float* parseCutoffList(char *value, int *cutoffs);
+char* joinArguments(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,475 @@
+/*
+*	Name: qSeries.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Keeps the Q values of a trajectory in a binary file, so later programs can use
+*		them without reading a qFile as text or evaluating every frame again.  The file
+*		is a struct QSeriesHeader, a float cutoff for each column, then the values of
+*		every frame as one packed array of int32_t or float, in the byte order of the
+*		machine that wrote it.  The header records the frames, the first frame and
+*		stride they were taken with, the step and time of the first and last frame and
+*		a hash of the contact file.  With a Q series the probability of the contacts
+*		only needs the frames whose Q value is in range to be decoded; the others are
+*		skipped by their byte offset in the frame index.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../calcQFromContacts/calcQFromContacts.h"
+#include "../contactState/contactState.h"
+#include "../smoothQ/smoothQ.h"
+#include "qSeries.h"
+
+/*
+*	Name: struct QSeries* createQSeries()
+*	Description: Describes Q values calculated from an open traj.xtc stream.  Call
+*		     before the stream is closed; the frame index gives the steps and times.
+*
+*	Args: -int type - Q_SERIES_INT32 or Q_SERIES_FLOAT
+*	      -int columns - the amount of cutoffs, one column each
+*	      -float *cutoff - the cutoff of every column; 0 for a fractional Q
+*	      -int xtcFrames - the amount of frames read from the stream
+*	      -void *values - columns values for every frame; not copied, freed by freeQSeries()
+*	      -struct XtcStream *stream - the stream the Q values were calculated from
+*	      -char *contactFile - the contacts file of the Q values
+*
+*	Returns: -struct QSeries *series - ready for writeQSeries()
+*/
+
+struct QSeries* createQSeries(int type, int columns, float *cutoff, int xtcFrames, void *values, struct XtcStream *stream, char *contactFile) {
+	struct QSeries *series = (struct QSeries*) malloc(sizeof(struct QSeries));
+	if(!series) {
+		perror("series memory not allocated");
+		abort();
+	}
+
+	series->cutoff = (float*) malloc(sizeof(float) * columns);
+	if(!series->cutoff) {
+		perror("cutoff memory not allocated");
+		abort();
+	}
+
+	memset(&series->header, 0, sizeof(series->header));
+	memcpy(series->header.magic, Q_SERIES_MAGIC, sizeof(series->header.magic));
+	series->header.version = Q_SERIES_VERSION;
+	series->header.type = type;
+	series->header.columns = columns;
+	series->header.stride = stream->stride;
+	series->header.frames = xtcFrames;
+	series->header.firstFrame = stream->firstFrame;
+	series->header.contactHash = hashFileContents(contactFile);
+
+	for(int k = 0; k < columns; k++) {
+		series->cutoff[k] = cutoff ? cutoff[k] : 0.0f;
+	}
+
+	series->values = values;
+
+	if(xtcFrames > 0) {
+		struct XtcFrameIndex *index = stream->index ? stream->index : getXtcFrameIndex(stream->xtcFile);
+		int64_t lastFrame = series->header.firstFrame + (xtcFrames - 1) * (int64_t) series->header.stride;
+
+		if(lastFrame < index->frames) {
+			series->header.firstStep = index->steps[series->header.firstFrame];
+			series->header.firstTime = index->times[series->header.firstFrame];
+			series->header.lastStep = index->steps[lastFrame];
+			series->header.lastTime = index->times[lastFrame];
+		}
+
+		if(index != stream->index) {
+			freeXtcFrameIndex(index);
+		}
+	}
+
+	return series;
+}
+
+/*
+*	Name: void writeQSeries()
+*	Description: Writes a Q series to a binary file, the header, cutoffs and values each
+*		     with one write.
+*
+*	Args: -struct QSeries *series - from createQSeries()
+*	      -char *qSeriesFile - the file name where the Q series will be written
+*/
+
+void writeQSeries(struct QSeries *series, char *qSeriesFile) {
+	size_t values = (size_t) series->header.frames * series->header.columns;
+	FILE *fp;
+
+	if ((fp = fopen(qSeriesFile, "wb")) == NULL) {
+		perror("could not open qSeriesFile for output.");
+		exit(1);
+	}
+
+	if (fwrite(&series->header, sizeof(series->header), 1, fp) != 1 ||
+	    fwrite(series->cutoff, sizeof(float), series->header.columns, fp) != (size_t) series->header.columns ||
+	    fwrite(series->values, 4, values, fp) != values || fclose(fp) != 0) {
+		printf("\nCould not write %s\n", qSeriesFile);
+		exit(1);
+	}
+}
+
+/*
+*	Name: struct QSeries* readQSeries()
+*	Description: Reads a Q series written by writeQSeries().  Exits with a message if the
+*		     file is not a Q series or is incomplete.
+*
+*	Args: -char *qSeriesFile - the binary Q series file
+*
+*	Returns: -struct QSeries *series - the header, cutoffs and values
+*/
+
+struct QSeries* readQSeries(char *qSeriesFile) {
+	struct QSeries *series = (struct QSeries*) malloc(sizeof(struct QSeries));
+	FILE *fp;
+
+	if(!series) {
+		perror("series memory not allocated");
+		abort();
+	}
+
+	if ((fp = fopen(qSeriesFile, "rb")) == NULL) {
+		printf("\nCould not open %s\n", qSeriesFile);
+		exit(1);
+	}
+
+	if (fread(&series->header, sizeof(series->header), 1, fp) != 1 ||
+	    memcmp(series->header.magic, Q_SERIES_MAGIC, sizeof(series->header.magic)) != 0) {
+		printf("\n%s is not a Q series\n", qSeriesFile);
+		exit(1);
+	}
+
+	if (series->header.version != Q_SERIES_VERSION || (series->header.type != Q_SERIES_INT32 && series->header.type != Q_SERIES_FLOAT) ||
+	    series->header.columns < 1 || series->header.stride < 1 || series->header.frames < 0) {
+		printf("\n%s is a Q series of another version\n", qSeriesFile);
+		exit(1);
+	}
+
+	size_t values = (size_t) series->header.frames * series->header.columns;
+
+	series->cutoff = (float*) malloc(sizeof(float) * series->header.columns);
+	series->values = malloc(4 * (values > 0 ? values : 1));
+	if(!series->cutoff || !series->values) {
+		perror("series memory not allocated");
+		abort();
+	}
+
+	if (fread(series->cutoff, sizeof(float), series->header.columns, fp) != (size_t) series->header.columns ||
+	    fread(series->values, 4, values, fp) != values) {
+		printf("\n%s ends before its last frame\n", qSeriesFile);
+		exit(1);
+	}
+
+	fclose(fp);
+
+	return series;
+}
+
+/*
+*	Name: int isQSeriesFile()
+*	Description: Tells a binary Q series from a text qFile by its first bytes.
+*
+*	Args: -char *file - a qFile or Q series
+*
+*	Returns: -int - 1 if the file starts with the magic of a Q series, otherwise 0
+*/
+
+int isQSeriesFile(char *file) {
+	char magic[sizeof(((struct QSeriesHeader*) 0)->magic)];
+	int found;
+	FILE *fp;
+
+	if ((fp = fopen(file, "rb")) == NULL) {
+		printf("\nCould not open %s\n", file);
+		exit(1);
+	}
+
+	found = fread(magic, sizeof(magic), 1, fp) == 1 && memcmp(magic, Q_SERIES_MAGIC, sizeof(magic)) == 0;
+	fclose(fp);
+
+	return found;
+}
+
+/*
+*	Name: double* readQValuesFile()
+*	Description: Reads the Q values of a trajectory from a qFile written by
+*		     calcQFromContactsProg, or from a binary Q series, for programs that take
+*		     either.  With several cutoffs the first column is used.
+*
+*	Args: -char *qFile - a qFile or Q series
+*	      -int *frames - set to the amount of Q values
+*	      -int *firstFrame - set to the frame of the first Q value, starting at 0
+*	      -int *stride - set to the frames between Q values
+*
+*	Returns: -double *qValue - the Q value of every frame
+*/
+
+double* readQValuesFile(char *qFile, int *frames, int *firstFrame, int *stride) {
+	char line[Q_SERIES_LINE];
+	double *qValue = NULL;
+	int capacity = 0;
+	FILE *fp;
+
+	*frames = 0;
+	*firstFrame = 0;
+	*stride = 1;
+
+	if (isQSeriesFile(qFile)) {
+		struct QSeries *series = readQSeries(qFile);
+		int columns = series->header.columns;
+
+		*frames = series->header.frames;
+		*firstFrame = series->header.firstFrame;
+		*stride = series->header.stride;
+
+		qValue = (double*) malloc(sizeof(double) * (*frames > 0 ? *frames : 1));
+		if(!qValue) {
+			perror("qValue memory not allocated");
+			abort();
+		}
+
+		for(int i = 0; i < *frames; i++) {
+			if (series->header.type == Q_SERIES_FLOAT) {
+				qValue[i] = ((float*) series->values)[(size_t)i * columns];
+			} else {
+				qValue[i] = ((int32_t*) series->values)[(size_t)i * columns];
+			}
+		}
+
+		freeQSeries(series);
+
+		return qValue;
+	}
+
+	if ((fp = fopen(qFile, "r")) == NULL) {
+		printf("\nCould not open %s\n", qFile);
+		exit(1);
+	}
+
+	while(fgets(line, sizeof(line), fp) != NULL) {
+		char *end;
+		double value = strtod(line, &end);
+
+		if (end == line) {
+			continue;
+		}
+
+		if (*frames == capacity) {
+			capacity = capacity ? capacity * 2 : 4096;
+			qValue = (double*) realloc(qValue, sizeof(double) * capacity);
+			if(!qValue) {
+				perror("qValue memory not allocated");
+				abort();
+			}
+		}
+
+		qValue[(*frames)++] = value;
+	}
+
+	fclose(fp);
+
+	return qValue;
+}
+
+/*
+*	Name: void writeQSeriesText()
+*	Description: Writes a Q series as the qFile calcQFromContactsProg writes for it.
+*
+*	Args: -struct QSeries *series - from readQSeries()
+*	      -char *qFile - the file name where Q values will be written
+*/
+
+void writeQSeriesText(struct QSeries *series, char *qFile) {
+	if(series->header.type == Q_SERIES_FLOAT) {
+		writeSmoothQFile((float*) series->values, series->header.frames, qFile);
+	} else {
+		writeQFileCutoffs((int*) series->values, series->header.frames, series->header.columns, qFile);
+	}
+}
+
+/*
+*	Name: void checkQSeries()
+*	Description: Exits with a message unless the Q series holds the Q values of one
+*		     cutoff, calculated with this cutoff and contact file from the trajectory
+*		     of the stream.
+*
+*	Args: -struct QSeries *series - from readQSeries()
+*	      -struct XtcStream *stream - the trajectory the series will be used with
+*	      -char *contactFile - the contacts file being used
+*	      -float cutoff - the cutoff being used
+*/
+
+void checkQSeries(struct QSeries *series, struct XtcStream *stream, char *contactFile, float cutoff) {
+	if(series->header.type != Q_SERIES_INT32 || series->header.columns != 1) {
+		printf("\nThe Q series must hold the Q values of a single cutoff\n");
+		exit(1);
+	}
+
+	if(series->cutoff[0] != cutoff) {
+		printf("\nThe Q series was calculated with a cutoff of %g, not %g\n", series->cutoff[0], cutoff);
+		exit(1);
+	}
+
+	if(series->header.contactHash != hashFileContents(contactFile)) {
+		printf("\nThe Q series was calculated with another contact file than %s\n", contactFile);
+		exit(1);
+	}
+
+	// The index is kept on the stream, which seeks by it later
+	if(!stream->index) {
+		stream->index = getXtcFrameIndex(stream->xtcFile);
+	}
+
+	checkQSeriesSteps(series, stream->index, stream->xtcFile);
+}
+
+/*
+*	Name: void checkQSeriesSteps()
+*	Description: Exits with a message unless the first and last frame of the Q series
+*		     are frames of the trajectory with the steps recorded in the series, so
+*		     the series was calculated from this trajectory or one it was extended
+*		     from.
+*
+*	Args: -struct QSeries *series - from readQSeries()
+*	      -struct XtcFrameIndex *index - frame index of the trajectory
+*	      -char *xtcFile - location of the trajectory, for the message
+*/
+
+void checkQSeriesSteps(struct QSeries *series, struct XtcFrameIndex *index, char *xtcFile) {
+	int64_t firstFrame = series->header.firstFrame;
+	int64_t lastFrame = firstFrame + (series->header.frames - 1) * series->header.stride;
+
+	if(series->header.frames == 0) {
+		return;
+	}
+
+	if(lastFrame >= index->frames) {
+		printf("\nThe Q series goes up to frame %lld, %s has %d frames\n", (long long) lastFrame + 1, xtcFile, index->frames);
+		exit(1);
+	}
+
+	if(index->steps[firstFrame] != series->header.firstStep || index->steps[lastFrame] != series->header.lastStep) {
+		printf("\nThe Q series was calculated from another trajectory than %s, its steps %lld to %lld are steps %d to %d there\n",
+		       xtcFile, (long long) series->header.firstStep, (long long) series->header.lastStep, index->steps[firstFrame], index->steps[lastFrame]);
+		exit(1);
+	}
+}
+
+/*
+*	Name: int getQSeriesValue()
+*	Description: Finds the Q value of a frame of the trajectory.
+*
+*	Args: -struct QSeries *series - an int32_t Q series of one column
+*	      -int frame - the frame, starting at 0
+*	      -int *qValue - set to the Q value of the frame
+*
+*	Returns: -int found - 1 if the frame is in the series, 0 if the series ended before
+*			      it, -1 if the series skipped it
+*/
+
+int getQSeriesValue(struct QSeries *series, int frame, int *qValue) {
+	int64_t offset = frame - series->header.firstFrame;
+
+	if(offset < 0 || offset % series->header.stride != 0) {
+		return -1;
+	}
+
+	if(offset / series->header.stride >= series->header.frames) {
+		return 0;
+	}
+
+	*qValue = ((int32_t*) series->values)[offset / series->header.stride];
+
+	return 1;
+}
+
+/*
+*	Name: struct ContactInformation* calculateContactProbabilityFromQSeries()
+*	Description: Same as calculateContactProbabilityFromStream(), taking the Q value of
+*		     every frame from a Q series.  Only the frames in the time range whose Q
+*		     value is in the Q range are decoded.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -struct QSeries *series - Q values of the same trajectory, from readQSeries()
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -struct QRange qRange - low and high range of Q values
+*	      -struct TSRange timeRange - low and high range of time slices
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*
+*	Returns: -struct ContactInformation* residueContactsInformation - an array of structures
+*				containing values for every variable
+*/
+
+struct ContactInformation* calculateContactProbabilityFromQSeries(struct XtcStream *stream, struct QSeries *series, int contacts, struct Contact *residueContacts, struct QRange qRange, struct TSRange timeRange, float cutOff) {
+	struct ContactInformation* residueContactsInformation = createResidueContactInformation(contacts, residueContacts);
+	uint64_t *contactStates = allocateContactStatesMemory(1, contacts);
+	int qValuesInRange = 0, qValue, found;
+
+	setXtcStreamTimeRange(stream, timeRange);
+
+	// Frames of the time range and stride, the same as readXtcStreamFrame() returns
+	for(int frame = nextXtcStreamFrame(stream); frame <= stream->lastFrame; frame += stream->stride) {
+		found = getQSeriesValue(series, frame, &qValue);
+
+		// The series ends with the trajectory, unless it was calculated with a --range
+		if(found == 0) {
+			if(!stream->index) {
+				stream->index = getXtcFrameIndex(stream->xtcFile);
+			}
+
+			if(frame < stream->index->frames) {
+				printf("\nThe Q series ends before frame %d of %s\n", frame + 1, stream->xtcFile);
+				exit(1);
+			}
+
+			break;
+		}
+
+		if(found < 0) {
+			printf("\nThe Q series has no Q value for frame %d, it was calculated with another --stride or --range\n", frame + 1);
+			exit(1);
+		}
+
+		// If the Q value is within the defined range
+		if(qValue >= qRange.low && qValue <= qRange.high) {
+			if(stream->currentFrame != frame) {
+				seekXtcStreamFrame(stream, frame);
+			}
+
+			if(!readXtcStreamFrame(stream)) {
+				printf("\n%s ended before frame %d of the Q series\n", stream->xtcFile, frame + 1);
+				exit(1);
+			}
+
+			calculateContactStates(contacts, cutOff, stream->frame, residueContacts, contactStates);
+			addContactStateOccurrences(contacts, contactStates, residueContactsInformation);
+			qValuesInRange++;
+		}
+	}
+
+	free(contactStates);
+
+	calculateProbabilities(contacts, residueContactsInformation, qValuesInRange);
+
+	return residueContactsInformation;
+}
+
+/*
+*	Name: void freeQSeries()
+*	Description:	Frees the cutoffs and values of a series and frees the series.
+*
+*	Args: -struct QSeries *series - series from readQSeries or createQSeries.
+*/
+
+void freeQSeries(struct QSeries *series) {
+	free(series->cutoff);
+	free(series->values);
+	free(series);
+}
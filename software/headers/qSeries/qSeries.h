@@ -0,0 +1,60 @@
+/*
+*	Name: qSeries.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef Q_SERIES
+#define Q_SERIES
+
+#include <stdint.h>
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactReader/contactReader.h"
+#include "../probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+
+#define Q_SERIES_MAGIC "QSERIES\0"
+#define Q_SERIES_VERSION 1
+
+#define Q_SERIES_LINE 4096
+
+// Values are int32_t Q values, or the float fraction of --native
+#define Q_SERIES_INT32 0
+#define Q_SERIES_FLOAT 1
+
+// Followed by a float cutoff per column, then frames rows of columns values
+struct QSeriesHeader {
+	char magic[8];
+	int32_t version;
+	int32_t type;
+	int32_t columns;
+	int32_t stride;
+	int64_t frames;
+	int64_t firstFrame;
+	int64_t firstStep;
+	int64_t lastStep;
+	float firstTime;
+	float lastTime;
+	uint64_t contactHash;
+};
+
+struct QSeries {
+	struct QSeriesHeader header;
+	float *cutoff;
+	void *values;
+};
+
+struct QSeries* createQSeries(int type, int columns, float *cutoff, int xtcFrames, void *values, struct XtcStream *stream, char *contactFile);
+void writeQSeries(struct QSeries *series, char *qSeriesFile);
+struct QSeries* readQSeries(char *qSeriesFile);
+int isQSeriesFile(char *file);
+double* readQValuesFile(char *qFile, int *frames, int *firstFrame, int *stride);
+void writeQSeriesText(struct QSeries *series, char *qFile);
+void checkQSeries(struct QSeries *series, struct XtcStream *stream, char *contactFile, float cutoff);
+void checkQSeriesSteps(struct QSeries *series, struct XtcFrameIndex *index, char *xtcFile);
+int getQSeriesValue(struct QSeries *series, int frame, int *qValue);
+struct ContactInformation* calculateContactProbabilityFromQSeries(struct XtcStream *stream, struct QSeries *series, int contacts, struct Contact *residueContacts, struct QRange qRange, struct TSRange timeRange, float cutOff);
+void freeQSeries(struct QSeries *series);
+
+#endif
@@ -0,0 +1,114 @@
+/*
+*	Name: residueGraph.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Maps every residue to the contacts it is part of, as either residue of the pair.
+*		The graph is built once from the contact list with a counting sort, in time
+*		linear in the amount of contacts, and is then used for per-residue reductions
+*		such as the average contact probability.  Within a residue the contacts where
+*		it is the focusResidue come first, then those where it is the contactResidue,
+*		each in contactFile order.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "residueGraph.h"
+
+/*
+*	Name: struct ResidueGraph* createResidueGraph()
+*	Description: Builds the rows of every residue from the contact list.
+*
+*	Args: -int residues - the amount of residues in the protein
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*
+*	Returns: -struct ResidueGraph *graph - the contacts of every residue
+*/
+
+struct ResidueGraph* createResidueGraph(int residues, int contacts, struct Contact *residueContacts) {
+	struct ResidueGraph *graph = (struct ResidueGraph*) malloc(sizeof(struct ResidueGraph));
+	if(!graph) {
+		perror("graph memory not allocated");
+		abort();
+	}
+
+	graph->residues = residues;
+	graph->contacts = contacts;
+	graph->rowStart = (int*) calloc(residues + 1, sizeof(int));
+	graph->contact = (int*) malloc(sizeof(int) * (contacts > 0 ? contacts * 2 : 1));
+
+	if(!graph->rowStart || !graph->contact) {
+		perror("graph memory not allocated");
+		abort();
+	}
+
+	// Counts the contacts of every residue, rowStart[r] holds residue r
+	for(int i = 0; i < contacts; i++) {
+		int focus = residueContacts[i].focusResidue;
+		int contact = residueContacts[i].contactResidue;
+
+		if(focus < 1 || focus > residues || contact < 1 || contact > residues) {
+			printf("\nContact %d (%d %d) is outside of the %d residues\n", i + 1, focus, contact, residues);
+			exit(1);
+		}
+
+		graph->rowStart[focus]++;
+		graph->rowStart[contact]++;
+	}
+
+	// Turns the counts into the start of every row
+	for(int r = 1; r <= residues; r++) {
+		graph->rowStart[r] += graph->rowStart[r-1];
+	}
+
+	// Fills every row from its start, focusResidue pass first; rowStart[r-1] is moved
+	// to the end of row r and then shifted back
+	for(int pass = 0; pass < 2; pass++) {
+		for(int i = 0; i < contacts; i++) {
+			int residue = pass == 0 ? residueContacts[i].focusResidue : residueContacts[i].contactResidue;
+
+			graph->contact[graph->rowStart[residue-1]++] = i;
+		}
+	}
+
+	for(int r = residues; r > 0; r--) {
+		graph->rowStart[r] = graph->rowStart[r-1];
+	}
+	graph->rowStart[0] = 0;
+
+	return graph;
+}
+
+/*
+*	Name: int* getResidueGraphContacts()
+*	Description: Finds the contacts of one residue.
+*
+*	Args: -struct ResidueGraph *graph - from createResidueGraph()
+*	      -int residue - the residue, starting at 1
+*	      -int *residueContacts - set to the amount of contacts of the residue
+*
+*	Returns: -int *contact - indices into the contact list of the contacts of the residue
+*/
+
+int* getResidueGraphContacts(struct ResidueGraph *graph, int residue, int *residueContacts) {
+	*residueContacts = graph->rowStart[residue] - graph->rowStart[residue-1];
+
+	return &graph->contact[graph->rowStart[residue-1]];
+}
+
+/*
+*	Name: void freeResidueGraph()
+*	Description:	Frees the row starts and contacts of a residue graph and the graph.
+*
+*	Args: -struct ResidueGraph *graph - graph from createResidueGraph.
+*/
+
+void freeResidueGraph(struct ResidueGraph *graph) {
+	free(graph->rowStart);
+	free(graph->contact);
+	free(graph);
+}
@@ -0,0 +1,26 @@
+/*
+*	Name: residueGraph.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef RESIDUE_GRAPH
+#define RESIDUE_GRAPH
+
+#include "../contactReader/contactReader.h"
+
+// Compressed sparse rows: the contacts of residue r are contact[rowStart[r-1]] to
+// contact[rowStart[r]-1], indices into the contact list of the contactFile
+struct ResidueGraph {
+	int residues;
+	int contacts;
+	int *rowStart;
+	int *contact;
+};
+
+struct ResidueGraph* createResidueGraph(int residues, int contacts, struct Contact *residueContacts);
+int* getResidueGraphContacts(struct ResidueGraph *graph, int residue, int *residueContacts);
+void freeResidueGraph(struct ResidueGraph *graph);
+
+#endif
@@ -0,0 +1,330 @@
+/*
+*	Name: resultCache.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Keeps the results of an analysis in a directory given with --cache, or with the
+*		environment variable PROTEIN_CACHE, so running the same analysis again reads
+*		them instead of the trajectory.  An entry is named by a 64-bit key hashed from
+*		the stage, the identities of the traj.xtc and contact file (size, modification
+*		time and contents) and the settings that change the results.  The contact file
+*		is hashed whole and the traj.xtc by its first and last RESULT_CACHE_SAMPLE
+*		bytes, so a key takes milliseconds to find.  Hits and misses are reported on
+*		stderr.  After an entry is added, the entries used least recently are removed
+*		until the directory holds no more than --cache-size megabytes (default
+*		RESULT_CACHE_SIZE).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <utime.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "../fileIdentity/fileIdentity.h"
+#include "../programOptions/programOptions.h"
+#include "resultCache.h"
+
+struct ResultCacheEntry {
+	char *file;
+	int64_t size;
+	// Modification time in nanoseconds
+	int64_t used;
+	int kept;
+};
+
+static int compareResultCacheEntries(const void *a, const void *b);
+
+/*
+*	Name: struct ResultCache* openResultCache()
+*	Description: Removes --cache and --cache-size from argv and, if a cache directory was
+*		     given or PROTEIN_CACHE is set, creates the directory if needed.
+*
+*	Args: -int *argc - argument count, reduced by the options found.
+*	      -char *argv[] - arguments.
+*
+*	Returns: -struct ResultCache *cache - the cache, or NULL when no cache is used.
+*/
+
+struct ResultCache* openResultCache(int *argc, char *argv[]) {
+	char *directory = takeOption(argc, argv, "--cache");
+	float sizeLimit = takeFloatOption(argc, argv, "--cache-size", RESULT_CACHE_SIZE);
+
+	if (!directory) {
+		directory = getenv("PROTEIN_CACHE");
+	}
+
+	if (!directory || directory[0] == '\0') {
+		return NULL;
+	}
+
+	if (mkdir(directory, 0777) != 0 && errno != EEXIST) {
+		printf("\nCould not create the cache directory %s\n", directory);
+		exit(1);
+	}
+
+	struct ResultCache *cache = (struct ResultCache*) malloc(sizeof(struct ResultCache));
+	if(!cache) {
+		perror("cache memory not allocated");
+		abort();
+	}
+
+	cache->directory = strdup(directory);
+	cache->entryFile = NULL;
+	cache->sizeLimit = (int64_t) (sizeLimit * 1048576.0);
+	cache->key = 0;
+
+	return cache;
+}
+
+/*
+*	Name: void setResultCacheKey()
+*	Description: Names the entry of one stage of an analysis.
+*
+*	Args: -struct ResultCache *cache - from openResultCache().
+*	      -char *stage - the results being kept, for example "qValues".
+*	      -char *xtcFile - the traj.xtc file being analysed.
+*	      -char *contactFile - the contacts file of the analysis.
+*	      -char *settings - every other setting that changes the results, as text.
+*/
+
+void setResultCacheKey(struct ResultCache *cache, char *stage, char *xtcFile, char *contactFile, char *settings) {
+	struct FileIdentity xtcIdentity = getFileIdentity(xtcFile, 0);
+	struct FileIdentity contactIdentity = getFileIdentity(contactFile, 1);
+	uint64_t key = FILE_IDENTITY_HASH_SEED;
+
+	xtcIdentity.hash = hashFileSample(xtcFile, RESULT_CACHE_SAMPLE);
+
+	// The stage and settings end with their null, so "ab" "c" and "a" "bc" differ
+	key = hashBytes(key, stage, strlen(stage) + 1);
+	key = hashBytes(key, &xtcIdentity, sizeof(xtcIdentity));
+	key = hashBytes(key, &contactIdentity, sizeof(contactIdentity));
+	key = hashBytes(key, settings, strlen(settings) + 1);
+
+	free(cache->entryFile);
+	cache->entryFile = (char*) malloc(strlen(cache->directory) + 18 + sizeof(RESULT_CACHE_SUFFIX));
+	if(!cache->entryFile) {
+		perror("entryFile memory not allocated");
+		abort();
+	}
+
+	sprintf(cache->entryFile, "%s/%016llx%s", cache->directory, (unsigned long long) key, RESULT_CACHE_SUFFIX);
+	cache->key = key;
+}
+
+/*
+*	Name: void* readResultCache()
+*	Description: Reads the results of the entry named by setResultCacheKey(), and marks
+*		     the entry as used.
+*
+*	Args: -struct ResultCache *cache - with a key set.
+*	      -int64_t *frames - set to the frames of the results.
+*	      -int64_t *bytes - set to the size of the results.
+*
+*	Returns: -void *data - the results, or NULL if the entry is missing or incomplete.
+*/
+
+void* readResultCache(struct ResultCache *cache, int64_t *frames, int64_t *bytes) {
+	struct ResultCacheHeader header;
+	char *data = NULL;
+	FILE *fp;
+
+	if ((fp = fopen(cache->entryFile, "rb")) != NULL) {
+		if (fread(&header, sizeof(header), 1, fp) == 1 &&
+		    memcmp(header.magic, RESULT_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+		    header.version == RESULT_CACHE_VERSION && header.key == cache->key && header.bytes >= 0) {
+			data = (char*) malloc(header.bytes > 0 ? header.bytes : 1);
+			if(!data) {
+				perror("cache data memory not allocated");
+				abort();
+			}
+
+			if (header.bytes > 0 && fread(data, header.bytes, 1, fp) != 1) {
+				free(data);
+				data = NULL;
+			}
+		}
+
+		fclose(fp);
+	}
+
+	if (!data) {
+		fprintf(stderr, "Cache miss: %s\n", cache->entryFile);
+		return NULL;
+	}
+
+	// The modification time orders the entries for eviction
+	utime(cache->entryFile, NULL);
+	fprintf(stderr, "Cache hit: %s\n", cache->entryFile);
+
+	*frames = header.frames;
+	*bytes = header.bytes;
+
+	return data;
+}
+
+/*
+*	Name: void writeResultCache()
+*	Description: Adds the results as the entry named by setResultCacheKey(), then evicts
+*		     entries over the size of the cache.  If the entry can not be written the
+*		     analysis goes on without it.
+*
+*	Args: -struct ResultCache *cache - with a key set.
+*	      -void *data - the results.
+*	      -int64_t frames - the frames of the results.
+*	      -int64_t bytes - the size of the results.
+*/
+
+void writeResultCache(struct ResultCache *cache, void *data, int64_t frames, int64_t bytes) {
+	struct ResultCacheHeader header;
+	char *tmpFile;
+	FILE *fp = NULL;
+	int fd, written = 0;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, RESULT_CACHE_MAGIC, sizeof(header.magic));
+	header.version = RESULT_CACHE_VERSION;
+	header.key = cache->key;
+	header.frames = frames;
+	header.bytes = bytes;
+
+	tmpFile = (char*) malloc(strlen(cache->entryFile) + sizeof(".XXXXXX"));
+	if(!tmpFile) {
+		perror("tmpFile memory not allocated");
+		abort();
+	}
+
+	strcpy(tmpFile, cache->entryFile);
+	strcat(tmpFile, ".XXXXXX");
+
+	// Readers never see a partly written entry, and processes adding the same entry
+	// at once each write their own temporary file
+	if ((fd = mkstemp(tmpFile)) != -1) {
+		fchmod(fd, 0644);
+		if ((fp = fdopen(fd, "wb")) == NULL) {
+			close(fd);
+		}
+	}
+
+	if (fp != NULL) {
+		written = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+			  (bytes == 0 || fwrite(data, bytes, 1, fp) == 1);
+		written = fclose(fp) == 0 && written && rename(tmpFile, cache->entryFile) == 0;
+	}
+
+	if (!written) {
+		fprintf(stderr, "Could not add %s to the cache\n", cache->entryFile);
+		remove(tmpFile);
+	}
+
+	free(tmpFile);
+
+	evictResultCache(cache->directory, cache->sizeLimit, cache->entryFile);
+}
+
+/*
+*	Name: void evictResultCache()
+*	Description: Removes the entries used least recently until the entries in the
+*		     directory add up to no more than sizeLimit bytes.  Entries are ordered
+*		     by their modification time in nanoseconds, and the entry just written
+*		     is never removed, even if it is larger than sizeLimit on its own.
+*
+*	Args: -char *directory - the cache directory.
+*	      -int64_t sizeLimit - bytes the entries may use.
+*	      -char *keepFile - the entry just written, or NULL.
+*/
+
+void evictResultCache(char *directory, int64_t sizeLimit, char *keepFile) {
+	struct ResultCacheEntry *entry = NULL;
+	int entries = 0, capacity = 0, evicted = 0, keep;
+	int64_t total = 0;
+	struct dirent *file;
+	struct stat fileStat, keepStat;
+	DIR *dir;
+
+	if ((dir = opendir(directory)) == NULL) {
+		return;
+	}
+
+	keep = keepFile != NULL && stat(keepFile, &keepStat) == 0;
+
+	while((file = readdir(dir)) != NULL) {
+		size_t length = strlen(file->d_name);
+
+		if (length <= strlen(RESULT_CACHE_SUFFIX) || strcmp(&file->d_name[length - strlen(RESULT_CACHE_SUFFIX)], RESULT_CACHE_SUFFIX) != 0) {
+			continue;
+		}
+
+		char *path = (char*) malloc(strlen(directory) + length + 2);
+		if(!path) {
+			perror("path memory not allocated");
+			abort();
+		}
+
+		sprintf(path, "%s/%s", directory, file->d_name);
+
+		if (stat(path, &fileStat) != 0) {
+			free(path);
+			continue;
+		}
+
+		if (entries == capacity) {
+			capacity = capacity ? capacity * 2 : 64;
+			entry = (struct ResultCacheEntry*) realloc(entry, sizeof(struct ResultCacheEntry) * capacity);
+			if(!entry) {
+				perror("entry memory not allocated");
+				abort();
+			}
+		}
+
+		entry[entries].file = path;
+		entry[entries].size = (int64_t) fileStat.st_size;
+		entry[entries].used = (int64_t) fileStat.st_mtim.tv_sec * 1000000000 + fileStat.st_mtim.tv_nsec;
+		entry[entries].kept = keep && fileStat.st_dev == keepStat.st_dev && fileStat.st_ino == keepStat.st_ino;
+		total += entry[entries++].size;
+	}
+
+	closedir(dir);
+
+	qsort(entry, entries, sizeof(struct ResultCacheEntry), compareResultCacheEntries);
+
+	for(int i = 0; i < entries; i++) {
+		if (total > sizeLimit && !entry[i].kept && remove(entry[i].file) == 0) {
+			total -= entry[i].size;
+			evicted++;
+		}
+
+		free(entry[i].file);
+	}
+
+	free(entry);
+
+	if (evicted > 0) {
+		fprintf(stderr, "Cache evicted %d entries from %s\n", evicted, directory);
+	}
+}
+
+/*
+*	Name: void freeResultCache()
+*	Description:	Frees a cache and its directory and entry file names.  Nothing is written.
+*
+*	Args: -struct ResultCache *cache - cache from openResultCache.
+*/
+
+void freeResultCache(struct ResultCache *cache) {
+	free(cache->directory);
+	free(cache->entryFile);
+	free(cache);
+}
+
+static int compareResultCacheEntries(const void *a, const void *b) {
+	const struct ResultCacheEntry *entry1 = (const struct ResultCacheEntry*) a;
+	const struct ResultCacheEntry *entry2 = (const struct ResultCacheEntry*) b;
+
+	return (entry1->used > entry2->used) - (entry1->used < entry2->used);
+}
@@ -0,0 +1,47 @@
+/*
+*	Name: resultCache.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef RESULT_CACHE
+#define RESULT_CACHE
+
+#include <stdint.h>
+
+#define RESULT_CACHE_MAGIC "QCACHE\0\0"
+#define RESULT_CACHE_VERSION 1
+#define RESULT_CACHE_SUFFIX ".qcache"
+
+// Megabytes kept in the cache directory, unless --cache-size is given
+#define RESULT_CACHE_SIZE 1024
+
+// Bytes hashed at the start and at the end of the traj.xtc for its key
+#define RESULT_CACHE_SAMPLE 1048576
+
+// Followed by bytes of results: Q values, fractional Q values or struct ContactInformation
+struct ResultCacheHeader {
+	char magic[8];
+	int32_t version;
+	int32_t reserved;
+	uint64_t key;
+	int64_t frames;
+	int64_t bytes;
+};
+
+struct ResultCache {
+	char *directory;
+	char *entryFile;
+	int64_t sizeLimit;
+	uint64_t key;
+};
+
+struct ResultCache* openResultCache(int *argc, char *argv[]);
+void setResultCacheKey(struct ResultCache *cache, char *stage, char *xtcFile, char *contactFile, char *settings);
+void* readResultCache(struct ResultCache *cache, int64_t *frames, int64_t *bytes);
+void writeResultCache(struct ResultCache *cache, void *data, int64_t frames, int64_t bytes);
+void evictResultCache(char *directory, int64_t sizeLimit, char *keepFile);
+void freeResultCache(struct ResultCache *cache);
+
+#endif
@@ -0,0 +1,272 @@
+/*
+*	Name: smoothQ.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Calculates the fractional Q of every frame with the switching function of Best,
+*		Hummer and Eaton, Q(X) = 1/N sum 1/(1 + exp(beta(r - lambda r0))), where r0 is
+*		the distance of the contact in the native structure.  A contact at its native
+*		distance counts as almost 1 and fades to 0 as it stretches past lambda r0, so
+*		unlike the cutoff Q the value changes smoothly with the coordinates.
+*
+*		The native structure is read from a .gro file, for example the one made by SMOG
+*		Server, or from the first frame of a traj.xtc.  The sum over contacts is done by
+*		calculateContactKernelSmooth().
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../calcQFromContacts/calcQFromContacts.h"
+#include "../contactKernel/contactKernel.h"
+#include "smoothQ.h"
+
+static struct XtcCoordinates* readGroCoordinates(char *groFile, int residues);
+
+/*
+*	Name: struct SmoothQ* createSmoothQ()
+*	Description: Measures every contact in the native structure and stores lambda times
+*		     the native distance, where the switching function is 1/2.
+*
+*	Args: -int contacts - the amount of contacts in the contacts file.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -struct XtcCoordinates *nativeFrame - residue coordinates of the native structure.
+*	      -float beta - steepness of the switching function, in 1/nm.
+*	      -float lambda - how far past the native distance a contact is half formed.
+*
+*	returns: -struct SmoothQ *smoothQ - the parameters of the fractional Q.
+*/
+
+struct SmoothQ* createSmoothQ(int contacts, struct Contact *residueContacts, struct XtcCoordinates *nativeFrame, float beta, float lambda) {
+	struct SmoothQ *smoothQ = (struct SmoothQ*) malloc(sizeof(struct SmoothQ));
+	if(!smoothQ) {
+		perror("smoothQ memory not allocated");
+		abort();
+	}
+
+	smoothQ->contacts = contacts;
+	smoothQ->beta = beta;
+	smoothQ->lambda = lambda;
+	smoothQ->switchDistance = (float*) malloc(sizeof(float) * (contacts > 0 ? contacts : 1));
+	if(!smoothQ->switchDistance) {
+		perror("switchDistance memory not allocated");
+		abort();
+	}
+
+	for(int j = 0; j < contacts; j++) {
+		float nativeDistance = calculateDistance(nativeFrame[residueContacts[j].focusResidue-1],
+				nativeFrame[residueContacts[j].contactResidue-1]);
+
+		smoothQ->switchDistance[j] = lambda * nativeDistance;
+	}
+
+	return smoothQ;
+}
+
+/*
+*	Name: struct XtcCoordinates* readNativeStructure()
+*	Description: Reads the residue coordinates of the native structure from a .gro file,
+*		     or from the first frame of any other file, read as a traj.xtc.
+*
+*	Args: -char *nativeFile - location of the native structure.
+*	      -int residues - total number of residues in the protein.
+*
+*	returns: -struct XtcCoordinates *nativeFrame - coordinates of every residue, in nm.
+*/
+
+struct XtcCoordinates* readNativeStructure(char *nativeFile, int residues) {
+	size_t length = strlen(nativeFile);
+
+	if(length >= 4 && strcmp(nativeFile + length - 4, ".gro") == 0) {
+		return readGroCoordinates(nativeFile, residues);
+	}
+
+	struct XtcStream *stream = openXtcStream(nativeFile, residues);
+	struct XtcCoordinates *nativeFrame = (struct XtcCoordinates*) malloc(sizeof(struct XtcCoordinates) * residues);
+	if(!nativeFrame) {
+		perror("nativeFrame memory not allocated");
+		abort();
+	}
+
+	if(!readXtcStreamFrame(stream)) {
+		printf("\n%s has no frames\n", nativeFile);
+		exit(1);
+	}
+
+	memcpy(nativeFrame, stream->frame, sizeof(struct XtcCoordinates) * residues);
+	closeXtcStream(stream);
+
+	return nativeFrame;
+}
+
+/*
+*	Name: float calculateFrameSmoothQValue()
+*	Description: Calculates the fractional Q of one frame.
+*
+*	Args: -struct SmoothQ *smoothQ - from createSmoothQ().
+*	      -struct XtcCoordinates *frame - residue coordinates of one frame.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*
+*	returns: -float qValue - between 0 and 1.
+*/
+
+float calculateFrameSmoothQValue(struct SmoothQ *smoothQ, struct XtcCoordinates *frame, struct Contact *residueContacts) {
+	if(smoothQ->contacts == 0) {
+		return 0.0f;
+	}
+
+	double sum = calculateContactKernelSmooth(&frame[0].x, &frame[0].y, &frame[0].z, 3, smoothQ->contacts, residueContacts,
+			smoothQ->switchDistance, smoothQ->beta);
+
+	return (float)(sum / smoothQ->contacts);
+}
+
+/*
+*	Name: float* calculateSmoothQValuesFromStream()
+*	Description: Same as calculateQValuesFromStream(), calculating the fractional Q.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -struct SmoothQ *smoothQ - from createSmoothQ().
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -int *xtcFrames - set to the amount of frames read from the stream.
+*
+*	returns: -float *qValues - a fractional Q for each frame read from the traj.xtc.
+*/
+
+float* calculateSmoothQValuesFromStream(struct XtcStream *stream, struct SmoothQ *smoothQ, struct Contact *residueContacts, int *xtcFrames) {
+	int capacity = 1024, frames = 0;
+	float *qValues = allocateSmoothQValuesMemory(capacity);
+
+	// For every frame decoded from the traj.xtc file
+	while(readXtcStreamFrame(stream)) {
+		if(frames == capacity) {
+			capacity *= 2;
+			qValues = (float*) realloc(qValues, sizeof(float) * capacity);
+			if(!qValues) {
+				perror("qValues memory not allocated");
+				abort();
+			}
+		}
+
+		qValues[frames++] = calculateFrameSmoothQValue(smoothQ, stream->frame, residueContacts);
+	}
+
+	*xtcFrames = frames;
+
+	return qValues;
+}
+
+/*
+*	Name: void writeSmoothQFile()
+*	Description: Creates a file with a fractional Q on every line.
+*
+*	Args: -float *qValues - a fractional Q for each frame of the traj.xtc.
+*	      -int xtcFrames - the amount of frames in the traj.xtc file.
+*	      -char *qFile - the file name where Q values will be written.
+*/
+
+void writeSmoothQFile(float *qValues, int xtcFrames, char *qFile) {
+	FILE *fp;
+
+	if ((fp = fopen(qFile, "w")) == NULL) {
+		perror("could not open qFile for output.");
+		exit(1);
+	}
+
+	for(int i = 0; i < xtcFrames; i++) {
+		fprintf(fp, "%.6f\n", qValues[i]);
+	}
+
+	fclose(fp);
+}
+
+/*
+*	Name: float* allocateSmoothQValuesMemory()
+*	Description:	Allocates one smooth Q value per frame.
+*
+*	Args: -int xtcFrames - the amount of frames.
+*
+*	Returns: -float *qValues - room for xtcFrames values.
+*/
+
+float* allocateSmoothQValuesMemory(int xtcFrames) {
+	float *qValues = (float*) malloc(sizeof(float) * (xtcFrames > 0 ? xtcFrames : 1));
+	if(!qValues) {
+		perror("qValues memory not allocated");
+		abort();
+	}
+
+	return qValues;
+}
+
+/*
+*	Name: void freeSmoothQ()
+*	Description:	Frees the switching distances and the parameters.
+*
+*	Args: -struct SmoothQ *smoothQ - parameters from createSmoothQ.
+*/
+
+void freeSmoothQ(struct SmoothQ *smoothQ) {
+	free(smoothQ->switchDistance);
+	free(smoothQ);
+}
+
+/*
+*	Name: static struct XtcCoordinates* readGroCoordinates()
+*	Description: Reads the first residues atoms of a .gro file.  After a title line and
+*		     the atom count, each atom line has its x, y and z in nm in the 8 character
+*		     columns starting at character 21.
+*/
+
+static struct XtcCoordinates* readGroCoordinates(char *groFile, int residues) {
+	struct XtcCoordinates *nativeFrame;
+	char line[256];
+	int atoms;
+	FILE *fp;
+
+	if ((fp = fopen(groFile, "r")) == NULL) {
+		perror("could not open native structure for readGroCoordinates().");
+		exit(1);
+	}
+
+	if (!fgets(line, sizeof(line), fp) || !fgets(line, sizeof(line), fp) || sscanf(line, "%d", &atoms) != 1) {
+		printf("\n%s is not a .gro file\n", groFile);
+		exit(1);
+	}
+
+	if (atoms < residues) {
+		printf("\n%s has %d atoms, fewer than the %d residues\n", groFile, atoms, residues);
+		exit(1);
+	}
+
+	nativeFrame = (struct XtcCoordinates*) malloc(sizeof(struct XtcCoordinates) * residues);
+	if(!nativeFrame) {
+		perror("nativeFrame memory not allocated");
+		abort();
+	}
+
+	for(int i = 0; i < residues; i++) {
+		char column[3][9];
+
+		if (!fgets(line, sizeof(line), fp) || strlen(line) < 44) {
+			printf("\n%s ends at atom %d\n", groFile, i + 1);
+			exit(1);
+		}
+
+		for(int k = 0; k < 3; k++) {
+			memcpy(column[k], line + 20 + k * 8, 8);
+			column[k][8] = '\0';
+		}
+
+		nativeFrame[i].x = atof(column[0]);
+		nativeFrame[i].y = atof(column[1]);
+		nativeFrame[i].z = atof(column[2]);
+	}
+
+	fclose(fp);
+
+	return nativeFrame;
+}
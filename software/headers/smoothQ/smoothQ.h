@@ -0,0 +1,34 @@
+/*
+*	Name: smoothQ.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef SMOOTH_Q
+#define SMOOTH_Q
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactReader/contactReader.h"
+
+// Values used by Best, Hummer and Eaton (2013); beta is in 1/nm
+#define SMOOTH_Q_BETA 50.0f
+#define SMOOTH_Q_LAMBDA 1.8f
+
+// Q(X) = 1/N sum over contacts of 1/(1 + exp(beta(r - lambda r0)))
+struct SmoothQ {
+	int contacts;
+	float beta;
+	float lambda;
+	float *switchDistance;
+};
+
+struct SmoothQ* createSmoothQ(int contacts, struct Contact *residueContacts, struct XtcCoordinates *nativeFrame, float beta, float lambda);
+struct XtcCoordinates* readNativeStructure(char *nativeFile, int residues);
+float calculateFrameSmoothQValue(struct SmoothQ *smoothQ, struct XtcCoordinates *frame, struct Contact *residueContacts);
+float* calculateSmoothQValuesFromStream(struct XtcStream *stream, struct SmoothQ *smoothQ, struct Contact *residueContacts, int *xtcFrames);
+void writeSmoothQFile(float *qValues, int xtcFrames, char *qFile);
+float* allocateSmoothQValuesMemory(int xtcFrames);
+void freeSmoothQ(struct SmoothQ *smoothQ);
+
+#endif
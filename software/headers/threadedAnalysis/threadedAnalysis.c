@@ -0,0 +1,508 @@
+/*
+*	Name: threadedAnalysis.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Threaded versions of calculateQValuesFromStream(),
+*		calculateContactProbabilityFromStream(),
+*		calculateOccupancyTableFromStream() and
+*		calculateNonNativeContactsFromStream().  The frame boundaries of the traj.xtc
+*		are found with getXtcFrameIndex(), then every worker opens its own handle to
+*		the file and claims THREADED_ANALYSIS_CHUNK frames at a time from a shared
+*		counter.  A worker seeks to its chunk and both decompresses and evaluates the
+*		frames, so decoding is spread over the threads as well.
+*		Each worker counts contact occurrences in its own struct OccupancyTable; the
+*		tables are added together once every frame has been evaluated, as are the
+*		pair occurrences each worker counts with its own cell list.  Integer counts are summed, so
+*		the output is identical to the serial functions.
+*
+*	Dependencies: libxdrfile v2.1, pthreads
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "../calcQFromContacts/calcQFromContacts.h"
+#include "../contactState/contactState.h"
+#include "../smoothQ/smoothQ.h"
+#include "../cellList/cellList.h"
+#include "threadedAnalysis.h"
+
+struct ThreadedAnalysis {
+	int contacts;
+	float cutoff;
+	struct Contact *residueContacts;
+
+	// Set when several cutoffs are calculated at once
+	int cutoffs;
+	double *threshold;
+
+	// Set when the fractional Q is calculated
+	struct SmoothQ *smoothQ;
+	float *smoothQValues;
+
+	// Set when every pair within the cutoff is counted; qValues holds the native counts
+	struct PairMap *nativePairs;
+	int separation;
+	int *nonNativeContacts;
+
+	int countOccurrences;
+	int windows;
+	struct OccupancyWindow *window;
+
+	// Frames firstFrame, firstFrame + stride, ... are evaluated
+	char *xtcFile;
+	int residues;
+	struct XtcFrameIndex *index;
+	int firstFrame;
+	int stride;
+	int frames;
+	atomic_int nextFrame;
+	int *qValues;
+};
+
+struct ThreadedWorker {
+	struct ThreadedAnalysis *analysis;
+	uint64_t *contactStates;
+	struct OccupancyTable *table;
+	struct CellList *cellList;
+	struct PairMap *frequency;
+	pthread_t thread;
+};
+
+static void runThreadedAnalysis(struct XtcStream *stream, struct ThreadedAnalysis *analysis, struct ThreadedWorker *workers, int threads, int *xtcFrames);
+static void* evaluateFrameChunks(void *arg);
+static void evaluateFrame(struct ThreadedWorker *worker, struct XtcStream *stream, int selectedFrame);
+static struct ThreadedWorker* createWorkers(struct ThreadedAnalysis *analysis, int threads);
+static void freeWorkers(struct ThreadedWorker *workers, int threads);
+
+/*
+*	Name: int* calculateQValuesThreaded()
+*	Description: Calculates the Q values of the frames left in an open traj.xtc stream
+*		     using multiple threads.  The time range and stride of the stream are
+*		     followed.  The stream is left at the end of the file.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -int *xtcFrames - set to the amount of frames read from the stream.
+*	      -int threads - the amount of worker threads.
+*
+*	returns: -int *qValues - a Q value for each frame read from the traj.xtc.
+*/
+
+int* calculateQValuesThreaded(struct XtcStream *stream, int contacts, float cutoff, struct Contact *residueContacts, int *xtcFrames, int threads) {
+	struct ThreadedAnalysis analysis;
+
+	memset(&analysis, 0, sizeof(analysis));
+	analysis.contacts = contacts;
+	analysis.cutoff = cutoff;
+	analysis.residueContacts = residueContacts;
+	analysis.countOccurrences = 0;
+
+	struct ThreadedWorker *workers = createWorkers(&analysis, threads);
+
+	runThreadedAnalysis(stream, &analysis, workers, threads, xtcFrames);
+
+	freeWorkers(workers, threads);
+
+	return analysis.qValues;
+}
+
+/*
+*	Name: int* calculateQValuesCutoffsThreaded()
+*	Description: Same as calculateQValuesCutoffsFromStream(), using multiple threads.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -int cutoffs - the amount of cutoff values.
+*	      -float *cutoff - the cutoff values.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -int *xtcFrames - set to the amount of frames read from the stream.
+*	      -int threads - the amount of worker threads.
+*
+*	returns: -int *qValues - cutoffs Q values for each frame read from the traj.xtc.
+*/
+
+int* calculateQValuesCutoffsThreaded(struct XtcStream *stream, int contacts, int cutoffs, float *cutoff, struct Contact *residueContacts, int *xtcFrames, int threads) {
+	struct ThreadedAnalysis analysis;
+
+	memset(&analysis, 0, sizeof(analysis));
+	analysis.contacts = contacts;
+	analysis.residueContacts = residueContacts;
+	analysis.countOccurrences = 0;
+	analysis.cutoffs = cutoffs;
+	analysis.threshold = calculateCutoffThresholds(cutoffs, cutoff);
+
+	struct ThreadedWorker *workers = createWorkers(&analysis, threads);
+
+	runThreadedAnalysis(stream, &analysis, workers, threads, xtcFrames);
+
+	freeWorkers(workers, threads);
+	free(analysis.threshold);
+
+	return analysis.qValues;
+}
+
+/*
+*	Name: float* calculateSmoothQValuesThreaded()
+*	Description: Same as calculateSmoothQValuesFromStream(), using multiple threads.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -struct SmoothQ *smoothQ - from createSmoothQ().
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -int *xtcFrames - set to the amount of frames read from the stream.
+*	      -int threads - the amount of worker threads.
+*
+*	returns: -float *qValues - a fractional Q for each frame read from the traj.xtc.
+*/
+
+float* calculateSmoothQValuesThreaded(struct XtcStream *stream, struct SmoothQ *smoothQ, struct Contact *residueContacts, int *xtcFrames, int threads) {
+	struct ThreadedAnalysis analysis;
+
+	memset(&analysis, 0, sizeof(analysis));
+	analysis.contacts = smoothQ->contacts;
+	analysis.residueContacts = residueContacts;
+	analysis.countOccurrences = 0;
+	analysis.smoothQ = smoothQ;
+
+	struct ThreadedWorker *workers = createWorkers(&analysis, threads);
+
+	runThreadedAnalysis(stream, &analysis, workers, threads, xtcFrames);
+
+	freeWorkers(workers, threads);
+	free(analysis.qValues);
+
+	return analysis.smoothQValues;
+}
+
+/*
+*	Name: struct NonNativeContacts* calculateNonNativeContactsThreaded()
+*	Description: Same as calculateNonNativeContactsFromStream(), using multiple threads.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream().
+*	      -int contacts - the amount of contacts in the contacts file.
+*	      -struct Contact *residueContacts - all of the residue pairs from the contacts file.
+*	      -float cutoff - the user specified contact cutoff value for a residue pair.
+*	      -int separation - non-native pairs closer than this in sequence are skipped.
+*	      -int threads - the amount of worker threads.
+*
+*	Returns: -struct NonNativeContacts *nonNative - the counts of every frame and the
+*				occurrences of every pair.
+*/
+
+struct NonNativeContacts* calculateNonNativeContactsThreaded(struct XtcStream *stream, int contacts, struct Contact *residueContacts, float cutoff, int separation, int threads) {
+	struct ThreadedAnalysis analysis;
+	int xtcFrames;
+
+	memset(&analysis, 0, sizeof(analysis));
+	analysis.contacts = contacts;
+	analysis.cutoff = cutoff;
+	analysis.residueContacts = residueContacts;
+	analysis.countOccurrences = 0;
+	analysis.residues = stream->residues;
+	analysis.nativePairs = createNativePairMap(contacts, residueContacts);
+	analysis.separation = separation;
+
+	struct ThreadedWorker *workers = createWorkers(&analysis, threads);
+
+	runThreadedAnalysis(stream, &analysis, workers, threads, &xtcFrames);
+
+	struct NonNativeContacts *nonNative = allocateNonNativeContacts(xtcFrames);
+	nonNative->frames = xtcFrames;
+	memcpy(nonNative->nativeContacts, analysis.qValues, sizeof(int) * xtcFrames);
+	memcpy(nonNative->nonNativeContacts, analysis.nonNativeContacts, sizeof(int) * xtcFrames);
+
+	// Adds the pair occurrences counted by every worker together
+	for(int t = 0; t < threads; t++) {
+		addPairMaps(nonNative->frequency, workers[t].frequency);
+	}
+
+	freeWorkers(workers, threads);
+	freePairMap(analysis.nativePairs);
+	free(analysis.nonNativeContacts);
+	free(analysis.qValues);
+
+	return nonNative;
+}
+
+/*
+*	Name: struct ContactInformation* calculateContactProbabilityThreaded()
+*	Description: Same as calculateContactProbabilityFromStream(), using multiple threads.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -struct QRange qRange - low and high range of Q values
+*	      -struct TSRange timeRange - low and high range of time slices
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*	      -int threads - the amount of worker threads
+*
+*	Returns: -struct ContactInformation* residueContactsInformation - an array of structures
+*				containing values for every variable
+*/
+
+struct ContactInformation* calculateContactProbabilityThreaded(struct XtcStream *stream, int contacts, struct Contact *residueContacts, struct QRange qRange, struct TSRange timeRange, float cutOff, int threads) {
+	struct OccupancyWindow window;
+
+	window.qRange = qRange;
+	window.timeRange = timeRange;
+
+	struct OccupancyTable *table = calculateOccupancyTableThreaded(stream, contacts, residueContacts, 1, &window, cutOff, threads);
+
+	// The only window of the table is the result
+	struct ContactInformation *residueContactsInformation = table->contactInformation;
+	free(table->qValuesInRange);
+	free(table);
+
+	return residueContactsInformation;
+}
+
+/*
+*	Name: struct OccupancyTable* calculateOccupancyTableThreaded()
+*	Description: Same as calculateOccupancyTableFromStream(), using multiple threads.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -int windows - the amount of windows
+*	      -struct OccupancyWindow *window - Q value and time slice range of each window
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*	      -int threads - the amount of worker threads
+*
+*	Returns: -struct OccupancyTable *table - occurrences and probabilities of every contact
+*				in every window
+*/
+
+struct OccupancyTable* calculateOccupancyTableThreaded(struct XtcStream *stream, int contacts, struct Contact *residueContacts, int windows, struct OccupancyWindow *window, float cutOff, int threads) {
+	struct OccupancyTable *table = allocateOccupancyTable(windows, window, contacts, residueContacts);
+
+	// Frames outside of every time window are never decoded
+	setXtcStreamTimeRange(stream, getOccupancyTimeRange(windows, window));
+
+	countOccupancyTableThreaded(stream, table, cutOff, threads);
+
+	calculateOccupancyTableProbabilities(table);
+
+	return table;
+}
+
+/*
+*	Name: void countOccupancyTableThreaded()
+*	Description: Same as countOccupancyTableFromStream(), using multiple threads.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -struct OccupancyTable *table - the table being counted
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*	      -int threads - the amount of worker threads
+*/
+
+void countOccupancyTableThreaded(struct XtcStream *stream, struct OccupancyTable *table, float cutOff, int threads) {
+	int xtcFrames;
+
+	free(countOccupancyTableQValuesThreaded(stream, table, cutOff, &xtcFrames, threads));
+}
+
+/*
+*	Name: int* countOccupancyTableQValuesThreaded()
+*	Description: Same as countOccupancyTableQValuesFromStream(), using multiple threads.
+*
+*	Args: -struct XtcStream *stream - the traj.xtc file opened with openXtcStream()
+*	      -struct OccupancyTable *table - the table being counted
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*	      -int *xtcFrames - set to the amount of frames read from the stream
+*	      -int threads - the amount of worker threads
+*
+*	Returns: -int *qValues - a Q value for each frame read from the traj.xtc
+*/
+
+int* countOccupancyTableQValuesThreaded(struct XtcStream *stream, struct OccupancyTable *table, float cutOff, int *xtcFrames, int threads) {
+	struct ThreadedAnalysis analysis;
+
+	memset(&analysis, 0, sizeof(analysis));
+	analysis.contacts = table->contacts;
+	analysis.cutoff = cutOff;
+	analysis.residueContacts = table->residueContacts;
+	analysis.countOccurrences = 1;
+	analysis.windows = table->windows;
+	analysis.window = table->window;
+
+	struct ThreadedWorker *workers = createWorkers(&analysis, threads);
+
+	runThreadedAnalysis(stream, &analysis, workers, threads, xtcFrames);
+
+	// Adds the occurrences counted by every worker together
+	for(int t = 0; t < threads; t++) {
+		addOccupancyTable(table, workers[t].table);
+	}
+
+	freeWorkers(workers, threads);
+
+	return analysis.qValues;
+}
+
+/*
+*	Name: static void runThreadedAnalysis()
+*	Description: Starts the workers on the frames left in the stream and waits for them to
+*		     finish.  The frames within the stream's time range and stride are counted
+*		     from the frame index, so the Q values are allocated up front and workers
+*		     never wait on each other.
+*/
+
+static void runThreadedAnalysis(struct XtcStream *stream, struct ThreadedAnalysis *analysis, struct ThreadedWorker *workers, int threads, int *xtcFrames) {
+	analysis->xtcFile = stream->xtcFile;
+	analysis->residues = stream->residues;
+	analysis->index = getXtcFrameIndex(stream->xtcFile);
+	analysis->firstFrame = nextXtcStreamFrame(stream);
+	analysis->stride = stream->stride;
+
+	int lastFrame = stream->lastFrame < analysis->index->frames - 1 ? stream->lastFrame : analysis->index->frames - 1;
+	analysis->frames = analysis->firstFrame <= lastFrame ? (lastFrame - analysis->firstFrame) / analysis->stride + 1 : 0;
+
+	int cutoffs = analysis->cutoffs > 0 ? analysis->cutoffs : 1;
+	analysis->qValues = allocateQValuesMemory((analysis->frames > 0 ? analysis->frames : 1) * cutoffs);
+	if(analysis->smoothQ) {
+		analysis->smoothQValues = allocateSmoothQValuesMemory(analysis->frames);
+	}
+	if(analysis->nativePairs) {
+		analysis->nonNativeContacts = allocateQValuesMemory(analysis->frames > 0 ? analysis->frames : 1);
+	}
+	atomic_init(&analysis->nextFrame, 0);
+
+	for(int t = 0; t < threads; t++) {
+		if(pthread_create(&workers[t].thread, NULL, evaluateFrameChunks, &workers[t]) != 0) {
+			perror("could not create worker thread");
+			exit(1);
+		}
+	}
+
+	for(int t = 0; t < threads; t++) {
+		pthread_join(workers[t].thread, NULL);
+	}
+
+	// Leaves the stream after the last frame, as the serial functions do
+	if(xdr_seek(stream->xd, 0, SEEK_END) != exdrOK) {
+		printf("\nxdr_seek: could not seek to the end of %s\n", stream->xtcFile);
+		exit(1);
+	}
+
+	if(stream->currentFrame < analysis->index->frames) {
+		stream->currentFrame = analysis->index->frames;
+	}
+
+	*xtcFrames = analysis->frames;
+
+	freeXtcFrameIndex(analysis->index);
+}
+
+static void* evaluateFrameChunks(void *arg) {
+	struct ThreadedWorker *worker = (struct ThreadedWorker*) arg;
+	struct ThreadedAnalysis *analysis = worker->analysis;
+	struct XtcStream *stream = openXtcStream(analysis->xtcFile, analysis->residues);
+	int frames = analysis->frames;
+	int start;
+
+	while((start = atomic_fetch_add(&analysis->nextFrame, THREADED_ANALYSIS_CHUNK)) < frames) {
+		int end = start + THREADED_ANALYSIS_CHUNK < frames ? start + THREADED_ANALYSIS_CHUNK : frames;
+
+		for(int k = start; k < end; k++) {
+			int frame = analysis->firstFrame + k * analysis->stride;
+
+			// Consecutive frames are read without seeking
+			if(stream->currentFrame != frame) {
+				seekXtcStream(stream, analysis->index, frame);
+			}
+
+			if(!readXtcStreamFrame(stream)) {
+				printf("\n%s ended before frame %d\n", analysis->xtcFile, frame + 1);
+				exit(1);
+			}
+
+			evaluateFrame(worker, stream, k);
+		}
+	}
+
+	closeXtcStream(stream);
+
+	return NULL;
+}
+
+static void evaluateFrame(struct ThreadedWorker *worker, struct XtcStream *stream, int selectedFrame) {
+	struct ThreadedAnalysis *analysis = worker->analysis;
+
+	if(analysis->smoothQ) {
+		analysis->smoothQValues[selectedFrame] = calculateFrameSmoothQValue(analysis->smoothQ, stream->frame, analysis->residueContacts);
+		return;
+	}
+
+	if(analysis->nativePairs) {
+		buildCellList(worker->cellList, stream->frame);
+		analysis->qValues[selectedFrame] = countCellListContacts(worker->cellList, stream->frame, analysis->nativePairs,
+				worker->frequency, &analysis->nonNativeContacts[selectedFrame]);
+		return;
+	}
+
+	if(analysis->cutoffs > 0) {
+		calculateFrameQValueCutoffs(analysis->contacts, analysis->cutoffs, analysis->threshold, stream->frame, analysis->residueContacts, &analysis->qValues[(size_t)selectedFrame * analysis->cutoffs]);
+		return;
+	}
+
+	if(!analysis->countOccurrences) {
+		analysis->qValues[selectedFrame] = calculateFrameQValue(analysis->contacts, analysis->cutoff, stream->frame, analysis->residueContacts);
+		return;
+	}
+
+	analysis->qValues[selectedFrame] = calculateContactStates(analysis->contacts, analysis->cutoff, stream->frame, analysis->residueContacts, worker->contactStates);
+
+	addOccupancyTableFrame(worker->table, stream->currentFrame-1, analysis->qValues[selectedFrame], worker->contactStates);
+}
+
+static struct ThreadedWorker* createWorkers(struct ThreadedAnalysis *analysis, int threads) {
+	struct ThreadedWorker *workers = (struct ThreadedWorker*) malloc(sizeof(struct ThreadedWorker) * threads);
+	if(!workers) {
+		perror("workers memory not allocated");
+		abort();
+	}
+
+	for(int t = 0; t < threads; t++) {
+		workers[t].analysis = analysis;
+		workers[t].contactStates = allocateContactStatesMemory(1, analysis->contacts);
+		workers[t].table = NULL;
+		workers[t].cellList = NULL;
+		workers[t].frequency = NULL;
+
+		if(analysis->countOccurrences) {
+			workers[t].table = allocateOccupancyTable(analysis->windows, analysis->window, analysis->contacts, analysis->residueContacts);
+		}
+
+		if(analysis->nativePairs) {
+			workers[t].cellList = createCellList(analysis->residues, analysis->cutoff, analysis->separation);
+			workers[t].frequency = createPairMap(1024);
+		}
+	}
+
+	return workers;
+}
+
+static void freeWorkers(struct ThreadedWorker *workers, int threads) {
+	for(int t = 0; t < threads; t++) {
+		free(workers[t].contactStates);
+
+		if(workers[t].table) {
+			freeOccupancyTable(workers[t].table);
+		}
+
+		if(workers[t].cellList) {
+			freeCellList(workers[t].cellList);
+			freePairMap(workers[t].frequency);
+		}
+	}
+
+	free(workers);
+}
@@ -0,0 +1,30 @@
+/*
+*	Name: threadedAnalysis.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef THREADED_ANALYSIS
+#define THREADED_ANALYSIS
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactReader/contactReader.h"
+#include "../probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+#include "../occupancyTable/occupancyTable.h"
+#include "../smoothQ/smoothQ.h"
+#include "../cellList/cellList.h"
+
+// Consecutive frames decoded and evaluated by a worker after each seek
+#define THREADED_ANALYSIS_CHUNK 16
+
+int* calculateQValuesThreaded(struct XtcStream *stream, int contacts, float cutoff, struct Contact *residueContacts, int *xtcFrames, int threads);
+int* calculateQValuesCutoffsThreaded(struct XtcStream *stream, int contacts, int cutoffs, float *cutoff, struct Contact *residueContacts, int *xtcFrames, int threads);
+float* calculateSmoothQValuesThreaded(struct XtcStream *stream, struct SmoothQ *smoothQ, struct Contact *residueContacts, int *xtcFrames, int threads);
+struct NonNativeContacts* calculateNonNativeContactsThreaded(struct XtcStream *stream, int contacts, struct Contact *residueContacts, float cutoff, int separation, int threads);
+struct ContactInformation* calculateContactProbabilityThreaded(struct XtcStream *stream, int contacts, struct Contact *residueContacts, struct QRange qRange, struct TSRange timeRange, float cutOff, int threads);
+struct OccupancyTable* calculateOccupancyTableThreaded(struct XtcStream *stream, int contacts, struct Contact *residueContacts, int windows, struct OccupancyWindow *window, float cutOff, int threads);
+void countOccupancyTableThreaded(struct XtcStream *stream, struct OccupancyTable *table, float cutOff, int threads);
+int* countOccupancyTableQValuesThreaded(struct XtcStream *stream, struct OccupancyTable *table, float cutOff, int *xtcFrames, int threads);
+
+#endif
@@ -0,0 +1,1197 @@
+/*
+*	Name: wham.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Dependencies: pthreads
+*
+*	Summary of expected functionality:
+*		Combines the Q values and potential energies of simulations at several
+*		temperatures, for example the A/B/C stages of every replica made by
+*		run_simulation_set.csh, with the weighted histogram analysis method.  Every
+*		frame is used on its own rather than binned by energy, so the dimensionless
+*		free energy f_k of each run solves
+*
+*			f_k = -ln sum_n exp(-beta_k E_n) / sum_l N_l exp(f_l - beta_l E_n)
+*
+*		over the frames n of all runs.  md.log prints energies to a few digits, so many
+*		frames share an energy; every distinct energy is a level counted once, with the
+*		amount of its frames.  Both sums are taken as log-sum-exp, the largest term
+*		factored out, so energies of thousands of kJ/mol do not overflow.  The levels
+*		are split into chunks of WHAM_CHUNK that threads claim from a shared counter.
+*		The partial sums of the chunks are added in chunk order, so the free energies
+*		are the same for any amount of threads.
+*
+*		The exponentials of a chunk are taken by a scalar or an AVX2 kernel, chosen
+*		with the contact kernel (see setContactKernel()), so PROTEIN_CONTACT_KERNEL
+*		selects both.  exp() is replaced by calculateWhamExp(), which both kernels
+*		evaluate with the same double operations, and a sum over levels is kept in
+*		4 partial sums, one per vector lane, added in order, so every kernel gives
+*		the same free energies.  Once solved, every frame has a weight at any
+*		temperature, which gives F(Q) and the contact probabilities at that
+*		temperature.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WHAM_X86
+#endif
+
+#include "../xtcReader/xtcReader.h"
+#include "../contactState/contactState.h"
+#include "../contactKernel/contactKernel.h"
+#include "../qSeries/qSeries.h"
+#include "../mdLog/mdLog.h"
+#include "wham.h"
+
+#define WHAM_LINE 4096
+
+// Partial sums of a sum over levels, one per lane of an AVX2 vector of doubles
+#define WHAM_LANES 4
+
+// Adds exp(coefficient - beta * energy[u] - maximum[u]) to sum[u] for every level u
+typedef void (*WhamTermsKernel)(int levels, double coefficient, double beta, const double *energy, const double *maximum, double *sum);
+
+// Returns the sum of exp(term[u] - maximum) over the levels
+typedef double (*WhamSumKernel)(int levels, const double *term, double maximum);
+
+struct WhamSolver {
+	struct Wham *wham;
+	int chunks;
+	WhamTermsKernel termsKernel;
+	WhamSumKernel sumKernel;
+	double *coefficient;
+	double *partialMax;
+	double *partialSum;
+	atomic_int nextChunk;
+	int finished;
+	pthread_barrier_t start;
+	pthread_barrier_t done;
+};
+
+struct WhamFrameEnergy {
+	double energy;
+	int frame;
+};
+
+struct WhamContactAnalysis {
+	struct Wham *wham;
+	int temperatures;
+	double **logWeight;
+	int residues;
+	int contacts;
+	struct Contact *residueContacts;
+	float cutOff;
+	double **runProbability;
+	atomic_int nextRun;
+};
+
+static int compareWhamFrameEnergies(const void *a, const void *b);
+static void solveWhamChunks(struct WhamSolver *solver, double *scratch);
+static void solveWhamChunk(struct WhamSolver *solver, int chunk, double *scratch);
+static void* solveWhamWorker(void *arg);
+static void* analyseWhamRuns(void *arg);
+static double* alignWhamEnergies(struct WhamRun *run, int series, double *energy, int energies);
+static double* readWhamLogEnergies(struct WhamRun *run, char *energyLabel);
+static void scalarWhamTermsKernel(int levels, double coefficient, double beta, const double *energy, const double *maximum, double *sum);
+static double scalarWhamSumKernel(int levels, const double *term, double maximum);
+
+#ifdef WHAM_X86
+static void avx2WhamTermsKernel(int levels, double coefficient, double beta, const double *energy, const double *maximum, double *sum);
+static double avx2WhamSumKernel(int levels, const double *term, double maximum);
+#endif
+
+/*
+*	Name: struct Wham* readWhamRuns()
+*	Description: Reads a list of runs, one per line: the temperature, the qFile or Q
+*		     series, the energy file and, for contact probabilities, the traj.xtc of
+*		     the run.  Empty lines and lines starting with '#' are skipped.  Every
+*		     line of an energy file is a frame of the trajectory, so each Q value is
+*		     given the energy of its own frame.  The energy file may be the md.log of
+*		     the run instead, whose energies are joined to the frames by the steps of
+*		     the traj.xtc, which must then be given.
+*
+*	Args: -char *runFile - the list of runs
+*	      -char *energyLabel - the energy read from an md.log as it labels it, "Potential"
+*
+*	Returns: -struct Wham *wham - every run, ready for solveWham()
+*/
+
+struct Wham* readWhamRuns(char *runFile, char *energyLabel) {
+	char line[WHAM_LINE], qFile[WHAM_LINE], energyFile[WHAM_LINE], xtcFile[WHAM_LINE];
+	struct WhamRun *run = NULL;
+	int runs = 0, capacity = 0, fields, energies;
+	double *energy;
+	float temperature;
+	FILE *fp;
+
+	if ((fp = fopen(runFile, "r")) == NULL) {
+		printf("\nCould not open %s\n", runFile);
+		exit(1);
+	}
+
+	while(fgets(line, sizeof(line), fp) != NULL) {
+		char *c = line + strspn(line, " \t");
+
+		if (*c == '#' || *c == '\n' || *c == '\0') {
+			continue;
+		}
+
+		fields = sscanf(c, "%f %4095s %4095s %4095s", &temperature, qFile, energyFile, xtcFile);
+		if (fields < 3 || temperature <= 0) {
+			printf("\nEvery run of %s must be a temperature, a qFile and an energy file: %s\n", runFile, line);
+			exit(1);
+		}
+
+		if (runs == capacity) {
+			capacity = capacity ? capacity * 2 : 16;
+			run = (struct WhamRun*) realloc(run, sizeof(struct WhamRun) * capacity);
+			if(!run) {
+				perror("run memory not allocated");
+				abort();
+			}
+		}
+
+		run[runs].temperature = temperature;
+		run[runs].qFile = strdup(qFile);
+		run[runs].energyFile = strdup(energyFile);
+		run[runs].xtcFile = fields == 4 ? strdup(xtcFile) : NULL;
+		run[runs].qValue = readQValuesFile(qFile, &run[runs].frames, &run[runs].firstFrame, &run[runs].stride);
+
+		if (isMdLogFile(energyFile)) {
+			run[runs].energy = readWhamLogEnergies(&run[runs], energyLabel);
+		} else {
+			energy = readWhamEnergies(energyFile, &energies);
+			run[runs].energy = alignWhamEnergies(&run[runs], isQSeriesFile(qFile), energy, energies);
+			free(energy);
+		}
+
+		runs++;
+	}
+
+	fclose(fp);
+
+	if (runs == 0) {
+		printf("\n%s holds no runs\n", runFile);
+		exit(1);
+	}
+
+	return createWham(runs, run);
+}
+
+/*
+*	Name: double* readWhamEnergies()
+*	Description: Reads the potential energy of every frame, the last number of each line.
+*		     Takes the "frame energy" lines of mdtoen.csh, an .xvg written by gmx
+*		     energy and the rows of energyTableProg with one --energy; '#' and '@'
+*		     lines are skipped.  Any other line must hold only numbers, so a row of
+*		     energyTableProg without energies, N/A, is not taken for its time or Q.
+*
+*	Args: -char *energyFile - the energies of a run, in kJ/mol
+*	      -int *frames - set to the amount of energies
+*
+*	Returns: -double *energy - the energy of every frame
+*/
+
+double* readWhamEnergies(char *energyFile, int *frames) {
+	char line[WHAM_LINE];
+	double *energy = NULL;
+	int capacity = 0;
+	FILE *fp;
+
+	if ((fp = fopen(energyFile, "r")) == NULL) {
+		printf("\nCould not open %s\n", energyFile);
+		exit(1);
+	}
+
+	*frames = 0;
+
+	while(fgets(line, sizeof(line), fp) != NULL) {
+		char *c = line + strspn(line, " \t\r\n"), *end;
+		double value = 0.0;
+
+		if (*c == '#' || *c == '@' || *c == '\0') {
+			continue;
+		}
+
+		for(double number = strtod(c, &end); end != c; number = strtod(c, &end)) {
+			value = number;
+			c = end;
+		}
+
+		if (c == line + strspn(line, " \t\r\n") || c[strspn(c, " \t\r\n")] != '\0') {
+			printf("\nEvery line of %s must end in the energy of a frame: %s\n", energyFile, line);
+			exit(1);
+		}
+
+		if (*frames == capacity) {
+			capacity = capacity ? capacity * 2 : 4096;
+			energy = (double*) realloc(energy, sizeof(double) * capacity);
+			if(!energy) {
+				perror("energy memory not allocated");
+				abort();
+			}
+		}
+
+		energy[(*frames)++] = value;
+	}
+
+	fclose(fp);
+
+	return energy;
+}
+
+/*
+*	Name: struct Wham* createWham()
+*	Description: Puts the frames of every run one after the other, and finds the
+*		     distinct energies of the frames.  The Q values and energies of the runs
+*		     are moved into the combined arrays.
+*
+*	Args: -int runs - the amount of runs
+*	      -struct WhamRun *run - every run with its frames, Q values and energies;
+*				     freed by freeWham()
+*
+*	Returns: -struct Wham *wham - ready for solveWham()
+*/
+
+struct Wham* createWham(int runs, struct WhamRun *run) {
+	struct Wham *wham = (struct Wham*) malloc(sizeof(struct Wham));
+	struct WhamFrameEnergy *frameEnergy;
+	int frames = 0;
+
+	if(!wham) {
+		perror("wham memory not allocated");
+		abort();
+	}
+
+	for(int r = 0; r < runs; r++) {
+		frames += run[r].frames;
+	}
+
+	if (frames == 0) {
+		printf("\nThe runs hold no frames\n");
+		exit(1);
+	}
+
+	wham->runs = runs;
+	wham->run = run;
+	wham->frames = frames;
+	wham->qValue = (double*) malloc(sizeof(double) * frames);
+	wham->energy = (double*) malloc(sizeof(double) * frames);
+	wham->level = (int*) malloc(sizeof(int) * frames);
+	wham->levelEnergy = (double*) malloc(sizeof(double) * frames);
+	wham->levelLogFrames = (double*) malloc(sizeof(double) * frames);
+	wham->logDenominator = (double*) malloc(sizeof(double) * frames);
+	wham->beta = (double*) malloc(sizeof(double) * runs);
+	wham->logFrames = (double*) malloc(sizeof(double) * runs);
+	wham->freeEnergy = (double*) calloc(runs, sizeof(double));
+	if(!wham->qValue || !wham->energy || !wham->level || !wham->levelEnergy || !wham->levelLogFrames ||
+	   !wham->logDenominator || !wham->beta || !wham->logFrames || !wham->freeEnergy) {
+		perror("wham memory not allocated");
+		abort();
+	}
+
+	frames = 0;
+	for(int r = 0; r < runs; r++) {
+		memcpy(&wham->qValue[frames], run[r].qValue, sizeof(double) * run[r].frames);
+		memcpy(&wham->energy[frames], run[r].energy, sizeof(double) * run[r].frames);
+		free(run[r].qValue);
+		free(run[r].energy);
+
+		run[r].qValue = &wham->qValue[frames];
+		run[r].energy = &wham->energy[frames];
+		frames += run[r].frames;
+
+		wham->beta[r] = 1.0 / (WHAM_BOLTZMANN * run[r].temperature);
+		wham->logFrames[r] = run[r].frames > 0 ? log(run[r].frames) : -INFINITY;
+	}
+
+	frameEnergy = (struct WhamFrameEnergy*) malloc(sizeof(struct WhamFrameEnergy) * frames);
+	if(!frameEnergy) {
+		perror("frameEnergy memory not allocated");
+		abort();
+	}
+
+	for(int n = 0; n < frames; n++) {
+		frameEnergy[n].energy = wham->energy[n];
+		frameEnergy[n].frame = n;
+	}
+
+	qsort(frameEnergy, frames, sizeof(struct WhamFrameEnergy), compareWhamFrameEnergies);
+
+	// Frames of exactly the same energy share the denominator and weight of their level
+	wham->levels = 0;
+	for(int n = 0, count = 0; n < frames; n++) {
+		if(n == 0 || frameEnergy[n].energy != frameEnergy[n-1].energy) {
+			if(n > 0) {
+				wham->levelLogFrames[wham->levels-1] = log(count);
+			}
+
+			wham->levelEnergy[wham->levels++] = frameEnergy[n].energy;
+			count = 0;
+		}
+
+		wham->level[frameEnergy[n].frame] = wham->levels - 1;
+		count++;
+
+		if(n == frames - 1) {
+			wham->levelLogFrames[wham->levels-1] = log(count);
+		}
+	}
+
+	free(frameEnergy);
+
+	wham->iterations = 0;
+	wham->change = INFINITY;
+
+	return wham;
+}
+
+/*
+*	Name: int solveWham()
+*	Description: Iterates the WHAM equations from the current free energies until no
+*		     free energy changes by more than the tolerance.  The free energy of the
+*		     first run is kept at 0.
+*
+*	Args: -struct Wham *wham - from readWhamRuns() or createWham()
+*	      -double tolerance - the largest change of a converged free energy
+*	      -int iterations - stop after this many iterations even if not converged
+*	      -int threads - the amount of threads
+*
+*	Returns: -int converged - 1 if converged, 0 if the iterations ran out
+*/
+
+int solveWham(struct Wham *wham, double tolerance, int iterations, int threads) {
+	struct WhamSolver solver;
+	int runs = wham->runs;
+	double *scratch;
+
+	solver.wham = wham;
+	solver.chunks = (wham->levels + WHAM_CHUNK - 1) / WHAM_CHUNK;
+	solver.termsKernel = scalarWhamTermsKernel;
+	solver.sumKernel = scalarWhamSumKernel;
+
+#ifdef WHAM_X86
+	// The AVX-512 contact kernel is used with the AVX2 kernels elsewhere too
+	if(strcmp(getContactKernelName(), "avx2") == 0 || strcmp(getContactKernelName(), "avx512") == 0) {
+		solver.termsKernel = avx2WhamTermsKernel;
+		solver.sumKernel = avx2WhamSumKernel;
+	}
+#endif
+
+	solver.coefficient = (double*) malloc(sizeof(double) * runs);
+	solver.partialMax = (double*) malloc(sizeof(double) * solver.chunks * runs);
+	solver.partialSum = (double*) malloc(sizeof(double) * solver.chunks * runs);
+	scratch = (double*) malloc(sizeof(double) * 3 * WHAM_CHUNK);
+	if(!solver.coefficient || !solver.partialMax || !solver.partialSum || !scratch) {
+		perror("solver memory not allocated");
+		abort();
+	}
+
+	threads = threads < solver.chunks ? threads : solver.chunks;
+	threads = threads > 0 ? threads : 1;
+	solver.finished = 0;
+	pthread_barrier_init(&solver.start, NULL, threads);
+	pthread_barrier_init(&solver.done, NULL, threads);
+
+	pthread_t *worker = (pthread_t*) malloc(sizeof(pthread_t) * threads);
+	if(!worker) {
+		perror("worker memory not allocated");
+		abort();
+	}
+
+	// The calling thread works on the chunks too, as worker 0
+	for(int t = 1; t < threads; t++) {
+		if(pthread_create(&worker[t], NULL, solveWhamWorker, &solver) != 0) {
+			perror("could not create wham thread");
+			exit(1);
+		}
+	}
+
+	wham->change = INFINITY;
+
+	for(int i = 0; i < iterations && wham->change > tolerance; i++) {
+		for(int k = 0; k < runs; k++) {
+			solver.coefficient[k] = wham->logFrames[k] + wham->freeEnergy[k];
+		}
+
+		solveWhamChunks(&solver, scratch);
+
+		double first = 0.0, change = 0.0;
+
+		for(int k = 0; k < runs; k++) {
+			double maximum = -INFINITY, sum = 0.0, freeEnergy;
+
+			for(int c = 0; c < solver.chunks; c++) {
+				if(solver.partialMax[(size_t)c * runs + k] > maximum) {
+					maximum = solver.partialMax[(size_t)c * runs + k];
+				}
+			}
+
+			for(int c = 0; c < solver.chunks; c++) {
+				sum += solver.partialSum[(size_t)c * runs + k] * exp(solver.partialMax[(size_t)c * runs + k] - maximum);
+			}
+
+			freeEnergy = -(maximum + log(sum));
+			if(k == 0) {
+				first = freeEnergy;
+			}
+
+			freeEnergy -= first;
+			if(fabs(freeEnergy - wham->freeEnergy[k]) > change) {
+				change = fabs(freeEnergy - wham->freeEnergy[k]);
+			}
+
+			wham->freeEnergy[k] = freeEnergy;
+		}
+
+		wham->change = change;
+		wham->iterations++;
+	}
+
+	// The denominators of the final free energies weight the levels
+	for(int k = 0; k < runs; k++) {
+		solver.coefficient[k] = wham->logFrames[k] + wham->freeEnergy[k];
+	}
+
+	solveWhamChunks(&solver, scratch);
+
+	solver.finished = 1;
+	pthread_barrier_wait(&solver.start);
+
+	for(int t = 1; t < threads; t++) {
+		pthread_join(worker[t], NULL);
+	}
+
+	pthread_barrier_destroy(&solver.start);
+	pthread_barrier_destroy(&solver.done);
+	free(worker);
+	free(scratch);
+	free(solver.coefficient);
+	free(solver.partialMax);
+	free(solver.partialSum);
+
+	return wham->change <= tolerance;
+}
+
+/*
+*	Name: double* calculateWhamLogWeights()
+*	Description: Finds the probability of every frame at a temperature, as a logarithm so
+*		     temperatures far from the runs do not underflow.
+*
+*	Args: -struct Wham *wham - solved with solveWham()
+*	      -float temperature - the temperature to reweight to
+*
+*	Returns: -double *logWeight - ln of the probability of every frame; the probabilities
+*				      add up to 1
+*/
+
+double* calculateWhamLogWeights(struct Wham *wham, float temperature) {
+	double *logWeight = (double*) malloc(sizeof(double) * wham->frames);
+	double beta = 1.0 / (WHAM_BOLTZMANN * temperature), maximum = -INFINITY, sum = 0.0;
+
+	if(!logWeight) {
+		perror("logWeight memory not allocated");
+		abort();
+	}
+
+	for(int n = 0; n < wham->frames; n++) {
+		logWeight[n] = -beta * wham->energy[n] - wham->logDenominator[wham->level[n]];
+		maximum = logWeight[n] > maximum ? logWeight[n] : maximum;
+	}
+
+	for(int n = 0; n < wham->frames; n++) {
+		sum += exp(logWeight[n] - maximum);
+	}
+
+	for(int n = 0; n < wham->frames; n++) {
+		logWeight[n] -= maximum + log(sum);
+	}
+
+	return logWeight;
+}
+
+/*
+*	Name: int getWhamQBins()
+*	Description: Finds the Q bins that hold the Q values of every run.
+*
+*	Args: -struct Wham *wham - from readWhamRuns() or createWham()
+*	      -double binWidth - the width of a Q bin
+*	      -double *qMin - set to the low edge of the first bin, a multiple of binWidth
+*
+*	Returns: -int bins - the amount of bins
+*/
+
+int getWhamQBins(struct Wham *wham, double binWidth, double *qMin) {
+	double low = wham->qValue[0], high = wham->qValue[0];
+
+	for(int n = 1; n < wham->frames; n++) {
+		low = wham->qValue[n] < low ? wham->qValue[n] : low;
+		high = wham->qValue[n] > high ? wham->qValue[n] : high;
+	}
+
+	*qMin = floor(low / binWidth) * binWidth;
+
+	return (int) floor((high - *qMin) / binWidth) + 1;
+}
+
+/*
+*	Name: double* calculateWhamFreeEnergy()
+*	Description: Calculates the free energy F(Q) = -kT ln P(Q) of every Q bin at a
+*		     temperature, shifted so the lowest is 0.
+*
+*	Args: -struct Wham *wham - solved with solveWham()
+*	      -double *logWeight - from calculateWhamLogWeights() at the temperature
+*	      -float temperature - the temperature of logWeight
+*	      -double binWidth - the width of a Q bin
+*	      -double qMin - the low edge of the first bin, from getWhamQBins()
+*	      -int bins - the amount of bins, from getWhamQBins()
+*
+*	Returns: -double *freeEnergy - F of every bin in kJ/mol, NAN for bins without frames
+*/
+
+double* calculateWhamFreeEnergy(struct Wham *wham, double *logWeight, float temperature, double binWidth, double qMin, int bins) {
+	double *freeEnergy = (double*) calloc(bins, sizeof(double));
+	double lowest = INFINITY;
+
+	if(!freeEnergy) {
+		perror("freeEnergy memory not allocated");
+		abort();
+	}
+
+	for(int n = 0; n < wham->frames; n++) {
+		int bin = (int) floor((wham->qValue[n] - qMin) / binWidth);
+
+		if(bin >= 0 && bin < bins) {
+			freeEnergy[bin] += exp(logWeight[n]);
+		}
+	}
+
+	for(int b = 0; b < bins; b++) {
+		freeEnergy[b] = freeEnergy[b] > 0.0 ? -WHAM_BOLTZMANN * temperature * log(freeEnergy[b]) : NAN;
+		lowest = freeEnergy[b] < lowest ? freeEnergy[b] : lowest;
+	}
+
+	for(int b = 0; b < bins; b++) {
+		freeEnergy[b] -= lowest;
+	}
+
+	return freeEnergy;
+}
+
+/*
+*	Name: double* calculateWhamContactProbabilities()
+*	Description: Calculates the probability of every contact at several temperatures,
+*		     every frame of every run counted with its weight.  Each run reads its
+*		     traj.xtc; the frames of its Q values are decoded.  Runs are claimed by
+*		     threads from a shared counter and their sums are added in run order.
+*
+*	Args: -struct Wham *wham - solved with solveWham(), every run with a traj.xtc
+*	      -int temperatures - the amount of temperatures
+*	      -double **logWeight - from calculateWhamLogWeights() for every temperature
+*	      -int residues - the amount of residues in the protein
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*	      -float cutOff - the user specified contact cutoff value for a residue pair
+*	      -int threads - the amount of threads
+*
+*	Returns: -double *probability - the probability of contact i at temperature t in
+*					[i * temperatures + t]
+*/
+
+double* calculateWhamContactProbabilities(struct Wham *wham, int temperatures, double **logWeight, int residues, int contacts, struct Contact *residueContacts, float cutOff, int threads) {
+	struct WhamContactAnalysis analysis;
+	size_t values = (size_t) contacts * temperatures;
+	int workers = threads < wham->runs ? threads : wham->runs;
+	double *probability = (double*) calloc(values > 0 ? values : 1, sizeof(double));
+
+	if(!probability) {
+		perror("probability memory not allocated");
+		abort();
+	}
+
+	for(int r = 0; r < wham->runs; r++) {
+		if(!wham->run[r].xtcFile) {
+			printf("\nContact probabilities need the traj.xtc of every run, %s has none\n", wham->run[r].qFile);
+			exit(1);
+		}
+	}
+
+	analysis.wham = wham;
+	analysis.temperatures = temperatures;
+	analysis.logWeight = logWeight;
+	analysis.residues = residues;
+	analysis.contacts = contacts;
+	analysis.residueContacts = residueContacts;
+	analysis.cutOff = cutOff;
+	analysis.runProbability = (double**) malloc(sizeof(double*) * wham->runs);
+	if(!analysis.runProbability) {
+		perror("runProbability memory not allocated");
+		abort();
+	}
+
+	atomic_init(&analysis.nextRun, 0);
+
+	pthread_t *worker = (pthread_t*) malloc(sizeof(pthread_t) * (workers > 0 ? workers : 1));
+	if(!worker) {
+		perror("worker memory not allocated");
+		abort();
+	}
+
+	for(int t = 0; t < workers; t++) {
+		if(pthread_create(&worker[t], NULL, analyseWhamRuns, &analysis) != 0) {
+			perror("could not create wham thread");
+			exit(1);
+		}
+	}
+
+	for(int t = 0; t < workers; t++) {
+		pthread_join(worker[t], NULL);
+	}
+
+	free(worker);
+
+	// Added in run order, so the sums do not depend on which thread finished first
+	for(int r = 0; r < wham->runs; r++) {
+		for(size_t i = 0; i < values; i++) {
+			probability[i] += analysis.runProbability[r][i];
+		}
+
+		free(analysis.runProbability[r]);
+	}
+
+	free(analysis.runProbability);
+
+	return probability;
+}
+
+/*
+*	Name: void writeWhamFreeEnergy()
+*	Description: Writes the free energy of every run, then a row for every Q bin with
+*		     F(Q) at every temperature.  Lines starting with '#' describe the columns.
+*
+*	Args: -FILE *fp - destination, for example stdout
+*	      -struct Wham *wham - solved with solveWham()
+*	      -int temperatures - the amount of temperatures
+*	      -float *temperature - every temperature
+*	      -double **freeEnergy - from calculateWhamFreeEnergy() for every temperature
+*	      -double binWidth - the width of a Q bin
+*	      -double qMin - the low edge of the first bin
+*	      -int bins - the amount of bins
+*/
+
+void writeWhamFreeEnergy(FILE *fp, struct Wham *wham, int temperatures, float *temperature, double **freeEnergy, double binWidth, double qMin, int bins) {
+	fprintf(fp, "# %d runs, %d frames, %d iterations, largest change %g\n", wham->runs, wham->frames, wham->iterations, wham->change);
+	fprintf(fp, "# run temperature frames {f = free energy / kT}\n");
+	for(int r = 0; r < wham->runs; r++) {
+		fprintf(fp, "# %d %g %d %f\n", r+1, wham->run[r].temperature, wham->run[r].frames, wham->freeEnergy[r]);
+	}
+
+	fprintf(fp, "# Q {F(Q) kJ/mol} at");
+	for(int t = 0; t < temperatures; t++) {
+		fprintf(fp, " %gK", temperature[t]);
+	}
+
+	fprintf(fp, "\n");
+
+	for(int b = 0; b < bins; b++) {
+		fprintf(fp, "%g", qMin + b * binWidth);
+
+		for(int t = 0; t < temperatures; t++) {
+			if(!isnan(freeEnergy[t][b])) {
+				fprintf(fp, " %f", freeEnergy[t][b]);
+			} else {
+				fprintf(fp, " N/A");
+			}
+		}
+
+		fprintf(fp, "\n");
+	}
+}
+
+/*
+*	Name: void writeWhamContactProbabilities()
+*	Description: Writes a row for every contact with its probability at every temperature.
+*
+*	Args: -FILE *fp - destination, for example stdout
+*	      -int temperatures - the amount of temperatures
+*	      -float *temperature - every temperature
+*	      -double *probability - from calculateWhamContactProbabilities()
+*	      -int contacts - the amount of contacts in the contactFile
+*	      -struct Contact *residueContacts - contact pairs from the contactFile
+*/
+
+void writeWhamContactProbabilities(FILE *fp, int temperatures, float *temperature, double *probability, int contacts, struct Contact *residueContacts) {
+	fprintf(fp, "# contact focusResidue contactResidue {probability} at");
+	for(int t = 0; t < temperatures; t++) {
+		fprintf(fp, " %gK", temperature[t]);
+	}
+
+	fprintf(fp, "\n");
+
+	for(int i = 0; i < contacts; i++) {
+		fprintf(fp, "%d %d %d", i+1, residueContacts[i].focusResidue, residueContacts[i].contactResidue);
+
+		for(int t = 0; t < temperatures; t++) {
+			fprintf(fp, " %f", probability[(size_t)i * temperatures + t]);
+		}
+
+		fprintf(fp, "\n");
+	}
+}
+
+/*
+*	Name: double calculateWhamExp()
+*	Description: exp(x) from a rational function after removing multiples of ln(2), as
+*		     in the Cephes library, with a relative error below 4e-16.  x is limited
+*		     to [-708, 709] so the result stays a normal double; WHAM only takes the
+*		     exponential of numbers up to 0, where anything below -708 adds nothing.
+*
+*	Args: -double x - the exponent.
+*
+*	Returns: -double e - approximately exp(x).
+*/
+
+double calculateWhamExp(double x) {
+	x = x < 709.0 ? x : 709.0;
+	x = x > -708.0 ? x : -708.0;
+
+	// x = n ln(2) + remainder, ln(2) split in two so the remainder is exact
+	double n = floor(x * 1.4426950408889634073599 + 0.5);
+	x = x - n * 6.93145751953125e-1;
+	x = x - n * 1.42860682030941723212e-6;
+
+	double square = x * x;
+	double p = 1.26177193074810590878e-4;
+	p = p * square + 3.02994407707441961300e-2;
+	p = p * square + 9.99999999999999999910e-1;
+	p = p * x;
+
+	double q = 3.00198505138664455042e-6;
+	q = q * square + 2.52448340349684104192e-3;
+	q = q * square + 2.27265548208155028766e-1;
+	q = q * square + 2.00000000000000000009e0;
+
+	double e = p / (q - p);
+	e = e + e + 1.0;
+
+	// Multiplies by 2^n through the exponent bits
+	uint64_t bits = (uint64_t) ((int64_t) n + 1023) << 52;
+	double scale;
+	memcpy(&scale, &bits, sizeof(double));
+
+	return e * scale;
+}
+
+/*
+*	Name: void freeWham()
+*	Description:	Frees the runs and their file names, the frames, levels and results
+*			of a WHAM.
+*
+*	Args: -struct Wham *wham - WHAM from createWham or readWhamRuns.
+*/
+
+void freeWham(struct Wham *wham) {
+	for(int r = 0; r < wham->runs; r++) {
+		free(wham->run[r].qFile);
+		free(wham->run[r].energyFile);
+		free(wham->run[r].xtcFile);
+	}
+
+	free(wham->run);
+	free(wham->qValue);
+	free(wham->energy);
+	free(wham->level);
+	free(wham->levelEnergy);
+	free(wham->levelLogFrames);
+	free(wham->beta);
+	free(wham->logFrames);
+	free(wham->freeEnergy);
+	free(wham->logDenominator);
+	free(wham);
+}
+
+static int compareWhamFrameEnergies(const void *a, const void *b) {
+	const struct WhamFrameEnergy *frame1 = (const struct WhamFrameEnergy*) a;
+	const struct WhamFrameEnergy *frame2 = (const struct WhamFrameEnergy*) b;
+
+	return (frame1->energy > frame2->energy) - (frame1->energy < frame2->energy);
+}
+
+static void solveWhamChunks(struct WhamSolver *solver, double *scratch) {
+	int chunk;
+
+	atomic_store(&solver->nextChunk, 0);
+	pthread_barrier_wait(&solver->start);
+
+	while((chunk = atomic_fetch_add(&solver->nextChunk, 1)) < solver->chunks) {
+		solveWhamChunk(solver, chunk, scratch);
+	}
+
+	pthread_barrier_wait(&solver->done);
+}
+
+static void* solveWhamWorker(void *arg) {
+	struct WhamSolver *solver = (struct WhamSolver*) arg;
+	double *scratch = (double*) malloc(sizeof(double) * 3 * WHAM_CHUNK);
+	int chunk;
+
+	if(!scratch) {
+		perror("scratch memory not allocated");
+		abort();
+	}
+
+	for(;;) {
+		pthread_barrier_wait(&solver->start);
+
+		if(solver->finished) {
+			break;
+		}
+
+		while((chunk = atomic_fetch_add(&solver->nextChunk, 1)) < solver->chunks) {
+			solveWhamChunk(solver, chunk, scratch);
+		}
+
+		pthread_barrier_wait(&solver->done);
+	}
+
+	free(scratch);
+
+	return NULL;
+}
+
+/*
+*	Name: static void solveWhamChunk()
+*	Description: Finds ln sum_l N_l exp(f_l - beta_l E_u) of every energy level u of a
+*		     chunk, then the largest term and the scaled sum of the frames of the level
+*		     times exp(-beta_k E_u) / that sum for every run k.  Every loop runs over
+*		     consecutive levels.
+*
+*	Args: -struct WhamSolver *solver - the coefficients ln N_l + f_l of this iteration
+*	      -int chunk - the chunk of energy levels
+*	      -double *scratch - 3 * WHAM_CHUNK doubles of the calling thread
+*/
+
+static void solveWhamChunk(struct WhamSolver *solver, int chunk, double *scratch) {
+	struct Wham *wham = solver->wham;
+	int first = chunk * WHAM_CHUNK;
+	int levels = wham->levels - first < WHAM_CHUNK ? wham->levels - first : WHAM_CHUNK;
+	double *energy = &wham->levelEnergy[first];
+	double *logFrames = &wham->levelLogFrames[first];
+	double *logDenominator = &wham->logDenominator[first];
+	double *maximum = scratch, *sum = &scratch[WHAM_CHUNK], *term = &scratch[2 * WHAM_CHUNK];
+	double *coefficient = solver->coefficient, *beta = wham->beta;
+	int runs = wham->runs;
+
+	for(int u = 0; u < levels; u++) {
+		maximum[u] = -INFINITY;
+		sum[u] = 0.0;
+	}
+
+	for(int l = 0; l < runs; l++) {
+		for(int u = 0; u < levels; u++) {
+			double value = coefficient[l] - beta[l] * energy[u];
+			maximum[u] = value > maximum[u] ? value : maximum[u];
+		}
+	}
+
+	for(int l = 0; l < runs; l++) {
+		if(coefficient[l] == -INFINITY) {
+			continue;
+		}
+
+		solver->termsKernel(levels, coefficient[l], beta[l], energy, maximum, sum);
+	}
+
+	for(int u = 0; u < levels; u++) {
+		logDenominator[u] = maximum[u] + log(sum[u]);
+	}
+
+	for(int k = 0; k < runs; k++) {
+		double chunkMax = -INFINITY;
+
+		for(int u = 0; u < levels; u++) {
+			term[u] = logFrames[u] - beta[k] * energy[u] - logDenominator[u];
+			chunkMax = term[u] > chunkMax ? term[u] : chunkMax;
+		}
+
+		solver->partialMax[(size_t)chunk * runs + k] = chunkMax;
+		solver->partialSum[(size_t)chunk * runs + k] = solver->sumKernel(levels, term, chunkMax);
+	}
+}
+
+static void* analyseWhamRuns(void *arg) {
+	struct WhamContactAnalysis *analysis = (struct WhamContactAnalysis*) arg;
+	struct Wham *wham = analysis->wham;
+	int temperatures = analysis->temperatures, contacts = analysis->contacts;
+	uint64_t *contactStates = allocateContactStatesMemory(1, contacts);
+	double *weight = (double*) malloc(sizeof(double) * temperatures);
+	int r;
+
+	if(!weight) {
+		perror("weight memory not allocated");
+		abort();
+	}
+
+	while((r = atomic_fetch_add(&analysis->nextRun, 1)) < wham->runs) {
+		struct WhamRun *run = &wham->run[r];
+		size_t offset = run->energy - wham->energy;
+		double *probability = (double*) calloc((size_t) contacts * temperatures + 1, sizeof(double));
+		struct XtcStream *stream = openXtcStream(run->xtcFile, analysis->residues);
+
+		if(!probability) {
+			perror("probability memory not allocated");
+			abort();
+		}
+
+		for(int i = 0; i < run->frames; i++) {
+			int frame = run->firstFrame + i * run->stride;
+
+			if(stream->currentFrame != frame) {
+				seekXtcStreamFrame(stream, frame);
+			}
+
+			if(!readXtcStreamFrame(stream)) {
+				printf("\n%s ended before frame %d of %s\n", run->xtcFile, frame + 1, run->qFile);
+				exit(1);
+			}
+
+			for(int t = 0; t < temperatures; t++) {
+				weight[t] = exp(analysis->logWeight[t][offset + i]);
+			}
+
+			calculateContactStates(contacts, analysis->cutOff, stream->frame, analysis->residueContacts, contactStates);
+
+			for(int c = 0; c < contacts; c++) {
+				if(getContactState(contactStates, c)) {
+					for(int t = 0; t < temperatures; t++) {
+						probability[(size_t)c * temperatures + t] += weight[t];
+					}
+				}
+			}
+		}
+
+		closeXtcStream(stream);
+		analysis->runProbability[r] = probability;
+	}
+
+	free(weight);
+	free(contactStates);
+
+	return NULL;
+}
+
+/*
+*	Name: static double* alignWhamEnergies()
+*	Description: Picks the energy of the frame of every Q value: energy[firstFrame +
+*		     i * stride].  A Q series may hold a --range or --stride of the frames.  A
+*		     text qFile holds every frame from the first, so its Q values and the
+*		     energies may differ by the one frame written to only one of the files of
+*		     a run cut short; more than that and the files do not belong together.
+*		     A run whose last Q value has no energy loses that frame.
+*
+*	Args: -struct WhamRun *run - with its Q values read; frames may be lowered
+*	      -int series - 1 if the Q values came from a Q series
+*	      -double *energy - the energy of every frame of the trajectory
+*	      -int energies - the amount of energies
+*
+*	Returns: -double *runEnergy - the energy of every Q value
+*/
+
+static double* alignWhamEnergies(struct WhamRun *run, int series, double *energy, int energies) {
+	int64_t lastFrame = run->firstFrame + (int64_t) (run->frames - 1) * run->stride;
+	double *runEnergy;
+
+	if (!series && energies > run->frames + 1) {
+		printf("\n%s has %d Q values and %s has %d energies, one per frame.  A qFile must hold every frame;"
+		       " for a --stride or --range use the Q series of calcQFromContactsProg --qseries\n",
+		       run->qFile, run->frames, run->energyFile, energies);
+		exit(1);
+	}
+
+	if (run->frames > 0 && lastFrame >= energies) {
+		if (lastFrame - run->stride >= energies) {
+			printf("\n%s has Q values up to frame %lld, %s has energies for %d frames\n",
+			       run->qFile, (long long) lastFrame + 1, run->energyFile, energies);
+			exit(1);
+		}
+
+		fprintf(stderr, "Frame %lld of %s has no energy in %s and is not used\n", (long long) lastFrame + 1, run->qFile, run->energyFile);
+		run->frames--;
+	}
+
+	runEnergy = (double*) malloc(sizeof(double) * (run->frames > 0 ? run->frames : 1));
+	if(!runEnergy) {
+		perror("energy memory not allocated");
+		abort();
+	}
+
+	for(int i = 0; i < run->frames; i++) {
+		runEnergy[i] = energy[run->firstFrame + (int64_t) i * run->stride];
+	}
+
+	return runEnergy;
+}
+
+/*
+*	Name: static double* readWhamLogEnergies()
+*	Description: Reads the energies of a run from its md.log and picks the energy of
+*		     the step of every Q value's frame, frame firstFrame + i * stride of the
+*		     traj.xtc.  md.log holds energies every nstlog steps, so every frame has
+*		     one only when nstlog divides nstxout.
+*
+*	Args: -struct WhamRun *run - with its Q values read and its traj.xtc given
+*	      -char *energyLabel - the energy as md.log labels it, "Potential"
+*
+*	Returns: -double *runEnergy - the energy of every Q value
+*/
+
+static double* readWhamLogEnergies(struct WhamRun *run, char *energyLabel) {
+	struct MdLogEnergies *energies;
+	struct XtcFrameIndex *index;
+	double *runEnergy;
+	char **label;
+	int labels;
+
+	if (!run->xtcFile) {
+		printf("\n%s is an md.log, whose energies are joined to the frames by step; give the traj.xtc of the run after it\n", run->energyFile);
+		exit(1);
+	}
+
+	label = parseEnergyLabels(energyLabel, &labels);
+	if (labels != 1) {
+		printf("\nOne energy is read from an md.log, not %d: %s\n", labels, energyLabel);
+		exit(1);
+	}
+
+	energies = readMdLogEnergies(run->energyFile, labels, label);
+	index = getXtcFrameIndex(run->xtcFile);
+
+	runEnergy = (double*) malloc(sizeof(double) * (run->frames > 0 ? run->frames : 1));
+	if(!runEnergy) {
+		perror("energy memory not allocated");
+		abort();
+	}
+
+	for(int i = 0; i < run->frames; i++) {
+		int64_t frame = run->firstFrame + (int64_t) i * run->stride;
+		int row;
+
+		if (frame >= index->frames) {
+			printf("\n%s has Q values up to frame %lld, %s has %d frames\n",
+			       run->qFile, (long long) run->firstFrame + (int64_t) (run->frames - 1) * run->stride + 1, run->xtcFile, index->frames);
+			exit(1);
+		}
+
+		if ((row = findMdLogStep(energies, index->steps[frame])) < 0) {
+			printf("\nFrame %lld of %s, step %d, has no energy in %s; nstlog must divide nstxout\n",
+			       (long long) frame + 1, run->xtcFile, index->steps[frame], run->energyFile);
+			exit(1);
+		}
+
+		runEnergy[i] = energies->energy[row];
+	}
+
+	freeXtcFrameIndex(index);
+	freeMdLogEnergies(energies);
+
+	return runEnergy;
+}
+
+static void scalarWhamTermsKernel(int levels, double coefficient, double beta, const double *energy, const double *maximum, double *sum) {
+	for(int u = 0; u < levels; u++) {
+		sum[u] += calculateWhamExp(coefficient - beta * energy[u] - maximum[u]);
+	}
+}
+
+static double scalarWhamSumKernel(int levels, const double *term, double maximum) {
+	double lane[WHAM_LANES] = {0.0, 0.0, 0.0, 0.0};
+
+	for(int u = 0; u < levels; u++) {
+		lane[u % WHAM_LANES] += calculateWhamExp(term[u] - maximum);
+	}
+
+	return ((lane[0] + lane[1]) + lane[2]) + lane[3];
+}
+
+#ifdef WHAM_X86
+
+/*
+*	calculateWhamExp() of 4 doubles, with the same operations in the same order.
+*/
+
+__attribute__((target("avx2")))
+static __m256d avx2WhamExp(__m256d x) {
+	x = _mm256_min_pd(x, _mm256_set1_pd(709.0));
+	x = _mm256_max_pd(x, _mm256_set1_pd(-708.0));
+
+	__m256d n = _mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(1.4426950408889634073599)), _mm256_set1_pd(0.5)));
+	x = _mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(6.93145751953125e-1)));
+	x = _mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(1.42860682030941723212e-6)));
+
+	__m256d square = _mm256_mul_pd(x, x);
+	__m256d p = _mm256_set1_pd(1.26177193074810590878e-4);
+	p = _mm256_add_pd(_mm256_mul_pd(p, square), _mm256_set1_pd(3.02994407707441961300e-2));
+	p = _mm256_add_pd(_mm256_mul_pd(p, square), _mm256_set1_pd(9.99999999999999999910e-1));
+	p = _mm256_mul_pd(p, x);
+
+	__m256d q = _mm256_set1_pd(3.00198505138664455042e-6);
+	q = _mm256_add_pd(_mm256_mul_pd(q, square), _mm256_set1_pd(2.52448340349684104192e-3));
+	q = _mm256_add_pd(_mm256_mul_pd(q, square), _mm256_set1_pd(2.27265548208155028766e-1));
+	q = _mm256_add_pd(_mm256_mul_pd(q, square), _mm256_set1_pd(2.00000000000000000009e0));
+
+	__m256d e = _mm256_div_pd(p, _mm256_sub_pd(q, p));
+	e = _mm256_add_pd(_mm256_add_pd(e, e), _mm256_set1_pd(1.0));
+
+	__m256i bits = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+	bits = _mm256_slli_epi64(_mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52);
+
+	return _mm256_mul_pd(e, _mm256_castsi256_pd(bits));
+}
+
+__attribute__((target("avx2")))
+static void avx2WhamTermsKernel(int levels, double coefficient, double beta, const double *energy, const double *maximum, double *sum) {
+	__m256d coefficients = _mm256_set1_pd(coefficient), betas = _mm256_set1_pd(beta);
+	int u = 0;
+
+	for(; u + WHAM_LANES <= levels; u += WHAM_LANES) {
+		__m256d value = _mm256_sub_pd(coefficients, _mm256_mul_pd(betas, _mm256_loadu_pd(&energy[u])));
+		value = _mm256_sub_pd(value, _mm256_loadu_pd(&maximum[u]));
+		_mm256_storeu_pd(&sum[u], _mm256_add_pd(_mm256_loadu_pd(&sum[u]), avx2WhamExp(value)));
+	}
+
+	for(; u < levels; u++) {
+		sum[u] += calculateWhamExp(coefficient - beta * energy[u] - maximum[u]);
+	}
+}
+
+__attribute__((target("avx2")))
+static double avx2WhamSumKernel(int levels, const double *term, double maximum) {
+	__m256d maximums = _mm256_set1_pd(maximum), lanes = _mm256_setzero_pd();
+	double lane[WHAM_LANES];
+	int u = 0;
+
+	for(; u + WHAM_LANES <= levels; u += WHAM_LANES) {
+		lanes = _mm256_add_pd(lanes, avx2WhamExp(_mm256_sub_pd(_mm256_loadu_pd(&term[u]), maximums)));
+	}
+
+	_mm256_storeu_pd(lane, lanes);
+
+	// The levels left over go to the lanes they would have in a full vector
+	for(; u < levels; u++) {
+		lane[u % WHAM_LANES] += calculateWhamExp(term[u] - maximum);
+	}
+
+	return ((lane[0] + lane[1]) + lane[2]) + lane[3];
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*
+*	Name: wham.h
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#ifndef WHAM
+#define WHAM
+
+#include <stdio.h>
+
+#include "../contactReader/contactReader.h"
+
+// Boltzmann constant in kJ/(mol K), the energy unit of Gromacs
+#define WHAM_BOLTZMANN 0.0083144626
+
+// Energy levels claimed by a thread at a time; partial sums are added chunk by chunk in order
+#define WHAM_CHUNK 4096
+
+#define WHAM_TOLERANCE 1e-7
+#define WHAM_ITERATIONS 100000
+
+// One simulation at one temperature, for example one 4FAK_<T>K_<NN>_<A|B|C> folder
+struct WhamRun {
+	float temperature;
+	char *qFile;
+	char *energyFile;
+	char *xtcFile;
+	int frames;
+	int firstFrame;
+	int stride;
+	double *qValue;
+	double *energy;
+};
+
+struct Wham {
+	int runs;
+	struct WhamRun *run;
+	int frames;
+	double *qValue;
+	double *energy;
+	int levels;
+	int *level;
+	double *levelEnergy;
+	double *levelLogFrames;
+	double *beta;
+	double *logFrames;
+	double *freeEnergy;
+	double *logDenominator;
+	int iterations;
+	double change;
+};
+
+struct Wham* readWhamRuns(char *runFile, char *energyLabel);
+double* readWhamEnergies(char *energyFile, int *frames);
+struct Wham* createWham(int runs, struct WhamRun *run);
+int solveWham(struct Wham *wham, double tolerance, int iterations, int threads);
+double* calculateWhamLogWeights(struct Wham *wham, float temperature);
+int getWhamQBins(struct Wham *wham, double binWidth, double *qMin);
+double* calculateWhamFreeEnergy(struct Wham *wham, double *logWeight, float temperature, double binWidth, double qMin, int bins);
+double* calculateWhamContactProbabilities(struct Wham *wham, int temperatures, double **logWeight, int residues, int contacts, struct Contact *residueContacts, float cutOff, int threads);
+void writeWhamFreeEnergy(FILE *fp, struct Wham *wham, int temperatures, float *temperature, double **freeEnergy, double binWidth, double qMin, int bins);
+void writeWhamContactProbabilities(FILE *fp, int temperatures, float *temperature, double *probability, int contacts, struct Contact *residueContacts);
+double calculateWhamExp(double x);
+void freeWham(struct Wham *wham);
+
+#endif
@@ -7,7 +7,7 @@
 *	Summary of expected functionality:
 *		Provides an example of how use xtcReader.h.
 *	Compile:
-*		gcc -o runner runner.c xdrfile.c xdrfile_xtc.c
+*		gcc -o runner runner.c xtcReader.c xdrfile.c xdrfile_xtc.c ../fileIdentity/fileIdentity.c
 */
 
 #include <stdio.h>
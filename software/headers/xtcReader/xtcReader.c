@@ -12,11 +12,27 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <arpa/inet.h>
 
 #include "xdrfile.h"
 #include "xdrfile_xtc.h"
 
 #include "xtcReader.h"
+
+static void checkResidues(int residues, int natoms);
+static int readBigEndianInt(FILE *fp, int32_t *value);
+static int64_t readXtcFrameSize(FILE *fp, int64_t offset, int64_t fileSize, int32_t *step, int32_t *time);
+static struct XtcFrameIndex* allocateXtcFrameIndex(int capacity);
+static struct XtcFrameIndex* readXtcFrameIndexFile(char *indexFile, struct FileIdentity xtcIdentity);
+static void writeXtcFrameIndexFile(char *indexFile, struct XtcFrameIndex *index, struct FileIdentity xtcIdentity);
+
+// Frames decompressed by every thread so far, see getXtcFramesDecoded()
+static int64_t xtcFramesDecoded = 0;
+
 /*
 *	Name: struct XtcCoordinates** getXtcFileCoordinates()
 *	Description:	Opens a trajectory from Gromacs 4.6.7.  Then values form the
@@ -83,6 +99,7 @@ struct XtcCoordinates** getXtcFileCoordinates(char *xtcFile, int residues, int x
 			}
 
 			currentFrame++;
+			__atomic_fetch_add(&xtcFramesDecoded, 1, __ATOMIC_RELAXED);
 		}
 	} while (exdrOK == result);
 
@@ -102,82 +119,818 @@ struct XtcCoordinates** allocateFrameArrayMemory(int residues, int xtcFrames) {
 	struct XtcCoordinates **frameArray;
 
 	frameArray = (struct XtcCoordinates**) malloc(sizeof(struct XtcCoordinates*) * xtcFrames);
+	if(!frameArray) {
+		perror("frameArray memory not allocated");
+		abort();
+	}
+
 	for(int i = 0; i < xtcFrames; i++) {
 		frameArray[i] = (struct XtcCoordinates*) malloc(sizeof(struct XtcCoordinates) * residues);
+		if(!frameArray[i]) {
+			perror("frameArray memory not allocated");
+			abort();
+		}
 	}
 
 	return frameArray;
 }
 
 /*
-*	Name: int getFrames()
-*	Description:	Counts the frame in a trajectory from Gromacs 4.5.7.
+*	Name: void freeFrameArrayMemory()
+*	Description:	Frees the coordinates of every frame and the frame array.
+*
+*	Args: -struct XtcCoordinates **frameArray - frames from allocateFrameArrayMemory.
+*	      -int xtcFrames - the amount of frames.
+*/
+
+void freeFrameArrayMemory(struct XtcCoordinates **frameArray, int xtcFrames) {
+	for(int i = 0; i < xtcFrames; i++) {
+		free(frameArray[i]);
+	}
+
+	free(frameArray);
+}
+
+/*
+*	Name: struct XtcTrajectory* getXtcFileTrajectory()
+*	Description:	Same as getXtcFileCoordinates(), but the coordinates are stored in a
+*			struct XtcTrajectory.
 *
 *	Args: -char *xtcFile - location of the trajectory file to be read.
 *	      -int residues - total number of residues in the protein.
+*	      -int xtcFrames - total number of frames in the xtcFile.
 *
-*	Returns: currentFrame - number of frames contained in the trajectory file.
+*	Returns: -struct XtcTrajectory *trajectory - the x, y and z coordinates of each residue
+*			at each frame of the trajectory file.
+*/
+
+struct XtcTrajectory* getXtcFileTrajectory(char *xtcFile, int residues, int xtcFrames) {
+	struct XtcTrajectory *trajectory = allocateXtcTrajectory(residues, xtcFrames);
+	struct XtcStream *stream = openXtcStream(xtcFile, residues);
+
+	while(stream->currentFrame < xtcFrames && readXtcStreamFrame(stream)) {
+		copyXtcStreamFrame(stream, trajectory, stream->currentFrame-1);
+	}
+
+	trajectory->frames = stream->currentFrame;
+	closeXtcStream(stream);
+
+	return trajectory;
+}
+
+/*
+*	Name: struct XtcTrajectory* allocateXtcTrajectory()
+*	Description:	Allocates the x, y and z coordinates of every frame as three separate
+*			arrays in one 64-byte aligned allocation.  The coordinate of residue r
+*			at frame f is x[f * stride + r-1]; stride is residues rounded up to a
+*			multiple of XTC_TRAJECTORY_ALIGNMENT, so every frame starts on a 64-byte
+*			boundary.
+*
+*	Args: -int residues - total number of residues in the protein.
+*	      -int xtcFrames - total number of frames to hold.
+*
+*	Returns: -struct XtcTrajectory *trajectory - zeroed coordinates; free with
+*			freeXtcTrajectory().
+*/
+
+struct XtcTrajectory* allocateXtcTrajectory(int residues, int xtcFrames) {
+	struct XtcTrajectory *trajectory;
+
+	trajectory = (struct XtcTrajectory*) malloc(sizeof(struct XtcTrajectory));
+	if(!trajectory) {
+		perror("trajectory memory not allocated");
+		abort();
+	}
+
+	trajectory->frames = xtcFrames;
+	trajectory->residues = residues;
+	trajectory->stride = (residues + XTC_TRAJECTORY_ALIGNMENT - 1) / XTC_TRAJECTORY_ALIGNMENT * XTC_TRAJECTORY_ALIGNMENT;
+
+	size_t component = (size_t) trajectory->stride * (xtcFrames > 0 ? xtcFrames : 1);
+
+	trajectory->x = (float*) aligned_alloc(64, sizeof(float) * component * 3);
+	if(!trajectory->x) {
+		perror("trajectory memory not allocated");
+		abort();
+	}
+
+	trajectory->y = trajectory->x + component;
+	trajectory->z = trajectory->y + component;
+
+	for(size_t i = 0; i < component * 3; i++) {
+		trajectory->x[i] = 0.0f;
+	}
+
+	return trajectory;
+}
+
+/*
+*	Name: void copyXtcStreamFrame()
+*	Description:	Copies the most recently read frame of a stream into a frame of a
+*			struct XtcTrajectory.
 *
-*	Note: Inline comments ommitted due to most of the code being very similar
-*	      to readXtcFile().
+*	Args: -struct XtcStream *stream - trajectory opened with openXtcStream().
+*	      -struct XtcTrajectory *trajectory - destination of the coordinates.
+*	      -int frame - index of the destination frame, starting at 0.
+*/
+
+void copyXtcStreamFrame(struct XtcStream *stream, struct XtcTrajectory *trajectory, int frame) {
+	size_t offset = (size_t) frame * trajectory->stride;
+
+	for(int i = 0; i < stream->residues; i++) {
+		trajectory->x[offset + i] = stream->x[i][0];
+		trajectory->y[offset + i] = stream->x[i][1];
+		trajectory->z[offset + i] = stream->x[i][2];
+	}
+}
+
+/*
+*	Name: void freeXtcTrajectory()
+*	Description:	Frees the coordinates and the trajectory from getXtcFileTrajectory
+*			or allocateXtcTrajectory.
+*
+*	Args: -struct XtcTrajectory *trajectory - the trajectory.
+*/
+
+void freeXtcTrajectory(struct XtcTrajectory *trajectory) {
+	free(trajectory->x);
+	free(trajectory);
+}
+
+/*
+*	Name: int getFrames()
+*	Description:	Counts the frame in a trajectory from Gromacs 4.5.7.  The count
+*			comes from the frame index, so no frame is decompressed.
+*
+*	Args: -char *xtcFile - location of the trajectory file to be read.
+*	      -int residues - total number of residues in the protein.
+*
+*	Returns: frames - number of frames contained in the trajectory file.
 */
 
 int getFrames(char *xtcFile, int residues) {
-	XDRFILE *xd;
-	int result, natoms, step;
-	float time, prec;
-	matrix box;
-	rvec *x;
+	struct XtcFrameIndex *index = getXtcFrameIndex(xtcFile);
+	int frames = index->frames;
 
-	result = read_xtc_natoms(xtcFile, &natoms);
+	if (frames > 0) {
+		checkResidues(residues, index->natoms);
+	}
+
+	freeXtcFrameIndex(index);
+
+	return frames;
+}
+
+/*
+*	Name: struct XtcStream* openXtcStream()
+*	Description:	Opens a trajectory from Gromacs 4.6.7 for reading one frame at a time.
+*			Only a single frame is held in memory, so the trajectory is decoded
+*			once and memory use does not grow with the length of the trajectory.
+*
+*	Args: -char *xtcFile - location of the trajectory file to be read.
+*	      -int residues - total number of residues in the protein.
+*
+*	Returns: -struct XtcStream *stream - the open trajectory; stream->frame holds the
+*			coordinates of the most recently read frame.
+*/
+
+struct XtcStream* openXtcStream(char *xtcFile, int residues) {
+	struct XtcStream *stream;
+	int result;
+
+	stream = (struct XtcStream*) malloc(sizeof(struct XtcStream));
+	if(!stream) {
+		perror("stream memory not allocated");
+		abort();
+	}
+
+	result = read_xtc_natoms(xtcFile, &stream->natoms);
 	if (exdrOK != result) {
 		printf("\nread_xtc_natoms: incorrect result\n");
 		exit(1);
 	}
 
-	if (residues != natoms) {
-		printf("\nPlease change directive value residues.  residues is defined in");
-		printf("\nxtcReader.h as the number of residues cointained in the protein used");
-		printf("\nto calculate the values of the trajectory file.\n");
-		printf("residues = %i\n", residues);
-		printf("natoms = %i\n", natoms);
-		exit(1);
-	}
+	checkResidues(residues, stream->natoms);
 
-	x = calloc(natoms,sizeof(*x));
-	if (NULL == x) {
+	stream->x = calloc(stream->natoms, sizeof(*stream->x));
+	if (NULL == stream->x) {
 		printf("\nMemory for x not allocated.\n");
 		exit(1);
 	}
 
-	xd = xdrfile_open(xtcFile, "r");
-	if (NULL == xd) {
+	stream->frame = (struct XtcCoordinates*) malloc(sizeof(struct XtcCoordinates) * residues);
+	if(!stream->frame) {
+		perror("frame memory not allocated");
+		abort();
+	}
+
+	stream->xd = xdrfile_open(xtcFile, "r");
+	if (NULL == stream->xd) {
 		printf("\nError opening XTC file\n");
 		exit(1);
 	}
 
-	int currentFrame = 0;
+	stream->xtcFile = strdup(xtcFile);
+	stream->index = NULL;
+	stream->tail = NULL;
+	stream->residues = residues;
+	stream->currentFrame = 0;
+	stream->firstFrame = 0;
+	stream->lastFrame = INT_MAX;
+	stream->stride = 1;
+	stream->step = 0;
+	stream->time = 0.0;
+
+	return stream;
+}
 
-	do {
-		result = read_xtc(xd, natoms, &step, &time, box, x, &prec);
+/*
+*	Name: int readXtcStreamFrame()
+*	Description:	Reads the next frame of an open trajectory into stream->frame.
+*			Frames outside of the time range, or between strides, set with
+*			setXtcStreamTimeRange() and setXtcStreamStride() are skipped with a
+*			seek, so they are never decompressed.
+*
+*	Args: -struct XtcStream *stream - trajectory opened with openXtcStream().
+*
+*	Returns: -int - 1 if a frame was read, 0 once the end of the trajectory or of the
+*			time range is reached.
+*/
 
-		if (exdrENDOFFILE != result) {
-			if (exdrOK != result) {
-				printf("\nread_xtc result: %d\n", result);
+int readXtcStreamFrame(struct XtcStream *stream) {
+	int result, frame;
+	float prec;
+	matrix box;
+
+	frame = nextXtcStreamFrame(stream);
+	if (frame > stream->lastFrame) {
+		return 0;
+	}
+
+	if (frame != stream->currentFrame) {
+		if (!stream->index) {
+			stream->index = getXtcFrameIndex(stream->xtcFile);
+		}
+
+		if (frame >= stream->index->frames) {
+			return 0;
+		}
+
+		seekXtcStream(stream, stream->index, frame);
+	}
+
+	result = read_xtc(stream->xd, stream->natoms, &stream->step, &stream->time, box, stream->x, &prec);
+
+	if (exdrENDOFFILE == result) {
+		return 0;
+	}
+
+	if (exdrOK != result) {
+		printf("\nread_xtc result: %d\n", result);
+		exit(1);
+	}
+
+	for(int i = 0; i < stream->residues; i++) {
+		stream->frame[i].x = stream->x[i][0];
+		stream->frame[i].y = stream->x[i][1];
+		stream->frame[i].z = stream->x[i][2];
+	}
+
+	stream->currentFrame++;
+	__atomic_fetch_add(&xtcFramesDecoded, 1, __ATOMIC_RELAXED);
+
+	return 1;
+}
+
+/*
+*	Name: void setXtcStreamTimeRange()
+*	Description:	Limits the frames returned by readXtcStreamFrame() to a range of
+*			time slices.  The stride, if any, counts from the first time slice.
+*
+*	Args: -struct XtcStream *stream - trajectory opened with openXtcStream().
+*	      -struct TSRange timeRange - low and high time slice, starting at 1.
+*/
+
+void setXtcStreamTimeRange(struct XtcStream *stream, struct TSRange timeRange) {
+	stream->firstFrame = timeRange.low > 1 ? timeRange.low - 1 : 0;
+	stream->lastFrame = timeRange.high - 1;
+}
+
+/*
+*	Name: void setXtcStreamStride()
+*	Description:	Makes readXtcStreamFrame() return every stride-th frame, starting
+*			at the first frame of the time range.
+*
+*	Args: -struct XtcStream *stream - trajectory opened with openXtcStream().
+*	      -int stride - 1 reads every frame.
+*/
+
+void setXtcStreamStride(struct XtcStream *stream, int stride) {
+	if (stride < 1) {
+		printf("\nsetXtcStreamStride: stride must be at least 1\n");
+		exit(1);
+	}
+
+	stream->stride = stride;
+}
+
+/*
+*	Name: int nextXtcStreamFrame()
+*	Description:	Finds the frame the next call of readXtcStreamFrame() will read.
+*
+*	Args: -struct XtcStream *stream - trajectory opened with openXtcStream().
+*
+*	Returns: -int frame - the first frame at or after stream->currentFrame which is in
+*			the time range and on the stride, starting at 0.  It may be past
+*			stream->lastFrame or past the end of the trajectory.
+*/
+
+int nextXtcStreamFrame(struct XtcStream *stream) {
+	int frame = stream->currentFrame;
+
+	if (frame < stream->firstFrame) {
+		return stream->firstFrame;
+	}
+
+	int offset = (frame - stream->firstFrame) % stream->stride;
+	if (offset != 0) {
+		frame += stream->stride - offset;
+	}
+
+	return frame;
+}
+
+/*
+*	Name: void seekXtcStream()
+*	Description:	Moves an open trajectory to a frame, so the next call of
+*			readXtcStreamFrame() reads that frame.  Nothing before the frame is
+*			decoded.
+*
+*	Args: -struct XtcStream *stream - trajectory opened with openXtcStream().
+*	      -struct XtcFrameIndex *index - frame offsets of the same trajectory.
+*	      -int frame - the frame to move to, starting at 0.
+*/
+
+void seekXtcStream(struct XtcStream *stream, struct XtcFrameIndex *index, int frame) {
+	if (frame < 0 || frame >= index->frames) {
+		printf("\nseekXtcStream: frame %d is not in the trajectory\n", frame);
+		exit(1);
+	}
+
+	if (xdr_seek(stream->xd, index->offsets[frame], SEEK_SET) != exdrOK) {
+		printf("\nxdr_seek: could not seek to frame %d\n", frame);
+		exit(1);
+	}
+
+	stream->currentFrame = frame;
+}
+
+/*
+*	Name: void seekXtcStreamFrame()
+*	Description:	Same as seekXtcStream(), using the frame index of the stream's own
+*			trajectory.  The index is loaded by the first seek.
+*
+*	Args: -struct XtcStream *stream - trajectory opened with openXtcStream().
+*	      -int frame - the frame to move to, starting at 0.
+*/
+
+void seekXtcStreamFrame(struct XtcStream *stream, int frame) {
+	if (!stream->index) {
+		stream->index = getXtcFrameIndex(stream->xtcFile);
+	}
+
+	seekXtcStream(stream, stream->index, frame);
+}
+
+/*
+*	Name: int followXtcStreamFrame()
+*	Description:	Same as readXtcStreamFrame(), for a trajectory that is still being
+*			written.  A frame is only read once all of it is on disk; until then
+*			the file is checked again every poll seconds.  Frames outside of the
+*			time range or between strides are passed over by their headers.
+*
+*	Args: -struct XtcStream *stream - trajectory opened with openXtcStream().
+*	      -float poll - seconds between checks of the file size.
+*	      -float idle - give up after this many seconds without a new frame; 0 waits
+*			forever.
+*
+*	Returns: -int - 1 if a frame was read, 0 once the time range is finished or the
+*			trajectory stopped growing for idle seconds.
+*/
+
+int followXtcStreamFrame(struct XtcStream *stream, float poll, float idle) {
+	int frame = nextXtcStreamFrame(stream);
+	if (frame > stream->lastFrame) {
+		return 0;
+	}
+
+	if (!stream->tail && (stream->tail = fopen(stream->xtcFile, "rb")) == NULL) {
+		perror("could not open xtcFile for followXtcStreamFrame().");
+		exit(1);
+	}
+
+	for(;;) {
+		int64_t offset = xdr_tell(stream->xd);
+		int64_t frameSize, fileSize;
+		int32_t step, time;
+		float waited = 0.0f;
+
+		// The size is checked again on every pass, the file grows while it is followed
+		for(;;) {
+			fseeko(stream->tail, 0, SEEK_END);
+			fileSize = (int64_t) ftello(stream->tail);
+
+			if (fileSize < offset) {
+				printf("\n%s was truncated while it was followed\n", stream->xtcFile);
 				exit(1);
 			}
 
-			currentFrame++;
+			frameSize = readXtcFrameSize(stream->tail, offset, fileSize, &step, &time);
+			if (frameSize < 0) {
+				printf("\nfollowXtcStreamFrame: frame %d of %s has a bad magic number\n", stream->currentFrame, stream->xtcFile);
+				exit(1);
+			}
+
+			if (frameSize > 0) {
+				break;
+			}
+
+			if (idle > 0.0f && waited >= idle) {
+				return 0;
+			}
+
+			usleep((useconds_t) (poll * 1e6f));
+			waited += poll;
 		}
-	} while (exdrOK == result);
 
-	free(x);
+		if (stream->currentFrame == frame) {
+			break;
+		}
 
-	result = xdrfile_close(xd);
+		// Skipped frames are never decompressed
+		if (xdr_seek(stream->xd, offset + frameSize, SEEK_SET) != exdrOK) {
+			printf("\nxdr_seek: could not seek past frame %d\n", stream->currentFrame);
+			exit(1);
+		}
+		stream->currentFrame++;
+	}
+
+	// Drops anything read past the old end of the file
+	if (xdr_seek(stream->xd, xdr_tell(stream->xd), SEEK_SET) != exdrOK) {
+		printf("\nxdr_seek: could not seek to frame %d\n", frame);
+		exit(1);
+	}
+
+	return readXtcStreamFrame(stream);
+}
+
+/*
+*	Name: void closeXtcStream()
+*	Description:	Closes the trajectory of a stream, and the second handle
+*			followXtcStreamFrame() reads new frame sizes with, and frees the
+*			stream, its index and its buffers.
+*
+*	Args: -struct XtcStream *stream - stream from openXtcStream.
+*/
+
+void closeXtcStream(struct XtcStream *stream) {
+	int result = xdrfile_close(stream->xd);
 	if (result != 0) {
 		printf("\nclose_xtc result: %d\n", result);
 		exit(1);
 	}
 
-	return currentFrame;
+	if (stream->index) {
+		freeXtcFrameIndex(stream->index);
+	}
+
+	if (stream->tail) {
+		fclose(stream->tail);
+	}
+
+	free(stream->xtcFile);
+	free(stream->x);
+	free(stream->frame);
+	free(stream);
+}
+
+/*
+*	Name: struct XtcFrameIndex* getXtcFrameIndex()
+*	Description:	Returns the frame index of a trajectory from its <xtcFile>.idx file.
+*			If the file is missing, or was made for a trajectory of another size
+*			or modification time, the trajectory is scanned again and the file is
+*			rewritten.  When the file cannot be written, for example in a read-only
+*			directory, the scanned index is still returned.
+*
+*	Args: -char *xtcFile - location of the trajectory file.
+*
+*	Returns: -struct XtcFrameIndex *index - the frames of the trajectory; free with
+*			freeXtcFrameIndex().
+*/
+
+struct XtcFrameIndex* getXtcFrameIndex(char *xtcFile) {
+	struct FileIdentity xtcIdentity = getFileIdentity(xtcFile, 0);
+	struct XtcFrameIndex *index;
+	char *indexFile;
+
+	indexFile = (char*) malloc(strlen(xtcFile) + sizeof(XTC_FRAME_INDEX_SUFFIX));
+	if(!indexFile) {
+		perror("indexFile memory not allocated");
+		abort();
+	}
+
+	strcpy(indexFile, xtcFile);
+	strcat(indexFile, XTC_FRAME_INDEX_SUFFIX);
+
+	index = readXtcFrameIndexFile(indexFile, xtcIdentity);
+	if (!index) {
+		index = scanXtcFrameIndex(xtcFile);
+		writeXtcFrameIndexFile(indexFile, index, xtcIdentity);
+	}
+
+	free(indexFile);
+
+	return index;
+}
+
+/*
+*	Name: struct XtcFrameIndex* scanXtcFrameIndex()
+*	Description:	Finds the byte offset, step and time of every frame of a trajectory.
+*			Only the frame headers are read; the compressed coordinates are
+*			skipped using the byte count stored in each frame, so nothing is
+*			decompressed.  A partially written frame at the end of the file is
+*			not included.
+*
+*	Args: -char *xtcFile - location of the trajectory file to be read.
+*
+*	Returns: -struct XtcFrameIndex *index - the frames of the trajectory; free with
+*			freeXtcFrameIndex().
+*/
+
+struct XtcFrameIndex* scanXtcFrameIndex(char *xtcFile) {
+	struct XtcFrameIndex *index;
+	int capacity = 1024;
+	int64_t fileSize, offset = 0;
+	FILE *fp;
+
+	if ((fp = fopen(xtcFile, "rb")) == NULL) {
+		perror("could not open xtcFile for scanXtcFrameIndex().");
+		exit(1);
+	}
+
+	fseeko(fp, 0, SEEK_END);
+	fileSize = (int64_t) ftello(fp);
+
+	index = allocateXtcFrameIndex(capacity);
+
+	for(;;) {
+		int32_t natoms, step, time;
+		int64_t frameSize = readXtcFrameSize(fp, offset, fileSize, &step, &time);
+
+		if (frameSize < 0) {
+			printf("\nscanXtcFrameIndex: frame %d of %s has a bad magic number\n", index->frames, xtcFile);
+			exit(1);
+		}
+
+		if (frameSize == 0) {
+			break;
+		}
+
+		fseeko(fp, offset + 4, SEEK_SET);
+		if (!readBigEndianInt(fp, &natoms)) {
+			printf("\nscanXtcFrameIndex: could not read the atoms of frame %d of %s\n", index->frames + 1, xtcFile);
+			exit(1);
+		}
+
+		if (index->frames == capacity) {
+			capacity *= 2;
+			index->offsets = (int64_t*) realloc(index->offsets, sizeof(int64_t) * capacity);
+			index->steps = (int*) realloc(index->steps, sizeof(int) * capacity);
+			index->times = (float*) realloc(index->times, sizeof(float) * capacity);
+		}
+
+		if (!index->offsets || !index->steps || !index->times) {
+			perror("index memory not allocated");
+			abort();
+		}
+
+		index->natoms = natoms;
+		index->offsets[index->frames] = offset;
+		index->steps[index->frames] = step;
+		memcpy(&index->times[index->frames], &time, sizeof(float));
+		index->frames++;
+
+		offset += frameSize;
+	}
+
+	fclose(fp);
+
+	return index;
+}
+
+/*
+*	Name: void freeXtcFrameIndex()
+*	Description:	Frees the offsets, steps and times of a frame index and the index.
+*
+*	Args: -struct XtcFrameIndex *index - index from getXtcFrameIndex or scanXtcFrameIndex.
+*/
+
+void freeXtcFrameIndex(struct XtcFrameIndex *index) {
+	free(index->offsets);
+	free(index->steps);
+	free(index->times);
+	free(index);
+}
+
+/*
+*	Name: int64_t getXtcFramesDecoded()
+*	Description:	The amount of frames decompressed from any trajectory, on every
+*			thread, since the program started.  Frames passed over by a seek
+*			or a stride are not counted.
+*/
+
+int64_t getXtcFramesDecoded() {
+	return __atomic_load_n(&xtcFramesDecoded, __ATOMIC_RELAXED);
+}
+
+static struct XtcFrameIndex* allocateXtcFrameIndex(int capacity) {
+	struct XtcFrameIndex *index = (struct XtcFrameIndex*) malloc(sizeof(struct XtcFrameIndex));
+	if(!index) {
+		perror("index memory not allocated");
+		abort();
+	}
+
+	if (capacity < 1) {
+		capacity = 1;
+	}
+
+	index->frames = 0;
+	index->natoms = 0;
+	index->offsets = (int64_t*) malloc(sizeof(int64_t) * capacity);
+	index->steps = (int*) malloc(sizeof(int) * capacity);
+	index->times = (float*) malloc(sizeof(float) * capacity);
+
+	if (!index->offsets || !index->steps || !index->times) {
+		perror("index memory not allocated");
+		abort();
+	}
+
+	return index;
+}
+
+/*
+*	Returns NULL if the index file is missing, unreadable or does not belong to a
+*	trajectory with the given identity.
+*/
+
+static struct XtcFrameIndex* readXtcFrameIndexFile(char *indexFile, struct FileIdentity xtcIdentity) {
+	struct XtcFrameIndexHeader header;
+	struct XtcFrameIndex *index;
+	FILE *fp;
+
+	if ((fp = fopen(indexFile, "rb")) == NULL) {
+		return NULL;
+	}
+
+	if (fread(&header, sizeof(header), 1, fp) != 1 ||
+	    memcmp(header.magic, XTC_FRAME_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+	    header.version != XTC_FRAME_INDEX_VERSION || header.frames < 0 ||
+	    header.xtcIdentity.size != xtcIdentity.size ||
+	    header.xtcIdentity.modified != xtcIdentity.modified ||
+	    header.xtcIdentity.modifiedNanoseconds != xtcIdentity.modifiedNanoseconds) {
+		fclose(fp);
+		return NULL;
+	}
+
+	index = allocateXtcFrameIndex(header.frames);
+	index->frames = header.frames;
+	index->natoms = header.natoms;
+
+	if (fread(index->offsets, sizeof(int64_t), header.frames, fp) != (size_t) header.frames ||
+	    fread(index->steps, sizeof(int), header.frames, fp) != (size_t) header.frames ||
+	    fread(index->times, sizeof(float), header.frames, fp) != (size_t) header.frames) {
+		freeXtcFrameIndex(index);
+		fclose(fp);
+		return NULL;
+	}
+
+	fclose(fp);
+
+	return index;
+}
+
+/*
+*	The index is written to a temporary file which is then renamed, so a reader never
+*	sees a partially written index.  The temporary file has a unique name, so processes
+*	indexing the same trajectory at once do not write into each other's file.
+*/
+
+static void writeXtcFrameIndexFile(char *indexFile, struct XtcFrameIndex *index, struct FileIdentity xtcIdentity) {
+	struct XtcFrameIndexHeader header;
+	char *tmpFile;
+	FILE *fp;
+	int fd, written;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, XTC_FRAME_INDEX_MAGIC, sizeof(header.magic));
+	header.version = XTC_FRAME_INDEX_VERSION;
+	header.natoms = index->natoms;
+	header.frames = index->frames;
+	header.xtcIdentity = xtcIdentity;
+
+	tmpFile = (char*) malloc(strlen(indexFile) + sizeof(".XXXXXX"));
+	if(!tmpFile) {
+		perror("tmpFile memory not allocated");
+		abort();
+	}
+
+	strcpy(tmpFile, indexFile);
+	strcat(tmpFile, ".XXXXXX");
+
+	if ((fd = mkstemp(tmpFile)) == -1) {
+		free(tmpFile);
+		return;
+	}
+
+	// mkstemp creates the file readable by its owner only
+	fchmod(fd, 0644);
+
+	if ((fp = fdopen(fd, "wb")) == NULL) {
+		close(fd);
+		remove(tmpFile);
+		free(tmpFile);
+		return;
+	}
+
+	written = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+		  fwrite(index->offsets, sizeof(int64_t), index->frames, fp) == (size_t) index->frames &&
+		  fwrite(index->steps, sizeof(int), index->frames, fp) == (size_t) index->frames &&
+		  fwrite(index->times, sizeof(float), index->frames, fp) == (size_t) index->frames;
+
+	if (fclose(fp) != 0 || !written || rename(tmpFile, indexFile) != 0) {
+		remove(tmpFile);
+	}
+
+	free(tmpFile);
+}
+
+static int readBigEndianInt(FILE *fp, int32_t *value) {
+	uint32_t bytes;
+
+	if (fread(&bytes, sizeof(bytes), 1, fp) != 1) {
+		return 0;
+	}
+
+	bytes = ntohl(bytes);
+	memcpy(value, &bytes, sizeof(bytes));
+
+	return 1;
+}
+
+/*
+*	Returns the size in bytes of the frame starting at offset, 0 if the file ends before
+*	the frame does, or -1 if there is no frame header at offset.  Sets the step and time
+*	(as the bits of a float) of the frame.
+*/
+
+static int64_t readXtcFrameSize(FILE *fp, int64_t offset, int64_t fileSize, int32_t *step, int32_t *time) {
+	int32_t magic, natoms, byteCount;
+	int64_t frameSize;
+
+	// Frame header: magic number, atoms, step and time, then the box and atoms again
+	fseeko(fp, offset, SEEK_SET);
+	if (!readBigEndianInt(fp, &magic) || !readBigEndianInt(fp, &natoms) ||
+	    !readBigEndianInt(fp, step) || !readBigEndianInt(fp, time)) {
+		return 0;
+	}
+
+	if (magic != 1995) {
+		return -1;
+	}
+
+	// Up to 9 atoms are stored uncompressed, otherwise the compressed size follows
+	// the precision, minimum and maximum integers and small index
+	if (natoms <= 9) {
+		frameSize = 56 + (int64_t) natoms * 12;
+	} else {
+		fseeko(fp, offset + 88, SEEK_SET);
+		if (!readBigEndianInt(fp, &byteCount)) {
+			return 0;
+		}
+
+		frameSize = 92 + (((int64_t) byteCount + 3) & ~(int64_t) 3);
+	}
+
+	return offset + frameSize > fileSize ? 0 : frameSize;
+}
+
+static void checkResidues(int residues, int natoms) {
+	if (residues != natoms) {
+		printf("\nPlease change directive value residues.  residues is defined in");
+		printf("\nxtcReader.h as the number of residues cointained in the protein used");
+		printf("\nto calculate the values of the trajectory file.\n");
+		printf("residues = %i\n", residues);
+		printf("natoms = %i\n", natoms);
+		exit(1);
+	}
 }
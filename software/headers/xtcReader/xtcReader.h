@@ -8,15 +8,100 @@
 #ifndef XTC_READER
 #define XTC_READER
 
+#include <stdio.h>
+#include <stdint.h>
+
+#include "xdrfile.h"
+#include "../fileIdentity/fileIdentity.h"
+
 struct XtcCoordinates {
 	float x;
 	float y;
 	float z;
 };
 
+// Floats per frame in struct XtcTrajectory are rounded up to a multiple of this
+#define XTC_TRAJECTORY_ALIGNMENT 16
+
+struct XtcTrajectory {
+	int frames;
+	int residues;
+	int stride;
+	float *x;
+	float *y;
+	float *z;
+};
+
+// Time slices are frame numbers starting at 1; low and high are both included
+struct TSRange {
+	int low;
+	int high;
+};
+
+struct XtcFrameIndex {
+	int frames;
+	int natoms;
+	int64_t *offsets;
+	int *steps;
+	float *times;
+};
+
+// The frame index of a trajectory is kept next to it in <xtcFile>.idx
+#define XTC_FRAME_INDEX_SUFFIX ".idx"
+#define XTC_FRAME_INDEX_MAGIC "XTCINDEX"
+#define XTC_FRAME_INDEX_VERSION 2
+
+// Followed by the offsets, steps and times of every frame
+struct XtcFrameIndexHeader {
+	char magic[8];
+	int32_t version;
+	int32_t natoms;
+	int32_t frames;
+	int32_t reserved;
+	struct FileIdentity xtcIdentity;
+};
+
+struct XtcStream {
+	XDRFILE *xd;
+	char *xtcFile;
+	int natoms;
+	int residues;
+	int currentFrame;
+	int firstFrame;
+	int lastFrame;
+	int stride;
+	int step;
+	float time;
+	rvec *x;
+	struct XtcCoordinates *frame;
+	struct XtcFrameIndex *index;
+	FILE *tail;
+};
+
 struct XtcCoordinates** getXtcFileCoordinates(char *, int, int);
 struct XtcCoordinates** allocateFrameArrayMemory(int, int);
 int getFrames(char*, int);
+void freeFrameArrayMemory(struct XtcCoordinates **, int);
+
+struct XtcTrajectory* getXtcFileTrajectory(char *xtcFile, int residues, int xtcFrames);
+struct XtcTrajectory* allocateXtcTrajectory(int residues, int xtcFrames);
+void copyXtcStreamFrame(struct XtcStream *stream, struct XtcTrajectory *trajectory, int frame);
+void freeXtcTrajectory(struct XtcTrajectory *trajectory);
+
+struct XtcStream* openXtcStream(char *xtcFile, int residues);
+int readXtcStreamFrame(struct XtcStream *stream);
+void setXtcStreamTimeRange(struct XtcStream *stream, struct TSRange timeRange);
+void setXtcStreamStride(struct XtcStream *stream, int stride);
+int nextXtcStreamFrame(struct XtcStream *stream);
+void seekXtcStream(struct XtcStream *stream, struct XtcFrameIndex *index, int frame);
+void seekXtcStreamFrame(struct XtcStream *stream, int frame);
+int followXtcStreamFrame(struct XtcStream *stream, float poll, float idle);
+void closeXtcStream(struct XtcStream *stream);
+
+struct XtcFrameIndex* getXtcFrameIndex(char *xtcFile);
+struct XtcFrameIndex* scanXtcFrameIndex(char *xtcFile);
+void freeXtcFrameIndex(struct XtcFrameIndex *index);
+int64_t getXtcFramesDecoded();
 
 
 #endif
@@ -0,0 +1,92 @@
+/*
+*	Name: nonNativeContactsProg.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Finds every residue pair within the cutoff in every frame of the traj.xtc, not
+*		only the pairs of the contacts file, using a cell list.  The countsFile holds
+*		the native and non-native contacts of every frame.  The frequencyFile holds every
+*		pair that was in contact at least once, with its probability over the frames,
+*		its occurrences and its contact number in the contacts file, 0 when non-native.
+*		Non-native pairs closer than --separation residues in sequence (default 4) are
+*		left out.
+*
+*	Usage example:
+*		nonNativeContactsProg {residues} {cutoff} {xtcFile} {contactFile} {countsFile} {frequencyFile}
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "headers/xtcReader/xtcReader.h"
+#include "headers/contactReader/contactReader.h"
+#include "headers/cellList/cellList.h"
+#include "headers/threadedAnalysis/threadedAnalysis.h"
+#include "headers/programOptions/programOptions.h"
+#include "headers/profile/profile.h"
+
+int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	int threads = takeThreadsOption(&argc, argv);
+	int stride = takeStrideOption(&argc, argv);
+	struct TSRange timeRange;
+	int ranged = takeRangeOption(&argc, argv, "--range", &timeRange.low, &timeRange.high);
+	char *separationOption = takeOption(&argc, argv, "--separation");
+	int separation = separationOption ? atoi(separationOption) : CELL_LIST_SEPARATION;
+
+	if (argc != 7 || separation < 1) {
+		printf("Usage Example: nonNativeContactsProg 163 1.0 traj.xtc contactFile countsFile frequencyFile --separation 4\n");
+		return 1;
+	}
+
+	int residues = atoi(argv[1]);
+	float cutOff = atof(argv[2]);
+	char *xtcfile = argv[3];
+	char *contactFile = argv[4];
+
+	struct XtcStream *xtcStream;
+	struct NonNativeContacts *nonNative;
+
+	// Reads the contacts from the contact file once
+	profileStage("readContacts");
+	struct ContactSet *contactSet = readContactSet(contactFile);
+	checkContactSetResidues(contactSet, residues);
+
+	int contacts = contactSet->contacts;
+	struct Contact *residueContacts = contactSet->residueContacts;
+
+	// Opens the traj.xtc file, frames are decoded one at a time
+	profileStage("openTrajectory");
+	xtcStream = openXtcStream(xtcfile, residues);
+	setXtcStreamStride(xtcStream, stride);
+
+	// Frames outside of the time slice range are never decoded
+	if(ranged) {
+		setXtcStreamTimeRange(xtcStream, timeRange);
+	}
+
+	// Counts every pair within the cutoff of every frame
+	profileStage("countContacts");
+	if(threads > 1) {
+		nonNative = calculateNonNativeContactsThreaded(xtcStream, contacts, residueContacts, cutOff, separation, threads);
+	} else {
+		nonNative = calculateNonNativeContactsFromStream(xtcStream, contacts, residueContacts, cutOff, separation);
+	}
+
+	closeXtcStream(xtcStream);
+
+	profileStage("writeOutput");
+	struct PairMap *nativePairs = createNativePairMap(contacts, residueContacts);
+
+	writeNonNativeCountsFile(nonNative, argv[5]);
+	writePairFrequencyFile(nonNative, nativePairs, argv[6]);
+
+	freePairMap(nativePairs);
+	freeNonNativeContacts(nonNative);
+	freeContactSet(contactSet);
+
+	return 0;
+}
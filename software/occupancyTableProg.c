@@ -0,0 +1,99 @@
+/*
+*	Name: occupancyTableProg.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Reads the traj.xtc file once and writes, for every window of Q values and time
+*		slices, the probability and occurrences of every contact and the average contact
+*		probability of every residue.  Each window matches one run of
+*		probabilityContactInQValueRangeProg and averageContactProbabilityInQValueRangeProg.
+*		Windows are every combination of the Q bins given with --q and the time windows
+*		given with --ts; either may be left out to use all Q values or all time slices.
+*		With --checkpoint file, the counts are saved every --checkpoint-frames frames
+*		and a stopped run continues from them when started again.
+*
+*	Usage example:
+*		occupancyTableProg {residues} {cutoff} {xtcFile} {contactFile} --q 0:20,21:40 --ts 1:500,501:1000
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "headers/xtcReader/xtcReader.h"
+#include "headers/contactReader/contactReader.h"
+#include "headers/occupancyTable/occupancyTable.h"
+#include "headers/threadedAnalysis/threadedAnalysis.h"
+#include "headers/checkpoint/checkpoint.h"
+#include "headers/programOptions/programOptions.h"
+#include "headers/profile/profile.h"
+
+int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	int threads = takeThreadsOption(&argc, argv);
+	char *checkpointFile = takeOption(&argc, argv, "--checkpoint");
+	char *checkpointFrames = takeOption(&argc, argv, "--checkpoint-frames");
+	char *settings = joinArguments(argc, argv);
+	int stride = takeStrideOption(&argc, argv);
+	int qBins, timeWindows, windows;
+	int *qBin = takeRangeListOption(&argc, argv, "--q", &qBins);
+	int *timeWindow = takeRangeListOption(&argc, argv, "--ts", &timeWindows);
+
+	if (argc != 5) {
+		printf("Usage Example: occupancyTableProg 163 1.0 traj.xtc contactFile --q 0:100,101:200 --ts 1:500,501:1000\n");
+		return 1;
+	}
+
+	int residues = atoi(argv[1]);
+	float cutOff = atof(argv[2]);
+	char *xtcfile = argv[3];
+	char *contactFile = argv[4];
+
+	struct XtcStream *xtcStream;
+	struct OccupancyWindow *window;
+	struct OccupancyTable *table;
+	struct ContactAverages *contactAverages;
+	struct Checkpoint *checkpoint = NULL;
+
+	// Reads the contacts from the contact file once
+	profileStage("readContacts");
+	struct ContactSet *contactSet = readContactSet(contactFile);
+	checkContactSetResidues(contactSet, residues);
+
+	int contacts = contactSet->contacts;
+	struct Contact *residueContacts = contactSet->residueContacts;
+
+	window = createOccupancyWindows(qBins, qBin, timeWindows, timeWindow, &windows);
+
+	// Opens the traj.xtc file, frames are decoded one at a time
+	profileStage("openTrajectory");
+	xtcStream = openXtcStream(xtcfile, residues);
+	setXtcStreamStride(xtcStream, stride);
+
+	// Every frame is evaluated once and added to all of its windows
+	profileStage("calculateOccupancyTable");
+	if(checkpointFile) {
+		checkpoint = openCheckpoint(checkpointFile, checkpointFrames ? atoi(checkpointFrames) : CHECKPOINT_FRAMES, xtcfile, contactFile, settings);
+		table = calculateOccupancyTableCheckpointed(checkpoint, xtcStream, contacts, residueContacts, windows, window, cutOff, threads);
+	} else if(threads > 1) {
+		table = calculateOccupancyTableThreaded(xtcStream, contacts, residueContacts, windows, window, cutOff, threads);
+	} else {
+		table = calculateOccupancyTableFromStream(xtcStream, contacts, residueContacts, windows, window, cutOff);
+	}
+
+	closeXtcStream(xtcStream);
+
+	profileStage("calculateAverages");
+	contactAverages = calculateOccupancyTableAverages(table, residues);
+
+	profileStage("writeOutput");
+	writeOccupancyTable(stdout, table, contactAverages, residues);
+
+	if(checkpoint) {
+		finishCheckpoint(checkpoint);
+	}
+
+	return 0;
+}
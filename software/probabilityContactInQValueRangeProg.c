@@ -13,6 +13,12 @@
 *		within the specified range.  Also a range of time slices is provided to narrow the
 *		search.
 *
+*		With --qseries file, the Q values are read from a binary Q series written by
+*		calcQFromContactsProg --qseries, and only the frames in both ranges are decoded.
+*
+*		With --cache directory, or PROTEIN_CACHE set, the contact probabilities are kept
+*		in the directory and read from there when the same ranges are asked for again.
+*
 *	Compile example:
 *		gcc -o probabilityContactInQValueRange probabilityContactInQValueRange.c xdrfile.c xdrfile_xtc.c -lm
 */
@@ -24,9 +30,25 @@
 #include "headers/xtcReader/xtcReader.h"
 #include "headers/contactReader/contactReader.h"
 #include "headers/calcQFromContacts/calcQFromContacts.h"
+#include "headers/threadedAnalysis/threadedAnalysis.h"
+#include "headers/checkpoint/checkpoint.h"
+#include "headers/qSeries/qSeries.h"
+#include "headers/resultCache/resultCache.h"
+#include "headers/programOptions/programOptions.h"
+#include "headers/profile/profile.h"
 #include "headers/probabilityContactInQValueRange/probabilityContactInQValueRange.h"
 
 int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	int threads = takeThreadsOption(&argc, argv);
+	char *checkpointFile = takeOption(&argc, argv, "--checkpoint");
+	char *checkpointFrames = takeOption(&argc, argv, "--checkpoint-frames");
+	char *qSeriesFile = takeOption(&argc, argv, "--qseries");
+	struct ResultCache *cache = openResultCache(&argc, argv);
+	char *settings = joinArguments(argc, argv);
+	int stride = takeStrideOption(&argc, argv);
+
 	char *xtcfile = argv[5];
 	char *contactFile = argv[6];
 
@@ -39,36 +61,77 @@ int main(int argc, char *argv[]) {
 	int residues = atoi(argv[7]);
 	float cutOff = atof(argv[8]);
 
-	int *qValues, xtcFrames, contacts;
+	int contacts;
 
-	struct XtcCoordinates **xtcResidueCoordinates;
+	struct XtcStream *xtcStream;
+	struct Checkpoint *checkpoint = NULL;
+	struct ContactSet *contactSet;
 	struct Contact *residueContacts;
 	struct ContactInformation *residueContactsInformation;
 
-	// Counts amount of frames from the traj.xtc file
-	xtcFrames = getFrames(xtcfile, residues);
+	// Reads the contacts from the contact file once
+	profileStage("readContacts");
+	contactSet = readContactSet(contactFile);
+	checkContactSetResidues(contactSet, residues);
 
-	// Copies all the residue coordinates for each frame of the traj.xtc file into memory
-	xtcResidueCoordinates = getXtcFileCoordinates(xtcfile, residues, xtcFrames);
+	contacts = contactSet->contacts;
+	residueContacts = contactSet->residueContacts;
 
-	// Reads the amount of contacts from the contact file
-	contacts = getAmountOfContacts(contactFile);
+	// Opens the traj.xtc file, frames are decoded one at a time
+	profileStage("openTrajectory");
+	xtcStream = openXtcStream(xtcfile, residues);
+	setXtcStreamStride(xtcStream, stride);
 
-	// Copies all the residue contacts from the contact file
-	residueContacts = getContactFileContacts(contactFile);
+	// Both programs keep the same results for the same ranges, cutoff and stride
+	char cacheSettings[512];
+	int64_t cachedFrames, cachedBytes;
+	int cached = 0;
 
-	// Creates Q values for every frame in the traj.xtc file
-	qValues = calculateQValues(xtcFrames, contacts, cutOff, xtcResidueCoordinates, residueContacts);
+	if(cache) {
+		snprintf(cacheSettings, sizeof(cacheSettings), "%s %s %s %s %s %s stride %d", argv[1], argv[2], argv[3], argv[4], argv[7], argv[8], stride);
+		setResultCacheKey(cache, "contactProbability", xtcfile, contactFile, cacheSettings);
+	}
 
 	// Records total occurrences of each contact and calculates the probability of the contact occuring
-	residueContactsInformation = calculateContactProbability(xtcFrames, contacts, xtcResidueCoordinates, contactFile, qRange, timeRange, qValues, cutOff);
+	profileStage("calculateProbability");
+	if(cache && (residueContactsInformation = (struct ContactInformation*) readResultCache(cache, &cachedFrames, &cachedBytes)) != NULL) {
+		cached = 1;
+	} else if(qSeriesFile) {
+		// Frames with a Q value out of range are not decoded
+		struct QSeries *series = readQSeries(qSeriesFile);
+
+		checkQSeries(series, xtcStream, contactFile, cutOff);
+		residueContactsInformation = calculateContactProbabilityFromQSeries(xtcStream, series, contacts, residueContacts, qRange, timeRange, cutOff);
+		freeQSeries(series);
+	} else if(checkpointFile) {
+		// The counts of a table with one window are saved, and are the same as below
+		struct OccupancyWindow window = {qRange, timeRange};
+
+		checkpoint = openCheckpoint(checkpointFile, checkpointFrames ? atoi(checkpointFrames) : CHECKPOINT_FRAMES, xtcfile, contactFile, settings);
+		residueContactsInformation = calculateOccupancyTableCheckpointed(checkpoint, xtcStream, contacts, residueContacts, 1, &window, cutOff, threads)->contactInformation;
+	} else if(threads > 1) {
+		residueContactsInformation = calculateContactProbabilityThreaded(xtcStream, contacts, residueContacts, qRange, timeRange, cutOff, threads);
+	} else {
+		residueContactsInformation = calculateContactProbabilityFromStream(xtcStream, contacts, residueContacts, qRange, timeRange, cutOff);
+	}
+
+	if(cache && !cached) {
+		writeResultCache(cache, residueContactsInformation, contacts, sizeof(struct ContactInformation) * (int64_t) contacts);
+	}
+
+	closeXtcStream(xtcStream);
 
 	// Output for all information on that contacts
+	profileStage("writeOutput");
 	for(int i = 0; i < contacts; i++) {
 		//printf("%d - focusedResidue: %d\tcontactResidue: %d\tprobability: %f\toccurrences: %d\n", i+1, residueContactsInformation[i].focusResidue, residueContactsInformation[i].contactResidue, residueContactsInformation[i].probability, residueContactsInformation[i].totalOccurrences);
 		printf("%d %d %d %f %d\n", i+1, residueContactsInformation[i].focusResidue, residueContactsInformation[i].contactResidue, residueContactsInformation[i].probability, residueContactsInformation[i].totalOccurrences);
 	}
 
+	if(checkpoint) {
+		finishCheckpoint(checkpoint);
+	}
+
 	return 0;
 }
 
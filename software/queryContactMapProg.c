@@ -0,0 +1,156 @@
+/*
+*	Name: queryContactMapProg.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Answers queries from a contact map file created by buildContactMapProg.  The
+*		traj.xtc file is not read; Q values and contact occurrences are counted from the
+*		stored contact states of each frame.
+*
+*		probability - same output as probabilityContactInQValueRangeProg.
+*		average     - same output as averageContactProbabilityInQValueRangeProg.
+*		q           - the Q value of every frame within the time slice range, one per line.
+*
+*		Given --xtc, --contacts or --cutoff, the map must have been built from that
+*		traj.xtc, contact file and cutoff, so answers never come from a stale map.
+*
+*	Usage example:
+*		queryContactMapProg probability {QLow} {QHigh} {TSLow} {TSHigh} {mapFile}
+*		queryContactMapProg average {QLow} {QHigh} {TSLow} {TSHigh} {mapFile}
+*		queryContactMapProg q {TSLow} {TSHigh} {mapFile}
+*		queryContactMapProg probability 300 400 1 1000 traj.cmap --xtc traj.xtc --contacts contacts --cutoff 0.8
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "headers/contactState/contactState.h"
+#include "headers/probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+#include "headers/averageContactProbabilityInQValueRange/averageContactProbabilityInQValueRange.h"
+#include "headers/residueGraph/residueGraph.h"
+#include "headers/contactMap/contactMap.h"
+#include "headers/programOptions/programOptions.h"
+#include "headers/profile/profile.h"
+
+int printUsage();
+struct ContactMap* openCheckedContactMap(char *mapFile, char *xtcFile, char *contactFile, float cutoff);
+
+int main(int argc, char *argv[]) {
+	struct ContactMap *contactMap;
+	struct QRange qRange;
+	struct TSRange timeRange;
+
+	startProfile(&argc, argv);
+
+	char *xtcFile = takeOption(&argc, argv, "--xtc");
+	char *contactFile = takeOption(&argc, argv, "--contacts");
+	float cutoff = takeFloatOption(&argc, argv, "--cutoff", -1.0f);
+
+	if (argc < 2) {
+		return printUsage();
+	}
+
+	if (strcmp(argv[1], "q") == 0) {
+		if (argc != 5) {
+			return printUsage();
+		}
+
+		timeRange.low = atoi(argv[2]), timeRange.high = atoi(argv[3]);
+		profileStage("openContactMap");
+		contactMap = openCheckedContactMap(argv[4], xtcFile, contactFile, cutoff);
+
+		int words = contactMap->header->words;
+		int first = timeRange.low > 1 ? timeRange.low - 1 : 0;
+		int last = timeRange.high < contactMap->header->frames ? timeRange.high - 1 : contactMap->header->frames - 1;
+
+		// For every frame within the time slice range
+		profileStage("writeOutput");
+		for(int i = first; i <= last; i++) {
+			printf("%i\n", countContactStates(contactMap->header->contacts, &contactMap->contactStates[(size_t)i * words]));
+		}
+
+		closeContactMap(contactMap);
+
+		return 0;
+	}
+
+	if (argc != 7 || (strcmp(argv[1], "probability") != 0 && strcmp(argv[1], "average") != 0)) {
+		return printUsage();
+	}
+
+	qRange.low = atoi(argv[2]), qRange.high = atoi(argv[3]);
+	timeRange.low = atoi(argv[4]), timeRange.high = atoi(argv[5]);
+	profileStage("openContactMap");
+	contactMap = openCheckedContactMap(argv[6], xtcFile, contactFile, cutoff);
+
+	int contacts = contactMap->header->contacts;
+	int residues = contactMap->header->residues;
+
+	// Records total occurrences of each contact and calculates the probability of the contact occurring
+	profileStage("calculateProbability");
+	struct ContactInformation *residueContactsInformation =
+			calculateContactProbabilityFromContactStates(contactMap->header->frames, contacts,
+					contactMap->contactStates, contactMap->residueContacts, qRange, timeRange);
+
+	if (strcmp(argv[1], "probability") == 0) {
+		profileStage("writeOutput");
+		for(int i = 0; i < contacts; i++) {
+			printf("%d %d %d %f %d\n", i+1, residueContactsInformation[i].focusResidue, residueContactsInformation[i].contactResidue, residueContactsInformation[i].probability, residueContactsInformation[i].totalOccurrences);
+		}
+	} else {
+		// Lists the contacts of every residue, as either residue of the pair
+		profileStage("calculateAverages");
+		struct ResidueGraph *residueGraph = createResidueGraph(residues, contacts, contactMap->residueContacts);
+
+		// Calculates the average of all probabilities per residue
+		struct ContactAverages *contactAverages = calculateResidueGraphAverages(residueGraph, residueContactsInformation);
+
+		profileStage("writeOutput");
+		for(int i = 0; i < residues; i++) {
+			if(contactAverages[i].averageProbability != -1.0) {
+				printf("%d %f\n", contactAverages[i].focusResidue+1, contactAverages[i].averageProbability);
+			} else {
+				printf("%d N/A\n", contactAverages[i].focusResidue+1);
+			}
+		}
+	}
+
+	closeContactMap(contactMap);
+
+	return 0;
+}
+
+/*
+*	Name: struct ContactMap* openCheckedContactMap()
+*	Description: Opens a contact map and exits with a message unless it was built from
+*		     the traj.xtc, contact file and cutoff given on the command line.
+*
+*	Args: -char *mapFile - location of the contact map file.
+*	      -char *xtcFile - location of the trajectory file, or NULL to skip the check.
+*	      -char *contactFile - location of the contacts file, or NULL to skip the check.
+*	      -float cutoff - the expected cutoff, or a negative value to skip the check.
+*
+*	Returns: -struct ContactMap *contactMap - the opened contact map.
+*/
+
+struct ContactMap* openCheckedContactMap(char *mapFile, char *xtcFile, char *contactFile, float cutoff) {
+	struct ContactMap *contactMap = openContactMap(mapFile);
+
+	if (!checkContactMap(contactMap, xtcFile, contactFile, cutoff)) {
+		printf("\n%s was not built from the given traj.xtc, contact file and cutoff, run buildContactMapProg again\n", mapFile);
+		exit(1);
+	}
+
+	return contactMap;
+}
+
+int printUsage() {
+	printf("Usage Example: queryContactMapProg probability 300 400 1 1000 traj.cmap\n");
+	printf("               queryContactMapProg average 300 400 1 1000 traj.cmap\n");
+	printf("               queryContactMapProg q 1 1000 traj.cmap\n");
+	printf("               queryContactMapProg q 1 1000 traj.cmap --xtc traj.xtc --contacts contacts --cutoff 0.8\n");
+	return 1;
+}
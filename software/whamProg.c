@@ -0,0 +1,115 @@
+/*
+*	Name: whamProg.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*
+*	Summary of expected functionality:
+*		Combines runs at several temperatures with the weighted histogram analysis
+*		method and writes the free energy F(Q) at every requested temperature.  Each
+*		line of the runFile is a run: its temperature, the qFile or Q series of
+*		calcQFromContactsProg, the energy file of mdtoen.csh and optionally its traj.xtc.
+*		The energy file may be the md.log of the run, read for the --energy label
+*		and joined to the frames of its traj.xtc by step.
+*		Given the residues, cutoff and contactFile, the probability of every contact at
+*		every temperature follows, which needs the traj.xtc of every run.
+*
+*	Usage example:
+*		whamProg {runFile} {temperatures} [{residues} {cutoff} {contactFile}] --bin 1 --energy Potential --threads 8
+*		whamProg runs 130,135,140 163 1.0 contactFile --threads 8
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "headers/contactReader/contactReader.h"
+#include "headers/wham/wham.h"
+#include "headers/programOptions/programOptions.h"
+#include "headers/profile/profile.h"
+
+int main(int argc, char *argv[]) {
+	startProfile(&argc, argv);
+
+	int threads = takeThreadsOption(&argc, argv);
+	double binWidth = takeFloatOption(&argc, argv, "--bin", 1.0f);
+	double tolerance = takeFloatOption(&argc, argv, "--tolerance", WHAM_TOLERANCE);
+	int iterations = (int) takeFloatOption(&argc, argv, "--iterations", WHAM_ITERATIONS);
+	char *energyOption = takeOption(&argc, argv, "--energy");
+	int temperatures, bins;
+	double qMin;
+
+	if (argc != 3 && argc != 6) {
+		printf("Usage Example: whamProg runs 130,135,140 163 1.0 contactFile --threads 8\n");
+		return 1;
+	}
+
+	if (binWidth <= 0) {
+		printf("\n--bin must be larger than 0\n");
+		return 1;
+	}
+
+	float *temperature = parseCutoffList(argv[2], &temperatures);
+
+	for(int t = 0; t < temperatures; t++) {
+		if (temperature[t] <= 0) {
+			printf("\nTemperatures must be larger than 0 K\n");
+			return 1;
+		}
+	}
+
+	profileStage("readRuns");
+	struct Wham *wham = readWhamRuns(argv[1], energyOption ? energyOption : "Potential");
+
+	profileStage("solveWham");
+	if (!solveWham(wham, tolerance, iterations, threads)) {
+		fprintf(stderr, "WHAM did not converge in %d iterations, the largest change was %g\n", wham->iterations, wham->change);
+	}
+
+	profileStage("calculateFreeEnergy");
+	double **logWeight = (double**) malloc(sizeof(double*) * temperatures);
+	double **freeEnergy = (double**) malloc(sizeof(double*) * temperatures);
+	if(!logWeight || !freeEnergy) {
+		perror("freeEnergy memory not allocated");
+		abort();
+	}
+
+	bins = getWhamQBins(wham, binWidth, &qMin);
+
+	for(int t = 0; t < temperatures; t++) {
+		logWeight[t] = calculateWhamLogWeights(wham, temperature[t]);
+		freeEnergy[t] = calculateWhamFreeEnergy(wham, logWeight[t], temperature[t], binWidth, qMin, bins);
+	}
+
+	writeWhamFreeEnergy(stdout, wham, temperatures, temperature, freeEnergy, binWidth, qMin, bins);
+
+	if (argc == 6) {
+		int residues = atoi(argv[3]);
+		float cutOff = atof(argv[4]);
+
+		profileStage("readContacts");
+		struct ContactSet *contactSet = readContactSet(argv[5]);
+		checkContactSetResidues(contactSet, residues);
+
+		profileStage("calculateProbability");
+		double *probability = calculateWhamContactProbabilities(wham, temperatures, logWeight, residues,
+				contactSet->contacts, contactSet->residueContacts, cutOff, threads);
+
+		profileStage("writeOutput");
+		writeWhamContactProbabilities(stdout, temperatures, temperature, probability, contactSet->contacts, contactSet->residueContacts);
+
+		free(probability);
+		freeContactSet(contactSet);
+	}
+
+	for(int t = 0; t < temperatures; t++) {
+		free(logWeight[t]);
+		free(freeEnergy[t]);
+	}
+
+	free(logWeight);
+	free(freeEnergy);
+	free(temperature);
+	freeWham(wham);
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+/*
+*	Name: analysisJobsTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/occupancyTable/occupancyTable.h"
+#include "../software/headers/analysisJobs/analysisJobs.h"
+
+Test(analysisJobs, Test_parseAnalysisJobs) {
+	char *argv[] = {"q", "qFile", "probability", "300", "400", "0", "20", "probabilities",
+			"average", "300", "400", "0", "20", "averages", "average", "0", "440", "1", "101", "-"};
+
+	struct AnalysisJobs *jobs = parseAnalysisJobs(20, argv);
+
+	cr_assert_eq(4, jobs->jobs);
+	cr_assert_eq(ANALYSIS_JOB_Q, jobs->job[0].type);
+	cr_assert_eq(ANALYSIS_JOB_PROBABILITY, jobs->job[1].type);
+	cr_assert_eq(ANALYSIS_JOB_AVERAGE, jobs->job[3].type);
+
+	// The probabilities and averages of the same ranges share a window
+	cr_assert_eq(2, jobs->windows);
+	cr_assert_eq(0, jobs->job[1].tableWindow);
+	cr_assert_eq(0, jobs->job[2].tableWindow);
+	cr_assert_eq(1, jobs->job[3].tableWindow);
+	cr_assert_eq(440, jobs->window[1].qRange.high);
+	cr_assert_eq(101, jobs->window[1].timeRange.high);
+
+	freeAnalysisJobs(jobs);
+}
+
+Test(analysisJobs, Test_calculateAnalysisJobs) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	char *argv[] = {"q", "qFile", "probability", "300", "400", "0", "20", "probabilities"};
+	int xtcFrames;
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	int *qValues = calculateQValuesFromStream(xtcStream, contacts, 1.0f, residueContacts, &xtcFrames);
+	closeXtcStream(xtcStream);
+
+	struct OccupancyWindow window = {{300, 400}, {0, 20}};
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	struct OccupancyTable *table = calculateOccupancyTableFromStream(xtcStream, contacts, residueContacts, 1, &window, 1.0f);
+	closeXtcStream(xtcStream);
+
+	// The same as the separate runs, from one pass and on several threads
+	for(int threads = 1; threads <= 2; threads++) {
+		struct AnalysisJobs *jobs = parseAnalysisJobs(8, argv);
+
+		xtcStream = openXtcStream("./files/xtcFile", 163);
+		calculateAnalysisJobs(jobs, xtcStream, contacts, residueContacts, 163, 1.0f, threads);
+		closeXtcStream(xtcStream);
+
+		cr_assert_eq(xtcFrames, jobs->xtcFrames);
+		for(int i = 0; i < xtcFrames; i++) {
+			if(qValues[i] != jobs->qValues[i]) {
+				cr_assert_fail("Q value of frame: %i is different.\n", i + 1);
+			}
+		}
+
+		cr_assert_eq(table->qValuesInRange[0], jobs->table->qValuesInRange[0]);
+		for(int i = 0; i < contacts; i++) {
+			if(table->contactInformation[i].totalOccurrences != jobs->table->contactInformation[i].totalOccurrences) {
+				cr_assert_fail("Occurrences incorrect at line: %i\n", i + 1);
+			}
+		}
+
+		freeAnalysisJobs(jobs);
+	}
+
+	freeOccupancyTable(table);
+	free(qValues);
+}
@@ -35,7 +35,7 @@ Test(averageContactProbabilityInQValueRange, Test_contactAverages) {
 	timeRange.high = 20;
 
 	struct ContactInformation *residueContactsInformation =
-			calculateContactProbability(frames, contacts, xtcCoords, "./files/contactFile",
+			calculateContactProbability(frames, xtcCoords, readContactSet("./files/contactFile"),
 					qRange, timeRange, qValues, cutOff);
 
 	struct ContactInformation *sortedContacts =
@@ -75,3 +75,42 @@ Test(averageContactProbabilityInQValueRange, Test_contactAverages) {
 
 	cr_assert(true);
 }
+
+Test(averageContactProbabilityInQValueRange, Test_calculateResidueGraphAverages) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcCoordinates** xtcCoords = getXtcFileCoordinates("./files/xtcFile", 163, frames);
+
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	int *qValues = calculateQValues(frames, contacts, 1.0f, xtcCoords, residueContacts);
+
+	struct QRange qRange;
+	qRange.low = 0;
+	qRange.high = 440;
+
+	struct TSRange timeRange;
+	timeRange.low = 1;
+	timeRange.high = 101;
+
+	struct ContactInformation *residueContactsInformation =
+			calculateContactProbability(frames, xtcCoords, readContactSet("./files/contactFile"),
+					qRange, timeRange, qValues, 1.0f);
+
+	struct ContactAverages* expectedContactAverages = calculateAverageContactProbability(163, contacts,
+			sortContacts(contacts, createContactInfoForSort(contacts, residueContactsInformation)));
+
+	struct ResidueGraph *residueGraph = createResidueGraph(163, contacts, residueContacts);
+	struct ContactAverages* actualContactAverages = calculateResidueGraphAverages(residueGraph, residueContactsInformation);
+
+	// The probabilities are added in the same order, so the averages are equal
+	for(int i = 0; i < 163; i++) {
+		cr_assert_eq(expectedContactAverages[i].focusResidue, actualContactAverages[i].focusResidue);
+
+		if(expectedContactAverages[i].averageProbability != actualContactAverages[i].averageProbability) {
+			cr_assert_fail("Average Probability incorrect at line: %i\n", i + 1);
+		}
+	}
+
+	freeResidueGraph(residueGraph);
+}
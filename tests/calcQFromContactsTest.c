@@ -66,6 +66,106 @@ Test(calcQFromContacts, Test_writeQFile, .fini = cleanUp) {
 	cr_assert(true);
 }
 
+Test(calcQFromContacts, Test_calculateQValuesFromStream) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcCoordinates** xtcCoords = getXtcFileCoordinates("./files/xtcFile", 163, frames);
+
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	int *qValuesExpected = calculateQValues(frames, contacts, 1.0f, xtcCoords, residueContacts);
+
+	int streamFrames;
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	int *qValuesActual = calculateQValuesFromStream(xtcStream, contacts, 1.0f, residueContacts, &streamFrames);
+	closeXtcStream(xtcStream);
+
+	cr_assert_eq(frames, streamFrames);
+	for(int i = 0; i < frames; i++) {
+		if(qValuesExpected[i] != qValuesActual[i]) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i+1);
+		}
+	}
+}
+
+Test(calcQFromContacts, Test_calculateQValuesFromStreamTimeRange) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	struct TSRange timeRange;
+	timeRange.low = 51;
+	timeRange.high = 101;
+
+	int streamFrames;
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	setXtcStreamTimeRange(xtcStream, timeRange);
+	setXtcStreamStride(xtcStream, 10);
+	int *qValues = calculateQValuesFromStream(xtcStream, contacts, 1.0f, residueContacts, &streamFrames);
+	closeXtcStream(xtcStream);
+
+	// Time slices 51, 61, ..., 101
+	cr_assert_eq(6, streamFrames);
+
+	FILE *file = fopen("./files/qFile", "r");
+	for(int i = 0; i < 101; i++) {
+		int expectedQValue;
+		fscanf(file, "%i", &expectedQValue);
+
+		if(i >= 50 && (i - 50) % 10 == 0 && expectedQValue != qValues[(i - 50) / 10]) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i+1);
+		}
+	}
+	fclose(file);
+}
+
+Test(calcQFromContacts, Test_calculateQValuesCutoffsFromStream) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	float cutoff[] = {0.8f, 1.0f, 1.5f};
+
+	int streamFrames;
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	int *qValues = calculateQValuesCutoffsFromStream(xtcStream, contacts, 3, cutoff, residueContacts, &streamFrames);
+	closeXtcStream(xtcStream);
+
+	for(int k = 0; k < 3; k++) {
+		int frames;
+		xtcStream = openXtcStream("./files/xtcFile", 163);
+		int *qValuesExpected = calculateQValuesFromStream(xtcStream, contacts, cutoff[k], residueContacts, &frames);
+		closeXtcStream(xtcStream);
+
+		cr_assert_eq(frames, streamFrames);
+		for(int i = 0; i < frames; i++) {
+			if(qValuesExpected[i] != qValues[i * 3 + k]) {
+				cr_assert_fail("Q value of frame: %i cutoff: %f is different.\n", i+1, cutoff[k]);
+			}
+		}
+
+		free(qValuesExpected);
+	}
+
+	free(qValues);
+}
+
+Test(calcQFromContacts, Test_calculateQValuesFromTrajectory) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcTrajectory* trajectory = getXtcFileTrajectory("./files/xtcFile", 163, frames);
+
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	int *qValuesActual = calculateQValuesFromTrajectory(trajectory, contacts, 1.0f, residueContacts);
+	int* qValuesExpected = getContentsOfFile("./files/qFile", frames);
+
+	for(int i = 0; i < frames; i++) {
+		if(qValuesExpected[i] != qValuesActual[i]) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i+1);
+		}
+	}
+
+	freeXtcTrajectory(trajectory);
+}
+
 int getLinesInFile(char* fileName) {
 	char line[20];
 	FILE *file;
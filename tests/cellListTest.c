@@ -0,0 +1,176 @@
+/*
+*	Name: cellListTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/cellList/cellList.h"
+
+// Tests every pair of the frame, the way the cell list is expected to
+void countAllPairs(int residues, struct XtcCoordinates *frame, float cutoff, int separation, struct PairMap *nativePairs, struct PairMap *frequency, int *nativeContacts, int *nonNativeContacts) {
+	*nativeContacts = 0, *nonNativeContacts = 0;
+
+	for(int i = 1; i <= residues; i++) {
+		for(int j = i + 1; j <= residues; j++) {
+			if(!(calculateDistance(frame[i-1], frame[j-1]) <= cutoff)) {
+				continue;
+			}
+
+			if(getPairMap(nativePairs, i, j)) {
+				(*nativeContacts)++;
+			} else if(j - i >= separation) {
+				(*nonNativeContacts)++;
+			} else {
+				continue;
+			}
+
+			addPairMap(frequency, i, j, 1);
+		}
+	}
+}
+
+void checkCellList(int residues, struct XtcCoordinates *frame, float cutoff, int contacts, struct Contact *residueContacts) {
+	struct PairMap *nativePairs = createNativePairMap(contacts, residueContacts);
+	struct PairMap *frequency = createPairMap(16);
+	struct PairMap *expectedFrequency = createPairMap(16);
+	struct CellList *cellList = createCellList(residues, cutoff, CELL_LIST_SEPARATION);
+	int nativeContacts, nonNativeContacts, expectedNative, expectedNonNative;
+
+	buildCellList(cellList, frame);
+	nativeContacts = countCellListContacts(cellList, frame, nativePairs, frequency, &nonNativeContacts);
+	countAllPairs(residues, frame, cutoff, CELL_LIST_SEPARATION, nativePairs, expectedFrequency, &expectedNative, &expectedNonNative);
+
+	cr_assert_eq(expectedNative, nativeContacts);
+	cr_assert_eq(expectedNonNative, nonNativeContacts);
+	cr_assert_eq(expectedFrequency->pairs, frequency->pairs);
+
+	struct PairCount *pairCounts = getSortedPairCounts(expectedFrequency);
+	for(int64_t p = 0; p < expectedFrequency->pairs; p++) {
+		if(getPairMap(frequency, pairCounts[p].focusResidue, pairCounts[p].contactResidue) != 1) {
+			cr_assert_fail("pair %i %i was not found\n", pairCounts[p].focusResidue, pairCounts[p].contactResidue);
+		}
+	}
+
+	free(pairCounts);
+	freeCellList(cellList);
+	freePairMap(expectedFrequency);
+	freePairMap(frequency);
+	freePairMap(nativePairs);
+}
+
+Test(cellList, Test_countCellListContacts) {
+	struct XtcCoordinates frame[400];
+	struct Contact residueContacts[300];
+
+	srand(3);
+	for(int i = 0; i < 400; i++) {
+		frame[i].x = rand() / (float) RAND_MAX * 6.0f;
+		frame[i].y = rand() / (float) RAND_MAX * 6.0f;
+		frame[i].z = rand() / (float) RAND_MAX * 6.0f;
+	}
+
+	for(int j = 0; j < 300; j++) {
+		residueContacts[j].focusResidue = 1 + rand() % 400;
+		residueContacts[j].contactResidue = 1 + rand() % 400;
+	}
+
+	checkCellList(400, frame, 0.8f, 300, residueContacts);
+	checkCellList(400, frame, 1.7f, 300, residueContacts);
+	checkCellList(400, frame, 10.0f, 300, residueContacts);
+}
+
+Test(cellList, Test_countCellListContactsSpread) {
+	struct XtcCoordinates frame[50];
+	struct Contact residueContacts[2] = {{1, 2}, {49, 50}};
+
+	// Far more cells than residues would be needed at the cutoff width
+	for(int i = 0; i < 50; i++) {
+		frame[i].x = (i % 2) * 0.5f + (i / 2) * 1000.0f;
+		frame[i].y = (i / 2) * -700.0f;
+		frame[i].z = 0.25f * i;
+	}
+	frame[10].x = NAN;
+
+	checkCellList(50, frame, 1.0f, 2, residueContacts);
+
+	struct CellList *cellList = createCellList(50, 1.0f, CELL_LIST_SEPARATION);
+	buildCellList(cellList, frame);
+	cr_assert(cellList->cells <= CELL_LIST_CELLS_PER_RESIDUE * 50);
+	freeCellList(cellList);
+}
+
+Test(cellList, Test_addPairMaps) {
+	struct PairMap *map = createPairMap(4);
+	struct PairMap *other = createPairMap(4);
+
+	for(int i = 1; i <= 1000; i++) {
+		addPairMap(map, i, i % 7 + 1, i);
+		addPairMap(other, i % 7 + 1, i, 1);
+	}
+
+	addPairMaps(map, other);
+
+	cr_assert_eq(1000, map->pairs);
+	cr_assert_eq(501, getPairMap(map, 500, 4));
+	cr_assert_eq(501, getPairMap(map, 4, 500));
+	cr_assert_eq(0, getPairMap(map, 500, 5));
+
+	// Sorted by focusResidue, then contactResidue, the lower residue first
+	struct PairCount *pairCounts = getSortedPairCounts(map);
+	for(int64_t p = 1; p < map->pairs; p++) {
+		cr_assert(pairCounts[p].focusResidue < pairCounts[p].contactResidue);
+		cr_assert(pairCounts[p-1].focusResidue < pairCounts[p].focusResidue ||
+			(pairCounts[p-1].focusResidue == pairCounts[p].focusResidue && pairCounts[p-1].contactResidue < pairCounts[p].contactResidue));
+	}
+
+	free(pairCounts);
+	freePairMap(other);
+	freePairMap(map);
+}
+
+Test(cellList, Test_calculateNonNativeContactsFromStream) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcCoordinates** xtcCoords = getXtcFileCoordinates("./files/xtcFile", 163, frames);
+
+	struct ContactSet *contactSet = readContactSet("./files/contactFile");
+	struct PairMap *nativePairs = createNativePairMap(contactSet->contacts, contactSet->residueContacts);
+	struct PairMap *expectedFrequency = createPairMap(16);
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	struct NonNativeContacts *nonNative = calculateNonNativeContactsFromStream(xtcStream, contactSet->contacts, contactSet->residueContacts, 1.0f, CELL_LIST_SEPARATION);
+	closeXtcStream(xtcStream);
+
+	cr_assert_eq(frames, nonNative->frames);
+	for(int i = 0; i < frames; i++) {
+		int expectedNative, expectedNonNative;
+
+		countAllPairs(163, xtcCoords[i], 1.0f, CELL_LIST_SEPARATION, nativePairs, expectedFrequency, &expectedNative, &expectedNonNative);
+
+		if(expectedNative != nonNative->nativeContacts[i] || expectedNonNative != nonNative->nonNativeContacts[i]) {
+			cr_assert_fail("contacts of frame: %i are different.\n", i+1);
+		}
+	}
+
+	cr_assert_eq(expectedFrequency->pairs, nonNative->frequency->pairs);
+
+	struct PairCount *pairCounts = getSortedPairCounts(expectedFrequency);
+	for(int64_t p = 0; p < expectedFrequency->pairs; p++) {
+		cr_assert_eq(pairCounts[p].count, getPairMap(nonNative->frequency, pairCounts[p].focusResidue, pairCounts[p].contactResidue));
+	}
+
+	free(pairCounts);
+	freeNonNativeContacts(nonNative);
+	freePairMap(expectedFrequency);
+	freePairMap(nativePairs);
+	freeContactSet(contactSet);
+	freeFrameArrayMemory(xtcCoords, frames);
+}
@@ -0,0 +1,232 @@
+/*
+*	Name: checkpointTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/occupancyTable/occupancyTable.h"
+#include "../software/headers/checkpoint/checkpoint.h"
+
+void removeCheckpointFile() {
+	remove("checkpointFile");
+}
+
+// Leaves the checkpoint file in place, as a run that was stopped would
+void stopCheckpoint(struct Checkpoint *checkpoint) {
+	free(checkpoint->checkpointFile);
+	free(checkpoint->data);
+	free(checkpoint);
+}
+
+Test(checkpoint, Test_calculateQValuesCheckpointed, .fini = removeCheckpointFile) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	float cutoff = 1.0f;
+	int frames, checkpointFrames;
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	int *qValues = calculateQValuesFromStream(xtcStream, contacts, cutoff, residueContacts, &frames);
+	closeXtcStream(xtcStream);
+
+	removeCheckpointFile();
+	struct Checkpoint *checkpoint = openCheckpoint("checkpointFile", 7, "./files/xtcFile", "./files/contactFile", "163 1.0");
+
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	int *checkpointQValues = calculateQValuesCheckpointed(checkpoint, xtcStream, contacts, 1, &cutoff, residueContacts, &checkpointFrames, 1);
+	closeXtcStream(xtcStream);
+
+	cr_assert_eq(frames, checkpointFrames);
+	cr_assert_eq(101, checkpoint->header.nextFrame);
+
+	for(int i = 0; i < frames; i++) {
+		if(qValues[i] != checkpointQValues[i]) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i+1);
+		}
+	}
+
+	// The checkpoint is removed once the results are written
+	finishCheckpoint(checkpoint);
+	cr_assert_null(fopen("checkpointFile", "rb"));
+
+	free(qValues);
+	free(checkpointQValues);
+}
+
+Test(checkpoint, Test_resumeQValuesCheckpoint, .fini = removeCheckpointFile) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	float cutoff[2] = {1.0f, 1.5f};
+	int frames, checkpointFrames;
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	setXtcStreamStride(xtcStream, 3);
+	int *qValues = calculateQValuesCutoffsFromStream(xtcStream, contacts, 2, cutoff, residueContacts, &frames);
+	closeXtcStream(xtcStream);
+
+	// The first run is stopped after frame 45
+	removeCheckpointFile();
+	struct Checkpoint *checkpoint = openCheckpoint("checkpointFile", 5, "./files/xtcFile", "./files/contactFile", "163 1.0,1.5 --stride 3");
+
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	setXtcStreamStride(xtcStream, 3);
+	xtcStream->lastFrame = 44;
+	free(calculateQValuesCheckpointed(checkpoint, xtcStream, contacts, 2, cutoff, residueContacts, &checkpointFrames, 1));
+	closeXtcStream(xtcStream);
+	stopCheckpoint(checkpoint);
+
+	cr_assert_eq(15, checkpointFrames);
+
+	// The second run continues with the frame after the checkpoint
+	checkpoint = openCheckpoint("checkpointFile", 5, "./files/xtcFile", "./files/contactFile", "163 1.0,1.5 --stride 3");
+	cr_assert_eq(45, checkpoint->header.nextFrame);
+	cr_assert_eq(15, checkpoint->header.frames);
+
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	setXtcStreamStride(xtcStream, 3);
+	int *checkpointQValues = calculateQValuesCheckpointed(checkpoint, xtcStream, contacts, 2, cutoff, residueContacts, &checkpointFrames, 3);
+	closeXtcStream(xtcStream);
+
+	cr_assert_eq(frames, checkpointFrames);
+
+	for(int i = 0; i < frames * 2; i++) {
+		if(qValues[i] != checkpointQValues[i]) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i/2 + 1);
+		}
+	}
+
+	finishCheckpoint(checkpoint);
+	free(qValues);
+	free(checkpointQValues);
+}
+
+Test(checkpoint, Test_appendQValuesCheckpoint, .fini = removeCheckpointFile) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	float cutoff = 1.0f;
+	int frames, checkpointFrames;
+	int garbage[3] = {-1, -1, -1};
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	int *qValues = calculateQValuesFromStream(xtcStream, contacts, cutoff, residueContacts, &frames);
+	closeXtcStream(xtcStream);
+
+	removeCheckpointFile();
+	struct Checkpoint *checkpoint = openCheckpoint("checkpointFile", 4, "./files/xtcFile", "./files/contactFile", "163 1.0");
+
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	xtcStream->lastFrame = 19;
+	free(calculateQValuesCheckpointed(checkpoint, xtcStream, contacts, 1, &cutoff, residueContacts, &checkpointFrames, 1));
+	closeXtcStream(xtcStream);
+	stopCheckpoint(checkpoint);
+
+	// Every block was appended, so the file holds the header and 20 Q values
+	FILE *fp = fopen("checkpointFile", "ab");
+	cr_assert_eq(sizeof(struct CheckpointHeader) + 20 * sizeof(int), ftell(fp));
+
+	// A run stopped while appending leaves Q values the header does not count
+	fwrite(garbage, sizeof(int), 3, fp);
+	fclose(fp);
+
+	checkpoint = openCheckpoint("checkpointFile", 4, "./files/xtcFile", "./files/contactFile", "163 1.0");
+	cr_assert_eq(20, checkpoint->header.nextFrame);
+
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	xtcStream->lastFrame = 59;
+	free(calculateQValuesCheckpointed(checkpoint, xtcStream, contacts, 1, &cutoff, residueContacts, &checkpointFrames, 1));
+	closeXtcStream(xtcStream);
+	stopCheckpoint(checkpoint);
+
+	// The next block is written over them
+	checkpoint = openCheckpoint("checkpointFile", 4, "./files/xtcFile", "./files/contactFile", "163 1.0");
+	cr_assert_eq(60, checkpoint->header.frames);
+
+	for(int i = 0; i < 60; i++) {
+		if(qValues[i] != ((int*) checkpoint->data)[i]) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i+1);
+		}
+	}
+
+	finishCheckpoint(checkpoint);
+	free(qValues);
+}
+
+Test(checkpoint, Test_openCheckpointSettings, .fini = removeCheckpointFile) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	float cutoff = 1.0f;
+	int frames;
+
+	removeCheckpointFile();
+	struct Checkpoint *checkpoint = openCheckpoint("checkpointFile", 10, "./files/xtcFile", "./files/contactFile", "163 1.0");
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	xtcStream->lastFrame = 29;
+	free(calculateQValuesCheckpointed(checkpoint, xtcStream, contacts, 1, &cutoff, residueContacts, &frames, 1));
+	closeXtcStream(xtcStream);
+	stopCheckpoint(checkpoint);
+
+	// A checkpoint made with other settings is not used
+	checkpoint = openCheckpoint("checkpointFile", 10, "./files/xtcFile", "./files/contactFile", "163 1.5");
+	cr_assert_eq(0, checkpoint->header.nextFrame);
+	cr_assert_eq(0, checkpoint->header.frames);
+	cr_assert_eq(0, checkpoint->header.bytes);
+	stopCheckpoint(checkpoint);
+
+	checkpoint = openCheckpoint("checkpointFile", 10, "./files/xtcFile", "./files/contactFile", "163 1.0");
+	cr_assert_eq(30, checkpoint->header.nextFrame);
+	cr_assert_eq(30, checkpoint->header.frames);
+	finishCheckpoint(checkpoint);
+}
+
+Test(checkpoint, Test_calculateOccupancyTableCheckpointed, .fini = removeCheckpointFile) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	int qBin[4] = {0, 350, 351, 1000};
+	int timeWindow[4] = {1, 40, 30, 90};
+	int windows;
+	struct OccupancyWindow *window = createOccupancyWindows(2, qBin, 2, timeWindow, &windows);
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	struct OccupancyTable *table = calculateOccupancyTableFromStream(xtcStream, contacts, residueContacts, windows, window, 1.0f);
+	closeXtcStream(xtcStream);
+
+	// The first run is stopped after the last checkpoint, before the table is written
+	removeCheckpointFile();
+	struct Checkpoint *checkpoint = openCheckpoint("checkpointFile", 8, "./files/xtcFile", "./files/contactFile", "163 1.0 --q 0:350,351:1000 --ts 1:40,30:90");
+
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	freeOccupancyTable(calculateOccupancyTableCheckpointed(checkpoint, xtcStream, contacts, residueContacts, windows, window, 1.0f, 1));
+	closeXtcStream(xtcStream);
+	stopCheckpoint(checkpoint);
+
+	// The counts are taken from the checkpoint without reading a frame
+	checkpoint = openCheckpoint("checkpointFile", 8, "./files/xtcFile", "./files/contactFile", "163 1.0 --q 0:350,351:1000 --ts 1:40,30:90");
+	cr_assert_eq(90, checkpoint->header.nextFrame);
+
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	struct OccupancyTable *checkpointTable = calculateOccupancyTableCheckpointed(checkpoint, xtcStream, contacts, residueContacts, windows, window, 1.0f, 2);
+	closeXtcStream(xtcStream);
+
+	for(int w = 0; w < windows; w++) {
+		cr_assert_eq(table->qValuesInRange[w], checkpointTable->qValuesInRange[w]);
+	}
+
+	for(int i = 0; i < windows * contacts; i++) {
+		if(table->contactInformation[i].totalOccurrences != checkpointTable->contactInformation[i].totalOccurrences ||
+		   table->contactInformation[i].probability != checkpointTable->contactInformation[i].probability) {
+			cr_assert_fail("Contact %i of window %i is different.\n", i % contacts + 1, i / contacts + 1);
+		}
+	}
+
+	finishCheckpoint(checkpoint);
+	freeOccupancyTable(table);
+	freeOccupancyTable(checkpointTable);
+}
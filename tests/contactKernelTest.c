@@ -0,0 +1,180 @@
+/*
+*	Name: contactKernelTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/contactKernel/contactKernel.h"
+
+char *kernels[] = {"scalar", "sse2", "avx2", "avx512"};
+
+Test(contactKernel, Test_calculateCutoffThreshold) {
+	float cutoff = 1.0f;
+	double threshold = calculateCutoffThreshold(cutoff);
+
+	cr_assert((float) sqrt(threshold) <= cutoff);
+	cr_assert((float) sqrt(nextafter(threshold, 2.0)) > cutoff);
+	cr_assert_eq(-1.0, calculateCutoffThreshold(-1.0f));
+}
+
+Test(contactKernel, Test_calculateContactKernelNearCutoff) {
+	int residues = 101;
+	struct XtcCoordinates frame[101];
+	struct Contact residueContacts[100];
+	float cutoff = 1.2f;
+
+	// Residue 1 at the origin, every other residue a few float steps either side of the cutoff
+	frame[0].x = 0.0f, frame[0].y = 0.0f, frame[0].z = 0.0f;
+	for(int i = 1; i < residues; i++) {
+		float distance = cutoff;
+		for(int step = 0; step < abs(i - 50); step++) {
+			distance = i < 50 ? nextafterf(distance, 0.0f) : nextafterf(distance, 2.0f);
+		}
+
+		frame[i].x = distance * 0.6f;
+		frame[i].y = distance * 0.8f;
+		frame[i].z = (i % 3) * 0.0001f;
+
+		residueContacts[i-1].focusResidue = 1;
+		residueContacts[i-1].contactResidue = i + 1;
+	}
+
+	for(int k = 0; k < 4; k++) {
+		if(!setContactKernel(kernels[k])) {
+			continue;
+		}
+
+		uint64_t contactStates[2] = {0, 0};
+		int qValue = calculateContactKernel(&frame[0].x, &frame[0].y, &frame[0].z, 3, 100, residueContacts, cutoff, contactStates);
+		int expectedQValue = 0;
+
+		for(int j = 0; j < 100; j++) {
+			int expected = calculateDistance(frame[0], frame[j+1]) <= cutoff;
+			int actual = (contactStates[j / 64] >> (j % 64)) & 1;
+
+			if(expected != actual) {
+				cr_assert_fail("%s kernel differs at contact: %i\n", kernels[k], j + 1);
+			}
+			expectedQValue += expected;
+		}
+
+		cr_assert_eq(expectedQValue, qValue);
+	}
+
+	setContactKernel("scalar");
+}
+
+Test(contactKernel, Test_calculateContactKernelFrames) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcCoordinates** xtcCoords = getXtcFileCoordinates("./files/xtcFile", 163, frames);
+
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	FILE *file = fopen("./files/qFile", "r");
+	for(int i = 0; i < frames; i++) {
+		int expectedQValue;
+		fscanf(file, "%i", &expectedQValue);
+
+		for(int k = 0; k < 4; k++) {
+			if(setContactKernel(kernels[k]) &&
+			   expectedQValue != calculateFrameQValue(contacts, 1.0f, xtcCoords[i], residueContacts)) {
+				cr_assert_fail("%s kernel Q value of frame: %i is different.\n", kernels[k], i+1);
+			}
+		}
+	}
+	fclose(file);
+
+	setContactKernel("scalar");
+}
+
+Test(contactKernel, Test_calculateContactKernelThresholds) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcCoordinates** xtcCoords = getXtcFileCoordinates("./files/xtcFile", 163, frames);
+
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	float cutoff[] = {0.6f, 1.0f, 1.2f, 2.5f};
+	double *threshold = calculateCutoffThresholds(4, cutoff);
+
+	for(int i = 0; i < frames; i++) {
+		for(int k = 0; k < 4; k++) {
+			int qValues[4];
+
+			if(!setContactKernel(kernels[k])) {
+				continue;
+			}
+
+			calculateFrameQValueCutoffs(contacts, 4, threshold, xtcCoords[i], residueContacts, qValues);
+
+			for(int c = 0; c < 4; c++) {
+				if(qValues[c] != calculateFrameQValue(contacts, cutoff[c], xtcCoords[i], residueContacts)) {
+					cr_assert_fail("%s kernel Q value of frame: %i cutoff: %f is different.\n", kernels[k], i+1, cutoff[c]);
+				}
+			}
+		}
+	}
+
+	free(threshold);
+	setContactKernel("scalar");
+}
+
+Test(contactKernel, Test_calculateApproximateExp) {
+	for(float x = -80.0f; x <= 80.0f; x += 0.037f) {
+		double expected = exp((double) x);
+
+		if(fabs(calculateApproximateExp(x) - expected) > 4e-7 * expected) {
+			cr_assert_fail("exp(%f) is not accurate\n", x);
+		}
+	}
+
+	// Limited so the result is never infinite or zero
+	cr_assert(isfinite(calculateApproximateExp(1000.0f)));
+	cr_assert(calculateApproximateExp(-1000.0f) > 0.0f);
+}
+
+Test(contactKernel, Test_calculateContactKernelSmooth) {
+	struct XtcCoordinates frame[40];
+	struct Contact residueContacts[203];
+	float switchDistance[203];
+	double expectedSum = 0.0;
+
+	srand(7);
+	for(int i = 0; i < 40; i++) {
+		frame[i].x = rand() / (float) RAND_MAX * 4.0f;
+		frame[i].y = rand() / (float) RAND_MAX * 4.0f;
+		frame[i].z = rand() / (float) RAND_MAX * 4.0f;
+	}
+
+	for(int j = 0; j < 203; j++) {
+		residueContacts[j].focusResidue = 1 + rand() % 40;
+		residueContacts[j].contactResidue = 1 + rand() % 40;
+		switchDistance[j] = rand() / (float) RAND_MAX * 3.0f;
+
+		double distance = calculateDistance(frame[residueContacts[j].focusResidue-1], frame[residueContacts[j].contactResidue-1]);
+		expectedSum += 1.0 / (1.0 + exp(50.0 * (distance - switchDistance[j])));
+	}
+
+	setContactKernel("scalar");
+	double scalarSum = calculateContactKernelSmooth(&frame[0].x, &frame[0].y, &frame[0].z, 3, 203, residueContacts, switchDistance, 50.0f);
+	cr_assert(fabs(scalarSum - expectedSum) < 1e-4);
+
+	// Every version adds the same terms in the same order
+	for(int k = 0; k < 4; k++) {
+		if(setContactKernel(kernels[k])) {
+			cr_assert_eq(scalarSum, calculateContactKernelSmooth(&frame[0].x, &frame[0].y, &frame[0].z, 3, 203, residueContacts, switchDistance, 50.0f));
+		}
+	}
+
+	setContactKernel("scalar");
+}
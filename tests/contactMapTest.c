@@ -0,0 +1,85 @@
+/*
+*	Name: contactMapTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/contactState/contactState.h"
+#include "../software/headers/probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+#include "../software/headers/contactMap/contactMap.h"
+
+void cleanUp() {
+	remove("contactMap");
+}
+
+Test(contactMap, Test_buildContactMap, .fini = cleanUp) {
+	int frames = buildContactMap("./files/xtcFile", "./files/contactFile", 163, 1.0f, "contactMap");
+
+	cr_assert_eq(101, frames);
+
+	struct ContactMap *contactMap = openContactMap("contactMap");
+
+	cr_assert_eq(101, contactMap->header->frames);
+	cr_assert_eq(440, contactMap->header->contacts);
+	cr_assert_eq(163, contactMap->header->residues);
+	cr_assert_eq(3, contactMap->residueContacts[0].focusResidue);
+	cr_assert_eq(105, contactMap->residueContacts[0].contactResidue);
+
+	cr_assert_eq(1, checkContactMap(contactMap, "./files/xtcFile", "./files/contactFile", 1.0f));
+	cr_assert_eq(0, checkContactMap(contactMap, NULL, NULL, 1.2f));
+
+	FILE *file = fopen("./files/qFile", "r");
+	for(int i = 0; i < contactMap->header->frames; i++) {
+		int expectedQValue;
+		fscanf(file, "%i", &expectedQValue);
+
+		if(expectedQValue != countContactStates(440, &contactMap->contactStates[i * contactMap->header->words])) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i+1);
+		}
+	}
+	fclose(file);
+
+	closeContactMap(contactMap);
+}
+
+Test(contactMap, Test_calculateContactProbabilityFromContactMap, .fini = cleanUp) {
+	buildContactMap("./files/xtcFile", "./files/contactFile", 163, 1.0f, "contactMap");
+	struct ContactMap *contactMap = openContactMap("contactMap");
+
+	struct QRange qRange;
+	qRange.low = 300;
+	qRange.high = 400;
+
+	struct TSRange timeRange;
+	timeRange.low = 0;
+	timeRange.high = 20;
+
+	struct ContactInformation *residueContactsInformation =
+			calculateContactProbabilityFromContactStates(contactMap->header->frames, contactMap->header->contacts,
+					contactMap->contactStates, contactMap->residueContacts, qRange, timeRange);
+
+	FILE *file = fopen("./files/contactInformation", "r");
+	for(int i = 0; i < contactMap->header->contacts; i++) {
+		int tmp, focusResidue, contactResidue, totalOccurrences;
+		float probability;
+		fscanf(file, "%i %i %i %f %i", &tmp, &focusResidue, &contactResidue, &probability, &totalOccurrences);
+
+		if(probability != residueContactsInformation[i].probability) {
+			cr_assert_fail("Probability incorrect at line: %i\n", i + 1);
+		}
+		if(totalOccurrences != residueContactsInformation[i].totalOccurrences) {
+			cr_assert_fail("Total occurrences incorrect at line: %i\n", i + 1);
+		}
+	}
+	fclose(file);
+
+	closeContactMap(contactMap);
+}
@@ -27,3 +27,32 @@ Test(contactReader, Test_getContactFileContacts) {
 	cr_assert_eq(94, residueContacts[350].focusResidue);
 	cr_assert_eq(98, residueContacts[350].contactResidue);
 }
+
+Test(contactReader, Test_readContactSet) {
+	struct ContactSet* contactSet = readContactSet("./files/contactFile");
+	int contacts, iTemp, focusResidue, contactResidue;
+
+	FILE *file = fopen("./files/contactFile", "r");
+	fscanf(file, "%i %i", &contacts, &iTemp);
+
+	cr_assert_eq(contacts, contactSet->contacts);
+	for(int i = 0; i < contacts; i++) {
+		fscanf(file, "%i %i %i %i", &iTemp, &focusResidue, &iTemp, &contactResidue);
+
+		if(contactSet->residueContacts[i].focusResidue != focusResidue ||
+		   contactSet->residueContacts[i].contactResidue != contactResidue) {
+			cr_assert_fail("Contact incorrect at line: %i\n", i + 2);
+		}
+	}
+	fclose(file);
+
+	freeContactSet(contactSet);
+}
+
+Test(contactReader, Test_checkContactSetResidues, .exit_code = 1) {
+	struct ContactSet* contactSet = readContactSet("./files/contactFile");
+
+	// The largest residue in the contact file is 163
+	checkContactSetResidues(contactSet, 163);
+	checkContactSetResidues(contactSet, 100);
+}
@@ -0,0 +1,50 @@
+/*
+*	Name: contactStateTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/contactState/contactState.h"
+
+Test(contactState, Test_getContactStateWords) {
+	cr_assert_eq(0, getContactStateWords(0));
+	cr_assert_eq(1, getContactStateWords(64));
+	cr_assert_eq(2, getContactStateWords(65));
+	cr_assert_eq(7, getContactStateWords(440));
+}
+
+Test(contactState, Test_calculateQValuesFromContactStates) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcCoordinates** xtcCoords = getXtcFileCoordinates("./files/xtcFile", 163, frames);
+
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	int *qValuesExpected = calculateQValues(frames, contacts, 1.0f, xtcCoords, residueContacts);
+
+	uint64_t *contactStates = calculateTrajectoryContactStates(frames, contacts, 1.0f, xtcCoords, residueContacts);
+	int *qValuesActual = calculateQValuesFromContactStates(frames, contacts, contactStates);
+
+	for(int i = 0; i < frames; i++) {
+		if(qValuesExpected[i] != qValuesActual[i]) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i+1);
+		}
+	}
+
+	// The bit of a contact matches the distance check of calculateQValues()
+	int words = getContactStateWords(contacts);
+	for(int j = 0; j < contacts; j++) {
+		int present = calculateDistance(xtcCoords[0][residueContacts[j].focusResidue-1],
+				xtcCoords[0][residueContacts[j].contactResidue-1]) <= 1.0f;
+
+		cr_assert_eq(present, getContactState(&contactStates[0 * words], j));
+	}
+}
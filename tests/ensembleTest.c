@@ -0,0 +1,72 @@
+/*
+*	Name: ensembleTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/occupancyTable/occupancyTable.h"
+#include "../software/headers/ensemble/ensemble.h"
+
+Test(ensemble, Test_expandXtcFiles) {
+	// Matches xtcFile but not the xtcFile.idx written next to it by other tests
+	char *pattern[] = {"./files/xtcF?le", "./files/missing.xtc"};
+	int xtcFiles;
+
+	char **xtcFile = expandXtcFiles(2, pattern, &xtcFiles);
+
+	cr_assert_eq(2, xtcFiles);
+	cr_assert(strcmp(xtcFile[0], "./files/xtcFile") == 0);
+	cr_assert(strcmp(xtcFile[1], "./files/missing.xtc") == 0);
+}
+
+Test(ensemble, Test_calculateEnsembleOccupancy) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	char *pattern[] = {"./files/xtcF?le", "./files/xtcF?le", "./files/xtcF?le"};
+	int xtcFiles;
+
+	// Freed with the ensemble
+	char **xtcFile = expandXtcFiles(3, pattern, &xtcFiles);
+
+	int qBin[] = {300, 400};
+	int timeWindow[] = {0, 20, 21, 101};
+	int windows;
+
+	struct OccupancyWindow *window = createOccupancyWindows(1, qBin, 2, timeWindow, &windows);
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	struct OccupancyTable *expected = calculateOccupancyTableFromStream(xtcStream, contacts, residueContacts, windows, window, 1.0f);
+	closeXtcStream(xtcStream);
+
+	struct Ensemble *ensemble = calculateEnsembleOccupancy(3, xtcFile, 163, contacts, residueContacts, windows, window, 1.0f, 1, 4);
+
+	// Three copies of one trajectory triple the counts and keep the probabilities
+	for(int w = 0; w < windows; w++) {
+		cr_assert_eq(3 * expected->qValuesInRange[w], ensemble->table->qValuesInRange[w]);
+
+		for(int i = 0; i < contacts; i++) {
+			struct ContactInformation *actual = &ensemble->table->contactInformation[w * contacts + i];
+
+			if(actual->totalOccurrences != 3 * expected->contactInformation[w * contacts + i].totalOccurrences ||
+			   actual->probability != expected->contactInformation[w * contacts + i].probability) {
+				cr_assert_fail("Window: %i contact: %i is different.\n", w + 1, i + 1);
+			}
+		}
+
+		for(int r = 0; r < 3; r++) {
+			cr_assert_eq(expected->qValuesInRange[w], ensemble->replicaTable[r]->qValuesInRange[w]);
+		}
+	}
+
+	freeEnsemble(ensemble);
+	freeOccupancyTable(expected);
+	free(window);
+}
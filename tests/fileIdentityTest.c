@@ -0,0 +1,55 @@
+/*
+*	Name: fileIdentityTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "../software/headers/fileIdentity/fileIdentity.h"
+
+Test(fileIdentity, Test_hashBytes) {
+	// Published FNV-1a 64-bit test vectors
+	cr_assert_eq(0xcbf29ce484222325ULL, hashBytes(FILE_IDENTITY_HASH_SEED, "", 0));
+	cr_assert_eq(0xaf63dc4c8601ec8cULL, hashBytes(FILE_IDENTITY_HASH_SEED, "a", 1));
+}
+
+Test(fileIdentity, Test_getFileIdentity) {
+	struct FileIdentity identity1 = getFileIdentity("./files/contactFile", 1);
+	struct FileIdentity identity2 = getFileIdentity("./files/contactFile", 1);
+	struct FileIdentity identity3 = getFileIdentity("./files/qFile", 1);
+
+	cr_assert_eq(1, compareFileIdentity(identity1, identity2));
+	cr_assert_eq(0, compareFileIdentity(identity1, identity3));
+	cr_assert_neq(identity1.hash, identity3.hash);
+}
+
+Test(fileIdentity, Test_getFileIdentityNanoseconds) {
+	FILE *fp = fopen("identityFile", "w");
+	fprintf(fp, "1 2\n");
+	fclose(fp);
+
+	// Rewritten within the same second to the same size and hash
+	utimensat(AT_FDCWD, "identityFile", (struct timespec[]) {{100, 5}, {100, 5}}, 0);
+	struct FileIdentity identity1 = getFileIdentity("identityFile", 1);
+	utimensat(AT_FDCWD, "identityFile", (struct timespec[]) {{100, 6}, {100, 6}}, 0);
+	struct FileIdentity identity2 = getFileIdentity("identityFile", 1);
+
+	remove("identityFile");
+
+	cr_assert_eq(identity1.modified, identity2.modified);
+	cr_assert_eq(0, compareFileIdentity(identity1, identity2));
+}
+
+Test(fileIdentity, Test_hashFileSample) {
+	// A file shorter than both samples is hashed whole
+	cr_assert_eq(hashFileContents("./files/xtcFile"), hashFileSample("./files/xtcFile", 1 << 30));
+
+	// Only the ends are hashed, so the sample changes the hash
+	cr_assert_neq(hashFileContents("./files/xtcFile"), hashFileSample("./files/xtcFile", 4096));
+	cr_assert_eq(hashFileSample("./files/xtcFile", 4096), hashFileSample("./files/xtcFile", 4096));
+}
@@ -0,0 +1,105 @@
+/*
+*	Name: followQTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/followQ/followQ.h"
+
+// Copies bytes start to end-1 of the trajectory, or to its end, to the end of a file
+void appendXtcBytes(char *file, int64_t start, int64_t end) {
+	FILE *in = fopen("./files/xtcFile", "rb");
+	FILE *out = fopen(file, "ab");
+	char buffer[4096];
+
+	fseek(in, start, SEEK_SET);
+	while(start < end) {
+		size_t n = fread(buffer, 1, end - start < 4096 ? end - start : 4096, in);
+		if(n == 0) {
+			break;
+		}
+		fwrite(buffer, 1, n, out);
+		start += n;
+	}
+
+	fclose(out);
+	fclose(in);
+}
+
+void removeFollowedFiles() {
+	remove("followedXtcFile");
+	remove("followedXtcFile.idx");
+	remove("followedQFile");
+}
+
+Test(followQ, Test_countQFileFrames, .fini = removeFollowedFiles) {
+	FILE *file = fopen("followedQFile", "w");
+	fprintf(file, "12\n7\n10");
+	fclose(file);
+
+	cr_assert_eq(2, countQFileFrames("followedQFile"));
+
+	// The partial last line is removed
+	file = fopen("followedQFile", "r");
+	fseek(file, 0, SEEK_END);
+	cr_assert_eq(5, ftell(file));
+	fclose(file);
+
+	cr_assert_eq(0, countQFileFrames("missingQFile"));
+}
+
+Test(followQ, Test_followQValues, .fini = removeFollowedFiles) {
+	struct XtcFrameIndex* index = getXtcFrameIndex("./files/xtcFile");
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	float cutoff = 1.0f;
+	struct XtcStream* xtcStream;
+
+	// Five frames and half of the sixth are written so far
+	removeFollowedFiles();
+	appendXtcBytes("followedXtcFile", 0, (index->offsets[5] + index->offsets[6]) / 2);
+
+	xtcStream = openXtcStream("followedXtcFile", 163);
+	cr_assert_eq(5, followQValues(xtcStream, contacts, 1, &cutoff, residueContacts, NULL, "followedQFile", 0.01f, 0.05f));
+	closeXtcStream(xtcStream);
+
+	// A line cut short when the first run was stopped
+	FILE *file = fopen("followedQFile", "a");
+	fprintf(file, "4");
+	fclose(file);
+
+	// Following again continues after the frames in the qFile
+	appendXtcBytes("followedXtcFile", (index->offsets[5] + index->offsets[6]) / 2, INT64_MAX);
+
+	xtcStream = openXtcStream("followedXtcFile", 163);
+	cr_assert_eq(101, followQValues(xtcStream, contacts, 1, &cutoff, residueContacts, NULL, "followedQFile", 0.01f, 0.05f));
+	closeXtcStream(xtcStream);
+
+	int frames;
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	int *qValues = calculateQValuesFromStream(xtcStream, contacts, cutoff, residueContacts, &frames);
+	closeXtcStream(xtcStream);
+
+	file = fopen("followedQFile", "r");
+	for(int i = 0; i < frames; i++) {
+		int qValue;
+		cr_assert_eq(1, fscanf(file, "%i", &qValue));
+
+		if(qValue != qValues[i]) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i+1);
+		}
+	}
+	fclose(file);
+
+	free(qValues);
+	freeXtcFrameIndex(index);
+}
@@ -0,0 +1,123 @@
+/*
+*	Name: mdLogTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../software/headers/mdLog/mdLog.h"
+
+void cleanUp() {
+	remove("mdLog");
+}
+
+// An energy block as Gromacs 4.6 writes it, LJ (SR) and Potential set from the step
+void writeEnergyBlock(FILE *fp, int step, double offset) {
+	fprintf(fp, "%15s%15s%15s\n%15d%15.5f%15.5f\n\n", "Step", "Time", "Lambda", step, step * 0.002, 0.0);
+	fprintf(fp, "   Energies (kJ/mol)\n");
+	fprintf(fp, "%15s%15s%15s%15s%15s\n", "Angle", "Proper Dih.", "Improper Dih.", "LJ-14", "LJ (SR)");
+	fprintf(fp, "%15.5e%15.5e%15.5e%15.5e%15.5e\n", 10.0, 20.0, 3.0, -4.0, -500.0 - step - offset);
+	fprintf(fp, "%15s%15s%15s%15s%15s\n", "Potential", "Kinetic En.", "Total Energy", "Temperature", "Pressure (bar)");
+	fprintf(fp, "%15.5e%15.5e%15.5e%15.5e%15.5e\n\n", -471.0 - step - offset, 150.0, -321.0, 130.0, 0.0);
+}
+
+// Steps 0 to 300, step 200 written again by a restart, then the averages
+void writeMdLog() {
+	FILE *fp = fopen("mdLog", "w");
+
+	fprintf(fp, "Log file opened on Sat Oct 17 2026\nStep 0, time 0 (ps)  LINCS WARNING\n\n");
+	writeEnergyBlock(fp, 0, 0);
+	writeEnergyBlock(fp, 100, 0);
+	writeEnergyBlock(fp, 200, 0);
+	fprintf(fp, "Started mdrun on node 0\n\n");
+	writeEnergyBlock(fp, 200, 0.5);
+	writeEnergyBlock(fp, 300, 0);
+	fprintf(fp, "\t<======  ###############  ==>\n\t<====  A V E R A G E S  ====>\n\t<==  ###############  ======>\n\n");
+	writeEnergyBlock(fp, 300, 1000);
+	fclose(fp);
+}
+
+Test(mdLog, Test_parseEnergyLabels) {
+	int labels;
+	char **label = parseEnergyLabels("Potential, LJ (SR)", &labels);
+
+	cr_assert_eq(2, labels);
+	cr_assert(strcmp(label[0], "Potential") == 0);
+	cr_assert(strcmp(label[1], "LJ (SR)") == 0);
+
+	free(label[0]);
+	free(label[1]);
+	free(label);
+}
+
+Test(mdLog, Test_readMdLogEnergies, .fini = cleanUp) {
+	int labels;
+	char **label = parseEnergyLabels("LJ (SR),Potential", &labels);
+
+	writeMdLog();
+	struct MdLogEnergies *energies = readMdLogEnergies("mdLog", labels, label);
+
+	cr_assert_eq(4, energies->frames);
+	for(int i = 0; i < 4; i++) {
+		cr_assert_eq(i * 100, energies->step[i]);
+		cr_assert(fabs(energies->time[i] - i * 0.2) < 1e-9);
+	}
+
+	cr_assert(energies->energy[1 * 2 + 0] == -600.0);
+	cr_assert(energies->energy[1 * 2 + 1] == -571.0);
+
+	// The energies written last of a repeated step, none of the averages
+	cr_assert(energies->energy[2 * 2 + 1] == -671.5);
+	cr_assert(energies->energy[3 * 2 + 1] == -771.0);
+
+	cr_assert_eq(1, findMdLogStep(energies, 100));
+	cr_assert_eq(3, findMdLogStep(energies, 300));
+	cr_assert_eq(-1, findMdLogStep(energies, 150));
+	cr_assert_eq(-1, findMdLogStep(energies, 400));
+
+	freeMdLogEnergies(energies);
+}
+
+Test(mdLog, Test_writeEnergyTable, .fini = cleanUp) {
+	int labels, steps[] = {0, 150, 300};
+	float times[] = {0.0f, 0.3f, 0.6f};
+	double qValue[] = {12, 7, 3};
+	char **label = parseEnergyLabels("Potential", &labels);
+	struct XtcFrameIndex index = {3, 0, NULL, steps, times};
+	char row[256];
+
+	writeMdLog();
+	struct MdLogEnergies *energies = readMdLogEnergies("mdLog", labels, label);
+
+	FILE *fp = tmpfile();
+	cr_assert_eq(1, writeEnergyTable(fp, energies, &index, 3, qValue, 0, 1));
+	rewind(fp);
+
+	cr_assert(fgets(row, sizeof(row), fp) != NULL);
+	cr_assert(strcmp(row, "# frame step time Q \"Potential\"\n") == 0);
+	cr_assert(fgets(row, sizeof(row), fp) != NULL);
+	cr_assert(strcmp(row, "1 0 0 12 -4.71000e+02\n") == 0);
+	cr_assert(fgets(row, sizeof(row), fp) != NULL);
+	cr_assert(strcmp(row, "2 150 0.3 7 N/A\n") == 0);
+	cr_assert(fgets(row, sizeof(row), fp) != NULL);
+	cr_assert(strcmp(row, "3 300 0.6 3 -7.71000e+02\n") == 0);
+	fclose(fp);
+
+	freeMdLogEnergies(energies);
+}
+
+Test(mdLog, Test_isMdLogFile, .fini = cleanUp) {
+	writeMdLog();
+	cr_assert(isMdLogFile("mdLog"));
+
+	FILE *fp = fopen("mdLog", "w");
+	fprintf(fp, "\n# frame step time \"Potential\"\n1 0 0 -1.00000e+02\n");
+	fclose(fp);
+	cr_assert(!isMdLogFile("mdLog"));
+}
@@ -0,0 +1,126 @@
+/*
+*	Name: occupancyTableTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+#include "../software/headers/occupancyTable/occupancyTable.h"
+
+Test(occupancyTable, Test_createOccupancyWindows) {
+	int qBin[] = {0, 100, 101, 200, 201, 300};
+	int timeWindow[] = {1, 50, 51, 101};
+	int windows;
+
+	struct OccupancyWindow *window = createOccupancyWindows(3, qBin, 2, timeWindow, &windows);
+
+	cr_assert_eq(6, windows);
+	cr_assert_eq(101, window[4].qRange.low);
+	cr_assert_eq(200, window[4].qRange.high);
+	cr_assert_eq(51, window[4].timeRange.low);
+	cr_assert_eq(101, window[4].timeRange.high);
+
+	struct TSRange timeRange = getOccupancyTimeRange(windows, window);
+	cr_assert_eq(1, timeRange.low);
+	cr_assert_eq(101, timeRange.high);
+
+	free(window);
+}
+
+Test(occupancyTable, Test_calculateOccupancyTableFromStream) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	int qBin[] = {300, 400, 0, 440};
+	int timeWindow[] = {0, 20, 21, 101};
+	int windows;
+
+	struct OccupancyWindow *window = createOccupancyWindows(2, qBin, 2, timeWindow, &windows);
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	struct OccupancyTable *table = calculateOccupancyTableFromStream(xtcStream, contacts, residueContacts, windows, window, 1.0f);
+	closeXtcStream(xtcStream);
+
+	// The first window is the range used for ./files/contactInformation
+	FILE *file = fopen("./files/contactInformation", "r");
+	for(int i = 0; i < contacts; i++) {
+		int tmp, focusResidue, contactResidue, totalOccurrences;
+		float probability;
+		fscanf(file, "%i %i %i %f %i", &tmp, &focusResidue, &contactResidue, &probability, &totalOccurrences);
+
+		if(probability != table->contactInformation[i].probability) {
+			cr_assert_fail("Probability incorrect at line: %i\n", i + 1);
+		}
+		if(totalOccurrences != table->contactInformation[i].totalOccurrences) {
+			cr_assert_fail("Total occurrences incorrect at line: %i\n", i + 1);
+		}
+	}
+	fclose(file);
+
+	// Every window matches a separate run over the trajectory
+	for(int w = 0; w < windows; w++) {
+		xtcStream = openXtcStream("./files/xtcFile", 163);
+		struct ContactInformation *expected = calculateContactProbabilityFromStream(xtcStream, contacts, residueContacts,
+				window[w].qRange, window[w].timeRange, 1.0f);
+		closeXtcStream(xtcStream);
+
+		for(int i = 0; i < contacts; i++) {
+			cr_assert_eq(expected[i].totalOccurrences, table->contactInformation[w * contacts + i].totalOccurrences);
+			cr_assert_float_eq(expected[i].probability, table->contactInformation[w * contacts + i].probability, 0.0);
+		}
+
+		free(expected);
+	}
+
+	// The Q bin of every Q value counts every frame of its time window
+	cr_assert_eq(20, table->qValuesInRange[1]);
+	cr_assert_eq(81, table->qValuesInRange[3]);
+
+	freeOccupancyTable(table);
+	free(window);
+}
+
+Test(occupancyTable, Test_calculateOccupancyTableAverages) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	int qBin[] = {300, 400};
+	int timeWindow[] = {0, 20};
+	int windows;
+
+	struct OccupancyWindow *window = createOccupancyWindows(1, qBin, 1, timeWindow, &windows);
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	struct OccupancyTable *table = calculateOccupancyTableFromStream(xtcStream, contacts, residueContacts, windows, window, 1.0f);
+	closeXtcStream(xtcStream);
+
+	struct ContactAverages *contactAverages = calculateOccupancyTableAverages(table, 163);
+
+	FILE *file = fopen("./files/contactAverages", "r");
+	for(int i = 0; i < 163; i++) {
+		int residue;
+		float averageProbability, actualProbability;
+		fscanf(file, "%i %f", &residue, &averageProbability);
+
+		// Rounds like the printed expected values
+		char printedProbability[16];
+		sprintf(printedProbability, "%.6f", contactAverages[i].averageProbability);
+		sscanf(printedProbability, "%f", &actualProbability);
+
+		if(residue != contactAverages[i].focusResidue || averageProbability != actualProbability) {
+			cr_assert_fail("Average probability incorrect at line: %i\n", i + 1);
+		}
+	}
+	fclose(file);
+
+	free(contactAverages);
+	freeOccupancyTable(table);
+	free(window);
+}
@@ -0,0 +1,46 @@
+/*
+*	Name: parallelXtcReaderTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/parallelXtcReader/parallelXtcReader.h"
+
+Test(parallelXtcReader, Test_getXtcFileCoordinatesParallel) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcCoordinates** xtcCoords = getXtcFileCoordinates("./files/xtcFile", 163, frames);
+	struct XtcCoordinates** parallelCoords = getXtcFileCoordinatesParallel("./files/xtcFile", 163, frames, 4);
+
+	for(int i = 0; i < frames; i++) {
+		for(int j = 0; j < 163; j++) {
+			cr_assert_float_eq(xtcCoords[i][j].x, parallelCoords[i][j].x, 0.0);
+			cr_assert_float_eq(xtcCoords[i][j].y, parallelCoords[i][j].y, 0.0);
+			cr_assert_float_eq(xtcCoords[i][j].z, parallelCoords[i][j].z, 0.0);
+		}
+	}
+
+	freeFrameArrayMemory(parallelCoords, frames);
+	freeFrameArrayMemory(xtcCoords, frames);
+}
+
+Test(parallelXtcReader, Test_getXtcFileTrajectoryParallel) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcTrajectory* trajectory = getXtcFileTrajectory("./files/xtcFile", 163, frames);
+	struct XtcTrajectory* parallelTrajectory = getXtcFileTrajectoryParallel("./files/xtcFile", 163, 3);
+
+	cr_assert_eq(frames, parallelTrajectory->frames);
+
+	for(int i = 0; i < frames * trajectory->stride; i++) {
+		cr_assert_float_eq(trajectory->x[i], parallelTrajectory->x[i], 0.0);
+		cr_assert_float_eq(trajectory->y[i], parallelTrajectory->y[i], 0.0);
+		cr_assert_float_eq(trajectory->z[i], parallelTrajectory->z[i], 0.0);
+	}
+
+	freeXtcTrajectory(parallelTrajectory);
+	freeXtcTrajectory(trajectory);
+}
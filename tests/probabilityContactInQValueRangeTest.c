@@ -12,6 +12,7 @@
 #include "../software/headers/xtcReader/xtcReader.h"
 #include "../software/headers/contactReader/contactReader.h"
 #include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/contactState/contactState.h"
 #include "../software/headers/probabilityContactInQValueRange/probabilityContactInQValueRange.h"
 
 Test(probabilityContactInQValueRangeTest, Test_calculateContactProbability) {
@@ -34,7 +35,7 @@ Test(probabilityContactInQValueRangeTest, Test_calculateContactProbability) {
 	timeRange.high = 20;
 
 	struct ContactInformation *actualResidueContactsInformation =
-			calculateContactProbability(frames, contacts, xtcCoords, "./files/contactFile",
+			calculateContactProbability(frames, xtcCoords, readContactSet("./files/contactFile"),
 					qRange, timeRange, qValues, cutOff);
 
 	struct ContactInformation *expectedResidueContactsInformation =
@@ -73,4 +74,41 @@ Test(probabilityContactInQValueRangeTest, Test_calculateContactProbability) {
 
 }
 
+Test(probabilityContactInQValueRangeTest, Test_calculateContactProbabilityFromContactStates) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcCoordinates** xtcCoords = getXtcFileCoordinates("./files/xtcFile", 163, frames);
+
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	float cutOff = 1.0f;
+
+	int *qValues = calculateQValues(frames, contacts, cutOff, xtcCoords, residueContacts);
+
+	struct QRange qRange;
+	qRange.low = 300;
+	qRange.high = 400;
+
+	struct TSRange timeRange;
+	timeRange.low = 0;
+	timeRange.high = 20;
+
+	struct ContactInformation *expectedResidueContactsInformation =
+			calculateContactProbability(frames, xtcCoords, readContactSet("./files/contactFile"),
+					qRange, timeRange, qValues, cutOff);
 
+	uint64_t *contactStates = calculateTrajectoryContactStates(frames, contacts, cutOff, xtcCoords, residueContacts);
+
+	struct ContactInformation *actualResidueContactsInformation =
+			calculateContactProbabilityFromContactStates(frames, contacts, contactStates, residueContacts,
+					qRange, timeRange);
+
+	for(int i = 0; i < contacts; i++) {
+		if(expectedResidueContactsInformation[i].probability != actualResidueContactsInformation[i].probability) {
+			cr_assert_fail("Probability incorrect at line: %i\n", i + 1);
+		}
+		if(expectedResidueContactsInformation[i].totalOccurrences != actualResidueContactsInformation[i].totalOccurrences) {
+			cr_assert_fail("Total occurrences incorrect at line: %i\n", i + 1);
+		}
+	}
+}
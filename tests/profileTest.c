@@ -0,0 +1,90 @@
+/*
+*	Name: profileTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/profile/profile.h"
+
+Test(profile, Test_startProfile) {
+	char *argv[] = {"./calcQFromContactsProg", "163", "--profile", "1.0", NULL};
+	int argc = 4;
+
+	unsetenv("PROTEIN_PROFILE");
+	startProfile(&argc, argv);
+
+	cr_assert_eq(3, argc);
+	cr_assert(strcmp(argv[2], "1.0") == 0);
+	cr_assert_eq(1, isProfileEnabled());
+}
+
+Test(profile, Test_startProfileDisabled) {
+	char *argv[] = {"./calcQFromContactsProg", "163", NULL};
+	int argc = 2, stages;
+
+	setenv("PROTEIN_PROFILE", "0", 1);
+	startProfile(&argc, argv);
+	profileStage("readContacts");
+
+	cr_assert_eq(0, isProfileEnabled());
+	getProfileStages(&stages);
+	cr_assert_eq(0, stages);
+}
+
+Test(profile, Test_profileStage) {
+	char *argv[] = {"./calcQFromContactsProg", NULL};
+	int argc = 1, stages, frames;
+
+	setenv("PROTEIN_PROFILE", "1", 1);
+	startProfile(&argc, argv);
+
+	profileStage("readContacts");
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	profileStage("calculateQ");
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	setXtcStreamStride(xtcStream, 2);
+	free(calculateQValuesFromStream(xtcStream, contacts, 1.0f, residueContacts, &frames));
+	closeXtcStream(xtcStream);
+
+	profileStage("writeQFile");
+
+	struct ProfileStage *stage = getProfileStages(&stages);
+	cr_assert_eq(3, stages);
+
+	cr_assert(strcmp(stage[0].name, "readContacts") == 0);
+	cr_assert_eq(0, stage[0].sample.frames);
+	cr_assert_eq(0, stage[0].sample.contactEvaluations);
+
+	// Only the frames of the stride are decoded
+	cr_assert(strcmp(stage[1].name, "calculateQ") == 0);
+	cr_assert_eq(51, stage[1].sample.frames);
+	cr_assert_eq(51 * (int64_t) contacts, stage[1].sample.contactEvaluations);
+	cr_assert(stage[1].sample.wallSeconds >= 0);
+	cr_assert(stage[1].sample.bytesRead > 0);
+	cr_assert(stage[1].peakRssKb > 0);
+
+	FILE *file = tmpfile();
+	writeProfile(file);
+	rewind(file);
+
+	char line[4096];
+	cr_assert_not_null(fgets(line, sizeof(line), file));
+	fclose(file);
+
+	cr_assert(strncmp(line, "{\"program\": \"calcQFromContactsProg\", \"contactKernel\": ", 54) == 0);
+	cr_assert_not_null(strstr(line, "{\"stage\": \"calculateQ\", \"wallSeconds\": "));
+	cr_assert_not_null(strstr(line, "\"frames\": 51, "));
+	cr_assert_not_null(strstr(line, "], \"total\": {\"wallSeconds\": "));
+	cr_assert(strcmp(&line[strlen(line) - 3], "}}\n") == 0);
+}
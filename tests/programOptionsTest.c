@@ -0,0 +1,109 @@
+/*
+*	Name: programOptionsTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../software/headers/programOptions/programOptions.h"
+
+Test(programOptions, Test_takeOption) {
+	char *argv[] = {"prog", "163", "--threads", "8", "1.0", "--follow", "traj.xtc", NULL};
+	int argc = 7;
+
+	cr_assert_eq(8, takeThreadsOption(&argc, argv));
+	cr_assert_eq(1, takeFlag(&argc, argv, "--follow"));
+	cr_assert_eq(0, takeFlag(&argc, argv, "--follow"));
+	cr_assert_null(takeOption(&argc, argv, "--stride"));
+
+	cr_assert_eq(4, argc);
+	cr_assert(strcmp(argv[1], "163") == 0);
+	cr_assert(strcmp(argv[2], "1.0") == 0);
+	cr_assert(strcmp(argv[3], "traj.xtc") == 0);
+	cr_assert_null(argv[4]);
+}
+
+Test(programOptions, Test_takeThreadsOptionDefault) {
+	char *argv[] = {"prog", "163", NULL};
+	int argc = 2;
+
+	cr_assert_eq(1, takeThreadsOption(&argc, argv));
+	cr_assert_eq(2, argc);
+}
+
+Test(programOptions, Test_takeRangeOption) {
+	char *argv[] = {"prog", "--range", "150:180", "traj.xtc", "--stride", "10", NULL};
+	int argc = 6;
+	int low = 0, high = 0;
+
+	cr_assert_eq(10, takeStrideOption(&argc, argv));
+	cr_assert_eq(1, takeRangeOption(&argc, argv, "--range", &low, &high));
+	cr_assert_eq(150, low);
+	cr_assert_eq(180, high);
+	cr_assert_eq(0, takeRangeOption(&argc, argv, "--range", &low, &high));
+	cr_assert_eq(1, takeStrideOption(&argc, argv));
+
+	cr_assert_eq(2, argc);
+	cr_assert(strcmp(argv[1], "traj.xtc") == 0);
+}
+
+Test(programOptions, Test_takeRangeListOption) {
+	char *argv[] = {"prog", "--q", "0:20,20:40,40:440", "traj.xtc", NULL};
+	int argc = 4;
+	int ranges;
+
+	int *range = takeRangeListOption(&argc, argv, "--q", &ranges);
+
+	cr_assert_eq(3, ranges);
+	cr_assert_eq(0, range[0]);
+	cr_assert_eq(20, range[1]);
+	cr_assert_eq(20, range[2]);
+	cr_assert_eq(40, range[3]);
+	cr_assert_eq(40, range[4]);
+	cr_assert_eq(440, range[5]);
+	cr_assert_eq(2, argc);
+
+	cr_assert_null(takeRangeListOption(&argc, argv, "--q", &ranges));
+	cr_assert_eq(0, ranges);
+
+	free(range);
+}
+
+Test(programOptions, Test_parseCutoffList) {
+	char value[] = "6.5,7,9.25";
+	int cutoffs;
+
+	float *cutoff = parseCutoffList(value, &cutoffs);
+
+	cr_assert_eq(3, cutoffs);
+	cr_assert_float_eq(6.5, cutoff[0], 1e-6);
+	cr_assert_float_eq(7, cutoff[1], 1e-6);
+	cr_assert_float_eq(9.25, cutoff[2], 1e-6);
+
+	free(cutoff);
+}
+
+Test(programOptions, Test_takeFloatOption) {
+	char *argv[] = {"prog", "--beta", "50.5", "traj.xtc", NULL};
+	int argc = 4;
+
+	cr_assert_float_eq(50.5, takeFloatOption(&argc, argv, "--beta", 1.0f), 1e-6);
+	cr_assert_float_eq(1.8, takeFloatOption(&argc, argv, "--lambda", 1.8f), 1e-6);
+	cr_assert_eq(2, argc);
+}
+
+Test(programOptions, Test_joinArguments) {
+	char *argv[] = {"prog", "163", "1.0", "traj.xtc", "--stride", "2", NULL};
+
+	char *arguments = joinArguments(6, argv);
+	cr_assert(strcmp(arguments, "163 1.0 traj.xtc --stride 2") == 0);
+	free(arguments);
+
+	arguments = joinArguments(1, argv);
+	cr_assert(strcmp(arguments, "") == 0);
+	free(arguments);
+}
@@ -0,0 +1,151 @@
+/*
+*	Name: qSeriesTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+#include "../software/headers/qSeries/qSeries.h"
+
+void cleanUp() {
+	remove("qSeries");
+	remove("qFile");
+	remove("qFileSeries");
+}
+
+Test(qSeries, Test_formatQValue) {
+	char text[12];
+	int values[] = {0, 7, 440, -12, 2147483647};
+	char *expected[] = {"0", "7", "440", "-12", "2147483647"};
+
+	for(int i = 0; i < 5; i++) {
+		int length = formatQValue(text, values[i]);
+
+		text[length] = '\0';
+		cr_assert(strcmp(text, expected[i]) == 0);
+	}
+}
+
+Test(qSeries, Test_writeQSeries, .fini = cleanUp) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	float cutoff = 1.0f;
+	int xtcFrames;
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	setXtcStreamStride(xtcStream, 2);
+	int *qValues = calculateQValuesFromStream(xtcStream, contacts, cutoff, residueContacts, &xtcFrames);
+	writeQSeries(createQSeries(Q_SERIES_INT32, 1, &cutoff, xtcFrames, qValues, xtcStream, "./files/contactFile"), "qSeries");
+	closeXtcStream(xtcStream);
+
+	struct QSeries *series = readQSeries("qSeries");
+	cr_assert_eq(51, series->header.frames);
+	cr_assert_eq(0, series->header.firstFrame);
+	cr_assert_eq(2, series->header.stride);
+	cr_assert_eq(1, series->header.columns);
+	cr_assert(series->cutoff[0] == cutoff);
+
+	int qValue;
+	cr_assert_eq(1, getQSeriesValue(series, 4, &qValue));
+	cr_assert_eq(qValues[2], qValue);
+	cr_assert_eq(-1, getQSeriesValue(series, 5, &qValue));
+	cr_assert_eq(0, getQSeriesValue(series, 102, &qValue));
+
+	// The text export is the same as the qFile
+	writeQFile(qValues, xtcFrames, "qFile");
+	writeQSeriesText(series, "qFileSeries");
+
+	FILE *file1 = fopen("qFile", "r");
+	FILE *file2 = fopen("qFileSeries", "r");
+	int c1, c2;
+	do {
+		c1 = fgetc(file1), c2 = fgetc(file2);
+		cr_assert_eq(c1, c2);
+	} while(c1 != EOF);
+	fclose(file1);
+	fclose(file2);
+
+	// Either file gives the same Q values, only the series knows the stride
+	int frames1, frames2, firstFrame, stride;
+	double *qValues1 = readQValuesFile("qSeries", &frames1, &firstFrame, &stride);
+	cr_assert(isQSeriesFile("qSeries"));
+	cr_assert_eq(2, stride);
+
+	double *qValues2 = readQValuesFile("qFile", &frames2, &firstFrame, &stride);
+	cr_assert(!isQSeriesFile("qFile"));
+	cr_assert_eq(1, stride);
+
+	cr_assert_eq(xtcFrames, frames1);
+	cr_assert_eq(xtcFrames, frames2);
+	for(int i = 0; i < xtcFrames; i++) {
+		cr_assert(qValues1[i] == qValues[i] && qValues2[i] == qValues[i]);
+	}
+
+	free(qValues1);
+	free(qValues2);
+	freeQSeries(series);
+}
+
+Test(qSeries, Test_calculateContactProbabilityFromQSeries, .fini = cleanUp) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	struct QRange qRange = {300, 400};
+	struct TSRange timeRange = {0, 20};
+	float cutoff = 1.0f;
+	int xtcFrames;
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	int *qValues = calculateQValuesFromStream(xtcStream, contacts, cutoff, residueContacts, &xtcFrames);
+	writeQSeries(createQSeries(Q_SERIES_INT32, 1, &cutoff, xtcFrames, qValues, xtcStream, "./files/contactFile"), "qSeries");
+	closeXtcStream(xtcStream);
+
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	struct ContactInformation *expected = calculateContactProbabilityFromStream(xtcStream, contacts, residueContacts, qRange, timeRange, cutoff);
+	closeXtcStream(xtcStream);
+
+	struct QSeries *series = readQSeries("qSeries");
+
+	xtcStream = openXtcStream("./files/xtcFile", 163);
+	checkQSeries(series, xtcStream, "./files/contactFile", cutoff);
+	struct ContactInformation *actual = calculateContactProbabilityFromQSeries(xtcStream, series, contacts, residueContacts, qRange, timeRange, cutoff);
+	closeXtcStream(xtcStream);
+
+	for(int i = 0; i < contacts; i++) {
+		if(expected[i].totalOccurrences != actual[i].totalOccurrences || expected[i].probability != actual[i].probability) {
+			cr_assert_fail("Probability incorrect at line: %i\n", i + 1);
+		}
+	}
+
+	freeQSeries(series);
+	free(expected);
+	free(actual);
+}
+
+Test(qSeries, Test_checkQSeriesSteps, .fini = cleanUp, .exit_code = 1) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	float cutoff = 1.0f;
+	int xtcFrames;
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	setXtcStreamStride(xtcStream, 3);
+	int *qValues = calculateQValuesFromStream(xtcStream, contacts, cutoff, residueContacts, &xtcFrames);
+	struct QSeries *series = createQSeries(Q_SERIES_INT32, 1, &cutoff, xtcFrames, qValues, xtcStream, "./files/contactFile");
+	struct XtcFrameIndex *index = getXtcFrameIndex("./files/xtcFile");
+	closeXtcStream(xtcStream);
+
+	checkQSeriesSteps(series, index, "./files/xtcFile");
+
+	// A series of another trajectory with as many frames
+	series->header.lastStep++;
+	checkQSeriesSteps(series, index, "./files/xtcFile");
+}
@@ -0,0 +1,61 @@
+/*
+*	Name: residueGraphTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/residueGraph/residueGraph.h"
+
+Test(residueGraph, Test_createResidueGraph) {
+	struct Contact residueContacts[] = {{1, 3}, {2, 5}, {1, 5}, {3, 5}};
+	int residueContactCount;
+
+	struct ResidueGraph *graph = createResidueGraph(5, 4, residueContacts);
+
+	// Contacts as focusResidue first, then as contactResidue, each in contact order
+	int expectedCount[] = {2, 1, 2, 0, 3};
+	int expected[5][3] = {{0, 2}, {1}, {3, 0}, {0}, {1, 2, 3}};
+
+	for(int r = 1; r <= 5; r++) {
+		int *contact = getResidueGraphContacts(graph, r, &residueContactCount);
+
+		cr_assert_eq(expectedCount[r-1], residueContactCount);
+		for(int j = 0; j < residueContactCount; j++) {
+			cr_assert_eq(expected[r-1][j], contact[j]);
+		}
+	}
+
+	freeResidueGraph(graph);
+}
+
+Test(residueGraph, Test_createResidueGraphContactFile) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	int *seen = (int*) calloc(contacts, sizeof(int));
+	int residueContactCount;
+
+	struct ResidueGraph *graph = createResidueGraph(163, contacts, residueContacts);
+
+	// Every contact is listed under both of its residues
+	for(int r = 1; r <= 163; r++) {
+		int *contact = getResidueGraphContacts(graph, r, &residueContactCount);
+
+		for(int j = 0; j < residueContactCount; j++) {
+			cr_assert(residueContacts[contact[j]].focusResidue == r || residueContacts[contact[j]].contactResidue == r);
+			seen[contact[j]]++;
+		}
+	}
+
+	for(int i = 0; i < contacts; i++) {
+		cr_assert_eq(2, seen[i]);
+	}
+
+	freeResidueGraph(graph);
+	free(seen);
+}
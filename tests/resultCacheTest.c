@@ -0,0 +1,142 @@
+/*
+*	Name: resultCacheTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <utime.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "../software/headers/resultCache/resultCache.h"
+
+void cleanUp() {
+	system("rm -rf cacheDirectory");
+}
+
+Test(resultCache, Test_openResultCache, .fini = cleanUp) {
+	char *argv[] = {"./calcQFromContactsProg", "--cache", "cacheDirectory", "163", "--cache-size", "2", NULL};
+	int argc = 6;
+	struct stat fileStat;
+
+	unsetenv("PROTEIN_CACHE");
+	struct ResultCache *cache = openResultCache(&argc, argv);
+
+	cr_assert_not_null(cache);
+	cr_assert_eq(2, argc);
+	cr_assert(strcmp(argv[1], "163") == 0);
+	cr_assert_eq(2 * 1048576, cache->sizeLimit);
+	cr_assert_eq(0, stat("cacheDirectory", &fileStat));
+
+	argc = 2;
+	cr_assert_null(openResultCache(&argc, argv));
+
+	freeResultCache(cache);
+}
+
+Test(resultCache, Test_readResultCache, .fini = cleanUp) {
+	char *argv[] = {"./calcQFromContactsProg", "--cache", "cacheDirectory", NULL};
+	int argc = 3, qValues[] = {3, 1, 4, 1, 5};
+	int64_t frames, bytes;
+
+	struct ResultCache *cache = openResultCache(&argc, argv);
+
+	setResultCacheKey(cache, "qValues", "./files/xtcFile", "./files/contactFile", "163 1.0 stride 1");
+	cr_assert_null(readResultCache(cache, &frames, &bytes));
+
+	writeResultCache(cache, qValues, 5, sizeof(qValues));
+
+	int *cached = (int*) readResultCache(cache, &frames, &bytes);
+	cr_assert_not_null(cached);
+	cr_assert_eq(5, frames);
+	cr_assert_eq(sizeof(qValues), bytes);
+	cr_assert_eq(0, memcmp(qValues, cached, sizeof(qValues)));
+	free(cached);
+
+	// Other settings or another stage are another entry
+	setResultCacheKey(cache, "qValues", "./files/xtcFile", "./files/contactFile", "163 1.0 stride 2");
+	cr_assert_null(readResultCache(cache, &frames, &bytes));
+	setResultCacheKey(cache, "contactProbability", "./files/xtcFile", "./files/contactFile", "163 1.0 stride 1");
+	cr_assert_null(readResultCache(cache, &frames, &bytes));
+
+	freeResultCache(cache);
+}
+
+Test(resultCache, Test_evictResultCache, .fini = cleanUp) {
+	char *argv[] = {"./calcQFromContactsProg", "--cache", "cacheDirectory", NULL};
+	int argc = 3;
+	int64_t frames, bytes;
+	char *data = (char*) calloc(1000, 1);
+	char *first, settings[32];
+
+	struct ResultCache *cache = openResultCache(&argc, argv);
+	cache->sizeLimit = 2500;
+
+	setResultCacheKey(cache, "qValues", "./files/xtcFile", "./files/contactFile", "first");
+	writeResultCache(cache, data, 1000, 1000);
+	first = strdup(cache->entryFile);
+
+	// The first entry was used least recently once the others are written
+	utime(first, &(struct utimbuf) {1, 1});
+
+	for(int i = 0; i < 2; i++) {
+		sprintf(settings, "entry %d", i);
+		setResultCacheKey(cache, "qValues", "./files/xtcFile", "./files/contactFile", settings);
+		writeResultCache(cache, data, 1000, 1000);
+	}
+
+	cr_assert_neq(0, access(first, F_OK));
+	cr_assert_not_null(readResultCache(cache, &frames, &bytes));
+
+	free(first);
+	free(data);
+	freeResultCache(cache);
+}
+
+Test(resultCache, Test_evictResultCacheKeepsEntry, .fini = cleanUp) {
+	char *argv[] = {"./calcQFromContactsProg", "--cache", "cacheDirectory", NULL};
+	int argc = 3;
+	int64_t frames, bytes;
+	char *data = (char*) calloc(1000, 1);
+	char *older, *newer;
+
+	struct ResultCache *cache = openResultCache(&argc, argv);
+	cache->sizeLimit = 2500;
+
+	setResultCacheKey(cache, "qValues", "./files/xtcFile", "./files/contactFile", "older");
+	writeResultCache(cache, data, 1000, 1000);
+	older = strdup(cache->entryFile);
+
+	setResultCacheKey(cache, "qValues", "./files/xtcFile", "./files/contactFile", "newer");
+	writeResultCache(cache, data, 1000, 1000);
+	newer = strdup(cache->entryFile);
+
+	// Used in the same second, the nanoseconds tell which was used last
+	utimensat(AT_FDCWD, older, (struct timespec[]) {{100, 5}, {100, 5}}, 0);
+	utimensat(AT_FDCWD, newer, (struct timespec[]) {{100, 6}, {100, 6}}, 0);
+
+	setResultCacheKey(cache, "qValues", "./files/xtcFile", "./files/contactFile", "third");
+	writeResultCache(cache, data, 1000, 1000);
+
+	cr_assert_neq(0, access(older, F_OK));
+	cr_assert_eq(0, access(newer, F_OK));
+
+	// An entry larger than the limit on its own is kept until the next one is written
+	cache->sizeLimit = 500;
+	setResultCacheKey(cache, "qValues", "./files/xtcFile", "./files/contactFile", "large");
+	writeResultCache(cache, data, 1000, 1000);
+
+	cr_assert_not_null(readResultCache(cache, &frames, &bytes));
+	cr_assert_neq(0, access(newer, F_OK));
+
+	free(older);
+	free(newer);
+	free(data);
+	freeResultCache(cache);
+}
@@ -0,0 +1,88 @@
+/*
+*	Name: smoothQTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/smoothQ/smoothQ.h"
+
+void removeNativeFile() {
+	remove("native.gro");
+}
+
+Test(smoothQ, Test_readNativeStructure, .fini = removeNativeFile) {
+	FILE *file = fopen("native.gro", "w");
+	fprintf(file, "native structure\n    3\n");
+	fprintf(file, "%5d%-5s%5s%5d%8.3f%8.3f%8.3f\n", 1, "ALA", "CA", 1, 1.0, 2.0, 3.0);
+	fprintf(file, "%5d%-5s%5s%5d%8.3f%8.3f%8.3f\n", 2, "GLY", "CA", 2, -1.25, 0.5, 10.125);
+	fprintf(file, "%5d%-5s%5s%5d%8.3f%8.3f%8.3f\n", 3, "LYS", "CA", 3, 0.0, 0.0, 0.0);
+	fprintf(file, "   5.00000   5.00000   5.00000\n");
+	fclose(file);
+
+	struct XtcCoordinates *nativeFrame = readNativeStructure("native.gro", 2);
+
+	cr_assert_float_eq(1.0, nativeFrame[0].x, 1e-6);
+	cr_assert_float_eq(3.0, nativeFrame[0].z, 1e-6);
+	cr_assert_float_eq(-1.25, nativeFrame[1].x, 1e-6);
+	cr_assert_float_eq(10.125, nativeFrame[1].z, 1e-6);
+
+	free(nativeFrame);
+}
+
+Test(smoothQ, Test_calculateFrameSmoothQValue) {
+	struct XtcCoordinates frame[3] = {{0.0f, 0.0f, 0.0f}, {0.5f, 0.0f, 0.0f}, {0.0f, 0.8f, 0.0f}};
+	struct Contact residueContacts[2] = {{1, 2}, {1, 3}};
+
+	struct SmoothQ *smoothQ = createSmoothQ(2, residueContacts, frame, 50.0f, 1.5f);
+
+	cr_assert_float_eq(0.75, smoothQ->switchDistance[0], 1e-6);
+	cr_assert_float_eq(1.2, smoothQ->switchDistance[1], 1e-6);
+
+	// Both contacts at their native distance are almost fully formed
+	cr_assert(calculateFrameSmoothQValue(smoothQ, frame, residueContacts) > 0.99f);
+
+	// Stretching the first contact to its switch distance counts it as half formed
+	frame[1].x = 0.75f;
+	float expected = (0.5 + 1.0 / (1.0 + exp(50.0 * (0.8 - 1.2)))) / 2.0;
+	cr_assert_float_eq(expected, calculateFrameSmoothQValue(smoothQ, frame, residueContacts), 1e-6);
+
+	freeSmoothQ(smoothQ);
+}
+
+Test(smoothQ, Test_calculateSmoothQValuesFromStream) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcCoordinates** xtcCoords = getXtcFileCoordinates("./files/xtcFile", 163, frames);
+
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	struct XtcCoordinates *nativeFrame = readNativeStructure("./files/xtcFile", 163);
+	struct SmoothQ *smoothQ = createSmoothQ(contacts, residueContacts, nativeFrame, SMOOTH_Q_BETA, SMOOTH_Q_LAMBDA);
+
+	int streamFrames;
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	float *qValues = calculateSmoothQValuesFromStream(xtcStream, smoothQ, residueContacts, &streamFrames);
+	closeXtcStream(xtcStream);
+
+	cr_assert_eq(frames, streamFrames);
+	for(int i = 0; i < frames; i++) {
+		if(qValues[i] != calculateFrameSmoothQValue(smoothQ, xtcCoords[i], residueContacts) || qValues[i] < 0.0f || qValues[i] > 1.0f) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i+1);
+		}
+	}
+
+	// The native structure is the first frame
+	cr_assert(qValues[0] > 0.99f);
+
+	freeSmoothQ(smoothQ);
+	free(qValues);
+}
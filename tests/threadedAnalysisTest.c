@@ -0,0 +1,72 @@
+/*
+*	Name: threadedAnalysisTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/calcQFromContacts/calcQFromContacts.h"
+#include "../software/headers/probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+#include "../software/headers/threadedAnalysis/threadedAnalysis.h"
+
+Test(threadedAnalysis, Test_calculateQValuesThreaded) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	int frames;
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	int *qValues = calculateQValuesThreaded(xtcStream, contacts, 1.0f, residueContacts, &frames, 4);
+	closeXtcStream(xtcStream);
+
+	cr_assert_eq(101, frames);
+
+	FILE *file = fopen("./files/qFile", "r");
+	for(int i = 0; i < frames; i++) {
+		int expectedQValue;
+		fscanf(file, "%i", &expectedQValue);
+
+		if(expectedQValue != qValues[i]) {
+			cr_assert_fail("Q value of frame: %i is different.\n", i+1);
+		}
+	}
+	fclose(file);
+}
+
+Test(threadedAnalysis, Test_calculateContactProbabilityThreaded) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+
+	struct QRange qRange;
+	qRange.low = 300;
+	qRange.high = 400;
+
+	struct TSRange timeRange;
+	timeRange.low = 0;
+	timeRange.high = 20;
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	struct ContactInformation *residueContactsInformation =
+			calculateContactProbabilityThreaded(xtcStream, contacts, residueContacts, qRange, timeRange, 1.0f, 3);
+	closeXtcStream(xtcStream);
+
+	FILE *file = fopen("./files/contactInformation", "r");
+	for(int i = 0; i < contacts; i++) {
+		int tmp, focusResidue, contactResidue, totalOccurrences;
+		float probability;
+		fscanf(file, "%i %i %i %f %i", &tmp, &focusResidue, &contactResidue, &probability, &totalOccurrences);
+
+		if(probability != residueContactsInformation[i].probability) {
+			cr_assert_fail("Probability incorrect at line: %i\n", i + 1);
+		}
+		if(totalOccurrences != residueContactsInformation[i].totalOccurrences) {
+			cr_assert_fail("Total occurrences incorrect at line: %i\n", i + 1);
+		}
+	}
+	fclose(file);
+}
@@ -0,0 +1,367 @@
+/*
+*	Name: whamTest.c
+*	Author: Thomas Dahlstrom
+*	Date: Oct. 17, 2026
+*	Updated: Oct. 17, 2026
+*/
+
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../software/headers/xtcReader/xtcReader.h"
+#include "../software/headers/contactReader/contactReader.h"
+#include "../software/headers/contactKernel/contactKernel.h"
+#include "../software/headers/probabilityContactInQValueRange/probabilityContactInQValueRange.h"
+#include "../software/headers/qSeries/qSeries.h"
+#include "../software/headers/mdLog/mdLog.h"
+#include "../software/headers/wham/wham.h"
+
+void cleanUp() {
+	remove("whamRuns");
+	remove("qFile");
+	remove("energyFile");
+	remove("qSeries");
+	remove("mdLog");
+}
+
+struct WhamRun createRun(float temperature, int frames) {
+	struct WhamRun run;
+
+	run.temperature = temperature;
+	run.qFile = NULL;
+	run.energyFile = NULL;
+	run.xtcFile = NULL;
+	run.frames = frames;
+	run.firstFrame = 0;
+	run.stride = 1;
+	run.qValue = (double*) malloc(sizeof(double) * frames);
+	run.energy = (double*) malloc(sizeof(double) * frames);
+
+	return run;
+}
+
+// Two states, Q = 10 at 0 kJ/mol and Q = 0 at 5 kJ/mol, sampled in exact proportions
+struct Wham* createTwoStateWham() {
+	float temperature[] = {300, 400, 500};
+	struct WhamRun *run = (struct WhamRun*) malloc(sizeof(struct WhamRun) * 3);
+
+	for(int r = 0; r < 3; r++) {
+		double folded = 1.0 / (1.0 + exp(-5.0 / (WHAM_BOLTZMANN * temperature[r])));
+		int foldedFrames = (int) round(folded * 10000);
+
+		run[r] = createRun(temperature[r], 10000);
+		for(int n = 0; n < 10000; n++) {
+			run[r].qValue[n] = n < foldedFrames ? 10 : 0;
+			run[r].energy[n] = n < foldedFrames ? 0.0 : 5.0;
+		}
+	}
+
+	return createWham(3, run);
+}
+
+Test(wham, Test_solveWham) {
+	struct Wham *wham = createTwoStateWham();
+	double qMin;
+
+	// Every frame has one of two energies
+	cr_assert_eq(2, wham->levels);
+	cr_assert_eq(1, solveWham(wham, 1e-10, WHAM_ITERATIONS, 1));
+	cr_assert(wham->freeEnergy[0] == 0.0);
+
+	// Any temperature, also between and beyond the runs
+	float temperature[] = {300, 350, 600};
+	for(int t = 0; t < 3; t++) {
+		double *logWeight = calculateWhamLogWeights(wham, temperature[t]);
+		double folded = 0.0, expected = 1.0 / (1.0 + exp(-5.0 / (WHAM_BOLTZMANN * temperature[t])));
+
+		for(int n = 0; n < wham->frames; n++) {
+			folded += wham->qValue[n] == 10 ? exp(logWeight[n]) : 0.0;
+		}
+
+		cr_assert(fabs(folded - expected) < 1e-3, "P(folded) at %gK is %f, not %f", temperature[t], folded, expected);
+
+		int bins = getWhamQBins(wham, 1.0, &qMin);
+		double *freeEnergy = calculateWhamFreeEnergy(wham, logWeight, temperature[t], 1.0, qMin, bins);
+
+		cr_assert_eq(11, bins);
+		cr_assert(qMin == 0.0);
+		cr_assert(freeEnergy[10] == 0.0);
+		cr_assert(fabs(freeEnergy[0] - 5.0) < 0.02, "F(0) at %gK is %f", temperature[t], freeEnergy[0]);
+		cr_assert(isnan(freeEnergy[5]));
+
+		free(logWeight);
+		free(freeEnergy);
+	}
+
+	freeWham(wham);
+}
+
+Test(wham, Test_solveWhamThreads) {
+	struct WhamRun *run1 = (struct WhamRun*) malloc(sizeof(struct WhamRun) * 4);
+	struct WhamRun *run2 = (struct WhamRun*) malloc(sizeof(struct WhamRun) * 4);
+	unsigned int seed = 12345;
+
+	// More frames than one chunk, so the threads share the work
+	for(int r = 0; r < 4; r++) {
+		run1[r] = createRun(300 + 20 * r, 3000 + 1000 * r);
+		run2[r] = createRun(300 + 20 * r, 3000 + 1000 * r);
+
+		for(int n = 0; n < run1[r].frames; n++) {
+			seed = seed * 1103515245 + 12345;
+			run1[r].qValue[n] = run2[r].qValue[n] = (seed >> 16) % 100;
+			run1[r].energy[n] = run2[r].energy[n] = -2000.0 + 10.0 * r + run1[r].qValue[n] * 0.5 + (seed % 1000) / 100.0;
+		}
+	}
+
+	struct Wham *wham1 = createWham(4, run1);
+	struct Wham *wham2 = createWham(4, run2);
+
+	solveWham(wham1, 1e-9, 10000, 1);
+	solveWham(wham2, 1e-9, 10000, 4);
+
+	cr_assert_eq(wham1->iterations, wham2->iterations);
+	for(int r = 0; r < 4; r++) {
+		cr_assert(wham1->freeEnergy[r] == wham2->freeEnergy[r], "Free energy of run %d differs", r + 1);
+	}
+
+	cr_assert_eq(wham1->levels, wham2->levels);
+	for(int u = 0; u < wham1->levels; u++) {
+		if(wham1->logDenominator[u] != wham2->logDenominator[u]) {
+			cr_assert_fail("Denominator incorrect at level: %i\n", u + 1);
+		}
+	}
+
+	freeWham(wham1);
+	freeWham(wham2);
+}
+
+Test(wham, Test_calculateWhamExp) {
+	for(double x = -700.0; x <= 5.0; x += 0.0137) {
+		double expected = exp(x), actual = calculateWhamExp(x);
+
+		if(fabs(actual - expected) > 4e-16 * expected) {
+			cr_assert_fail("exp(%.17g) is %.17g, not %.17g\n", x, actual, expected);
+		}
+	}
+
+	cr_assert(calculateWhamExp(0.0) == 1.0);
+	cr_assert(calculateWhamExp(-INFINITY) < 1e-307);
+}
+
+Test(wham, Test_solveWhamKernels) {
+	char *kernels[] = {"scalar", "avx2"};
+	double freeEnergy[2][4];
+	unsigned int seed = 54321;
+	struct WhamRun *run[2];
+
+	// Levels left over after the last full vector of every chunk
+	for(int k = 0; k < 2; k++) {
+		run[k] = (struct WhamRun*) malloc(sizeof(struct WhamRun) * 4);
+	}
+
+	for(int r = 0; r < 4; r++) {
+		run[0][r] = createRun(300 + 15 * r, 2001 + r);
+		run[1][r] = createRun(300 + 15 * r, 2001 + r);
+
+		for(int n = 0; n < run[0][r].frames; n++) {
+			seed = seed * 1103515245 + 12345;
+			run[0][r].qValue[n] = run[1][r].qValue[n] = (seed >> 16) % 50;
+			run[0][r].energy[n] = run[1][r].energy[n] = -1500.0 + 8.0 * r + run[0][r].qValue[n] + (seed % 997) / 50.0;
+		}
+	}
+
+	for(int k = 0; k < 2; k++) {
+		struct Wham *wham = createWham(4, run[k]);
+
+		if(!setContactKernel(kernels[k])) {
+			memcpy(freeEnergy[k], freeEnergy[0], sizeof(freeEnergy[0]));
+			freeWham(wham);
+			continue;
+		}
+
+		solveWham(wham, 1e-9, 10000, 2);
+		memcpy(freeEnergy[k], wham->freeEnergy, sizeof(freeEnergy[k]));
+		freeWham(wham);
+	}
+
+	setContactKernel("scalar");
+
+	for(int r = 0; r < 4; r++) {
+		cr_assert(freeEnergy[0][r] == freeEnergy[1][r], "Free energy of run %d differs between kernels", r + 1);
+	}
+}
+
+Test(wham, Test_readWhamRuns, .fini = cleanUp) {
+	FILE *fp = fopen("whamRuns", "w");
+	fprintf(fp, "# temperature qFile energyFile\n\n300 qFile energyFile\n");
+	fclose(fp);
+
+	fp = fopen("qFile", "w");
+	fprintf(fp, "5\n6\n7\n");
+	fclose(fp);
+
+	// As written by mdtoen.csh, one energy less than Q values
+	fp = fopen("energyFile", "w");
+	fprintf(fp, "1 -1.005e+02\n2 -1.010e+02\n");
+	fclose(fp);
+
+	struct Wham *wham = readWhamRuns("whamRuns", "Potential");
+
+	cr_assert_eq(1, wham->runs);
+	cr_assert_eq(2, wham->frames);
+	cr_assert(wham->run[0].temperature == 300);
+	cr_assert(wham->run[0].xtcFile == NULL);
+	cr_assert(wham->qValue[1] == 6);
+	cr_assert(wham->energy[0] == -100.5);
+	cr_assert(wham->energy[1] == -101);
+
+	freeWham(wham);
+}
+
+Test(wham, Test_readWhamRunsStride, .fini = cleanUp) {
+	int32_t qValues[] = {5, 6, 7};
+	float cutoff = 1.0f;
+	struct QSeries series;
+
+	FILE *fp = fopen("whamRuns", "w");
+	fprintf(fp, "300 qSeries energyFile\n");
+	fclose(fp);
+
+	// Frames 2, 4 and 6 of a run written with --range 2:7 --stride 2
+	memset(&series.header, 0, sizeof(series.header));
+	memcpy(series.header.magic, Q_SERIES_MAGIC, sizeof(series.header.magic));
+	series.header.version = Q_SERIES_VERSION;
+	series.header.type = Q_SERIES_INT32;
+	series.header.columns = 1;
+	series.header.stride = 2;
+	series.header.frames = 3;
+	series.header.firstFrame = 1;
+	series.cutoff = &cutoff;
+	series.values = qValues;
+	writeQSeries(&series, "qSeries");
+
+	fp = fopen("energyFile", "w");
+	for(int i = 0; i < 7; i++) {
+		fprintf(fp, "%d %d\n", i + 1, -100 - i);
+	}
+	fclose(fp);
+
+	struct Wham *wham = readWhamRuns("whamRuns", "Potential");
+
+	cr_assert_eq(3, wham->frames);
+	cr_assert_eq(1, wham->run[0].firstFrame);
+	cr_assert_eq(2, wham->run[0].stride);
+	for(int i = 0; i < 3; i++) {
+		cr_assert(wham->qValue[i] == 5 + i);
+		cr_assert(wham->energy[i] == -101 - 2 * i, "Energy of Q value %d is %g", i + 1, wham->energy[i]);
+	}
+
+	freeWham(wham);
+}
+
+Test(wham, Test_readWhamRunsTextStride, .fini = cleanUp, .exit_code = 1) {
+	FILE *fp = fopen("whamRuns", "w");
+	fprintf(fp, "300 qFile energyFile\n");
+	fclose(fp);
+
+	// Every other frame, as a qFile of a --stride 2 run
+	fp = fopen("qFile", "w");
+	fprintf(fp, "5\n6\n7\n");
+	fclose(fp);
+
+	fp = fopen("energyFile", "w");
+	fprintf(fp, "1 -100\n2 -101\n3 -102\n4 -103\n5 -104\n6 -105\n");
+	fclose(fp);
+
+	readWhamRuns("whamRuns", "Potential");
+}
+
+Test(wham, Test_readWhamRunsNotAvailable, .fini = cleanUp, .exit_code = 1) {
+	FILE *fp = fopen("whamRuns", "w");
+	fprintf(fp, "300 qFile energyFile\n");
+	fclose(fp);
+
+	fp = fopen("qFile", "w");
+	fprintf(fp, "5\n6\n7\n");
+	fclose(fp);
+
+	// energyTableProg output whose second frame has no energy in md.log
+	fp = fopen("energyFile", "w");
+	fprintf(fp, "# frame step time Q \"Potential\"\n1 0 0 5 -1.00000e+02\n2 50 0.1 6 N/A\n3 100 0.2 7 -1.02000e+02\n");
+	fclose(fp);
+
+	readWhamRuns("whamRuns", "Potential");
+}
+
+Test(wham, Test_readWhamRunsMdLog, .fini = cleanUp) {
+	struct XtcFrameIndex *index = getXtcFrameIndex("./files/xtcFile");
+
+	FILE *fp = fopen("whamRuns", "w");
+	fprintf(fp, "300 qFile mdLog ./files/xtcFile\n");
+	fclose(fp);
+
+	fp = fopen("qFile", "w");
+	fprintf(fp, "5\n6\n7\n");
+	fclose(fp);
+
+	// An energy block at every frame of the trajectory, the Potential set from the frame
+	fp = fopen("mdLog", "w");
+	fprintf(fp, "Log file opened on Sat Oct 17 2026\n\n");
+	for(int frame = 0; frame < index->frames; frame++) {
+		fprintf(fp, "%15s%15s%15s\n%15d%15.5f%15.5f\n\n", "Step", "Time", "Lambda", index->steps[frame], index->times[frame], 0.0);
+		fprintf(fp, "   Energies (kJ/mol)\n%15s%15s\n%15.5e%15.5e\n\n", "LJ (SR)", "Potential", -500.0, -100.0 - frame);
+	}
+	fclose(fp);
+
+	struct Wham *wham = readWhamRuns("whamRuns", "Potential");
+
+	cr_assert_eq(3, wham->frames);
+	for(int i = 0; i < 3; i++) {
+		cr_assert(wham->energy[i] == -100 - i, "Energy of Q value %d is %g", i + 1, wham->energy[i]);
+	}
+
+	freeWham(wham);
+	freeXtcFrameIndex(index);
+}
+
+Test(wham, Test_calculateWhamContactProbabilities) {
+	int contacts = getAmountOfContacts("./files/contactFile");
+	struct Contact* residueContacts = getContactFileContacts("./files/contactFile");
+	int frames = getFrames("./files/xtcFile", 163);
+	struct QRange qRange = {0, contacts};
+	struct TSRange timeRange = {1, frames};
+	float temperature = 300;
+
+	struct WhamRun *run = (struct WhamRun*) malloc(sizeof(struct WhamRun));
+	run[0] = createRun(temperature, frames);
+	run[0].xtcFile = strdup("./files/xtcFile");
+	for(int n = 0; n < frames; n++) {
+		run[0].qValue[n] = 0;
+		run[0].energy[n] = -1000.0 - n;
+	}
+
+	struct Wham *wham = createWham(1, run);
+	solveWham(wham, WHAM_TOLERANCE, WHAM_ITERATIONS, 2);
+
+	// At the temperature of its only run every frame has the same weight
+	double *logWeight = calculateWhamLogWeights(wham, temperature);
+	double *probability = calculateWhamContactProbabilities(wham, 1, &logWeight, 163, contacts, residueContacts, 1.0, 2);
+
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+	struct ContactInformation *expected = calculateContactProbabilityFromStream(xtcStream, contacts, residueContacts, qRange, timeRange, 1.0);
+	closeXtcStream(xtcStream);
+
+	for(int i = 0; i < contacts; i++) {
+		if(fabs(expected[i].probability - probability[i]) > 1e-6) {
+			cr_assert_fail("Probability incorrect at line: %i\n", i + 1);
+		}
+	}
+
+	free(logWeight);
+	free(probability);
+	free(expected);
+	freeWham(wham);
+}
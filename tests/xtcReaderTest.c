@@ -7,6 +7,7 @@
 
 #include <criterion/criterion.h>
 #include <stdio.h>
+#include <stdint.h>
 
 #include "../software/headers/xtcReader/xtcReader.h"
 
@@ -23,3 +24,182 @@ Test(xtcReader, Test_getXtcFileCoordinates) {
 	cr_assert_float_eq(-2.802f, xtcCoords[0][0].x, 0.0);
 	cr_assert_float_eq(2.996f, xtcCoords[0][0].z, 0.0);
 }
+
+Test(xtcReader, Test_readXtcStreamFrame) {
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+
+	cr_assert_eq(1, readXtcStreamFrame(xtcStream));
+	cr_assert_float_eq(-2.802f, xtcStream->frame[0].x, 0.0);
+	cr_assert_float_eq(2.996f, xtcStream->frame[0].z, 0.0);
+
+	while(readXtcStreamFrame(xtcStream));
+
+	cr_assert_eq(xtcStream->currentFrame, 101);
+
+	closeXtcStream(xtcStream);
+}
+
+Test(xtcReader, Test_getXtcFileTrajectory) {
+	int frames = getFrames("./files/xtcFile", 163);
+	struct XtcCoordinates** xtcCoords = getXtcFileCoordinates("./files/xtcFile", 163, frames);
+	struct XtcTrajectory* trajectory = getXtcFileTrajectory("./files/xtcFile", 163, frames);
+
+	cr_assert_eq(frames, trajectory->frames);
+	cr_assert_eq(0, trajectory->stride % XTC_TRAJECTORY_ALIGNMENT);
+	cr_assert_eq(0, (uintptr_t) trajectory->x % 64);
+	cr_assert_eq(0, (uintptr_t) trajectory->y % 64);
+	cr_assert_eq(0, (uintptr_t) trajectory->z % 64);
+
+	for(int i = 0; i < frames; i++) {
+		for(int j = 0; j < 163; j++) {
+			cr_assert_float_eq(xtcCoords[i][j].x, trajectory->x[i * trajectory->stride + j], 0.0);
+			cr_assert_float_eq(xtcCoords[i][j].y, trajectory->y[i * trajectory->stride + j], 0.0);
+			cr_assert_float_eq(xtcCoords[i][j].z, trajectory->z[i * trajectory->stride + j], 0.0);
+		}
+	}
+
+	freeXtcTrajectory(trajectory);
+	freeFrameArrayMemory(xtcCoords, frames);
+}
+
+Test(xtcReader, Test_scanXtcFrameIndex) {
+	struct XtcFrameIndex* index = scanXtcFrameIndex("./files/xtcFile");
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+
+	cr_assert_eq(101, index->frames);
+	cr_assert_eq(163, index->natoms);
+	cr_assert_eq(0, index->offsets[0]);
+
+	// Frames read after a seek match the frames read in order
+	for(int i = 0; i < index->frames; i++) {
+		readXtcStreamFrame(xtcStream);
+		cr_assert_eq(index->steps[i], xtcStream->step);
+		cr_assert_float_eq(index->times[i], xtcStream->time, 0.0);
+	}
+
+	seekXtcStream(xtcStream, index, 50);
+	cr_assert_eq(1, readXtcStreamFrame(xtcStream));
+	cr_assert_eq(51, xtcStream->currentFrame);
+	cr_assert_eq(index->steps[50], xtcStream->step);
+
+	closeXtcStream(xtcStream);
+	freeXtcFrameIndex(index);
+}
+
+Test(xtcReader, Test_getXtcFrameIndex) {
+	struct XtcFrameIndexHeader header;
+	FILE *file;
+
+	remove("./files/xtcFile.idx");
+
+	// Scans the trajectory and writes the index file
+	struct XtcFrameIndex* index = getXtcFrameIndex("./files/xtcFile");
+	cr_assert_eq(101, index->frames);
+
+	file = fopen("./files/xtcFile.idx", "r+b");
+	cr_assert_not_null(file);
+	cr_assert_eq(1, fread(&header, sizeof(header), 1, file));
+	cr_assert_eq(101, header.frames);
+
+	// An index of a trajectory with another size is rebuilt
+	header.xtcIdentity.size++;
+	header.frames = 7;
+	rewind(file);
+	fwrite(&header, sizeof(header), 1, file);
+	fclose(file);
+
+	struct XtcFrameIndex* rebuiltIndex = getXtcFrameIndex("./files/xtcFile");
+	cr_assert_eq(101, rebuiltIndex->frames);
+
+	for(int i = 0; i < index->frames; i++) {
+		cr_assert_eq(index->offsets[i], rebuiltIndex->offsets[i]);
+		cr_assert_eq(index->steps[i], rebuiltIndex->steps[i]);
+	}
+
+	cr_assert_eq(101, getFrames("./files/xtcFile", 163));
+
+	freeXtcFrameIndex(rebuiltIndex);
+	freeXtcFrameIndex(index);
+}
+
+Test(xtcReader, Test_setXtcStreamTimeRange) {
+	struct XtcFrameIndex* index = getXtcFrameIndex("./files/xtcFile");
+	struct XtcStream* xtcStream = openXtcStream("./files/xtcFile", 163);
+
+	struct TSRange timeRange;
+	timeRange.low = 11;
+	timeRange.high = 30;
+
+	setXtcStreamTimeRange(xtcStream, timeRange);
+	setXtcStreamStride(xtcStream, 5);
+
+	// Time slices 11, 16, 21 and 26 are frames 10, 15, 20 and 25
+	for(int frame = 10; frame < 30; frame += 5) {
+		cr_assert_eq(1, readXtcStreamFrame(xtcStream));
+		cr_assert_eq(frame + 1, xtcStream->currentFrame);
+		cr_assert_eq(index->steps[frame], xtcStream->step);
+	}
+
+	cr_assert_eq(0, readXtcStreamFrame(xtcStream));
+
+	closeXtcStream(xtcStream);
+	freeXtcFrameIndex(index);
+}
+
+// Copies bytes start to end-1 of the trajectory, or to its end, to the end of a file
+void appendXtcBytes(char *file, int64_t start, int64_t end) {
+	FILE *in = fopen("./files/xtcFile", "rb");
+	FILE *out = fopen(file, "ab");
+	char buffer[4096];
+
+	fseek(in, start, SEEK_SET);
+	while(start < end) {
+		size_t n = fread(buffer, 1, end - start < 4096 ? end - start : 4096, in);
+		if(n == 0) {
+			break;
+		}
+		fwrite(buffer, 1, n, out);
+		start += n;
+	}
+
+	fclose(out);
+	fclose(in);
+}
+
+void removeFollowedFile() {
+	remove("followedXtcFile");
+	remove("followedXtcFile.idx");
+}
+
+Test(xtcReader, Test_followXtcStreamFrame, .fini = removeFollowedFile) {
+	struct XtcFrameIndex* index = getXtcFrameIndex("./files/xtcFile");
+	int64_t halfFrame = (index->offsets[10] + index->offsets[11]) / 2;
+
+	// Ten frames and half of the eleventh are written so far
+	removeFollowedFile();
+	appendXtcBytes("followedXtcFile", 0, halfFrame);
+
+	struct XtcStream* xtcStream = openXtcStream("followedXtcFile", 163);
+	setXtcStreamStride(xtcStream, 3);
+
+	for(int frame = 0; frame < 10; frame += 3) {
+		cr_assert_eq(1, followXtcStreamFrame(xtcStream, 0.01f, 0.05f));
+		cr_assert_eq(index->steps[frame], xtcStream->step);
+	}
+
+	// Frame 12 is not written yet
+	cr_assert_eq(0, followXtcStreamFrame(xtcStream, 0.01f, 0.05f));
+
+	appendXtcBytes("followedXtcFile", halfFrame, index->offsets[index->frames-1] + 1000000);
+
+	for(int frame = 12; frame < index->frames; frame += 3) {
+		cr_assert_eq(1, followXtcStreamFrame(xtcStream, 0.01f, 0.05f));
+		cr_assert_eq(frame + 1, xtcStream->currentFrame);
+		cr_assert_eq(index->steps[frame], xtcStream->step);
+	}
+
+	cr_assert_eq(0, followXtcStreamFrame(xtcStream, 0.01f, 0.05f));
+
+	closeXtcStream(xtcStream);
+	freeXtcFrameIndex(index);
+}